@@ -0,0 +1,707 @@
+// host/freertos_posix.c
+// FreeRTOS on pthreads with a simulated tick (see host_runtime.h).
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "host_runtime.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOST_MAX_TASKS  24
+
+// Each task thread gets its own stack, painted so uxTaskGetStackHighWaterMark()
+// can find the deepest byte ever written. Far larger than any target stack.
+#define HOST_TASK_STACK_BYTES   (256u * 1024u)
+#define HOST_STACK_PAINT        0xA5
+
+typedef enum {
+    TASK_READY,
+    TASK_RUNNING,
+    TASK_BLOCKED,
+    TASK_DELETED
+} HostTaskState_t;
+
+typedef enum {
+    WAIT_NONE,
+    WAIT_RECEIVE,       // Queue (or set) empty
+    WAIT_SEND,          // Queue full
+    WAIT_NOTIFY,
+    WAIT_DELAY
+} HostWait_t;
+
+struct HostTask {
+    pthread_t thread;
+    pthread_cond_t run_cond;    // Signalled when the task is given the CPU
+    const char *name;
+    UBaseType_t priority;
+    TaskFunction_t entry;
+    void *arg;
+
+    HostTaskState_t state;
+    HostWait_t wait;
+    struct HostQueue *wait_queue;
+    int has_timeout;
+    int timed_out;
+    TickType_t wake_tick;
+    uint64_t seq;               // FIFO order among equal priorities
+    uint32_t notify_count;
+
+    BaseType_t core;            // tskNO_AFFINITY or the simulated core
+
+    uint8_t *stack;             // HOST_TASK_STACK_BYTES, painted
+    uint8_t *stack_entry;       // Frame of task_thread(): depth is measured from here
+    uint32_t stack_depth;       // As requested by the creator, in bytes
+};
+
+struct HostQueue {
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    struct HostQueue *set;      // Queue set this queue belongs to, if any
+    UBaseType_t peak;           // Highest count ever reached
+};
+
+typedef char host_queue_fits_static_buffer[(sizeof(struct HostQueue) <= sizeof(StaticQueue_t)) ? 1 : -1];
+
+// The kernel lock is held by whoever is inside a FreeRTOS call. Only
+// s_current may run task code; every other task thread sleeps on run_cond.
+static pthread_mutex_t s_kernel = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_main_cond = PTHREAD_COND_INITIALIZER;
+static struct HostTask s_tasks[HOST_MAX_TASKS];
+static uint32_t s_task_count;
+static struct HostTask *s_current;
+static TickType_t s_tick;
+static TickType_t s_end_tick;
+static int s_running;
+static uint32_t s_warp;
+static uint64_t s_seq;
+static HostRuntimeStats_t s_rt_stats;
+
+// --- A. SCHEDULER ---
+
+static void make_ready(struct HostTask *t) {
+    t->state = TASK_READY;
+    t->wait = WAIT_NONE;
+    t->wait_queue = NULL;
+    t->seq = ++s_seq;
+}
+
+static struct HostTask *highest_ready(void) {
+    struct HostTask *best = NULL;
+
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        struct HostTask *t = &s_tasks[i];
+        if (t->state != TASK_READY) {
+            continue;
+        }
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->seq < best->seq)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void warp_sleep(TickType_t ticks) {
+    if (s_warp == 0) {
+        return;
+    }
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ull / s_warp;
+    struct timespec ts = { (time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull) };
+    nanosleep(&ts, NULL);
+}
+
+// Every task is blocked: jump to the earliest timeout. Returns 0 when there
+// is none before the end of the run.
+static int advance_time(void) {
+    TickType_t step = 0;
+    int found = 0;
+
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        struct HostTask *t = &s_tasks[i];
+        if (t->state == TASK_BLOCKED && t->has_timeout) {
+            TickType_t until = t->wake_tick - s_tick;
+            if (!found || until < step) {
+                step = until;
+                found = 1;
+            }
+        }
+    }
+    if (!found || step > (TickType_t)(s_end_tick - s_tick)) {
+        warp_sleep(s_end_tick - s_tick);
+        s_tick = s_end_tick;
+        return 0;
+    }
+
+    warp_sleep(step);
+    s_tick += step;
+    s_rt_stats.clock_jumps++;
+
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        struct HostTask *t = &s_tasks[i];
+        if (t->state == TASK_BLOCKED && t->has_timeout && t->wake_tick == s_tick) {
+            t->timed_out = 1;
+            make_ready(t);
+        }
+    }
+    return 1;
+}
+
+// Hands the CPU to the best ready task (advancing time if there is none)
+static void dispatch(void) {
+    for (;;) {
+        struct HostTask *next = highest_ready();
+        if (next != NULL) {
+            if (next != s_current) {
+                s_rt_stats.context_switches++;
+            }
+            s_current = next;
+            next->state = TASK_RUNNING;
+            pthread_cond_signal(&next->run_cond);
+            return;
+        }
+        if (!advance_time()) {
+            s_current = NULL;
+            s_running = 0;
+            pthread_cond_signal(&s_main_cond);
+            return;
+        }
+    }
+}
+
+// Called with the kernel lock held by a task that gave up the CPU
+static void switch_away(struct HostTask *self) {
+    dispatch();
+    while (s_current != self) {
+        pthread_cond_wait(&self->run_cond, &s_kernel);
+    }
+}
+
+// Blocks the running task until it is woken or `deadline` passes.
+// Returns 1 if woken by an event, 0 on timeout.
+static int block_until(HostWait_t wait, struct HostQueue *q, int forever, TickType_t deadline) {
+    struct HostTask *self = s_current;
+
+    self->state = TASK_BLOCKED;
+    self->wait = wait;
+    self->wait_queue = q;
+    self->has_timeout = !forever;
+    self->wake_tick = deadline;
+    self->timed_out = 0;
+    self->seq = ++s_seq;
+    switch_away(self);
+    return !self->timed_out;
+}
+
+// A call that woke a task of higher priority than the caller yields at once
+static void preempt_if_needed(void) {
+    struct HostTask *self = s_current;
+    struct HostTask *next;
+
+    if (self == NULL || !s_running) {
+        return;
+    }
+    next = highest_ready();
+    if (next != NULL && next->priority > self->priority) {
+        make_ready(self);
+        switch_away(self);
+    }
+}
+
+// Wakes the longest-waiting task of the highest priority blocked on q
+static void wake_waiter(struct HostQueue *q, HostWait_t wait) {
+    struct HostTask *best = NULL;
+
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        struct HostTask *t = &s_tasks[i];
+        if (t->state != TASK_BLOCKED || t->wait != wait || t->wait_queue != q) {
+            continue;
+        }
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->seq < best->seq)) {
+            best = t;
+        }
+    }
+    if (best != NULL) {
+        make_ready(best);
+    }
+}
+
+static int can_block(TickType_t timeout) {
+    return timeout != 0 && s_running && s_current != NULL;
+}
+
+// --- B. TASKS ---
+
+static void *task_thread(void *param) {
+    struct HostTask *self = (struct HostTask *)param;
+
+    self->stack_entry = (uint8_t *)__builtin_frame_address(0);
+    pthread_mutex_lock(&s_kernel);
+    while (s_current != self) {
+        pthread_cond_wait(&self->run_cond, &s_kernel);
+    }
+    pthread_mutex_unlock(&s_kernel);
+
+    self->entry(self->arg);
+    vTaskDelete(NULL);      // FreeRTOS tasks must not return; treat it as a delete
+    return NULL;
+}
+
+// The host CPUs this process may use, as found before the first pinned
+// thread (a pinned creator would only see its own CPU)
+static int s_host_cpu[CPU_SETSIZE];
+static int s_host_cpu_count = -1;
+
+static void find_host_cpus(void) {
+    cpu_set_t allowed;
+
+    s_host_cpu_count = 0;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            s_host_cpu[s_host_cpu_count++] = cpu;
+        }
+    }
+    s_rt_stats.host_cpus = (uint32_t)s_host_cpu_count;
+}
+
+// Pins the new thread when the task asks for a core; failing that it just
+// floats, which changes nothing in the simulated schedule
+static void pin_to_core(pthread_attr_t *attr, BaseType_t core) {
+    cpu_set_t set;
+
+    if (core < 0 || core >= portNUM_PROCESSORS) {
+        return;
+    }
+    if (s_host_cpu_count < 0) {
+        find_host_cpus();
+    }
+    if (s_host_cpu_count == 0) {
+        return;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(s_host_cpu[core % s_host_cpu_count], &set);
+    if (pthread_attr_setaffinity_np(attr, sizeof(set), &set) == 0) {
+        s_rt_stats.pinned_tasks++;
+    }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char *name, uint32_t stack_depth,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+    pthread_attr_t attr;
+    uint8_t *stack = malloc(HOST_TASK_STACK_BYTES);
+
+    if (stack == NULL) {
+        return pdFAIL;
+    }
+    memset(stack, HOST_STACK_PAINT, HOST_TASK_STACK_BYTES);
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, HOST_TASK_STACK_BYTES);
+
+    pthread_mutex_lock(&s_kernel);
+    if (s_task_count >= HOST_MAX_TASKS) {
+        pthread_mutex_unlock(&s_kernel);
+        pthread_attr_destroy(&attr);
+        free(stack);
+        return pdFAIL;
+    }
+    pin_to_core(&attr, core);
+    struct HostTask *t = &s_tasks[s_task_count];
+    memset(t, 0, sizeof(*t));
+    pthread_cond_init(&t->run_cond, NULL);
+    t->core = core;
+    t->name = name;
+    t->priority = priority;
+    t->entry = entry;
+    t->arg = arg;
+    t->stack = stack;
+    t->stack_depth = stack_depth;
+    make_ready(t);
+
+    if (pthread_create(&t->thread, &attr, task_thread, t) != 0) {
+        pthread_mutex_unlock(&s_kernel);
+        pthread_attr_destroy(&attr);
+        free(stack);
+        return pdFAIL;
+    }
+    pthread_attr_destroy(&attr);
+    s_task_count++;
+    s_rt_stats.tasks = s_task_count;
+    if (handle != NULL) {
+        *handle = t;
+    }
+    preempt_if_needed();
+    pthread_mutex_unlock(&s_kernel);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char *name, uint32_t stack_depth,
+                       void *arg, UBaseType_t priority, TaskHandle_t *handle) {
+    return xTaskCreatePinnedToCore(entry, name, stack_depth, arg, priority, handle, tskNO_AFFINITY);
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t entry, const char *name, uint32_t stack_depth,
+                                           void *arg, UBaseType_t priority, StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t core) {
+    TaskHandle_t handle = NULL;
+
+    if (stack == NULL || tcb == NULL ||
+        xTaskCreatePinnedToCore(entry, name, stack_depth, arg, priority, &handle, core) != pdPASS) {
+        return NULL;
+    }
+    return handle;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t entry, const char *name, uint32_t stack_depth,
+                               void *arg, UBaseType_t priority, StackType_t *stack,
+                               StaticTask_t *tcb) {
+    return xTaskCreateStaticPinnedToCore(entry, name, stack_depth, arg, priority, stack, tcb,
+                                         tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    pthread_mutex_lock(&s_kernel);
+    if (task == NULL || task == s_current) {
+        struct HostTask *self = s_current;
+        self->state = TASK_DELETED;
+        dispatch();
+        pthread_mutex_unlock(&s_kernel);
+        pthread_exit(NULL);
+    }
+    task->state = TASK_DELETED;     // Its thread stays parked on run_cond
+    pthread_mutex_unlock(&s_kernel);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    pthread_mutex_lock(&s_kernel);
+    if (s_running && s_current != NULL) {
+        if (ticks == 0) {
+            make_ready(s_current);          // Yield to tasks of the same priority
+            switch_away(s_current);
+        } else {
+            block_until(WAIT_DELAY, NULL, 0, s_tick + ticks);
+        }
+    }
+    pthread_mutex_unlock(&s_kernel);
+}
+
+// Fixed-rate delay: the next wake is counted from the previous one, not from now
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t period) {
+    pthread_mutex_lock(&s_kernel);
+    TickType_t wake = *previous_wake + period;
+    *previous_wake = wake;
+    if (s_running && s_current != NULL && (int32_t)(wake - s_tick) > 0) {
+        block_until(WAIT_DELAY, NULL, 0, wake);
+    }
+    pthread_mutex_unlock(&s_kernel);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return __atomic_load_n(&s_tick, __ATOMIC_RELAXED);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return s_current;
+}
+
+// Unpinned tasks (and code outside any task) count as core 0
+BaseType_t xPortGetCoreID(void) {
+    struct HostTask *self = s_current;
+    return (self != NULL && self->core >= 0 && self->core < portNUM_PROCESSORS) ? self->core : 0;
+}
+
+char *pcTaskGetName(TaskHandle_t task) {
+    if (task == NULL) {
+        task = s_current;
+    }
+    return (task != NULL) ? (char *)task->name : "main";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    struct HostTask *t = (task != NULL) ? task : s_current;
+    uint32_t used = host_runtime_stack_used(t);
+
+    return (used < t->stack_depth) ? t->stack_depth - used : 0u;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&s_kernel);
+    task->notify_count++;
+    if (task->state == TASK_BLOCKED && task->wait == WAIT_NOTIFY) {
+        make_ready(task);
+        preempt_if_needed();
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t timeout) {
+    uint32_t value;
+
+    pthread_mutex_lock(&s_kernel);
+    struct HostTask *self = s_current;
+    if (self->notify_count == 0 && can_block(timeout)) {
+        block_until(WAIT_NOTIFY, NULL, timeout == portMAX_DELAY, s_tick + timeout);
+    }
+    value = self->notify_count;
+    if (clear_on_exit) {
+        self->notify_count = 0;
+    } else if (value > 0) {
+        self->notify_count--;
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return value;
+}
+
+// --- C. QUEUES, SETS AND SEMAPHORES ---
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage,
+                                 StaticQueue_t *buffer) {
+    struct HostQueue *q = (struct HostQueue *)buffer;
+
+    if (q == NULL || length == 0 || (item_size > 0 && storage == NULL)) {
+        return NULL;
+    }
+    memset(q, 0, sizeof(*q));
+    q->storage = (item_size > 0) ? storage : NULL;
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    struct HostQueue *q = calloc(1, sizeof(*q));
+
+    if (q == NULL || length == 0) {
+        free(q);
+        return NULL;
+    }
+    if (item_size > 0) {
+        q->storage = malloc((size_t)length * item_size);
+        if (q->storage == NULL) {
+            free(q);
+            return NULL;
+        }
+    }
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+static void set_post(struct HostQueue *set, struct HostQueue *member);
+
+static BaseType_t queue_send(struct HostQueue *q, const void *item, TickType_t timeout, int front) {
+    TickType_t deadline;
+    BaseType_t result = errQUEUE_FULL;
+
+    pthread_mutex_lock(&s_kernel);
+    deadline = s_tick + timeout;
+    for (;;) {
+        if (q->count < q->length) {
+            UBaseType_t slot;
+            if (front) {
+                q->head = (q->head + q->length - 1) % q->length;
+                slot = q->head;
+            } else {
+                slot = (q->head + q->count) % q->length;
+            }
+            if (q->item_size > 0) {
+                memcpy(q->storage + (size_t)slot * q->item_size, item, q->item_size);
+            }
+            q->count++;
+            if (q->count > q->peak) {
+                q->peak = q->count;
+            }
+            if (q->set != NULL) {
+                set_post(q->set, q);
+            }
+            wake_waiter(q, WAIT_RECEIVE);
+            preempt_if_needed();
+            result = pdPASS;
+            break;
+        }
+        if (!can_block(timeout) ||
+            !block_until(WAIT_SEND, q, timeout == portMAX_DELAY, deadline)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return result;
+}
+
+static BaseType_t queue_receive(struct HostQueue *q, void *item, TickType_t timeout, int peek) {
+    TickType_t deadline;
+    BaseType_t result = errQUEUE_EMPTY;
+
+    pthread_mutex_lock(&s_kernel);
+    deadline = s_tick + timeout;
+    for (;;) {
+        if (q->count > 0) {
+            if (q->item_size > 0 && item != NULL) {
+                memcpy(item, q->storage + (size_t)q->head * q->item_size, q->item_size);
+            }
+            if (!peek) {
+                q->head = (q->head + 1) % q->length;
+                q->count--;
+                wake_waiter(q, WAIT_SEND);
+                preempt_if_needed();
+            }
+            result = pdPASS;
+            break;
+        }
+        if (!can_block(timeout) ||
+            !block_until(WAIT_RECEIVE, q, timeout == portMAX_DELAY, deadline)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return result;
+}
+
+// Kernel lock held: a set is a queue of member handles
+static void set_post(struct HostQueue *set, struct HostQueue *member) {
+    if (set->count < set->length) {
+        memcpy(set->storage + (size_t)((set->head + set->count) % set->length) * set->item_size,
+               &member, sizeof(member));
+        set->count++;
+        wake_waiter(set, WAIT_RECEIVE);
+    }
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t timeout) {
+    return queue_send(queue, item, timeout, 0);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t timeout) {
+    return queue_send(queue, item, timeout, 1);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t timeout) {
+    return queue_receive(queue, item, timeout, 0);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t timeout) {
+    return queue_receive(queue, item, timeout, 1);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    UBaseType_t count;
+
+    pthread_mutex_lock(&s_kernel);
+    count = queue->count;
+    pthread_mutex_unlock(&s_kernel);
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    UBaseType_t spaces;
+
+    pthread_mutex_lock(&s_kernel);
+    spaces = queue->length - queue->count;
+    pthread_mutex_unlock(&s_kernel);
+    return spaces;
+}
+
+QueueSetHandle_t xQueueCreateSet(UBaseType_t length) {
+    return xQueueCreate(length, sizeof(QueueHandle_t));
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t member, QueueSetHandle_t set) {
+    BaseType_t result = pdFAIL;
+
+    pthread_mutex_lock(&s_kernel);
+    if (member->set == NULL && member->count == 0) {    // Same rule as FreeRTOS
+        member->set = set;
+        result = pdPASS;
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return result;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t timeout) {
+    QueueSetMemberHandle_t member = NULL;
+
+    if (queue_receive(set, &member, timeout, 0) != pdPASS) {
+        return NULL;
+    }
+    return member;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    if (sem != NULL) {
+        sem->count = 1;     // A mutex starts available
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer) {
+    SemaphoreHandle_t sem = xQueueCreateStatic(1, 0, NULL, buffer);
+    if (sem != NULL) {
+        sem->count = 1;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xQueueCreate(1, 0);
+}
+
+// --- D. RUNTIME CONTROL ---
+
+void host_runtime_set_warp(uint32_t warp) {
+    s_warp = warp;
+}
+
+void host_runtime_run(TickType_t end_tick) {
+    pthread_mutex_lock(&s_kernel);
+    s_end_tick = end_tick;
+    s_running = 1;
+    dispatch();
+    while (s_running) {
+        pthread_cond_wait(&s_main_cond, &s_kernel);
+    }
+    pthread_mutex_unlock(&s_kernel);
+}
+
+void host_runtime_get_stats(HostRuntimeStats_t *stats) {
+    pthread_mutex_lock(&s_kernel);
+    if (s_host_cpu_count < 0) {
+        find_host_cpus();
+    }
+    *stats = s_rt_stats;
+    stats->now = s_tick;
+    pthread_mutex_unlock(&s_kernel);
+}
+
+UBaseType_t host_runtime_queue_peak(QueueHandle_t queue) {
+    UBaseType_t peak;
+
+    pthread_mutex_lock(&s_kernel);
+    peak = queue->peak;
+    pthread_mutex_unlock(&s_kernel);
+    return peak;
+}
+
+uint32_t host_runtime_stack_used(TaskHandle_t task) {
+    struct HostTask *t = (task != NULL) ? task : s_current;
+    const uint8_t *p = t->stack;
+
+    // Stacks grow down: the first unpainted byte from the bottom is the deepest
+    while (p < t->stack + HOST_TASK_STACK_BYTES && *p == HOST_STACK_PAINT) {
+        p++;
+    }
+    return (t->stack_entry > p) ? (uint32_t)(t->stack_entry - p) : 0u;
+}
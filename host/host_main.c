@@ -0,0 +1,618 @@
+// host/host_main.c
+// Host entry point: boots app_main() on the POSIX runtime, runs one mission
+// day on the simulated clock and checks how it went.
+//
+//   fsw_host [--seconds N] [--warp N] [--quiet] [--keep-archive] [--trace FILE]
+//            [--eps-trace FILE] [--downlink FILE] [--ber X] [--profile FILE]
+//            [--reset-at S [--reset-reason sw|wdt|brownout|panic]]
+//
+// --trace needs a build with -DFSW_TRACE=1; decode the file with tools/trace_decode.
+// --eps-trace replays a recorded bus voltage (one mV value per line, 1 kHz)
+// instead of the synthetic bus; the mission-day checks assume the latter.
+// Everything sent to the radio goes through a simulated ground station that
+// decodes the RS codeblocks (downlink_fec.h) back into space packets.
+// --ber flips that fraction of the downlink bits on the way (up to about 1e-3
+// the checks still expect every packet back). --downlink saves what the
+// ground received; decode the file with tools/tm_decode [--fec DEPTH].
+// --profile writes a task_sizing.h recommended from the run's stack and queue
+// high-water marks (see rtos_alloc.h).
+// --reset-at boots the FSW in a child process that also time-tags a NO_OP
+// for a minute after S, flies S seconds and stops dead as a reset would. The
+// run then boots warm from the checkpoint the child left (checkpoint.h),
+// flies the rest of the day and checks what the restart kept.
+//
+// Scenario (all of it comes from the flight code itself):
+//   T+5 s   cmd_inject sends TC_SET_MODE NOMINAL
+//   T+25 s  NO-OP, then a ground pass is requested (downlink starts)
+//   T+30 s  the simulated bus drops to 2.4 V; the EPS monitor trips within a few
+//           hundred ms (ignoring the single-sample glitches before it) and forces
+//           MODE_CRITICAL,
+//           which closes the pass early
+//   T+120 s a summary of the archive so far is requested (TC_REQUEST_SUMMARY)
+//   rest    TM generator, EPS monitor, logger and watchdog keep running
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_runtime.h"
+#include "satellite_types.h"
+#include "state_manager.h"
+#include "tc_proc.h"
+#include "watchdog.h"
+#include "data_logger.h"
+#include "cdhs_router.h"
+#include "task_defs.h"
+#include "eps_control.h"
+#include "param_store.h"
+#include "trace.h"
+#include "fsw_log.h"
+#include "rtos_alloc.h"
+#include "downlink_fec.h"
+#include "packet_pool.h"
+#include "utils.h"
+#include "checkpoint.h"
+#include "tc_scheduler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define MISSION_DAY_SECONDS (24u * 60u * 60u)
+
+void app_main(void);
+
+extern PacketPool_t g_telemetry_pool;
+extern PacketPool_t g_hk_response_pool;
+
+static int s_failures;
+
+static void check(int ok, const char *what) {
+    printf("  [%s] %s\n", ok ? "PASS" : "FAIL", what);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+#if FSW_TRACE
+static int write_trace(void *ctx, const void *data, size_t len) {
+    return (fwrite(data, 1, len, (FILE *)ctx) == len) ? 0 : -1;
+}
+#endif
+
+// --- Ground station on the radio tap ---
+typedef struct {
+    FILE *file;                 // --downlink
+    double ber;                 // --ber
+    uint32_t rng;
+    uint64_t error_gap;         // Clean bits before the next flipped one
+    uint32_t bit_errors;
+    DownlinkFecRxStats_t rx;
+    uint8_t block[DOWNLINK_FEC_BLOCK_LEN(DOWNLINK_FEC_MAX_DEPTH)];
+} GroundStation_t;
+
+static GroundStation_t s_ground = { .rng = 0x2545F491u };
+
+static double ground_uniform(GroundStation_t *g) {
+    g->rng ^= g->rng << 13;
+    g->rng ^= g->rng >> 17;
+    g->rng ^= g->rng << 5;
+    return ((double)g->rng + 1.0) / 4294967297.0;
+}
+
+// Independent bit errors: the gap to the next one is geometric
+static uint64_t ground_next_gap(GroundStation_t *g) {
+    return (uint64_t)floor(log(ground_uniform(g)) / log1p(-g->ber));
+}
+
+static int ground_receive(void *ctx, const uint8_t *frame, size_t len) {
+    GroundStation_t *g = (GroundStation_t *)ctx;
+    uint8_t *rx = g->block;
+
+    if (len > sizeof(g->block)) {
+        return -1;
+    }
+    memcpy(rx, frame, len);
+
+    // 1. Channel
+    if (g->ber > 0.0) {
+        uint64_t bit = g->error_gap, frame_bits = (uint64_t)len * 8u;
+        for (; bit < frame_bits; bit += 1u + ground_next_gap(g)) {
+            rx[bit / 8u] ^= (uint8_t)(0x80u >> (bit % 8u));
+            g->bit_errors++;
+        }
+        g->error_gap = bit - frame_bits;
+    }
+    if (g->file != NULL && fwrite(rx, 1, len, g->file) != len) {
+        return -1;
+    }
+
+    // 2. Decoder: a codeblock per call, or a bare packet when uncoded
+    if (DATA_LOGGER_FEC_DEPTH == 0) {
+        int ok = len > CCSDS_CRC_LEN &&
+                 crc16_ccitt(rx, len - CCSDS_CRC_LEN) == ccsds_get_be16(&rx[len - CCSDS_CRC_LEN]);
+        if (ok) {
+            g->rx.packets++;
+        } else {
+            g->rx.bad_packets++;
+        }
+    } else if (len == DOWNLINK_FEC_BLOCK_LEN(DATA_LOGGER_FEC_DEPTH)) {
+        downlink_fec_decode_block(rx, DATA_LOGGER_FEC_DEPTH, NULL, NULL, &g->rx);
+    }
+    return 0;
+}
+
+// The tasks on one core (RTOS_CORE_ANY: unpinned), if there are any
+static void print_core(int core) {
+    RtosTaskInfo_t task;
+    int first = 1;
+
+    for (uint32_t i = 0; rtos_profile_get_task(i, &task) == 0; i++) {
+        if (task.core != core) {
+            continue;
+        }
+        if (first) {
+            printf((core == RTOS_CORE_ANY) ? " unpinned:" : " core %d:", core);
+            first = 0;
+        }
+        printf(" %s", task.name);
+    }
+}
+
+// --- Warm restart ---
+#define RESET_COMMAND_DELAY_S   60      // The child's time-tagged NO_OP, after the reset
+
+static const struct {
+    const char *name;
+    CheckpointReset_t reset;
+} s_reset_reasons[] = {
+    { "sw",       CHECKPOINT_RESET_SOFTWARE },
+    { "wdt",      CHECKPOINT_RESET_WATCHDOG },
+    { "brownout", CHECKPOINT_RESET_BROWNOUT },
+    { "panic",    CHECKPOINT_RESET_PANIC },
+};
+
+// What the first boot had when it went down
+typedef struct {
+    SystemModeSnapshot_t mode;
+    uint16_t hk_sequence;
+    uint32_t pass_number;
+    uint16_t pending;           // Time-tagged commands
+    uint32_t command_time;      // Execution time of the child's NO_OP
+} PreReset_t;
+
+// Cold boot in a child process, flown for `seconds`. The child's memory is
+// gone with it; only the archive and checkpoint files are left behind.
+static int boot_before_reset(uint32_t seconds, PreReset_t *out) {
+    int fds[2], status;
+    pid_t pid;
+
+    fflush(stdout);
+    if (pipe(fds) != 0 || (pid = fork()) < 0) {
+        return -1;
+    }
+    if (pid == 0) {
+        PreReset_t state;
+        TcSchedulerStats_t sched;
+        DownlinkPassStats_t pass;
+        Command_t cmd;
+        uint16_t id;
+
+        close(fds[0]);
+        memset(&state, 0, sizeof(state));
+        app_main();
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.command_id = TC_NO_OP;
+        cmd.execution_time = pdMS_TO_TICKS((uint64_t)(seconds + RESET_COMMAND_DELAY_S) * 1000u);
+        tc_scheduler_insert(&cmd, &id);
+        host_runtime_run(pdMS_TO_TICKS((uint64_t)seconds * 1000u));
+        fsw_log_drain(UINT32_MAX);
+
+        get_system_mode_snapshot(&state.mode);
+        state.hk_sequence = tm_gen_get_hk_sequence();
+        data_logger_get_last_pass(&pass);
+        state.pass_number = pass.pass_number;
+        tc_scheduler_get_stats(&sched);
+        state.pending = sched.pending;
+        state.command_time = cmd.execution_time;
+        fflush(stdout);
+        _exit(write(fds[1], &state, sizeof(state)) == (ssize_t)sizeof(state) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = read(fds[0], out, sizeof(*out));
+    close(fds[0]);
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return -1;
+    }
+    return (got == (ssize_t)sizeof(*out)) ? 0 : -1;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    uint32_t seconds = MISSION_DAY_SECONDS;
+    uint32_t warp = 0;
+    uint32_t reset_at = 0;
+    CheckpointReset_t reset_reason = CHECKPOINT_RESET_WATCHDOG;
+    PreReset_t before;
+    int quiet = 0, keep_archive = 0, saved_stdout = -1;
+    const char *trace_path = NULL;
+    const char *profile_path = NULL;
+    EpsSampleSource_t eps_trace;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--warp") == 0 && i + 1 < argc) {
+            warp = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = 1;
+        } else if (strcmp(argv[i], "--keep-archive") == 0) {
+            keep_archive = 1;
+        } else if (strcmp(argv[i], "--eps-trace") == 0 && i + 1 < argc) {
+            if (eps_source_file_open(&eps_trace, argv[++i], EPS_SAMPLE_RATE_HZ) != 0) {
+                return 2;
+            }
+            eps_control_set_source(&eps_trace);
+        } else if (strcmp(argv[i], "--downlink") == 0 && i + 1 < argc) {
+            s_ground.file = fopen(argv[++i], "wb");
+            if (s_ground.file == NULL) {
+                fprintf(stderr, "Could not open %s\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--ber") == 0 && i + 1 < argc) {
+            s_ground.ber = strtod(argv[++i], NULL);
+            if (!(s_ground.ber >= 0.0 && s_ground.ber < 0.5)) {
+                fprintf(stderr, "--ber must be in [0, 0.5)\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--reset-at") == 0 && i + 1 < argc) {
+            reset_at = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--reset-reason") == 0 && i + 1 < argc) {
+            size_t r = 0, n = sizeof(s_reset_reasons) / sizeof(s_reset_reasons[0]);
+            while (r < n && strcmp(argv[i + 1], s_reset_reasons[r].name) != 0) {
+                r++;
+            }
+            if (r == n) {
+                fprintf(stderr, "--reset-reason must be sw, wdt, brownout or panic\n");
+                return 2;
+            }
+            reset_reason = s_reset_reasons[r].reset;
+            i++;
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc && FSW_TRACE) {
+            trace_path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--warp N] [--quiet] [--keep-archive] [--eps-trace FILE] [--downlink FILE] [--ber X] [--profile FILE] [--reset-at S [--reset-reason R]]%s\n",
+                    argv[0], FSW_TRACE ? " [--trace FILE]" : "");
+            return 2;
+        }
+    }
+
+    // 1. A fresh archive image keeps every run identical
+    if (s_ground.ber > 0.0) {
+        s_ground.error_gap = ground_next_gap(&s_ground);
+    }
+    data_logger_set_radio_tap(ground_receive, &s_ground);
+    if (!keep_archive) {
+        remove(DATA_LOGGER_HOST_IMAGE);
+    }
+    if (quiet) {
+        fflush(stdout);
+        saved_stdout = dup(STDOUT_FILENO);
+        if (freopen("/dev/null", "w", stdout) == NULL) {
+            return 2;
+        }
+    }
+
+    // 2. Warm restart: the first boot flies up to the reset in a child
+    if (reset_at > 0) {
+        if (reset_at >= seconds || boot_before_reset(reset_at, &before) != 0) {
+            fprintf(stderr, "Boot before the reset at T+%lu s failed\n", (unsigned long)reset_at);
+            return 2;
+        }
+        printf("=== RESET (%s) at T+%lu s ===\n", checkpoint_reset_name(reset_reason), (unsigned long)reset_at);
+        checkpoint_host_set_reset(reset_reason);
+        seconds -= reset_at;
+    }
+
+    // 3. Boot and fly
+    SystemModeSnapshot_t restored_mode;
+    TcTimelineEntry_t restored_cmd;
+    size_t restored_cmds;
+
+    host_runtime_set_warp(warp);
+    double t0 = wall_seconds();
+    uint32_t boot_us = util_get_time_us();
+    app_main();
+    get_system_mode_snapshot(&restored_mode);
+    restored_cmds = tc_scheduler_list(0, 0x7FFFFFFFu, &restored_cmd, 1);
+    host_runtime_run(pdMS_TO_TICKS((uint64_t)seconds * 1000u));
+    double wall = wall_seconds() - t0;
+
+    // Whatever LOG_DRAIN has not printed yet belongs to the run, not the report
+    fsw_log_drain(UINT32_MAX);
+    if (quiet) {
+        fflush(stdout);
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+
+    if (s_ground.file != NULL) {
+        fclose(s_ground.file);
+    }
+
+    if (profile_path != NULL) {
+        FILE *f = fopen(profile_path, "w");
+        if (f == NULL) {
+            fprintf(stderr, "Could not write profile to %s\n", profile_path);
+            s_failures++;
+        } else {
+            rtos_profile_write_header(f, seconds);
+            fclose(f);
+        }
+    }
+
+#if FSW_TRACE
+    if (trace_path != NULL) {
+        FILE *f = fopen(trace_path, "wb");
+        if (f == NULL || trace_dump(write_trace, f) != 0) {
+            fprintf(stderr, "Could not write trace to %s\n", trace_path);
+            s_failures++;
+        }
+        if (f != NULL) {
+            fclose(f);
+        }
+    }
+#else
+    (void)trace_path;
+#endif
+
+    // 4. Report (every task is blocked now, nothing changes underneath)
+    HostRuntimeStats_t rt;
+    SystemModeSnapshot_t mode;
+    TcProcStats_t tc;
+    TcCommandStats_t set_mode, no_op, request_hk;
+    HkResponseStats_t hk_rsp;
+    SummaryServiceStats_t summary;
+    UplinkDeframerStats_t uplink;
+    CdhsRouterStats_t router;
+    HkSchedStats_t hk;
+    DownlinkPassStats_t pass;
+    DownlinkFecStats_t fec;
+    TmArchiveStats_t archive;
+    EPS_Status_t eps;
+    RtosAllocStats_t alloc;
+    PoolStats_t tm_pool, rsp_pool;
+    ParamSnapshot_t params;
+    ParamVersion_t boot;
+    ParamId_t changed[PARAM_COUNT];
+    CheckpointStats_t cp;
+    FirstTelemetry_t first_tm;
+    WatchdogResetLog_t resets;
+    TcSchedulerStats_t sched;
+    size_t changed_count;
+    uint32_t expiries = 0, mode_events = 0, mode_latency_ticks = 0;
+    int placed = 1;
+    RtosTaskInfo_t task;
+
+    host_runtime_get_stats(&rt);
+    get_system_mode_snapshot(&mode);
+    tc_proc_get_stats(&tc);
+    tc_proc_get_command_stats(TC_SET_MODE, &set_mode);
+    tc_proc_get_command_stats(TC_NO_OP, &no_op);
+    tc_proc_get_command_stats(TC_REQUEST_HK, &request_hk);
+    data_logger_get_hk_response_stats(&hk_rsp);
+    data_logger_get_summary_stats(&summary);
+    cdhs_router_get_uplink_stats(&uplink);
+    cdhs_router_get_stats(&router);
+    tm_gen_get_hk_stats(&hk);
+    data_logger_get_last_pass(&pass);
+    data_logger_get_fec_stats(&fec);
+    tm_archive_get_stats(&g_tm_archive, &archive);
+    eps_get_status(&eps);
+    rtos_alloc_get_stats(&alloc);
+    packet_pool_get_stats(&g_telemetry_pool, &tm_pool);
+    packet_pool_get_stats(&g_hk_response_pool, &rsp_pool);
+    param_snapshot(&params);
+    memset(&boot, 0, sizeof(boot));
+    changed_count = param_changed_since(&params, &boot, changed, PARAM_COUNT);
+    checkpoint_get_stats(&cp);
+    data_logger_get_first_telemetry(&first_tm);
+    watchdog_get_reset_log(&resets);
+    tc_scheduler_get_stats(&sched);
+
+    printf("\n=== HOST RUN: %lu s simulated in %.2f s wall (x%.0f), %lu tasks, %lu context switches, %lu clock jumps ===\n",
+           (unsigned long)(rt.now / configTICK_RATE_HZ), wall, (double)(rt.now / configTICK_RATE_HZ) / wall,
+           (unsigned long)rt.tasks, (unsigned long)rt.context_switches, (unsigned long)rt.clock_jumps);
+    printf("Mode %d (generation %lu, entered at tick %lu)\n", mode.mode,
+           (unsigned long)mode.generation, (unsigned long)mode.last_transition_tick);
+    printf("Checkpoint: boot %lu after %s reset, %lu sections restored (%lu corrupt slots) in %lu us, "
+           "last alive at tick %lu; %lu writes, %lu B, %lu errors\n",
+           (unsigned long)cp.boot, checkpoint_reset_name(cp.reset), (unsigned long)cp.restored,
+           (unsigned long)cp.corrupt_slots, (unsigned long)cp.restore_us, (unsigned long)cp.last_alive_tick,
+           (unsigned long)cp.writes, (unsigned long)cp.write_bytes, (unsigned long)cp.write_errors);
+    printf("First telemetry: tick %lu in mode %d, %lu us wall after boot\n", (unsigned long)first_tm.tick,
+           first_tm.mode, (unsigned long)(first_tm.time_us - boot_us));
+    printf("TC: %lu received, %lu CRC failures, %lu unknown, %lu overflows, peak queue %lu\n",
+           (unsigned long)tc.received, (unsigned long)tc.crc_failures, (unsigned long)tc.unknown_id,
+           (unsigned long)tc.queue_overflows, (unsigned long)tc.queue_peak);
+    printf("Uplink: %lu B, %lu packets, %lu acquisitions, %lu markers corrected, %lu bit slips, "
+           "%lu sync losses, %lu header errors, %lu CRC failures, %lu overrun B, %lu dropped\n",
+           (unsigned long)uplink.bytes_in, (unsigned long)uplink.packets, (unsigned long)uplink.acquisitions,
+           (unsigned long)uplink.asm_corrected, (unsigned long)uplink.bit_slips,
+           (unsigned long)uplink.sync_losses, (unsigned long)uplink.header_errors,
+           (unsigned long)uplink.crc_failures, (unsigned long)uplink.overrun_bytes,
+           (unsigned long)router.uplink_drops);
+    printf("Downlink pass %lu: %lu records, %lu B in %lu ms\n", (unsigned long)pass.pass_number,
+           (unsigned long)pass.records_sent, (unsigned long)pass.bytes_sent, (unsigned long)pass.duration_ms);
+    printf("Downlink FEC: depth %u, %lu packets (%lu B) in %lu codeblocks, %lu fill B, encode max %lu cycles; "
+           "ground at BER %g: %lu bit errors, %lu symbols corrected, %lu codewords lost, %lu packets decoded, %lu bad\n",
+           (unsigned)DATA_LOGGER_FEC_DEPTH, (unsigned long)fec.packets, (unsigned long)fec.packet_bytes,
+           (unsigned long)fec.blocks, (unsigned long)fec.fill_bytes, (unsigned long)fec.encode_cycles_max,
+           s_ground.ber, (unsigned long)s_ground.bit_errors, (unsigned long)s_ground.rx.corrected,
+           (unsigned long)s_ground.rx.uncorrectable, (unsigned long)s_ground.rx.packets,
+           (unsigned long)s_ground.rx.bad_packets);
+    printf("HK: %lu sample sets, %lu B in %lu steps; parameters sent %lu due, %lu changed, %lu merged\n",
+           (unsigned long)hk.frames, (unsigned long)hk.bytes, (unsigned long)hk.steps,
+           (unsigned long)hk.sent_due, (unsigned long)hk.sent_changed, (unsigned long)hk.sent_merged);
+    printf("HK responses: %lu sent, %lu send errors, latency last %lu us / max %lu us (%lu ticks)\n",
+           (unsigned long)hk_rsp.sent, (unsigned long)hk_rsp.send_errors,
+           (unsigned long)hk_rsp.latency_last_us, (unsigned long)hk_rsp.latency_max_us,
+           (unsigned long)hk_rsp.latency_max_ticks);
+    printf("Archive: %lu records, %lu pages written\n",
+           (unsigned long)archive.records_appended, (unsigned long)archive.pages_written);
+    printf("Summaries: %lu sent, last over T: %lu..%lu from %lu pages (%lu missing) in %lu us (max %lu us)\n",
+           (unsigned long)summary.sent, (unsigned long)summary.last.first_ts,
+           (unsigned long)summary.last.last_ts, (unsigned long)summary.last.pages,
+           (unsigned long)summary.last.pages_missing, (unsigned long)summary.query_us_last,
+           (unsigned long)summary.query_us_max);
+    for (int i = 0; i < TM_STATS_COUNT; i++) {
+        const TmStatsAgg_t *agg = &summary.last.stat[i];
+        printf("  %-12s %lu samples, min %ld max %ld mean %.1f stddev %.1f, %lu below / %lu above limits\n",
+               tm_stats_name((TmStatId_t)i), (unsigned long)agg->count,
+               (long)(agg->count ? agg->min : 0), (long)(agg->count ? agg->max : 0),
+               tm_stats_mean(agg), tm_stats_stddev(agg), (unsigned long)agg->below,
+               (unsigned long)agg->above);
+    }
+    printf("EPS: %lu samples in %lu batches, bus %u mV (EWMA %u), %lu undervoltage trips (last at tick %lu), "
+           "filter max %lu cycles/batch\n", (unsigned long)eps.samples, (unsigned long)eps.batches,
+           (unsigned)eps.bus_mv, (unsigned)eps.bus_ewma_mv, (unsigned long)eps.undervoltage_events,
+           (unsigned long)eps.last_trip_tick, (unsigned long)eps.filter_cycles_max);
+    printf("Params: versions EPS %lu, MODE %lu, WDT %lu, TC %lu; %u of %u set since boot:",
+           (unsigned long)params.version.group[PARAM_GROUP_EPS], (unsigned long)params.version.group[PARAM_GROUP_MODE],
+           (unsigned long)params.version.group[PARAM_GROUP_WDT], (unsigned long)params.version.group[PARAM_GROUP_TC],
+           (unsigned)changed_count, (unsigned)PARAM_COUNT);
+    for (size_t i = 0; i < changed_count; i++) {
+        printf(" %s", param_name(changed[i]));
+    }
+    printf("\n");
+    printf("RTOS: %lu tasks, %lu queues, %lu mutexes, %lu static (queue arena %lu/%lu B), %lu failures\n",
+           (unsigned long)alloc.tasks, (unsigned long)alloc.queues, (unsigned long)alloc.mutexes,
+           (unsigned long)alloc.static_objects, (unsigned long)alloc.arena_used,
+           (unsigned long)alloc.arena_size, (unsigned long)alloc.failures);
+    printf("Cores (%lu task threads pinned on %lu host CPUs):", (unsigned long)rt.pinned_tasks,
+           (unsigned long)rt.host_cpus);
+    for (int core = RTOS_CORE_ANY; core < portNUM_PROCESSORS; core++) {
+        print_core(core);
+    }
+    printf("\n");
+    for (uint32_t i = 0; rtos_profile_get_task(i, &task) == 0; i++) {
+        // Archive, downlink and log output on the data core, everything else on the control core
+        int data_side = (strcmp(task.name, "DATA_LOG") == 0 || strcmp(task.name, "LOG_DRAIN") == 0);
+        int planned = !FSW_CORE_PLAN ? RTOS_CORE_ANY : data_side ? FSW_CORE_DATA : FSW_CORE_CONTROL;
+        placed &= (task.core == planned);
+    }
+    printf("Cross-core pools: TM %lu sets (%lu dropped, peak %u in use), HK_RSP %lu answers (%lu refused, peak %u)\n",
+           (unsigned long)tm_pool.allocations, (unsigned long)tm_pool.dropped_oldest, (unsigned)tm_pool.high_water,
+           (unsigned long)rsp_pool.allocations, (unsigned long)rsp_pool.alloc_failures,
+           (unsigned)rsp_pool.high_water);
+    printf("Mode subscribers:\n");
+    for (int i = 0; i < MODE_MAX_SUBSCRIBERS; i++) {
+        ModeSubscriberStats_t sub;
+        mode_get_subscriber_stats(i, &sub);
+        if (sub.events == 0) {
+            continue;
+        }
+        mode_events += sub.events;
+        if (sub.max_latency_ticks > mode_latency_ticks) {
+            mode_latency_ticks = sub.max_latency_ticks;
+        }
+        printf("  subscriber %d: %lu events (%lu coalesced), worst latency %lu ticks / %lu us\n", i,
+               (unsigned long)sub.events, (unsigned long)sub.coalesced,
+               (unsigned long)sub.max_latency_ticks, (unsigned long)sub.max_latency_us);
+    }
+    printf("Watchdog:\n");
+    for (int i = 0; i < WDT_TASK_COUNT; i++) {
+        WatchdogTaskStats_t wdt;
+        watchdog_get_stats((WatchdogTaskID_t)i, &wdt);
+        expiries += wdt.expiries;
+        printf("  task %d: %lu pets, interval %lu..%lu ticks, %lu expiries\n", i,
+               (unsigned long)wdt.pets, (unsigned long)(wdt.pets > 1 ? wdt.interval_min_ticks : 0),
+               (unsigned long)wdt.interval_max_ticks, (unsigned long)wdt.expiries);
+    }
+
+    // 5. Warm restart: what the first boot had must carry over
+    if (reset_at > 0) {
+        int32_t rebased = (int32_t)(before.command_time - cp.last_alive_tick);
+
+        printf("Checks (warm restart at T+%lu s):\n", (unsigned long)reset_at);
+        check(cp.boot == 1 && cp.reset == reset_reason && cp.restored == CHECKPOINT_SECTION_COUNT &&
+              cp.corrupt_slots == 0 && cp.write_errors == 0,
+              "Every checkpoint section restored in one pass, no corrupt slots");
+        check(restored_mode.mode == before.mode.mode && restored_mode.generation == before.mode.generation,
+              "Mode and mode generation of the first boot restored");
+        check(cp.last_alive_valid && cp.last_alive_tick <= pdMS_TO_TICKS(reset_at * 1000u) &&
+              cp.last_alive_tick + pdMS_TO_TICKS(HK_SCHED_TICK_MS) >= pdMS_TO_TICKS(reset_at * 1000u),
+              "Last sign of life of the first boot within one heartbeat of the reset");
+        check(before.pending == 1 && restored_cmds == 1 && sched.restored == 1 &&
+              restored_cmd.cmd.execution_time == (uint32_t)rebased && sched.fired == 1 && sched.corrupt == 0,
+              "Time-tagged command restored with its remaining wait and fired once");
+        check(tm_gen_get_hk_sequence() == (uint16_t)(before.hk_sequence + hk_rsp.sent),
+              "HK sequence count carries on from the first boot");
+        check(pass.pass_number == before.pass_number + 1, "Downlink pass numbering carries on");
+        check(resets.warm_resets == 1 && resets.count == 1 && resets.history[0].reason == (uint8_t)reset_reason &&
+              resets.history[0].boot == 0 && resets.history[0].last_expired == 0,
+              "Reset cause on record");
+        check(first_tm.valid && first_tm.tick <= pdMS_TO_TICKS(2000) && first_tm.mode == restored_mode.mode,
+              "First telemetry within 2 s of the warm boot, in the restored mode");
+        check(expiries == 0 && archive.write_errors == 0, "No watchdog expiries or archive errors");
+        check(fec.packets > 0 && s_ground.rx.packets == fec.packets && s_ground.rx.bad_packets == 0,
+              "Every downlink packet decoded from its codeblock on the ground");
+        return (s_failures == 0) ? 0 : 1;
+    }
+
+    // 6. Regression checks for the mission-day scenario
+    if (seconds >= 60) {
+        printf("Checks:\n");
+        check(mode.mode == MODE_CRITICAL && mode.generation == 2,
+              "SAFE -> NOMINAL (TC) -> CRITICAL (EPS FDIR), nothing else");
+        check(mode.last_transition_tick > pdMS_TO_TICKS(30000) &&
+              mode.last_transition_tick <= pdMS_TO_TICKS(30500), "EPS fault handled within 500 ms of the T+30 s sag");
+        check(eps.undervoltage_events == 1, "No EPS trip on the glitches before the sag");
+        check(set_mode.executed == 1 && no_op.executed == 1, "TC_SET_MODE and TC_NO_OP executed once each");
+        check(tc.crc_failures == 0 && tc.unknown_id == 0 && tc.queue_overflows == 0, "No TC errors");
+        check(pass.pass_number == 1 && pass.records_sent > 0, "Downlink pass delivered HK records");
+        check(archive.write_errors == 0 && archive.records_appended > 0, "Archive written without errors");
+        check(expiries == 0, "No watchdog expiries");
+        check(mode_events == 4 && mode_latency_ticks == 0,
+              "TM generator and logger saw both mode changes in the tick they happened");
+        check(alloc.failures == 0 && alloc.tasks > 0, "Every task, queue and mutex created");
+        check(hk.frames > 0 && hk.frames < hk.steps / 4 && hk.sent_changed > 0,
+              "Multi-rate HK: a sample set in under a quarter of the steps, changes sent between periods");
+        check(request_hk.executed == 1 && hk_rsp.sent == 1 && hk_rsp.latency_max_ticks == 0,
+              "TC_REQUEST_HK answered on the priority lane in the tick it executed");
+        check(params.value[PARAM_mode] == (int32_t)mode.mode &&
+              (uint32_t)params.value[PARAM_mode_generation] == mode.generation &&
+              (uint32_t)params.value[PARAM_tc_received] == tc.received &&
+              (uint32_t)params.value[PARAM_eps_trips] == eps.undervoltage_events &&
+              params.version.group[PARAM_GROUP_EPS] >= eps.batches,
+              "Parameter store matches the mode manager, TC processor and EPS monitor");
+        check(summary.sent == 1 && summary.last.pages_missing == 0 &&
+              summary.last.stat[TM_STAT_bus_min_mv].count > 0 &&
+              summary.last.stat[TM_STAT_bus_min_mv].min < 2500 &&
+              summary.last.stat[TM_STAT_bus_min_mv].below > 0,
+              "TC_REQUEST_SUMMARY answered from the page trailers, showing the T+30 s sag");
+        check(placed && g_telemetry_pool.spsc && g_hk_response_pool.spsc && tm_pool.in_use == 0 &&
+              rsp_pool.in_use == 0, "Command and FDIR tasks on the control core, logger on the data core, "
+              "joined only by SPSC pools");
+        check(fec.packets > 0 && fec.send_errors == 0 && s_ground.rx.packets == fec.packets &&
+              s_ground.rx.uncorrectable == 0 && s_ground.rx.bad_packets == 0,
+              "Every downlink packet decoded from its codeblock on the ground");
+        check(uplink.packets == 4 && uplink.crc_failures == 0 && uplink.header_errors == 0 &&
+              uplink.asm_corrected == 1 && uplink.bit_slips == 1 && uplink.overrun_bytes == 0 &&
+              router.uplink_drops == 0 && router.malformed == 0,
+              "Uplink deframer recovered every TC: corrupted marker and slipped bit included");
+        check(cp.boot == 0 && cp.restored == 0 && cp.writes > 0 && cp.write_errors == 0,
+              "Cold boot starts an empty checkpoint and keeps it written");
+        check(first_tm.valid && first_tm.tick <= pdMS_TO_TICKS(2000) && first_tm.mode == MODE_SAFE,
+              "First telemetry within 2 s of boot, in SAFE mode");
+    }
+    return (s_failures == 0) ? 0 : 1;
+}
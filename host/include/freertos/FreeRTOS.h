@@ -0,0 +1,50 @@
+// host/include/freertos/FreeRTOS.h
+// POSIX host runtime (host/freertos_posix.c): the part of the FreeRTOS API
+// the flight software uses, running on pthreads and a simulated tick.
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE          1
+#define pdFALSE         0
+#define pdPASS          pdTRUE
+#define pdFAIL          pdFALSE
+#define errQUEUE_FULL   0
+#define errQUEUE_EMPTY  0
+
+#define configTICK_RATE_HZ  100     // Same as CONFIG_FREERTOS_HZ on the target
+#define portTICK_PERIOD_MS  (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
+
+// Two simulated cores, as on the ESP32. Tasks pinned to a core run on a
+// host thread pinned to a host CPU, but still one task at a time.
+#define portNUM_PROCESSORS  2
+BaseType_t xPortGetCoreID(void);
+
+// Only one task runs at a time on the host, so critical sections are empty
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portMUX_INITIALIZE(mux)         (*(mux) = 0)
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+
+typedef struct HostQueue *QueueHandle_t;
+typedef struct HostTask *TaskHandle_t;
+
+// Static allocation. Stack depths are in bytes, as on ESP-IDF. Queues and
+// semaphores really live in the caller's buffers; a task keeps its host
+// thread stack (x86 frames are not target frames) and ignores the buffer.
+typedef uint8_t StackType_t;
+typedef struct { void *opaque[8]; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+typedef struct { void *opaque[1]; } StaticTask_t;
+
+#endif // HOST_FREERTOS_H
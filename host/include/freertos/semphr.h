@@ -0,0 +1,19 @@
+// host/include/freertos/semphr.h
+
+#ifndef HOST_SEMPHR_H
+#define HOST_SEMPHR_H
+
+#include "queue.h"
+
+// Semaphores are queues of zero-sized items, as in FreeRTOS itself
+// (no priority inheritance on the host).
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer);
+
+#define xSemaphoreTake(sem, timeout)    xQueueReceive((sem), NULL, (timeout))
+#define xSemaphoreGive(sem)             xQueueSend((sem), NULL, 0)
+
+#endif // HOST_SEMPHR_H
@@ -0,0 +1,46 @@
+// host/include/host_runtime.h
+
+#ifndef HOST_RUNTIME_H
+#define HOST_RUNTIME_H
+
+#include "freertos/FreeRTOS.h"
+
+// --- Simulated-time scheduler ---
+// Every FreeRTOS task is a pthread, but only the highest-priority ready task
+// runs; the others wait on their own condition variable. A task switch only
+// happens inside a FreeRTOS call (block, delay, or waking a higher-priority
+// task), so a run is deterministic. When every task is blocked the tick jumps
+// straight to the earliest timeout.
+//
+// A task created for a core (xTaskCreatePinnedToCore) gets a thread pinned to
+// one of the host CPUs the process may use, core N on the N-th of them
+// modulo their number. The schedule does not depend on it.
+
+typedef struct {
+    TickType_t now;
+    uint32_t tasks;
+    uint32_t context_switches;
+    uint32_t clock_jumps;       // Times every task was blocked and the tick advanced
+    uint32_t pinned_tasks;      // Threads pinned for a core
+    uint32_t host_cpus;         // Host CPUs the cores map onto
+} HostRuntimeStats_t;
+
+// Simulated seconds per wall-clock second. 0 (default) runs as fast as the
+// host allows; N > 0 sleeps through idle time at N times real time.
+void host_runtime_set_warp(uint32_t warp);
+
+// Starts (or resumes) the scheduler and returns once the tick reaches
+// end_tick with every task blocked. Tasks created before the call (e.g. by
+// app_main) start here, highest priority first.
+void host_runtime_run(TickType_t end_tick);
+
+void host_runtime_get_stats(HostRuntimeStats_t *stats);
+
+// Deepest a queue has ever been. Exact, unlike sampling uxQueueMessagesWaiting().
+UBaseType_t host_runtime_queue_peak(QueueHandle_t queue);
+
+// Stack bytes a task has used, even past the depth it asked for (which
+// uxTaskGetStackHighWaterMark() can only report as 0 left).
+uint32_t host_runtime_stack_used(TaskHandle_t task);
+
+#endif // HOST_RUNTIME_H
@@ -0,0 +1,120 @@
+// include/ccsds_packet.h
+
+#ifndef CCSDS_PACKET_H
+#define CCSDS_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- CCSDS Space Packet layout (CCSDS 133.0-B) ---
+// Primary header (6 B, big-endian on the wire):
+//   | Version:3 | Type:1 | SecHdr:1 | APID:11 | SeqFlags:2 | SeqCount:14 | DataLength:16 |
+// DataLength is (number of bytes after the primary header) - 1.
+// Secondary header (8 B): 64-bit Mission Elapsed Time from the Time Service.
+// Packet Error Control: CRC-16 CCITT-FALSE over everything before it (last 2 B).
+
+#define CCSDS_PRIMARY_HEADER_LEN    6
+#define CCSDS_SECONDARY_HEADER_LEN  8
+#define CCSDS_CRC_LEN               2
+#define CCSDS_MAX_PACKET_LEN        128
+
+// Attached Sync Marker: starts every uplink packet and downlink codeblock
+#define CCSDS_ASM                   0x1ACFFC1Du
+#define CCSDS_ASM_LEN               4
+
+#define CCSDS_APID_MASK             0x07FF
+#define CCSDS_APID_COUNT            2048
+#define CCSDS_SEQ_COUNT_MASK        0x3FFF
+
+#define CCSDS_TYPE_TM               0
+#define CCSDS_TYPE_TC               1
+#define CCSDS_SEQ_UNSEGMENTED       0x3
+
+// --- APIDs routed by the C&DH ---
+#define APID_ADCS           0x010
+#define APID_EPS            0x020
+#define APID_CDHS           0x040
+#define APID_HOUSEKEEPING   0x050
+#define APID_HK_COMPRESSED  0x051   // Delta/bit-packed HK frames (hk_compress.h)
+#define APID_HK_RESPONSE    0x052   // On-demand HK for TC_REQUEST_HK (packet_schema.h)
+#define APID_HK_SAMPLES     0x053   // Multi-rate HK sample sets (hk_sched.h)
+#define APID_TM_SUMMARY     0x054   // Archive window statistics for TC_REQUEST_SUMMARY (tm_stats.h)
+
+typedef struct {
+    uint8_t version;
+    uint8_t type;               // CCSDS_TYPE_TM / CCSDS_TYPE_TC
+    uint8_t sec_hdr_flag;
+    uint16_t apid;
+    uint8_t seq_flags;
+    uint16_t seq_count;
+    uint16_t data_length;       // Raw field value (bytes after primary header - 1)
+} CCSDS_PrimaryHeader_t;
+
+typedef struct {
+    uint64_t met;               // Mission Elapsed Time
+} CCSDS_SecondaryHeader_t;
+
+// A whole space packet as it travels through the uplink pool and router queues
+typedef struct {
+    uint16_t length;            // Valid bytes in data[]
+    uint32_t submit_time_us;    // util_get_time_us() when handed to the router
+    uint8_t data[CCSDS_MAX_PACKET_LEN];
+} CCSDS_Frame_t;
+
+// --- Endian-safe accessors ---
+// Byte-wise, so they work on any alignment and on either host byte order.
+
+static inline uint16_t ccsds_get_be16(const uint8_t *p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static inline uint32_t ccsds_get_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint64_t ccsds_get_be64(const uint8_t *p) {
+    return ((uint64_t)ccsds_get_be32(p) << 32) | ccsds_get_be32(p + 4);
+}
+
+static inline void ccsds_put_be16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static inline void ccsds_put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline void ccsds_put_be64(uint8_t *p, uint64_t v) {
+    ccsds_put_be32(p, (uint32_t)(v >> 32));
+    ccsds_put_be32(p + 4, (uint32_t)v);
+}
+
+// Fast path for the router: APID straight from the first two header bytes
+static inline uint16_t ccsds_get_apid(const uint8_t *packet) {
+    return ccsds_get_be16(packet) & CCSDS_APID_MASK;
+}
+
+// Total packet size announced by the primary header
+static inline size_t ccsds_packet_length(const CCSDS_PrimaryHeader_t *hdr) {
+    return (size_t)CCSDS_PRIMARY_HEADER_LEN + (size_t)hdr->data_length + 1u;
+}
+
+// --- Decode / encode (return 0 on success, -1 on a malformed buffer) ---
+int ccsds_decode_primary(const uint8_t *buf, size_t len, CCSDS_PrimaryHeader_t *hdr);
+int ccsds_decode_secondary(const uint8_t *buf, size_t len, CCSDS_SecondaryHeader_t *sec);
+
+// Builds primary + secondary header, copies user data and appends the CRC.
+// Returns the total packet length, or 0 if it does not fit in `cap` bytes.
+size_t ccsds_build_packet(uint8_t *buf, size_t cap, uint8_t type, uint16_t apid,
+                          uint16_t seq_count, uint64_t met,
+                          const uint8_t *user_data, size_t user_len);
+
+// User data field (between secondary header and CRC) of a decoded packet
+const uint8_t *ccsds_user_data(const uint8_t *packet, const CCSDS_PrimaryHeader_t *hdr,
+                               size_t *user_len);
+
+#endif // CCSDS_PACKET_H
@@ -0,0 +1,81 @@
+// include/cdhs_router.h
+
+#ifndef CDHS_ROUTER_H
+#define CDHS_ROUTER_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "ccsds_packet.h"
+#include "packet_pool.h"
+#include "uplink_deframer.h"
+
+// --- Destinations (one queue of CCSDS_Frame_t pointers each) ---
+typedef enum {
+    CDHS_DEST_NONE,     // Unrouted APID: counted and dropped
+    CDHS_DEST_ADCS,
+    CDHS_DEST_EPS,
+    CDHS_DEST_CDHS,     // Consumed by vCommandProcessorTask (xCommandQueue)
+    CDHS_DEST_HK,
+    CDHS_DEST_COUNT
+} CdhsDestination_t;
+
+// --- Raw uplink stream (see uplink_deframer.h) ---
+#define CDHS_UPLINK_RING_SIZE       512     // Power of two, >= 2 packets
+#define CDHS_UPLINK_ASM_ERRORS      2       // Marker bit errors tolerated
+#define CDHS_UPLINK_SLIP_BITS       2       // Re-lock window around the expected marker
+
+// Maximum number of APIDs with their own route and counters.
+// APIDs that were never registered share the catch-all counters.
+#define CDHS_MAX_ROUTED_APIDS 15
+
+typedef struct {
+    uint16_t apid;
+    uint32_t packets;       // Delivered to the destination queue
+    uint32_t bytes;
+    uint32_t drops;         // Destination queue full (or no destination)
+    uint32_t crc_failures;
+} CdhsApidStats_t;
+
+typedef struct {
+    uint32_t received;
+    uint32_t malformed;     // Bad version or length; APID not trusted
+    uint32_t unrouted;      // APID without a registered destination
+    uint32_t uplink_drops;  // Deframed packets lost for lack of a free frame
+} CdhsRouterStats_t;
+
+// Takes ownership of the uplink pool and installs the default APID routes
+// (ADCS 0x010, EPS 0x020, CDHS 0x040, Housekeeping 0x050).
+BaseType_t cdhs_router_init(PacketPool_t *uplink_pool);
+
+// Attach the queue that receives CCSDS_Frame_t pointers for a destination
+BaseType_t cdhs_router_set_destination(CdhsDestination_t dest, QueueHandle_t queue);
+
+// Add or move an APID route
+BaseType_t cdhs_router_register_apid(uint16_t apid, CdhsDestination_t dest);
+
+// --- Frame ownership ---
+// Producers (Comms link layer, injector) allocate, fill and submit frames;
+// whichever task receives a routed frame must release it.
+CCSDS_Frame_t *cdhs_router_alloc_frame(void);
+BaseType_t cdhs_router_submit(CCSDS_Frame_t *frame);
+void cdhs_router_release(CCSDS_Frame_t *frame);
+
+// Validates and dispatches one frame (the router task's inner step)
+void cdhs_router_route(CCSDS_Frame_t *frame);
+
+// --- Raw uplink ---
+// The radio driver hands over received bytes as they come (ASM-framed
+// packets, any bit alignment, idle fill in between). They go into the
+// deframer ring and the router task extracts the packets; only packets
+// that pass the CRC are copied into a frame, once. Single producer.
+// Returns pdFAIL if bytes were lost to a full ring.
+BaseType_t cdhs_router_rx_bytes(const uint8_t *data, size_t len);
+
+// --- Telemetry surface ---
+BaseType_t cdhs_router_get_apid_stats(uint16_t apid, CdhsApidStats_t *stats);
+void cdhs_router_get_stats(CdhsRouterStats_t *stats);
+void cdhs_router_get_uplink_stats(UplinkDeframerStats_t *stats);
+
+void vCdhsRouterTask(void *pvParameters);
+
+#endif // CDHS_ROUTER_H
@@ -0,0 +1,123 @@
+// include/checkpoint.h
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Warm-restart checkpoint ---
+// The state a watchdog, brown-out or software reset must not lose lives in
+// a small region that keeps its contents across such resets: RTC slow
+// memory on the target, a file on the host. The region holds one record per
+// section of CHECKPOINT_TABLE. Each section has exactly one writer task,
+// which rewrites it whenever its state changes.
+//
+// A record has two slots. A write always goes to the slot that does not
+// hold the newest copy, with a generation one higher and a CRC over header
+// and payload, so a reset in the middle of a write leaves the previous copy
+// standing. At boot, checkpoint_init() reads the region once, keeps the
+// newest valid slot of every section and hands it out through
+// checkpoint_get(). A power-on reset wipes the region instead: RTC memory
+// holds garbage then.
+//
+// Records are raw structs of the firmware that wrote them. The payload
+// length is checked on every read, so a record whose layout changed with a
+// new image is ignored rather than misread.
+//
+// Table: X(name, payload bytes reserved)
+
+#define CHECKPOINT_TABLE(X)                                                     \
+    X(MODE,         16)     /* state_manager.c: mode, generation */             \
+    X(TM_GEN,       8)      /* tm_gen.c: HK sequence count, 1 Hz heartbeat */   \
+    X(LOGGER,       320)    /* data_logger.c: packet sequences, downlink resume */ \
+    X(TIMELINE,     528)    /* tc_scheduler.c: earliest pending commands */     \
+    X(RESETS,       48)     /* watchdog.c: last expiry, reset cause history */
+
+#define CHECKPOINT_ID(name, bytes) CHECKPOINT_##name,
+typedef enum {
+    CHECKPOINT_TABLE(CHECKPOINT_ID)
+    CHECKPOINT_SECTION_COUNT
+} CheckpointSection_t;
+#undef CHECKPOINT_ID
+
+#define CHECKPOINT_MAGIC            0xC700u     // + section
+#define CHECKPOINT_HOST_IMAGE       "fsw_checkpoint.bin"
+
+// Why the CPU restarted (esp_reset_reason() on the target)
+typedef enum {
+    CHECKPOINT_RESET_POWER_ON,      // Cold boot: nothing to restore
+    CHECKPOINT_RESET_SOFTWARE,      // esp_restart(), e.g. a watchdog restart hook
+    CHECKPOINT_RESET_WATCHDOG,      // Hardware task/interrupt watchdog
+    CHECKPOINT_RESET_BROWNOUT,
+    CHECKPOINT_RESET_PANIC,
+    CHECKPOINT_RESET_OTHER
+} CheckpointReset_t;
+
+typedef struct {
+    uint16_t magic;             // CHECKPOINT_MAGIC + section
+    uint16_t len;               // Payload bytes
+    uint32_t generation;        // Writes of the section so far; the newer slot wins
+    uint32_t boot;              // Boot that wrote it (0 after power-on)
+    uint32_t tick;              // Its tick count at the time
+    uint16_t crc;               // CRC-16 of the fields above and the payload
+} CheckpointHeader_t;
+
+#define CHECKPOINT_SLOT_BYTES(bytes)    (sizeof(CheckpointHeader_t) + (((bytes) + 3u) & ~3u))
+#define CHECKPOINT_REGION_TERM(name, bytes) + 2u * CHECKPOINT_SLOT_BYTES(bytes)
+#define CHECKPOINT_REGION_BYTES         (0 CHECKPOINT_TABLE(CHECKPOINT_REGION_TERM))
+
+// Where a restored record came from
+typedef struct {
+    uint32_t generation;
+    uint32_t boot;
+    uint32_t tick;
+} CheckpointInfo_t;
+
+typedef struct {
+    uint32_t boot;              // Boots since power-on, this one included
+    CheckpointReset_t reset;
+    uint32_t restored;          // Sections with a valid record at boot
+    uint32_t corrupt_slots;     // Slots written once but failing their CRC
+    uint32_t restore_us;        // checkpoint_init(), one pass over the region
+    uint8_t last_alive_valid;
+    uint32_t last_alive_tick;   // Latest record tick of the previous boot
+    uint32_t writes;
+    uint32_t write_bytes;
+    uint32_t write_errors;      // Oversize payloads, failed syncs
+} CheckpointStats_t;
+
+// Persists a slot once it is written (the host file); NULL when the region
+// itself survives resets
+typedef int (*CheckpointSyncFn_t)(void *ctx, uint32_t offset, const void *data, size_t len);
+
+// Takes over `region` (CHECKPOINT_REGION_BYTES) and restores it in
+// one pass, or wipes it after a power-on reset. Returns 0, or -1 without a
+// region. Call once at boot, before any writer starts.
+int checkpoint_init(void *region, CheckpointReset_t reset, CheckpointSyncFn_t sync, void *sync_ctx);
+
+// Newest valid record of a section, if it has exactly `len` bytes. Returns
+// 0 and fills *info (may be NULL), -1 if there is none.
+int checkpoint_get(CheckpointSection_t section, void *payload, uint16_t len, CheckpointInfo_t *info);
+
+// Writer side, one task per section. Returns 0, or -1 if the payload does
+// not fit or the sync failed (the RAM copy is still written).
+int checkpoint_write(CheckpointSection_t section, const void *payload, uint16_t len, uint32_t tick);
+
+void checkpoint_get_stats(CheckpointStats_t *stats);
+
+const char *checkpoint_reset_name(CheckpointReset_t reset);
+
+// --- Platform region ---
+// Opens the region, works out the reset reason and calls checkpoint_init().
+// On the target the region is RTC slow memory (RTC_NOINIT_ATTR) and the
+// reason comes from esp_reset_reason(); on the host it is a file.
+int checkpoint_open(void);
+
+#ifndef ESP_PLATFORM
+// The host has no reset reason of its own, so the harness says how the
+// previous run ended (default: power-on, which also empties the file)
+void checkpoint_host_set_reset(CheckpointReset_t reset);
+#endif
+
+#endif // CHECKPOINT_H
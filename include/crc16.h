@@ -0,0 +1,58 @@
+// include/crc16.h
+
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stdint.h>
+#include <stddef.h> // For size_t
+
+// CRC-16 CCITT-FALSE: poly 0x1021, init 0xFFFF, no reflection, no final XOR.
+// Check value for the ASCII string "123456789" is 0x29B1.
+#define CRC16_POLY    0x1021
+#define CRC16_INITIAL 0xFFFF
+
+// --- Back-end selection (compile time) ---
+// All lookup tables are generated by the preprocessor and live in .rodata,
+// so no back-end needs a runtime init call.
+//   BITWISE : 8 shift/XOR steps per byte, no tables (reference)
+//   TABLE   : 1 lookup per byte, 512 B of tables
+//   SLICE4  : 4 bytes per iteration, 2 KB of tables
+//   SLICE8  : 8 bytes per iteration, 4 KB of tables
+// These sizes hold when the image is linked with --gc-sections (the ESP-IDF
+// default): each back-end's tables are a separate object and only those of
+// the back-ends actually called are kept. Without it all 4 KB are linked,
+// since every back-end below stays callable.
+#define CRC16_BACKEND_BITWISE 0
+#define CRC16_BACKEND_TABLE   1
+#define CRC16_BACKEND_SLICE4  2
+#define CRC16_BACKEND_SLICE8  3
+
+#ifndef CRC16_BACKEND
+#define CRC16_BACKEND CRC16_BACKEND_TABLE
+#endif
+
+// --- Streaming API ---
+// Frames split across several buffers are checked without copying:
+//   uint16_t crc = crc16_init();
+//   crc = crc16_update(crc, hdr, hdr_len);
+//   crc = crc16_update(crc, body, body_len);
+//   if (crc16_final(crc) == received_crc) { ... }
+static inline uint16_t crc16_init(void) {
+    return CRC16_INITIAL;
+}
+
+uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t length);
+
+static inline uint16_t crc16_final(uint16_t crc) {
+    return crc; // CCITT-FALSE has no output XOR
+}
+
+// --- Individual back-ends ---
+// Always available so the host benchmark can compare them side by side.
+// Flight code should call crc16_update(), which maps to CRC16_BACKEND.
+uint16_t crc16_update_bitwise(uint16_t crc, const uint8_t *data, size_t length);
+uint16_t crc16_update_table(uint16_t crc, const uint8_t *data, size_t length);
+uint16_t crc16_update_slice4(uint16_t crc, const uint8_t *data, size_t length);
+uint16_t crc16_update_slice8(uint16_t crc, const uint8_t *data, size_t length);
+
+#endif // CRC16_H
@@ -0,0 +1,93 @@
+// include/data_logger.h
+
+#ifndef DATA_LOGGER_H
+#define DATA_LOGGER_H
+
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+#include "tm_archive.h"
+#include "downlink.h"
+#include "downlink_fec.h"
+#include "tm_stats.h"
+#include "satellite_types.h"
+
+// Sector geometry of the "tm_archive" partition (0xF0000 bytes, see partitions.csv)
+#define DATA_LOGGER_SECTOR_SIZE     4096
+#define DATA_LOGGER_SECTOR_COUNT    240
+#define DATA_LOGGER_HOST_IMAGE      "tm_archive.bin"   // Host build: file-backed flash
+
+// RS(255,223) interleave depth of the radio codeblocks (downlink_fec.h).
+// 0 sends space packets uncoded.
+#define DATA_LOGGER_FEC_DEPTH       1
+
+// On-board telemetry archive, owned by vDataLoggerTask
+extern TmArchive_t g_tm_archive;
+
+// Opens the flash backend and mounts the archive (formats it if no log is
+// found). Returns pdFAIL if the flash is unavailable; the logger then only
+// prints packets.
+BaseType_t data_logger_init(void);
+
+// Archive time: ticks since the first boot of the archive rather than of
+// this boot. Every boot's count starts after the newest record, so the time
+// index stays ordered across resets. Records, the downlink MET and the
+// TC_REQUEST_SUMMARY window all use it. Valid after data_logger_init().
+uint32_t data_logger_archive_time(TickType_t tick);
+
+// Asks the logger to open a downlink pass of `duration_ms` (0 closes the
+// current pass at once, e.g. on loss of signal). Safe to call from any task.
+BaseType_t data_logger_request_pass(uint32_t duration_ms);
+
+// Report of the last completed pass (all zero before the first one)
+void data_logger_get_last_pass(DownlinkPassStats_t *pass);
+
+// TC_REQUEST_HK answers (APID_HK_RESPONSE). They come in on
+// g_hk_response_pool and go straight to the radio, in any mode and outside
+// any pass budget; the archive never sees them. Latency runs from the TC
+// handler to the radio.
+typedef struct {
+    uint32_t sent;
+    uint32_t send_errors;
+    uint32_t latency_last_us;
+    uint32_t latency_max_us;
+    uint64_t latency_sum_us;        // Mean: latency_sum_us / sent
+    uint32_t latency_max_ticks;
+} HkResponseStats_t;
+
+void data_logger_get_hk_response_stats(HkResponseStats_t *stats);
+
+// TC_REQUEST_SUMMARY answers (APID_TM_SUMMARY): statistics of an archive
+// window merged from the page trailers (tm_stats.h). Sent at once like HK
+// responses.
+typedef struct {
+    uint32_t sent;
+    uint32_t send_errors;
+    uint32_t query_us_last;         // Trailer merge of the last request
+    uint32_t query_us_max;
+    TmStatsSummary_t last;          // What the last answer was built from
+} SummaryServiceStats_t;
+
+void data_logger_get_summary_stats(SummaryServiceStats_t *stats);
+
+// Channel coding counters (packets in, codeblocks out)
+void data_logger_get_fec_stats(DownlinkFecStats_t *stats);
+
+// First HK sample set archived after boot: the point from which ground
+// gets telemetry again. Valid once `valid` is set.
+typedef struct {
+    uint8_t valid;
+    uint32_t tick;
+    uint32_t time_us;               // util_get_time_us() at the same point
+    SystemMode_t mode;              // Mode it was taken in
+} FirstTelemetry_t;
+
+void data_logger_get_first_telemetry(FirstTelemetry_t *first);
+
+// Optional copy of everything handed to the radio: codeblocks, or space
+// packets with DATA_LOGGER_FEC_DEPTH 0 (the host run uses it to record the
+// downlink). Set it before the first pass.
+void data_logger_set_radio_tap(DownlinkSendFn_t tap, void *ctx);
+
+void vDataLoggerTask(void *pvParameters);
+
+#endif // DATA_LOGGER_H
@@ -0,0 +1,138 @@
+// include/downlink.h
+
+#ifndef DOWNLINK_H
+#define DOWNLINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "satellite_types.h"   // DownlinkMode_t
+#include "ccsds_packet.h"
+#include "tm_archive.h"
+
+// --- Streaming downlink engine ---
+// Streams archived records as CCSDS TM packets during a ground pass. A token
+// bucket paces frames to the link rate. A per-page "sent" bitmap plus the
+// cursor of the page in flight make passes resumable: a new pass continues
+// where the last one stopped and never resends a record. Bits are dropped
+// automatically when the archive erases and reuses a sector.
+//
+// Each record goes down on the APID of its archive kind (TmRecordKind_t).
+// With compression on, the HK records of a page are packed into
+// hk_compress frames (APID_HK_COMPRESSED), many records per TM packet.
+//
+// The engine is not thread-safe; it belongs to the task that owns the archive
+// (vDataLoggerTask). Times are milliseconds from any monotonic clock.
+
+#define DOWNLINK_MAX_PAGES      2048    // Archive pages the sent bitmap can track
+#define DOWNLINK_BURST_BYTES    256     // Token bucket depth: largest back-to-back burst
+#define DOWNLINK_FRAME_OVERHEAD (CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + CCSDS_CRC_LEN)
+
+// Archive record kinds (tm_archive_append_kind())
+typedef enum {
+    TM_RECORD_HK = 0,           // HK_TM_SCHEMA record: APID_HOUSEKEEPING, compressible
+    TM_RECORD_HK_SAMPLES        // hk_sched.h sample set: APID_HK_SAMPLES
+} TmRecordKind_t;
+
+typedef enum {
+    DOWNLINK_OLDEST_FIRST,      // Chronological backlog dump
+    DOWNLINK_NEWEST_FIRST       // Latest state first, then work back through the backlog
+} DownlinkPolicy_t;
+
+// Radio hook: returns 0 once the frame is handed to the transmitter
+typedef int (*DownlinkSendFn_t)(void *ctx, const uint8_t *frame, size_t len);
+
+typedef struct {
+    uint32_t pass_number;
+    uint32_t duration_ms;
+    uint32_t frames_sent;
+    uint32_t records_sent;
+    uint32_t bytes_sent;        // On-air bytes, CCSDS headers included
+    uint32_t budget_bytes;      // Link rate x pass duration
+    uint16_t utilization_pct;   // bytes_sent / budget_bytes
+    uint32_t backlog_records;   // Archived records still unsent at pass end
+    uint32_t backlog_bytes;     // Their on-air size, uncompressed
+    uint32_t send_errors;
+} DownlinkPassStats_t;
+
+typedef struct {
+    TmArchive_t *archive;
+    DownlinkSendFn_t send;
+    void *send_ctx;
+    uint32_t link_rate_bps;
+    DownlinkPolicy_t policy;
+    uint8_t compress;
+
+    DownlinkMode_t mode;
+    uint32_t pass_start_ms;
+    uint32_t pass_end_ms;
+    uint32_t last_refill_ms;
+    uint32_t tokens;            // Bytes the link may carry right now
+
+    // Scan through the archive for the current pass
+    uint32_t scan_origin;       // Write page when the pass started
+    uint32_t scan_step;
+    uint8_t page_open;
+    uint16_t page_records;
+    TmArchiveCursor_t cursor;   // Next record of the page in flight
+
+    // Resume state, kept across passes
+    uint8_t sent[DOWNLINK_MAX_PAGES / 8];
+    uint32_t sector_seq[TM_ARCHIVE_MAX_SECTORS];   // Sector generation the bits belong to
+    uint8_t resume_valid;
+    TmArchiveCursor_t resume;
+
+    uint16_t tm_sequence;
+    DownlinkPassStats_t pass;
+    DownlinkPassStats_t last_pass;
+} Downlink_t;
+
+// Resume state in a form that survives a reset (checkpoint.h). Sector
+// generations are not kept one by one: the archive's next page sequence at
+// save time stands for all of them, since any sector erased and rewritten
+// later starts with a higher one.
+typedef struct {
+    uint8_t sent[DOWNLINK_MAX_PAGES / 8];
+    uint32_t archive_sequence;  // archive->next_sequence when saved
+    TmArchiveCursor_t resume;
+    uint8_t resume_valid;
+    uint16_t tm_sequence;
+    uint32_t pass_number;       // Last pass started
+} DownlinkResume_t;
+
+// Returns 0 on success, -1 if the archive is larger than the sent bitmap
+int downlink_init(Downlink_t *dl, TmArchive_t *archive, uint32_t link_rate_bps,
+                  DownlinkPolicy_t policy, DownlinkSendFn_t send, void *send_ctx);
+
+void downlink_set_policy(Downlink_t *dl, DownlinkPolicy_t policy);
+
+// Packs HK records into compressed frames (non-HK records still go out plain)
+void downlink_set_compression(Downlink_t *dl, int enable);
+
+// Opens a pass window of `duration_ms`. Returns -1 if a pass is already active.
+int downlink_pass_begin(Downlink_t *dl, uint32_t now_ms, uint32_t duration_ms);
+
+// Sends as many frames as the link budget allows and closes the pass when the
+// window is over. Call it often (every tick) while a pass is active.
+// Returns the number of frames sent.
+uint32_t downlink_service(Downlink_t *dl, uint32_t now_ms);
+
+// Closes the pass early (loss of signal, mode change) and computes its stats
+void downlink_pass_end(Downlink_t *dl, uint32_t now_ms);
+
+static inline int downlink_is_active(const Downlink_t *dl) {
+    return dl->mode == DOWNLINK_ACTIVE;
+}
+
+// Figures of the last completed pass
+void downlink_get_last_pass(const Downlink_t *dl, DownlinkPassStats_t *stats);
+
+// Snapshot of the resume state. A pass in progress counts as cut off here.
+void downlink_save_resume(Downlink_t *dl, DownlinkResume_t *out);
+
+// Takes over a snapshot after downlink_init() on the remounted archive. Sent
+// marks of sectors rewritten since the save are dropped; if the archive is
+// behind the snapshot (reformatted) all of them are. Returns the pages
+// whose marks were kept.
+uint32_t downlink_restore_resume(Downlink_t *dl, const DownlinkResume_t *in);
+
+#endif // DOWNLINK_H
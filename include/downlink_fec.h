@@ -0,0 +1,81 @@
+// include/downlink_fec.h
+
+#ifndef DOWNLINK_FEC_H
+#define DOWNLINK_FEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "downlink.h"       // DownlinkSendFn_t
+#include "ccsds_packet.h"
+#include "rs_fec.h"
+
+// --- Downlink channel coding ---
+// Sits between the packet sources (downlink engine, HK responses, summaries)
+// and the radio. Space packets are packed back to back into the data field
+// of a codeblock. When the next one does not fit, the rest of the field is
+// filled with DOWNLINK_FEC_FILL and the block goes out as
+//
+// | ASM:32 | data: depth x 223 B | parity: depth x 32 B |
+//
+// coded as `depth` interleaved RS(255,223) codewords (rs_fec.h): byte i of
+// the data and of the parity belongs to codeword i % depth, so any burst of
+// up to 16 x depth bytes is corrected. Packets never straddle two blocks. A
+// packet never starts with 0xFF (version 7), so the fill is unambiguous.
+//
+// Depth 0 turns coding off: packets go to the radio as they are.
+
+#define DOWNLINK_FEC_MAX_DEPTH          5
+#define DOWNLINK_FEC_FILL               0xFF
+#define DOWNLINK_FEC_BLOCK_LEN(depth)   (CCSDS_ASM_LEN + (depth) * RS_N)
+#define DOWNLINK_FEC_DATA_LEN(depth)    ((depth) * RS_K)
+
+typedef struct {
+    uint32_t packets;           // Packets accepted
+    uint32_t packet_bytes;
+    uint32_t blocks;            // Codeblocks handed to the radio
+    uint32_t fill_bytes;        // Data field bytes that went out as fill
+    uint32_t send_errors;
+    uint32_t encode_cycles_max; // Worst codeblock encode (util_get_cycle_count)
+} DownlinkFecStats_t;
+
+typedef struct {
+    uint8_t depth;
+    uint16_t used;              // Data field bytes taken so far
+    uint8_t block[DOWNLINK_FEC_BLOCK_LEN(DOWNLINK_FEC_MAX_DEPTH)];
+    DownlinkSendFn_t send;
+    void *send_ctx;
+    DownlinkFecStats_t stats;
+} DownlinkFec_t;
+
+// Returns 0, or -1 if depth is above DOWNLINK_FEC_MAX_DEPTH
+int downlink_fec_init(DownlinkFec_t *fec, unsigned depth, DownlinkSendFn_t send, void *send_ctx);
+
+// A DownlinkSendFn_t (ctx is the DownlinkFec_t): puts the packet in the
+// current block, sending that block first if the packet does not fit.
+int downlink_fec_send(void *ctx, const uint8_t *packet, size_t len);
+
+// Sends the current block now, fill and all. Nothing happens when it is empty.
+int downlink_fec_flush(DownlinkFec_t *fec);
+
+// Link rate left for packets once the coding overhead is paid
+uint32_t downlink_fec_info_rate(uint32_t link_rate_bps, unsigned depth);
+
+// --- Ground side (host run, tools, tests) ---
+typedef struct {
+    uint32_t blocks;
+    uint32_t codewords;
+    uint32_t corrected;         // Symbols repaired
+    uint32_t uncorrectable;     // Codewords beyond repair
+    uint32_t packets;           // CRC-valid packets handed out
+    uint32_t bad_packets;       // Failed their CRC (only behind an uncorrectable codeword)
+} DownlinkFecRxStats_t;
+
+typedef void (*DownlinkFecPacketFn_t)(void *ctx, const uint8_t *packet, size_t len);
+
+// Corrects one codeblock (ASM first) in place and hands out the packets of
+// its data field whose CRC checks out. Returns 0, or -1 if a codeword was
+// beyond repair (the packets that survived are still handed out).
+int downlink_fec_decode_block(uint8_t *block, unsigned depth, DownlinkFecPacketFn_t on_packet,
+                              void *ctx, DownlinkFecRxStats_t *stats);
+
+#endif // DOWNLINK_FEC_H
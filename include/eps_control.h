@@ -3,15 +3,42 @@
 #ifndef EPS_CONTROL_H
 #define EPS_CONTROL_H
 
+#include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "eps_filter.h"
+#include "eps_source.h"
+#include "satellite_types.h"    // EPS_Status_t
+
+// --- EPS acquisition pipeline ---
+// Every EPS_BATCH_PERIOD_MS the monitor reads the samples taken since the
+// last batch, filters them in fixed point and feeds the lowest moving average
+// to the hysteresis FDIR. Two low batches (~200 ms) trip MODE_CRITICAL; a
+// single glitch only moves a 16-sample average by a sixteenth of its depth.
+
+#define EPS_SAMPLE_RATE_HZ      1000
+#define EPS_BATCH_PERIOD_MS     100
+#define EPS_BATCH_SAMPLES       (EPS_SAMPLE_RATE_HZ * EPS_BATCH_PERIOD_MS / 1000)
+#define EPS_EWMA_SHIFT          6           // alpha = 1/64, ~64 ms time constant
+
+#define EPS_TRIP_MV             2500        // Critical bus voltage
+#define EPS_CLEAR_MV            2700        // Hysteresis: must recover this far
+#define EPS_TRIP_BATCHES        2
+#define EPS_CLEAR_BATCHES       10          // 1 s above EPS_CLEAR_MV
 
 // --- Public Function Prototypes ---
 
 // 1. The FreeRTOS Task function (called by xTaskCreate in cdh_main.c)
 void vEPSMonitoringTask(void *pvParameters);
 
-// 2. The critical execution function for load shedding (called by the Command Processor)
+// 2. Replaces the default sample source (ADC1 on the target, the synthetic
+//    bus on the host); call before the task starts
+void eps_control_set_source(const EpsSampleSource_t *source);
+
+// 3. Latest published status: the EPS group of the parameter store (lock-free)
+void eps_get_status(EPS_Status_t *status);
+
+// 4. The critical execution function for load shedding (called by the Command Processor)
 // This is the function we will fully implement in your EPS project phase.
 void vEPS_SetSafeModePower(int mode_id); 
 
-#endif // EPS_CONTROL_H
\ No newline at end of file
+#endif // EPS_CONTROL_H
@@ -0,0 +1,66 @@
+// include/eps_filter.h
+
+#ifndef EPS_FILTER_H
+#define EPS_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Fixed-point bus voltage filtering and undervoltage FDIR ---
+// Samples are millivolts, below 32768 (the EWMA state is a signed Q16.16).
+// Every kernel is integer-only: the moving average
+// keeps a running sum over a power-of-two window, the EWMA keeps its state
+// in Q16.16 and uses a shift for alpha. Nothing here touches FreeRTOS, so
+// the host tests drive the same code with recorded traces.
+
+#define EPS_FILTER_MA_LOG2      4                           // 16-sample window
+#define EPS_FILTER_MA_WINDOW    (1u << EPS_FILTER_MA_LOG2)
+
+typedef struct {
+    uint16_t window[EPS_FILTER_MA_WINDOW];
+    uint32_t sum;               // Sum of window[]
+    uint32_t index;
+    uint32_t ewma_q16;          // mV << 16 (used as int32_t)
+    uint8_t ewma_shift;         // alpha = 2^-ewma_shift
+} EpsFilter_t;
+
+// What one batch looked like after filtering
+typedef struct {
+    uint16_t mean_mv;           // Moving average after the last sample
+    uint16_t ewma_mv;
+    uint16_t min_mv;            // Raw extremes of the batch
+    uint16_t max_mv;
+    uint16_t mean_min_mv;       // Lowest moving average inside the batch (FDIR input)
+} EpsBatchResult_t;
+
+// Starts with the window filled with initial_mv, so there is no false trip at boot
+void eps_filter_init(EpsFilter_t *filter, uint16_t initial_mv, uint8_t ewma_shift);
+void eps_filter_run(EpsFilter_t *filter, const uint16_t *samples_mv, size_t count,
+                    EpsBatchResult_t *result);
+
+// --- Debounced hysteresis state machine ---
+// Trips after trip_batches consecutive batches below trip_mv; clears after
+// clear_batches consecutive batches at or above clear_mv (> trip_mv).
+typedef enum {
+    EPS_HEALTH_NOMINAL = 0,
+    EPS_HEALTH_UNDERVOLTAGE
+} EpsHealth_t;
+
+typedef struct {
+    uint16_t trip_mv;
+    uint16_t clear_mv;
+    uint8_t trip_batches;
+    uint8_t clear_batches;
+} EpsFdirConfig_t;
+
+typedef struct {
+    EpsFdirConfig_t config;
+    EpsHealth_t state;
+    uint8_t streak;             // Consecutive batches arguing for the other state
+} EpsFdir_t;
+
+// Returns -1 if clear_mv is not above trip_mv or a debounce count is zero
+int eps_fdir_init(EpsFdir_t *fdir, const EpsFdirConfig_t *config);
+EpsHealth_t eps_fdir_update(EpsFdir_t *fdir, uint16_t level_mv);
+
+#endif // EPS_FILTER_H
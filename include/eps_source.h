@@ -0,0 +1,50 @@
+// include/eps_source.h
+
+#ifndef EPS_SOURCE_H
+#define EPS_SOURCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Pluggable bus voltage sample source ---
+// read() fills up to `count` samples in millivolts, oldest first, and returns
+// how many it wrote (0 when nothing is available yet) or -1 on a fault.
+// Sources are paced by the caller: each read covers the samples taken since
+// the previous one at sample_rate_hz.
+typedef struct {
+    uint32_t sample_rate_hz;
+    void *ctx;                  // Source private state
+
+    int (*read)(void *ctx, uint16_t *samples_mv, size_t count);
+} EpsSampleSource_t;
+
+// Synthetic bus: nominal level with noise, optional single-sample glitches
+// and a step down to fault_mv at fault_onset_ms (0 = never). Deterministic.
+typedef struct {
+    uint16_t nominal_mv;
+    uint16_t fault_mv;
+    uint16_t noise_mv;          // Peak, uniform
+    uint16_t glitch_mv;         // Depth of a glitch below the current level
+    uint32_t glitch_every;      // Samples between glitches (0 = none)
+    uint32_t fault_onset_ms;
+    uint32_t rng;               // Noise seed, then state
+
+    // Set by eps_source_synth_open()
+    uint32_t sample_rate_hz;
+    uint32_t sample_index;
+} EpsSynthConfig_t;
+
+void eps_source_synth_open(EpsSampleSource_t *source, EpsSynthConfig_t *config,
+                           uint32_t sample_rate_hz);
+
+#ifdef ESP_PLATFORM
+// ADC1 channel behind a resistive divider (EPS_ADC_* in eps_source_adc.c)
+int eps_source_adc_open(EpsSampleSource_t *source, uint32_t sample_rate_hz);
+#else
+// Recorded trace on the host: one sample in mV per line. The last value is
+// held once the file runs out.
+int eps_source_file_open(EpsSampleSource_t *source, const char *path, uint32_t sample_rate_hz);
+void eps_source_file_close(EpsSampleSource_t *source);
+#endif
+
+#endif // EPS_SOURCE_H
@@ -0,0 +1,34 @@
+// include/flash_backend.h
+
+#ifndef FLASH_BACKEND_H
+#define FLASH_BACKEND_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Pluggable NOR-flash interface ---
+// Erase sets a whole sector to 0xFF; program can only clear bits. Addresses
+// are byte offsets from the start of the region. Every call returns 0 on
+// success and -1 on failure.
+typedef struct {
+    uint32_t sector_size;       // Erase unit in bytes
+    uint32_t sector_count;
+    void *ctx;                  // Backend private state
+
+    int (*read)(void *ctx, uint32_t addr, void *buf, size_t len);
+    int (*program)(void *ctx, uint32_t addr, const void *buf, size_t len);
+    int (*erase_sector)(void *ctx, uint32_t sector);
+} FlashBackend_t;
+
+#ifdef ESP_PLATFORM
+// Data partition on the SPI flash, looked up by label (see partitions.csv)
+int flash_partition_open(FlashBackend_t *flash, const char *label);
+#else
+// File-backed mock for the host build. The file is created (erased) if it
+// does not exist; writes follow NOR rules so power-cut behaviour matches.
+int flash_file_open(FlashBackend_t *flash, const char *path,
+                    uint32_t sector_size, uint32_t sector_count);
+void flash_file_close(FlashBackend_t *flash);
+#endif
+
+#endif // FLASH_BACKEND_H
@@ -0,0 +1,111 @@
+// include/fsw_log.h
+
+#ifndef FSW_LOG_H
+#define FSW_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+
+// --- Deferred binary logging ---
+// FSW_LOGx() stores a pointer to its call site plus the raw arguments in a
+// RAM ring and returns: no formatting and no UART on the caller's path. The
+// low-priority LOG_DRAIN task formats and prints the records later, so a
+// log call inside a loop or under a lock costs a few hundred cycles instead
+// of the milliseconds a blocking printf takes at 115200 baud.
+//
+//   FSW_LOGW(LOG_MOD_EPS, "EPS MON: Bus at %.2f V\n", (double)volts);
+//
+// Rules: task context only, at most FSW_LOG_MAX_ARGS conversions per format,
+// and %s arguments must be string literals (only the pointer is stored).
+
+#define FSW_LOG_RING_DEPTH      64      // Records, power of two
+#define FSW_LOG_MAX_ARGS        4
+#define FSW_LOG_LINE_MAX        160     // Longest formatted line
+
+// Sites above this level are compiled out entirely
+#ifndef FSW_LOG_COMPILE_LEVEL
+#define FSW_LOG_COMPILE_LEVEL   LOG_LEVEL_DEBUG
+#endif
+
+typedef enum {
+    LOG_LEVEL_NONE = 0,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+} FswLogLevel_t;
+
+typedef enum {
+    LOG_MOD_MODE = 0,
+    LOG_MOD_TC,
+    LOG_MOD_TM,
+    LOG_MOD_EPS,
+    LOG_MOD_LOGGER,
+    LOG_MOD_SCHED,
+    LOG_MOD_ROUTER,
+    LOG_MOD_WDT,
+    LOG_MOD_COUNT
+} FswLogModule_t;
+
+// One per call site (a static inside FSW_LOG); the argument types are
+// parsed from the format on first use and cached here.
+typedef struct {
+    const char *format;
+    uint8_t level;
+    uint8_t module;
+    uint8_t arg_count;          // FSW_LOG_UNPARSED until the first call
+    uint8_t arg_types[FSW_LOG_MAX_ARGS];
+} FswLogSite_t;
+
+#define FSW_LOG_UNPARSED        0xFF
+
+typedef union {
+    int32_t i;
+    uint32_t u;
+    float f;                    // %f/%e/%g (the double is narrowed)
+    const char *s;
+} FswLogArg_t;
+
+typedef struct {
+    const FswLogSite_t *site;
+    FswLogArg_t args[FSW_LOG_MAX_ARGS];
+} FswLogRecord_t;
+
+typedef struct {
+    uint32_t written;           // Records queued
+    uint32_t dropped;           // Ring full: the new record was lost
+    uint32_t drained;           // Records formatted by fsw_log_drain()
+    uint32_t high_water;        // Deepest the ring has been
+} FswLogStats_t;
+
+// Runtime level per module (LOG_LEVEL_INFO after fsw_log_init())
+extern uint8_t g_fsw_log_level[LOG_MOD_COUNT];
+
+void fsw_log_init(void);
+void fsw_log_set_level(FswLogModule_t module, FswLogLevel_t level);
+void fsw_log_get_stats(FswLogStats_t *stats);
+
+// Producer side (through the macros below)
+void fsw_log_write(FswLogSite_t *site, ...);
+
+// Consumer side: pop returns 0 or -1 when empty; format returns the length
+int fsw_log_pop(FswLogRecord_t *record);
+size_t fsw_log_format(const FswLogRecord_t *record, char *buf, size_t len);
+uint32_t fsw_log_drain(uint32_t max_records);   // Pops, formats and prints
+
+void vLogDrainTask(void *pvParameters);
+
+#define FSW_LOG(level, module, fmt, ...) do {                                     \
+        static FswLogSite_t fsw_log_site_ = { (fmt), (level), (module), FSW_LOG_UNPARSED, {0} }; \
+        if ((level) <= FSW_LOG_COMPILE_LEVEL && (level) <= g_fsw_log_level[(module)]) { \
+            fsw_log_write(&fsw_log_site_, ##__VA_ARGS__);                          \
+        }                                                                         \
+    } while (0)
+
+#define FSW_LOGE(module, fmt, ...)  FSW_LOG(LOG_LEVEL_ERROR, module, fmt, ##__VA_ARGS__)
+#define FSW_LOGW(module, fmt, ...)  FSW_LOG(LOG_LEVEL_WARN, module, fmt, ##__VA_ARGS__)
+#define FSW_LOGI(module, fmt, ...)  FSW_LOG(LOG_LEVEL_INFO, module, fmt, ##__VA_ARGS__)
+#define FSW_LOGD(module, fmt, ...)  FSW_LOG(LOG_LEVEL_DEBUG, module, fmt, ##__VA_ARGS__)
+
+#endif // FSW_LOG_H
@@ -0,0 +1,63 @@
+// include/hk_compress.h
+
+#ifndef HK_COMPRESS_H
+#define HK_COMPRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "satellite_types.h"
+
+// --- Compressed housekeeping frames ---
+// One frame carries a keyframe followed by delta records, bit-packed MSB first:
+//
+// | magic:8 | count:16 | keyframe | delta | delta | ... | pad | CRC-16:16 |
+//
+// Keyframe: timestamp:32 sequence:16 flags:8 voltage_q:32 temp_q:32
+// Delta:    timestamp  '0' same step as before | '10' +-8 bit | '110' +-16 bit | '111' step:32
+//           sequence   '0' previous + 1        | '1' value:16
+//           flags      '0' unchanged           | '1' value:8
+//           voltage_q  '0' unchanged | '10' +-4 bit | '110' +-10 bit | '111' value:32
+//           temp_q     (same as voltage_q)
+//
+// Voltage and temperature are quantized before delta coding (lossy to half an
+// LSB); deltas are taken between quantized values so errors never accumulate.
+// The per-packet crc_checksum is not sent: the frame CRC covers everything and
+// the decoder fills in a fresh checksum for each record.
+
+#define HK_FRAME_MAGIC          0xD1
+#define HK_FRAME_OVERHEAD       5       // magic + count + CRC
+#define HK_KEYFRAME_BITS        120
+#define HK_VOLT_LSB             0.001f  // 1 mV
+#define HK_TEMP_LSB             0.01f   // 0.01 degC
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap_bits;            // Bit budget between the count field and the CRC
+    size_t bits;                // Bits written so far
+    uint16_t count;
+
+    // Previous sample, as the decoder will have reconstructed it
+    uint32_t last_ts;
+    int32_t last_step;
+    uint16_t last_seq;
+    uint8_t last_flags;
+    int32_t last_volt_q;
+    int32_t last_temp_q;
+} HkEncoder_t;
+
+// Starts a frame in `buf`. Returns -1 if `cap` cannot hold even a keyframe.
+int hk_encoder_begin(HkEncoder_t *enc, uint8_t *buf, size_t cap);
+
+// Appends one packet. Returns 0 on success, -1 if the frame is full (the
+// frame is left exactly as it was, so the packet can start the next one).
+int hk_encoder_add(HkEncoder_t *enc, const HK_Telemetry_t *pkt);
+
+// Writes the count and CRC. Returns the frame length, 0 if no packet was added.
+size_t hk_encoder_finish(HkEncoder_t *enc);
+
+// Ground-side decoder. Returns 0 and the number of packets in `count`,
+// -1 on a bad magic, CRC or truncated bit stream.
+int hk_decode_frame(const uint8_t *frame, size_t len, HK_Telemetry_t *out,
+                    size_t max_packets, size_t *count);
+
+#endif // HK_COMPRESS_H
@@ -0,0 +1,111 @@
+// include/hk_sched.h
+
+#ifndef HK_SCHED_H
+#define HK_SCHED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "satellite_types.h"
+#include "packet_schema.h"
+
+// --- Multi-rate housekeeping scheduler ---
+// Each HK parameter has its own period and deadband, per system mode. The
+// scheduler is stepped at a fixed base rate with a fresh sample of every
+// parameter. A parameter goes into the step's sample set when its period is
+// up (due) or when it has moved more than its deadband since it was last
+// sent (changed). Once anything is going out, parameters that would fall due
+// within the merge window ride along and take their slot early, so a change
+// just before a slot does not cost a second frame. Slots sit on a fixed grid
+// from the last mode change, so harmonic periods share frames. Nothing due,
+// no frame.
+//
+// Sample set on the wire (APID_HK_SAMPLES), big-endian:
+//
+// | timestamp:32 | present:16 | value | value | ... | CRC-16:16 |
+//
+// Bit i of `present` is parameter i of HK_PARAM_TABLE (16 at most); the
+// values of the present parameters follow in table order, each in its wire
+// type.
+//
+// Table: X(name, wire type, period SAFE/NOMINAL/CRITICAL (s, 0 = off), deadband)
+// The period is the longest a parameter goes unsent; the deadband (in the
+// parameter's own units, 0 = any change) decides how fine a change is sent at
+// the base rate in between.
+
+#define HK_PARAM_TABLE(X)                                   \
+    X(bus_mv,           U16,    120,  30,  10,  20)         \
+    X(bus_min_mv,       U16,    120,  30,  10,  50)         \
+    X(status_flags,     U8,     300,  60,  60,   0)         \
+    X(ext_temp_cc,      I16,    600, 120, 120,  50)         \
+    X(eps_trips,        U16,    600, 300,  60,   0)         \
+    X(tc_received,      U16,    600, 120, 300,   0)
+
+#define HK_SCHED_TICK_MS        1000    // Base rate the scheduler is stepped at
+#define HK_SCHED_MERGE_PCT      25      // Pull a parameter forward by up to this much of its period
+
+#define HK_PARAM_ID(name, type, safe_s, nominal_s, critical_s, deadband) HK_PARAM_##name,
+typedef enum {
+    HK_PARAM_TABLE(HK_PARAM_ID)
+    HK_PARAM_COUNT
+} HkParamId_t;
+#undef HK_PARAM_ID
+
+#define HK_SAMPLES_OFF_timestamp    0
+#define HK_SAMPLES_OFF_present      WIRE_SIZE_U32
+#define HK_SAMPLES_OFF_values       (HK_SAMPLES_OFF_present + WIRE_SIZE_U16)
+#define HK_SAMPLES_OVERHEAD         (HK_SAMPLES_OFF_values + WIRE_CRC_LEN)
+
+#define HK_PARAM_WIRE_SIZE(name, type, safe_s, nominal_s, critical_s, deadband) + WIRE_SIZE_##type
+#define HK_SAMPLES_MAX_LEN          (HK_SAMPLES_OVERHEAD HK_PARAM_TABLE(HK_PARAM_WIRE_SIZE))
+
+// A decoded sample set (value[i] valid when bit i of present is set)
+typedef struct {
+    uint32_t timestamp;
+    uint16_t present;
+    int32_t value[HK_PARAM_COUNT];
+} HkSampleSet_t;
+
+// Pool slot the TM Generator hands to the logger
+typedef struct {
+    uint32_t timestamp;
+    uint16_t length;
+    uint8_t wire[HK_SAMPLES_MAX_LEN];
+} HkSampleFrame_t;
+
+typedef struct {
+    uint32_t steps;
+    uint32_t frames;            // Sample sets produced
+    uint32_t bytes;             // Their wire size
+    uint32_t sent_due;          // Parameters sent because their period was up
+    uint32_t sent_changed;      // ... because they left the deadband
+    uint32_t sent_merged;       // ... pulled forward into another parameter's frame
+} HkSchedStats_t;
+
+typedef struct {
+    SystemMode_t mode;
+    uint32_t next_due_ms[HK_PARAM_COUNT];
+    int32_t last_sent[HK_PARAM_COUNT];
+    HkSchedStats_t stats;
+} HkSched_t;
+
+// Starts in `mode` with every enabled parameter due at once
+void hk_sched_init(HkSched_t *sched, SystemMode_t mode, uint32_t now_ms);
+
+// Switches the rate table. Every parameter enabled in the new mode is due at
+// once, so the first frame after a mode change is a full set.
+void hk_sched_set_mode(HkSched_t *sched, SystemMode_t mode, uint32_t now_ms);
+
+// One base-rate step with a fresh sample of every parameter. Writes the
+// sample set to `frame` (HK_SAMPLES_MAX_LEN is always enough) and returns its
+// length, or 0 when nothing is due or changed.
+size_t hk_sched_step(HkSched_t *sched, uint32_t now_ms, uint32_t timestamp,
+                     const int32_t value[HK_PARAM_COUNT], uint8_t *frame);
+
+// Period of a parameter in a mode, in ms (0: not sent in that mode)
+uint32_t hk_sched_period_ms(HkParamId_t id, SystemMode_t mode);
+const char *hk_param_name(HkParamId_t id);
+
+// Ground side. Returns PKT_SCHEMA_OK, PKT_SCHEMA_BAD_LENGTH or PKT_SCHEMA_BAD_CRC.
+int hk_samples_unpack(const uint8_t *frame, size_t len, HkSampleSet_t *set);
+
+#endif // HK_SCHED_H
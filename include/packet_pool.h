@@ -0,0 +1,107 @@
+// include/packet_pool.h
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "spsc_ring.h"
+
+// --- Fixed-size packet buffer pool with ownership handoff ---
+// Producers fill a slot in place and submit it; consumers receive a pointer
+// to the same slot and release it when done. Only slot pointers travel
+// through the kernel queues, so packets are never copied on the way.
+//
+//   Producer:  pkt = packet_pool_alloc(&pool);  fill *pkt;  packet_pool_submit(&pool, pkt);
+//   Consumer:  pkt = packet_pool_receive(&pool, timeout);  use *pkt;  packet_pool_release(&pool, pkt);
+//
+// A pool between exactly one producer task and one consumer task on
+// different cores is set up with packet_pool_init_spsc() instead: the slot
+// pointers then travel over two lock-free rings (spsc_ring.h), and neither
+// side makes a kernel call or takes a lock except to wake the consumer.
+
+// Largest cross-core pool (ring entries are a power of two)
+#define PACKET_POOL_SPSC_MAX_SLOTS  16
+
+// Largest pool of either kind (one ownership flag per slot)
+#define PACKET_POOL_MAX_SLOTS       64
+
+// What packet_pool_alloc() does when every slot is in use
+typedef enum {
+    POOL_DROP_OLDEST,   // Reclaim the oldest submitted packet the consumer has not taken yet
+    POOL_DROP_NEWEST,   // Fail the allocation; the new packet is not produced
+    POOL_BLOCK          // Wait up to block_timeout for the consumer to release a slot
+} PoolPolicy_t;
+
+typedef struct {
+    uint32_t allocations;       // Successful packet_pool_alloc() calls
+    uint32_t alloc_failures;    // Allocations that returned NULL
+    uint32_t dropped_oldest;    // Submitted packets reclaimed under POOL_DROP_OLDEST
+    uint32_t bad_releases;      // Releases ignored: foreign slot, or one already free
+    uint16_t in_use;            // Slots currently owned by a producer, queued or owned by a consumer
+    uint16_t high_water;        // Maximum value in_use has ever reached
+} PoolStats_t;
+
+typedef struct {
+    const char *name;
+    uint8_t *storage;           // slot_count * slot_size bytes, provided by the caller
+    size_t slot_size;
+    uint16_t slot_count;
+    PoolPolicy_t policy;
+    TickType_t block_timeout;   // Only used by POOL_BLOCK
+
+    QueueHandle_t free_slots;   // Pointers to slots nobody owns
+    QueueHandle_t ready_slots;  // Pointers submitted to the consumer, oldest first
+    TaskHandle_t consumer;      // Notified on every submit, if set
+
+    // Cross-core pools: the same two lists as rings. The producer keeps
+    // `stats` on its own; the consumer only counts its releases.
+    uint8_t spsc;
+    SpscRing_t free_ring;       // Consumer -> producer
+    SpscRing_t ready_ring;      // Producer -> consumer
+    void *ring_storage[2][PACKET_POOL_SPSC_MAX_SLOTS];
+    uint32_t releases;
+
+    // Set while a slot sits on the free list: a second release is refused
+    uint8_t slot_free[PACKET_POOL_MAX_SLOTS];
+
+    PoolStats_t stats;
+    portMUX_TYPE stats_mux;
+} PacketPool_t;
+
+// Creates the two pointer queues and puts every slot on the free list.
+// Refuses more than PACKET_POOL_MAX_SLOTS slots.
+BaseType_t packet_pool_init(PacketPool_t *pool, const char *name,
+                            void *storage, size_t slot_size, uint16_t slot_count,
+                            PoolPolicy_t policy, TickType_t block_timeout);
+
+// Cross-core pool for one producer task and one consumer task. POOL_BLOCK is
+// refused (the producer would have to wait on the other core), and so is a
+// slot_count above PACKET_POOL_SPSC_MAX_SLOTS.
+BaseType_t packet_pool_init_spsc(PacketPool_t *pool, const char *name,
+                                 void *storage, size_t slot_size, uint16_t slot_count,
+                                 PoolPolicy_t policy);
+
+// Producer side
+void *packet_pool_alloc(PacketPool_t *pool);
+BaseType_t packet_pool_submit(PacketPool_t *pool, void *slot);
+
+// Consumer side. A consumer that waits on its task notification (to wake on
+// other events too) registers itself and then drains with a zero timeout.
+// A cross-core pool can only wait in packet_pool_receive() for the
+// registered consumer.
+void packet_pool_set_consumer(PacketPool_t *pool, TaskHandle_t task);
+void *packet_pool_receive(PacketPool_t *pool, TickType_t timeout);
+
+// Returns the slot to the free list. A pointer that is not a slot of this
+// pool, or a slot that is already free, is ignored and counted in
+// bad_releases.
+void packet_pool_release(PacketPool_t *pool, void *slot);
+
+// Consistent copy of the counters
+void packet_pool_get_stats(PacketPool_t *pool, PoolStats_t *stats);
+
+#endif // PACKET_POOL_H
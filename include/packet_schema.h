@@ -0,0 +1,105 @@
+// include/packet_schema.h
+
+#ifndef PACKET_SCHEMA_H
+#define PACKET_SCHEMA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "satellite_types.h"
+
+// --- Wire layouts of the HK telemetry and telecommand user data ---
+// Each layout is written once below as an X-macro list of (field, wire type).
+// The list expands into the byte offsets, the big-endian pack/unpack routines
+// in packet_schema.c and the ground decoder in tools/tm_decode.c. Structs are
+// never cast to bytes: a field's place on the wire does not depend on the
+// compiler, and the CRC-16 is computed over the wire bytes.
+//
+// Wire types:
+//   U8, U16, U32   unsigned, big-endian
+//   I16            two's complement, big-endian (HK sample sets, hk_sched.h)
+//   F32            IEEE-754 single, bit pattern big-endian
+//   FLAGS          HK_StatusFlags_t as one byte (HK_FLAG_* below)
+//   BYTES8         8 raw bytes
+//
+// The CRC-16 CCITT of everything before it follows the last field.
+
+#define HK_TM_SCHEMA(X)                 \
+    X(timestamp,        U32)            \
+    X(sequence_count,   U16)            \
+    X(status_flags,     FLAGS)          \
+    X(bus_voltage,      F32)            \
+    X(ext_temp_c,       F32)
+
+#define TC_SCHEMA(X)                    \
+    X(timestamp,        U32)            \
+    X(command_id,       U8)             \
+    X(payload,          BYTES8)
+
+#define WIRE_SIZE_U8        1
+#define WIRE_SIZE_U16       2
+#define WIRE_SIZE_U32       4
+#define WIRE_SIZE_I16       2
+#define WIRE_SIZE_F32       4
+#define WIRE_SIZE_FLAGS     1
+#define WIRE_SIZE_BYTES8    8
+#define WIRE_CRC_LEN        2
+
+// --- Field offsets ---
+// Each field starts one byte after the previous field's last byte:
+// HK_TM_OFF_<field>, then HK_TM_OFF_crc and HK_TM_WIRE_LEN (same for TC_).
+#define HK_TM_OFFSET(name, type) \
+    HK_TM_OFF_##name, HK_TM_LAST_##name = HK_TM_OFF_##name + WIRE_SIZE_##type - 1,
+#define TC_OFFSET(name, type) \
+    TC_OFF_##name, TC_LAST_##name = TC_OFF_##name + WIRE_SIZE_##type - 1,
+
+enum {
+    HK_TM_SCHEMA(HK_TM_OFFSET)
+    HK_TM_OFF_crc,
+    HK_TM_WIRE_LEN = HK_TM_OFF_crc + WIRE_CRC_LEN
+};
+
+enum {
+    TC_SCHEMA(TC_OFFSET)
+    TC_OFF_crc,
+    TC_WIRE_LEN = TC_OFF_crc + WIRE_CRC_LEN
+};
+
+// --- Status flag byte ---
+#define HK_FLAG_LOW_VOLTAGE     0x01u
+#define HK_FLAG_ANTENNA_ARMED   0x02u
+#define HK_FLAG_MODE_SHIFT      2
+#define HK_FLAG_MODE_MASK       0x1Cu
+#define HK_FLAG_RESET_PENDING   0x20u
+#define HK_FLAG_RESERVED_SHIFT  6
+#define HK_FLAG_RESERVED_MASK   0xC0u
+
+uint8_t hk_flags_pack(const HK_StatusFlags_t *flags);
+void hk_flags_unpack(HK_StatusFlags_t *flags, uint8_t byte);
+
+// --- Serializers ---
+// pack writes exactly *_WIRE_LEN bytes, CRC included, and returns that length.
+// The CRC fields of the structs are ignored on pack.
+// unpack fills every field (crc from the wire) when the length is right, and
+// returns PKT_SCHEMA_OK, PKT_SCHEMA_BAD_LENGTH or PKT_SCHEMA_BAD_CRC.
+#define PKT_SCHEMA_OK           0
+#define PKT_SCHEMA_BAD_LENGTH   (-1)
+#define PKT_SCHEMA_BAD_CRC      (-2)
+
+size_t hk_tm_pack(const HK_Telemetry_t *pkt, uint8_t *wire);
+int hk_tm_unpack(const uint8_t *wire, size_t len, HK_Telemetry_t *pkt);
+
+size_t tc_pack(const TelecommandPacket_t *tc, uint8_t *wire);
+int tc_unpack(const uint8_t *wire, size_t len, TelecommandPacket_t *tc);
+
+// --- HK response (APID_HK_RESPONSE) ---
+// The answer to TC_REQUEST_HK: the requesting TC's timestamp (U32), so ground
+// can match it and time the round trip, then one HK record as above.
+#define HK_RESP_OFF_request_timestamp   0
+#define HK_RESP_OFF_record              WIRE_SIZE_U32
+#define HK_RESP_WIRE_LEN                (HK_RESP_OFF_record + HK_TM_WIRE_LEN)
+
+size_t hk_response_pack(uint32_t request_timestamp, const HK_Telemetry_t *pkt, uint8_t *wire);
+int hk_response_unpack(const uint8_t *wire, size_t len, uint32_t *request_timestamp,
+                       HK_Telemetry_t *pkt);
+
+#endif // PACKET_SCHEMA_H
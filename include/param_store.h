@@ -0,0 +1,106 @@
+// include/param_store.h
+
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Central housekeeping parameter store ---
+// Every value a producer publishes for the rest of the FSW lives here, in
+// groups with exactly one writer each (EPS monitor, mode manager, watchdog
+// monitor, command processor). A group is published as a unit under its own
+// seqlock: the writer opens it, sets its parameters and closes it, and the
+// group version goes up by one. Readers never lock: they copy a group and
+// retry if its sequence was odd or moved meanwhile, so what they get is one
+// publish of that group, never a mix of two.
+//
+// Each parameter remembers the group version that last changed its value, so
+// a reader holding the versions of an earlier snapshot can list what changed
+// since then. Versions are per group: two groups with different writers have
+// no common order, and a single store-wide counter would let a slow writer
+// publish "in the past" of a reader that already moved on.
+//
+// Table: X(name, group, type). A group's parameters must be contiguous.
+// Values are held as int32_t; U8/U16/I16 are clamped on write, U32 is stored
+// as its bit pattern (read it back through a uint32_t cast).
+
+#define PARAM_GROUP_TABLE(X)    \
+    X(EPS)                      \
+    X(MODE)                     \
+    X(WDT)                      \
+    X(TC)
+
+#define PARAM_TABLE(X)                                  \
+    X(eps_fault_code,           EPS,    U8)             \
+    X(eps_bus_mv,               EPS,    U16)            \
+    X(eps_bus_ewma_mv,          EPS,    U16)            \
+    X(eps_batch_min_mv,         EPS,    U16)            \
+    X(eps_batch_max_mv,         EPS,    U16)            \
+    X(eps_samples,              EPS,    U32)            \
+    X(eps_batches,              EPS,    U32)            \
+    X(eps_read_errors,          EPS,    U32)            \
+    X(eps_trips,                EPS,    U32)            \
+    X(eps_last_trip_tick,       EPS,    U32)            \
+    X(eps_filter_cycles_max,    EPS,    U32)            \
+    X(mode,                     MODE,   U8)             \
+    X(mode_generation,          MODE,   U32)            \
+    X(mode_since_tick,          MODE,   U32)            \
+    X(wdt_expiries,             WDT,    U32)            \
+    X(wdt_last_expired,         WDT,    U8)             \
+    X(tc_received,              TC,     U32)            \
+    X(tc_rejected,              TC,     U32)
+
+#define PARAM_GROUP_ID(group) PARAM_GROUP_##group,
+typedef enum {
+    PARAM_GROUP_TABLE(PARAM_GROUP_ID)
+    PARAM_GROUP_COUNT
+} ParamGroup_t;
+#undef PARAM_GROUP_ID
+
+#define PARAM_ID(name, group, type) PARAM_##name,
+typedef enum {
+    PARAM_TABLE(PARAM_ID)
+    PARAM_COUNT
+} ParamId_t;
+#undef PARAM_ID
+
+#define PARAM_WDT_NONE  0       // wdt_last_expired: task id + 1 of the last expiry
+
+// Version of every group at one point
+typedef struct {
+    uint32_t group[PARAM_GROUP_COUNT];
+} ParamVersion_t;
+
+typedef struct {
+    ParamVersion_t version;
+    int32_t value[PARAM_COUNT];
+    uint32_t changed[PARAM_COUNT];  // Group version that last changed the value (0: never set)
+} ParamSnapshot_t;
+
+// Checks the table layout and zeroes the store. Returns 0, or -1 if a group's
+// parameters are not contiguous. Call once before any task starts.
+int param_store_init(void);
+
+// --- Writer side (one writer per group) ---
+// The write runs inside the group's critical section, so a reader on the
+// same core can never spin on a writer it preempted. Keep it to the sets.
+void param_write_begin(ParamGroup_t group);
+void param_write(ParamId_t id, int32_t value);      // Only ids of the open group
+uint32_t param_write_end(ParamGroup_t group);       // Returns the new group version
+
+// --- Reader side (any task, never blocks) ---
+// Each copy is one publish of its group. Both return the seqlock retries it
+// took (0 when no writer got in the way).
+uint32_t param_read_group(ParamGroup_t group, ParamSnapshot_t *snap);
+uint32_t param_snapshot(ParamSnapshot_t *snap);     // Every group
+
+// Ids whose value changed after `since` (an earlier snapshot's versions), in
+// table order; returns how many, at most max_ids.
+size_t param_changed_since(const ParamSnapshot_t *snap, const ParamVersion_t *since,
+                           ParamId_t *ids, size_t max_ids);
+
+const char *param_name(ParamId_t id);
+ParamGroup_t param_group(ParamId_t id);
+
+#endif // PARAM_STORE_H
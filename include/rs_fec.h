@@ -0,0 +1,40 @@
+// include/rs_fec.h
+
+#ifndef RS_FEC_H
+#define RS_FEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Reed-Solomon (255,223) ---
+// CCSDS code parameters: GF(256) generated by x^8 + x^7 + x^2 + x + 1
+// (0x187), generator roots alpha^(11 * j) for j = 112 .. 143, conventional
+// (not dual-basis) symbol representation. 32 parity symbols correct any 16
+// wrong symbols of a codeword.
+//
+// Shortened codes (k < RS_K data symbols) behave as if the missing symbols
+// were leading zeros; they are never sent. Data and parity are read every
+// `stride` bytes, so interleaved codewords are coded where they lie:
+// codeword l of an interleave depth I block owns bytes l, l + I, l + 2I, ...
+//
+// Flight code only encodes. The decoder (Berlekamp-Massey, Chien search,
+// Forney) serves the ground tools, the host run and the tests.
+
+#define RS_N            255
+#define RS_K            223
+#define RS_PARITY       (RS_N - RS_K)
+#define RS_MAX_ERRORS   (RS_PARITY / 2)
+
+// Computes the RS_PARITY parity symbols of data[0], data[stride], ...
+// (k <= RS_K symbols) into parity[0], parity[stride], ...
+void rs_encode(const uint8_t *data, size_t k, size_t stride, uint8_t *parity);
+
+// Corrects a codeword of k data symbols followed by RS_PARITY parity symbols
+// (same stride) in place. Returns the symbols corrected, or -1 when there
+// were too many errors to correct (the codeword is left untouched).
+int rs_decode(uint8_t *codeword, size_t k, size_t stride);
+
+// GF(256) multiply on the same tables (the tests check the field with it)
+uint8_t rs_gf_mul(uint8_t a, uint8_t b);
+
+#endif // RS_FEC_H
@@ -0,0 +1,132 @@
+// include/rtos_alloc.h
+
+#ifndef RTOS_ALLOC_H
+#define RTOS_ALLOC_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "task_sizing.h"
+
+// --- Kernel object allocation and sizing profile ---
+// Every task, queue and mutex the FSW creates goes through these wrappers.
+// Build with -DFSW_STATIC_ALLOC=1 and they come from buffers fixed at link
+// time: task stacks and TCBs declared by main.c from task_sizing.h, queue
+// storage carved from one arena of RTOS_QUEUE_ARENA_BYTES. Boot then never
+// touches the heap, and an undersized arena fails the same way on every
+// boot instead of depending on fragmentation. Without the flag the plain
+// xTaskCreate / xQueueCreate / xSemaphoreCreateMutex are used.
+//
+// Each object is registered under its name, so a profiling run can report
+// stack and queue high-water marks and write a new task_sizing.h:
+//   host:   fsw_host --profile include/task_sizing.h   (exact queue peaks)
+//   target: build with -DFSW_PROFILE_SECONDS=N; after N s the RTOS_PROFILE
+//           task prints the header on the console (queue depths sampled
+//           every tick, so a lower bound).
+
+#ifndef FSW_STATIC_ALLOC
+#define FSW_STATIC_ALLOC 0
+#endif
+
+#ifndef FSW_PROFILE_SECONDS
+#define FSW_PROFILE_SECONDS 0
+#endif
+
+// --- Core placement ---
+// FSW_TASKS in main.c gives every task a core. The command path and FDIR
+// (router, TC processor and scheduler, subsystem hub, EPS monitor, HK
+// generator, watchdog) run on FSW_CORE_CONTROL, so archive writes, downlink
+// coding and log output on FSW_CORE_DATA never delay a command. The only
+// data crossing between them goes over SPSC rings (packet_pool_init_spsc).
+// -DFSW_CORE_PLAN=0 leaves every task to the scheduler instead. On a
+// single-core build every task is unpinned whatever the plan says.
+#ifndef FSW_CORE_PLAN
+#define FSW_CORE_PLAN       1
+#endif
+#ifndef FSW_CORE_CONTROL
+#define FSW_CORE_CONTROL    0
+#endif
+#ifndef FSW_CORE_DATA
+#define FSW_CORE_DATA       1
+#endif
+#define RTOS_CORE_ANY       (-1)
+
+#define RTOS_MAX_TASKS          16
+#define RTOS_MAX_QUEUES         16
+#define RTOS_MAX_MUTEXES        4
+#define RTOS_NAME_LEN           16
+
+// Sizing rule for the generated header: peak + 25% + 512 B, in 256 B steps
+#define RTOS_STACK_MARGIN_PCT   25
+#define RTOS_STACK_MARGIN_BYTES 512
+#define RTOS_STACK_ROUND        256
+#define RTOS_STACK_MIN          1536
+
+#ifndef RTOS_QUEUE_ARENA_BYTES
+#define RTOS_QUEUE_ARENA_BYTES  1024
+#endif
+
+#ifndef TASK_STACK_RTOS_PROFILE
+#define TASK_STACK_RTOS_PROFILE 3072
+#endif
+
+typedef struct {
+    char name[RTOS_NAME_LEN];
+    TaskHandle_t handle;
+    uint32_t stack_bytes;       // As created (ESP-IDF stack depths are in bytes)
+    uint32_t stack_peak;        // Deepest use seen so far
+    uint8_t is_static;
+    uint8_t deleted;            // Left through rtos_task_delete_self()
+    int8_t core;                // Pinned to, or RTOS_CORE_ANY
+} RtosTaskInfo_t;
+
+typedef struct {
+    char name[RTOS_NAME_LEN];   // Empty for internal queues (pool free lists)
+    QueueHandle_t handle;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t peak;           // Highest depth seen
+    uint8_t is_static;
+} RtosQueueInfo_t;
+
+typedef struct {
+    uint32_t tasks;
+    uint32_t queues;
+    uint32_t mutexes;
+    uint32_t static_objects;
+    uint32_t arena_used;        // Bytes of queue storage handed out
+    uint32_t arena_size;
+    uint32_t failures;          // Creations refused (pool, arena or kernel)
+} RtosAllocStats_t;
+
+// Task creation. With FSW_STATIC_ALLOC the caller passes its stack (at least
+// stack_bytes) and TCB; a NULL buffer is refused. Otherwise both must be NULL.
+// The task is pinned to `core` (RTOS_CORE_ANY: none) when FSW_CORE_PLAN is set.
+BaseType_t rtos_task_create(TaskFunction_t entry, const char *name, uint32_t stack_bytes,
+                            UBaseType_t priority, int core, StackType_t *stack, StaticTask_t *tcb);
+
+// A task that finishes its job calls this instead of vTaskDelete(NULL), so
+// its stack peak is kept after the handle goes away.
+void rtos_task_delete_self(void);
+
+// Queues and mutexes. The name also goes to the trace (NULL: not profiled).
+QueueHandle_t rtos_queue_create(const char *name, UBaseType_t length, UBaseType_t item_size);
+SemaphoreHandle_t rtos_mutex_create(const char *name);
+
+void rtos_alloc_get_stats(RtosAllocStats_t *stats);
+
+// --- Profile ---
+// rtos_profile_sample() updates every peak; the write function samples once
+// more, then prints the report as a ready-to-use task_sizing.h.
+void rtos_profile_sample(void);
+int rtos_profile_get_task(uint32_t index, RtosTaskInfo_t *info);
+int rtos_profile_get_queue(uint32_t index, RtosQueueInfo_t *info);
+uint32_t rtos_profile_recommend_stack(uint32_t peak_bytes);
+void rtos_profile_write_header(FILE *out, uint32_t seconds_profiled);
+
+void vRtosProfileTask(void *pvParameters);
+
+#endif // RTOS_ALLOC_H
@@ -6,27 +6,37 @@
 #include <stdint.h> // For uint8_t, uint16_t, etc.
 
 // --- I. TELEMETRY PACKET (TM) ---
-// The structure sent down to the ground station.
+// The structure sent down to the ground station. In-memory form only: the
+// wire layout is HK_TM_SCHEMA in packet_schema.h (17 bytes, big-endian).
+
+// Combined status of the C&DH and EPS (one byte on the wire, HK_FLAG_*)
+typedef struct {
+    unsigned int flg_low_voltage    : 1; // Bit 0: EPS fault flag
+    unsigned int flg_antenna_armed  : 1; // Bit 1: ADCS/Mechanisms status
+    unsigned int system_mode        : 3; // Bits 2-4: Current operating state (NOMINAL, SAFE, etc.)
+    unsigned int flg_reset_pending  : 1; // Bit 5: FDIR status
+    unsigned int reserved           : 2; // Bits 6-7: Spare
+} HK_StatusFlags_t;
+
 typedef struct {
-    uint32_t timestamp;         // 32 bits: Time of data acquisition
-    uint16_t sequence_count;    // 16 bits: Incremented with every TM packet
-
-    // Status Flags (8 bits total, using bit fields for efficiency)
-    // This is the combined status of the C&DH and EPS.
-    struct {
-        unsigned int flg_low_voltage    : 1; // Bit 0: EPS fault flag
-        unsigned int flg_antenna_armed  : 1; // Bit 1: ADCS/Mechanisms status
-        unsigned int system_mode        : 3; // Bits 2-4: Current operating state (NOMINAL, SAFE, etc.)
-        unsigned int flg_reset_pending  : 1; // Bit 5: FDIR status
-        unsigned int reserved           : 2; // Bits 6-7: Padding for 8-bit alignment
-    } status_flags;
-
-    float bus_voltage;          // 32 bits: Main battery voltage (from EPS)
-    float ext_temp_c;           // 32 bits: External temperature (from TCS)
-    
-    // Checksum must be the last field calculated over the *preceding* data.
-    uint16_t crc_checksum;      // 16 bits: CRC-16 check value
-} __attribute__((packed)) HK_Telemetry_t; // Total size: 14 bytes + 2 bytes for CRC = 16 bytes
+    uint32_t timestamp;         // Time of data acquisition
+    uint16_t sequence_count;    // Incremented with every TM packet
+    HK_StatusFlags_t status_flags;
+    float bus_voltage;          // Main battery voltage (from EPS)
+    float ext_temp_c;           // External temperature (from TCS)
+
+    // CRC-16 of the wire bytes before it; filled in by hk_tm_unpack()
+    uint16_t crc_checksum;
+} HK_Telemetry_t;
+
+// Answer to TC_REQUEST_HK, handed from the TM Generator to the logger's
+// priority lane (wire layout: hk_response_pack() in packet_schema.h)
+typedef struct {
+    uint32_t request_timestamp; // Timestamp of the requesting TC, echoed to ground
+    uint32_t request_us;        // When the TC was executed (latency start)
+    uint32_t request_tick;
+    HK_Telemetry_t hk;
+} HK_Response_t;
 
 // --- II. TELECOMMAND PACKET (TC) ---
 // The structure received from the ground station (Uplink).
@@ -45,33 +55,55 @@ typedef enum {
 } SystemMode_t;
 
 // --- III. EPS INTERNAL STATUS ---
-// Data passed internally from the EPS Task to the TM Generator Task via a Queue.
+// Published by the EPS monitor after every sample batch, as the EPS group of
+// the parameter store (param_store.h); eps_get_status() reads it back.
+// Fixed point throughout: voltages in mV.
+#define EPS_FAULT_NONE  0x00
+#define EPS_FAULT_UVLO  0x01
+
 typedef struct {
-    float state_of_charge;      // 32 bits: Remaining battery life (%)
-    float current_draw;         // 32 bits: Total system current draw
-    uint8_t fault_code;         // 8 bits: Detailed fault identifier (0x00=OK, 0x01=UVLO)
+    uint8_t fault_code;             // 8 bits: Detailed fault identifier (0x00=OK, 0x01=UVLO)
+    uint16_t bus_mv;                // Moving average at the end of the last batch
+    uint16_t bus_ewma_mv;
+    uint16_t batch_min_mv;          // Raw extremes of the last batch
+    uint16_t batch_max_mv;
+    uint32_t samples;
+    uint32_t batches;
+    uint32_t read_errors;
+    uint32_t undervoltage_events;   // OK -> UVLO transitions
+    uint32_t last_trip_tick;
+    uint32_t filter_cycles_max;     // Filter + FDIR cost of one batch
 } EPS_Status_t;
 
 // --- IV. Enumeration of Telecommand IDs ---
 typedef enum {
     TC_NO_OP,        // Command for testing connectivity (no operation)
     TC_SET_MODE,     // Command to change the system mode
-    TC_REQUEST_HK    // Command to request immediate Housekeeping Telemetry
+    TC_REQUEST_HK,   // Command to request immediate Housekeeping Telemetry
+    TC_SCHED_INSERT, // Queue a time-tagged command (see tc_scheduler.h for payload layouts)
+    TC_SCHED_DELETE, // Remove a queued command by id
+    TC_SCHED_LIST,   // Report queued commands in a time range
+    TC_REQUEST_SUMMARY, // Statistics of an archive window: [0..3] from, [4..7] to (ticks, big-endian)
+    TC_ID_COUNT      // Size of the TC handler table (tc_proc.c)
 } TelecommandID_t;
 
 // --- V. Telecommand Packet Structure ---
+// In-memory form; the wire layout is TC_SCHEMA in packet_schema.h (15 bytes,
+// command_id as one byte).
 typedef struct {
     uint32_t timestamp; 
     TelecommandID_t command_id;
     uint8_t payload[8]; // Simple payload for command arguments (e.g., the new mode value)
-    uint16_t crc;       // CRC-16 for integrity
-}__attribute__((packed)) TelecommandPacket_t;
+    uint16_t crc;       // CRC-16 of the wire bytes; filled in by tc_unpack()
+} TelecommandPacket_t;
 
 typedef enum {
     WDT_TASK_TM_GEN,
     WDT_TASK_CMD_PROC,
     WDT_TASK_EPS_MON,
     WDT_TASK_DATA_LOG,
+    WDT_TASK_ROUTER,
+    WDT_TASK_TC_SCHED,
     WDT_TASK_COUNT
 } WatchdogTaskID_t;
 
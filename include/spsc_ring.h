@@ -0,0 +1,44 @@
+// include/spsc_ring.h
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Lock-free single-producer / single-consumer pointer ring ---
+// Carries pointers from one task to one other task, typically on the other
+// core, without a kernel call or a critical section on either side: the
+// producer alone writes `head`, and the release store that publishes an
+// entry pairs with the consumer's acquire load. Both indices run freely and
+// are masked on use, so all `size` entries can be in flight.
+//
+// The one exception is spsc_ring_drop_oldest(): a producer that would
+// rather lose the oldest entry than the newest may take it back. To allow
+// that, `tail` moves by compare-and-swap, so the consumer and a dropping
+// producer never both get the same entry.
+
+typedef struct {
+    void **slots;               // size entries, provided by the caller
+    uint32_t mask;              // size - 1
+    uint32_t head;              // Entries ever pushed (producer)
+    uint32_t tail;              // Entries ever taken (consumer, or a dropping producer)
+} SpscRing_t;
+
+// size must be a power of two. Returns 0, or -1 on a bad size.
+int spsc_ring_init(SpscRing_t *ring, void **storage, uint32_t size);
+
+// Producer side: 0, or -1 when the ring is full
+int spsc_ring_push(SpscRing_t *ring, void *item);
+
+// Producer side: takes back the oldest entry the consumer has not taken yet
+// (NULL if there is none)
+void *spsc_ring_drop_oldest(SpscRing_t *ring);
+
+// Consumer side: the oldest entry, or NULL when the ring is empty
+void *spsc_ring_pop(SpscRing_t *ring);
+
+// Entries waiting; exact only from the producer or consumer task
+uint32_t spsc_ring_count(const SpscRing_t *ring);
+
+#endif // SPSC_RING_H
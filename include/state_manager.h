@@ -3,10 +3,63 @@
 #ifndef STATE_MANAGER_H
 #define STATE_MANAGER_H
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "satellite_types.h"
 
+#define MODE_MAX_SUBSCRIBERS    8
 
+// Consistent copy of the mode state block.
+typedef struct {
+    SystemMode_t mode;
+    uint32_t generation;            // Incremented on every successful transition
+    uint32_t last_transition_tick;  // Tick count when the current mode was entered
+} SystemModeSnapshot_t;
+
+// --- Mode-change bus ---
+// A subscribed task gets each transition in its own mailbox and is woken by
+// xTaskNotifyGive() as the mode is published, so it reacts in the same tick
+// instead of on its next poll. Transitions the task has not taken yet are
+// merged: old_mode stays the one it last saw and `coalesced` counts the
+// intermediate steps it missed.
+typedef struct {
+    SystemMode_t old_mode;
+    SystemMode_t new_mode;
+    uint32_t generation;
+    uint32_t tick;                  // When set_system_mode() published it
+    uint32_t time_us;               // util_get_time_us() at the same point
+    uint32_t coalesced;             // Transitions merged into this event
+} ModeChangeEvent_t;
+
+typedef struct {
+    uint32_t events;                // Events taken
+    uint32_t coalesced;             // Transitions merged before they were taken
+    uint32_t max_latency_ticks;     // Publish to mode_take_event(), worst case
+    uint32_t max_latency_us;
+} ModeSubscriberStats_t;
+
+// Resets the state block to MODE_SAFE, generation 0, or to the mode and
+// generation of the warm-restart checkpoint, and drops every subscription
+// (called once from app_main, after checkpoint_open()).
+void state_manager_init(void);
+
+// Registers `task` for mode changes and returns its subscriber id (-1 when
+// all MODE_MAX_SUBSCRIBERS are taken). *current is the mode at the moment of
+// subscribing, so no transition falls between the two.
+int mode_subscribe(TaskHandle_t task, SystemMode_t *current);
+
+// Non-blocking. Returns 1 and fills *event if a transition is pending.
+int mode_take_event(int subscriber, ModeChangeEvent_t *event);
+
+void mode_get_subscriber_stats(int subscriber, ModeSubscriberStats_t *stats);
+
+// Wait-free: a single atomic load, never touches xModeMutex.
 SystemMode_t get_system_mode(void);
-void set_system_mode(SystemMode_t new_mode);
 
-#endif // STATE_MANAGER_H
\ No newline at end of file
+// Lock-free: seqlock read of mode, generation and transition time together.
+void get_system_mode_snapshot(SystemModeSnapshot_t *snapshot);
+
+// Serialized by xModeMutex. Returns pdFAIL for an invalid mode or a busy mutex.
+BaseType_t set_system_mode(SystemMode_t new_mode);
+
+#endif // STATE_MANAGER_H
@@ -0,0 +1,19 @@
+// include/subsystem_hub.h
+
+#ifndef SUBSYSTEM_HUB_H
+#define SUBSYSTEM_HUB_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#define SUBSYSTEM_INBOX_DEPTH 4
+
+// Per-subsystem inboxes filled by the CDHS Router (CCSDS_Frame_t pointers)
+extern QueueHandle_t xAdcsQueue;
+extern QueueHandle_t xEpsQueue;
+extern QueueHandle_t xHkQueue;
+
+// Drains the ADCS/EPS/HK inboxes through a queue set and releases each frame.
+void vSubsystemHubTask(void *pvParameters);
+
+#endif // SUBSYSTEM_HUB_H
@@ -3,7 +3,25 @@
 #ifndef TASK_DEFS_H
 #define TASK_DEFS_H
 
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+#include "hk_sched.h"
+
+// Pending TC_REQUEST_HK answers the generator holds before it runs
+#define TM_GEN_REQUEST_DEPTH    4
+
+// Called by the TC handler: wakes the TM Generator, which builds a fresh HK
+// snapshot and sends it on the logger's priority lane (g_hk_response_pool),
+// past the archive. Answered in every mode. pdFAIL if requests are already
+// TM_GEN_REQUEST_DEPTH deep.
+BaseType_t tm_gen_request_hk(uint32_t request_timestamp);
+
+// Counters of the multi-rate HK scheduler (frames, bytes, why parameters went)
+void tm_gen_get_hk_stats(HkSchedStats_t *stats);
+
+// sequence_count the next HK packet will carry; survives warm restarts
+uint16_t tm_gen_get_hk_sequence(void);
 
 void vTelemetryGeneratorTask(void *pvParameters);
 
-#endif // TASK_DEFS_H
\ No newline at end of file
+#endif // TASK_DEFS_H
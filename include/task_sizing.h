@@ -0,0 +1,24 @@
+// include/task_sizing.h
+// Stack sizes for the FSW tasks (bytes) and the static queue arena. Replace
+// with the output of a profiling run (see rtos_alloc.h) rather than by hand.
+// Stacks: the host profile of a mission day (peak + 25% + 512 B, rounded up
+// to 256 B), never below the hand-picked sizes until a target profile
+// shows the smaller value is enough.
+
+#ifndef TASK_SIZING_H
+#define TASK_SIZING_H
+
+#define TASK_STACK_WDT_MON          4608    // Host peak 3192 B
+#define TASK_STACK_CDHS_ROUTER      4096    // Host peak 440 B
+#define TASK_STACK_CMD_PROC         5376    // Host peak 3704 B
+#define TASK_STACK_TC_SCHED         3072    // Host peak 1816 B
+#define TASK_STACK_SUBSYS_HUB       2048    // Host peak 520 B
+#define TASK_STACK_EPS_MON          3072    // Host peak 2008 B
+#define TASK_STACK_TM_GEN           2048    // Host peak 904 B
+#define TASK_STACK_CMD_INJECT       2816    // Host peak 1768 B
+#define TASK_STACK_DATA_LOG         5120    // Host peak 3640 B
+#define TASK_STACK_LOG_DRAIN        5120    // Host peak 3576 B
+
+#define RTOS_QUEUE_ARENA_BYTES      1024
+
+#endif // TASK_SIZING_H
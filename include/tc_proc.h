@@ -3,12 +3,61 @@
 #ifndef TC_PROC_H
 #define TC_PROC_H
 
+#include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "satellite_types.h"
 
+// --- Queue sizing ---
+// xCommandQueue holds CCSDS_Frame_t pointers from the CDHS Router. The task
+// wakes on the first arrival and drains up to TC_PROC_BATCH_MAX before
+// petting the watchdog again.
+#define TC_PROC_QUEUE_DEPTH     16
+#define TC_PROC_BATCH_MAX       8
+#define TC_PROC_IDLE_WAKE_MS    1000    // Wake-up without traffic, for the watchdog only
+
+// --- Command handler table ---
+// One entry per TelecommandID_t. validate() runs after the CRC check and
+// returns 0 if the payload is acceptable; NULL means any payload is.
+// Register before the scheduler starts: the table is not locked.
+typedef int (*TcValidateFn_t)(const TelecommandPacket_t *tc);
+typedef void (*TcHandlerFn_t)(const TelecommandPacket_t *tc);
+
+BaseType_t tc_proc_register_handler(TelecommandID_t id, const char *name,
+                                    TcValidateFn_t validate, TcHandlerFn_t execute);
+
+// --- Telemetry surface ---
+// Latencies in microseconds:
+//   wait = router submit -> CRC checked   (queueing + routing)
+//   exec = CRC checked   -> handler returned
+typedef struct {
+    uint32_t executed;
+    uint32_t invalid_params;    // Rejected by the handler's validate()
+    uint32_t wait_max_us;
+    uint32_t wait_sum_us;       // Mean = wait_sum_us / (executed + invalid_params)
+    uint32_t exec_max_us;
+    uint32_t exec_sum_us;       // Mean = exec_sum_us / executed
+} TcCommandStats_t;
+
+typedef struct {
+    uint32_t received;          // TCs taken off xCommandQueue
+    uint32_t malformed;         // Wrong TC length inside the space packet (TC_WIRE_LEN)
+    uint32_t crc_failures;      // TC CRC mismatch (command id not trusted)
+    uint32_t unknown_id;        // No handler registered
+    uint32_t batches;
+    uint32_t batch_max;         // Most TCs drained in one wake-up
+    uint32_t queue_peak;        // Deepest xCommandQueue seen on wake-up
+    uint32_t queue_overflows;   // Dropped by the router because xCommandQueue was full
+} TcProcStats_t;
+
+void tc_proc_get_stats(TcProcStats_t *stats);
+BaseType_t tc_proc_get_command_stats(TelecommandID_t id, TcCommandStats_t *stats);
 
 void vCommandProcessorTask(void *pvParameters);
 
+// Serializes the TC and runs it through the same checks as an uplinked one
+// (used by the TC scheduler)
+void process_telecommand(const TelecommandPacket_t *tc_packet);
+
 void vTC_SetSystemMode(int new_mode);
 
-#endif // TC_PROC_H
\ No newline at end of file
+#endif // TC_PROC_H
@@ -0,0 +1,54 @@
+// include/tc_scheduler.h
+
+#ifndef TC_SCHEDULER_H
+#define TC_SCHEDULER_H
+
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "satellite_types.h"
+#include "tc_timeline.h"
+
+// --- Time-tagged command scheduler ---
+// Command_t.execution_time is in FreeRTOS ticks. vTcSchedulerTask sleeps on
+// its task notification until the earliest deadline (or an insert/delete
+// that changes it), then runs every due command through process_telecommand().
+//
+// Ground interface (TelecommandPacket_t.payload, multi-byte fields big-endian):
+//   TC_SCHED_INSERT  [0] command id  [1..4] execution time  [5..7] parameters
+//   TC_SCHED_DELETE  [0..1] id returned on insert
+//   TC_SCHED_LIST    [0..3] from     [4..7] to
+
+#define TC_SCHED_MAX_SLEEP_MS   5000    // Longest sleep, keeps the watchdog fed
+#define TC_SCHED_LIST_MAX       16      // Entries reported per TC_SCHED_LIST
+#define TC_SCHED_CHECKPOINT_MAX 32      // Earliest commands kept across a warm restart
+
+typedef struct {
+    uint32_t inserted;
+    uint32_t rejected_full;
+    uint32_t deleted;
+    uint32_t fired;
+    uint32_t fired_late;        // Dispatched one tick or more after execution_time
+    uint32_t corrupt;           // Stored command failed its checksum before dispatch
+    uint32_t jitter_max_ticks;
+    uint32_t jitter_sum_ticks;  // Mean = jitter_sum_ticks / fired
+    uint16_t pending;
+    uint16_t restored;          // Commands taken over from the checkpoint at boot
+} TcSchedulerStats_t;
+
+// Also registers the TC_SCHED_* handlers with the TC processor and re-queues
+// the commands of the warm-restart checkpoint (they get new ids)
+BaseType_t tc_scheduler_init(void);
+
+// Queues a command (its checksum is filled in here). pdFAIL when full.
+BaseType_t tc_scheduler_insert(const Command_t *cmd, uint16_t *id);
+BaseType_t tc_scheduler_delete(uint16_t id);
+size_t tc_scheduler_list(uint32_t from, uint32_t to, TcTimelineEntry_t *entries, size_t max_entries);
+void tc_scheduler_get_stats(TcSchedulerStats_t *stats);
+
+// TC handlers for TC_SCHED_INSERT / TC_SCHED_DELETE / TC_SCHED_LIST
+void tc_scheduler_handle_telecommand(const TelecommandPacket_t *tc);
+
+void vTcSchedulerTask(void *pvParameters);
+
+#endif // TC_SCHEDULER_H
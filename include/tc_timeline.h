@@ -0,0 +1,70 @@
+// include/tc_timeline.h
+
+#ifndef TC_TIMELINE_H
+#define TC_TIMELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "satellite_types.h"   // Command_t
+
+// --- Time-tagged command store ---
+// Bounded binary min-heap of Command_t ordered by execution_time (ties keep
+// insertion order). Commands live in fixed slots; the heap only moves 16-bit
+// slot indices and a reverse map gives every slot's heap position, so:
+//   insert O(log n), delete-by-id O(log n), next-due O(1).
+//
+// Ids carry a generation byte, so the id of a command that already fired or
+// was deleted never matches the command that reuses its slot. No id is ever
+// TC_TIMELINE_INVALID_ID.
+// Times compare with wrap-around (valid within 2^31 ticks of each other).
+// Not thread-safe: the caller serializes access.
+
+#define TC_TIMELINE_CAPACITY    256
+#define TC_TIMELINE_INVALID_ID  0xFFFF
+
+typedef struct {
+    uint16_t id;
+    Command_t cmd;
+} TcTimelineEntry_t;
+
+typedef struct {
+    Command_t cmd[TC_TIMELINE_CAPACITY];
+    uint32_t order[TC_TIMELINE_CAPACITY];       // Insertion counter: FIFO for equal times
+    uint8_t generation[TC_TIMELINE_CAPACITY];
+    uint16_t heap[TC_TIMELINE_CAPACITY];        // Slot indices, heap-ordered
+    uint16_t pos[TC_TIMELINE_CAPACITY];         // Slot -> heap index
+    uint16_t free_slots[TC_TIMELINE_CAPACITY];
+    uint16_t count;
+    uint16_t free_count;
+    uint32_t next_order;
+} TcTimeline_t;
+
+void tc_timeline_init(TcTimeline_t *tl);
+
+// Returns 0 and the command id, -1 if the timeline is full
+int tc_timeline_insert(TcTimeline_t *tl, const Command_t *cmd, uint16_t *id);
+
+// Returns 0 if the command was pending and is now removed, -1 otherwise
+int tc_timeline_delete(TcTimeline_t *tl, uint16_t id);
+
+// Execution time of the earliest command. Returns 0 if there is one.
+int tc_timeline_next_time(const TcTimeline_t *tl, uint32_t *execution_time);
+
+// Removes the earliest command if it is due at `now`. Returns 1 with a
+// command, 0 if nothing is due yet.
+int tc_timeline_pop_due(TcTimeline_t *tl, uint32_t now, TcTimelineEntry_t *entry);
+
+// Copies pending commands with from <= execution_time <= to, in time order.
+// Returns how many were copied (at most max_entries).
+size_t tc_timeline_list(const TcTimeline_t *tl, uint32_t from, uint32_t to,
+                        TcTimelineEntry_t *entries, size_t max_entries);
+
+// Copies the `max_entries` earliest pending commands, in time order, without
+// looking at the rest of the heap. Returns how many were copied.
+size_t tc_timeline_earliest(const TcTimeline_t *tl, TcTimelineEntry_t *entries, size_t max_entries);
+
+static inline uint16_t tc_timeline_count(const TcTimeline_t *tl) {
+    return tl->count;
+}
+
+#endif // TC_TIMELINE_H
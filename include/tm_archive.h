@@ -0,0 +1,184 @@
+// include/tm_archive.h
+
+#ifndef TM_ARCHIVE_H
+#define TM_ARCHIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "flash_backend.h"
+
+// --- Log-structured telemetry archive ---
+// Records are batched in RAM into one page and programmed with a single
+// write. Pages fill sectors in order and sectors are reused round-robin, so
+// every sector sees the same number of erases. The oldest sector is erased
+// when the log wraps onto it.
+//
+// Page layout: | TmArchivePageHeader_t | record | record | ... | 0xFF padding |
+// Record:      | timestamp:32 | kind:4 length:12 | payload[length] |
+//
+// The kind is the writer's tag for what the payload is (the logger maps it
+// to an APID, see downlink.h); plain tm_archive_append() writes kind 0.
+//
+// An owner can reserve a fixed-size trailer at the end of every page
+// (tm_archive_set_trailer()). The archive asks the owner to fill it just
+// before the page is programmed, so it can describe exactly the records of
+// that page (tm_stats.h keeps per-page aggregates there). The trailer is
+// opaque to the archive and not covered by its CRCs; it carries its own.
+//
+// Mounting reads only page headers: the newest sector is the one with the
+// highest sequence number and the first erased header in it is the write
+// position. A per-sector RAM index (first sequence + first timestamp of its
+// first valid page) lets time queries binary-search sectors instead of
+// scanning the log.
+//
+// That search needs timestamps that never go back over the whole log, resets
+// included, so tick counts that restart at 0 on every boot cannot be used
+// as they are. The logger stamps records with archive time instead (see
+// data_logger_archive_time()), which starts each boot after the newest
+// record (tm_archive_last_timestamp()).
+
+#define TM_ARCHIVE_PAGE_SIZE        512
+#define TM_ARCHIVE_MAX_SECTORS      256
+#define TM_ARCHIVE_PAGE_MAGIC       0x31414D54u   // "TMA1"
+#define TM_ARCHIVE_RECORD_HDR_LEN   6
+#define TM_ARCHIVE_KIND_SHIFT       12
+#define TM_ARCHIVE_LENGTH_MASK      0x0FFFu
+#define TM_ARCHIVE_MAX_KIND         15
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;          // Global page sequence, starts at 1, never reused
+    uint32_t first_ts;
+    uint32_t last_ts;
+    uint16_t record_count;
+    uint16_t used_bytes;        // Record bytes after the header
+    uint16_t data_crc;          // CRC-16 over the record bytes
+    uint16_t header_crc;        // CRC-16 over the header fields above
+} TmArchivePageHeader_t;
+
+#define TM_ARCHIVE_MAX_RECORD \
+    (TM_ARCHIVE_PAGE_SIZE - sizeof(TmArchivePageHeader_t) - TM_ARCHIVE_RECORD_HDR_LEN)
+
+typedef struct {
+    uint32_t records_appended;
+    uint32_t bytes_appended;    // Payload bytes
+    uint32_t pages_written;
+    uint32_t sector_erases;
+    uint32_t write_errors;
+    uint32_t pages_recovered;   // Valid pages found by the last mount
+    uint32_t pages_corrupt;     // Torn or unreadable pages skipped by the last mount
+} TmArchiveStats_t;
+
+// Read position in the log; valid across flushes and other appends
+typedef struct {
+    uint32_t page;              // Absolute page number in the region
+    uint32_t sequence;          // Sequence of that page when the cursor was placed
+    uint16_t offset;            // Byte offset of the next record in the page
+    uint16_t record;            // Index of the next record in the page
+    uint8_t kind;               // Kind of the record tm_archive_read_next() last returned
+} TmArchiveCursor_t;
+
+// Fills the `len`-byte trailer of the page about to be programmed
+typedef void (*TmArchiveTrailerFn_t)(void *ctx, uint8_t *trailer, uint16_t len);
+
+typedef struct {
+    const FlashBackend_t *flash;
+    uint32_t sector_count;
+    uint32_t pages_per_sector;
+
+    // Write position: next page to program
+    uint32_t head_sector;
+    uint32_t head_page;
+    uint32_t next_sequence;
+    uint32_t last_ts;           // Newest timestamp written or buffered (recovered by mount)
+    uint8_t has_records;
+
+    // Sparse time index, one entry per sector (first_seq 0 = no data)
+    struct {
+        uint32_t first_seq;
+        uint32_t first_ts;
+    } index[TM_ARCHIVE_MAX_SECTORS];
+    uint8_t erased[TM_ARCHIVE_MAX_SECTORS];     // Known to be blank, no erase needed
+
+    // RAM page being filled
+    uint8_t page_buf[TM_ARCHIVE_PAGE_SIZE];
+    uint16_t page_used;
+    uint16_t page_records;
+    uint32_t page_first_ts;
+    uint32_t page_last_ts;
+
+    // Optional page trailer (last trailer_len bytes of every page)
+    uint16_t trailer_len;
+    TmArchiveTrailerFn_t trailer_fn;
+    void *trailer_ctx;
+
+    // Read cache: the page under the last cursor (one flash read per page)
+    uint8_t read_buf[TM_ARCHIVE_PAGE_SIZE];
+    uint32_t read_page;
+    uint32_t read_seq;
+    uint8_t read_valid;
+    uint8_t read_data_ok;
+
+    TmArchiveStats_t stats;
+} TmArchive_t;
+
+// Erases the whole region and starts an empty log
+int tm_archive_format(TmArchive_t *archive, const FlashBackend_t *flash);
+
+// Recovers the log after a reset or power cut by scanning page headers only
+int tm_archive_mount(TmArchive_t *archive, const FlashBackend_t *flash);
+
+// Buffers one record; programs the RAM page when the record does not fit.
+// Returns 0 once the record is buffered, -1 (nothing buffered) on an
+// oversize record or bad kind. A page that fails to program is dropped and
+// counted in stats.write_errors; the record that pushed it out is kept.
+// Timestamps must not be older than the newest record.
+int tm_archive_append(TmArchive_t *archive, uint32_t timestamp, const void *data, uint16_t length);
+int tm_archive_append_kind(TmArchive_t *archive, uint8_t kind, uint32_t timestamp,
+                           const void *data, uint16_t length);
+
+// Reserves a trailer of `len` bytes in every page programmed from now on.
+// Call after mount/format, before the first append. Records lose the same
+// number of bytes of maximum size. Returns -1 if the trailer would take more
+// than half the page.
+int tm_archive_set_trailer(TmArchive_t *archive, uint16_t len, TmArchiveTrailerFn_t fill, void *ctx);
+
+// Programs the partially filled RAM page so its records become readable
+int tm_archive_flush(TmArchive_t *archive);
+
+// Newest timestamp in the log, RAM page included; after a mount, the last
+// one of the newest page. Returns 0, or -1 if the log is empty.
+int tm_archive_last_timestamp(const TmArchive_t *archive, uint32_t *timestamp);
+
+// Places the cursor on the first stored record with timestamp >= `timestamp`.
+// Returns 0 if found, -1 if the archive holds nothing at or after that time.
+int tm_archive_seek(TmArchive_t *archive, uint32_t timestamp, TmArchiveCursor_t *cursor);
+
+// Reads the record under the cursor and advances it (its kind is left in
+// cursor->kind).
+// Returns 1 with a record, 0 at the end of the flushed log (the cursor stays
+// valid and continues once more pages are written), -1 if the data under the
+// cursor was overwritten or is corrupt.
+int tm_archive_read_next(TmArchive_t *archive, TmArchiveCursor_t *cursor,
+                         uint32_t *timestamp, void *buf, uint16_t buf_size, uint16_t *length);
+
+void tm_archive_get_stats(const TmArchive_t *archive, TmArchiveStats_t *stats);
+
+// --- Page-level access (downlink bookkeeping) ---
+// Pages are numbered 0 .. tm_archive_page_count()-1. In log order the oldest
+// page follows the write page and the newest one precedes it; erased and torn
+// pages in between are simply not valid.
+uint32_t tm_archive_page_count(const TmArchive_t *archive);
+uint32_t tm_archive_write_page(const TmArchive_t *archive);
+
+// Reads the header of a page holding live data and places the cursor on its
+// first record. Returns 0 if the page is valid, -1 otherwise.
+int tm_archive_open_page(TmArchive_t *archive, uint32_t page,
+                         TmArchivePageHeader_t *hdr, TmArchiveCursor_t *cursor);
+
+// Reads the header and the trailer (archive->trailer_len bytes) of a page
+// holding live data. Returns 0 if the page is valid, -1 otherwise.
+int tm_archive_read_trailer(TmArchive_t *archive, uint32_t page,
+                            TmArchivePageHeader_t *hdr, void *trailer);
+
+#endif // TM_ARCHIVE_H
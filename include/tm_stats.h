@@ -0,0 +1,145 @@
+// include/tm_stats.h
+
+#ifndef TM_STATS_H
+#define TM_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hk_sched.h"
+#include "tm_archive.h"
+
+// --- On-board telemetry statistics ---
+// Runs next to the archive on every HK sample set the logger stores. Each
+// parameter of TM_STATS_TABLE gets count, min, max, sum and sum of squares
+// (mean and variance), limit violations and a histogram. A sample costs O(1)
+// and the memory is fixed.
+//
+// The aggregates of the records in the archive's RAM page are written into
+// that page's trailer when it is programmed (tm_archive_set_trailer()), then
+// restart from zero. A summary of any past window merges the trailers of the
+// pages that overlap it, plus the page still in RAM. That is one short flash
+// read per page, and no record is decoded again. The window is rounded out to
+// whole pages; the summary says which span it covers.
+//
+// Table: X(name, HK parameter, low limit, high limit, histogram base, bin width)
+// A sample is a violation below `low` or above `high`. Bin 0 counts samples
+// below base + width and the last bin everything from
+// base + (TM_STATS_HIST_BINS - 1) * width up.
+// Statistics parameters are 16-bit HK parameters (U16/I16 wire types).
+
+#define TM_STATS_TABLE(X)                                           \
+    X(bus_mv,       bus_mv,        2700,  3600,  2400,  150)        \
+    X(bus_min_mv,   bus_min_mv,    2500,  3600,  2400,  150)        \
+    X(ext_temp_cc,  ext_temp_cc,  -2000,  6000, -4000, 1500)
+
+#define TM_STATS_HIST_BINS      8
+
+#define TM_STATS_ID(name, hk, low, high, base, width) TM_STAT_##name,
+typedef enum {
+    TM_STATS_TABLE(TM_STATS_ID)
+    TM_STATS_COUNT
+} TmStatId_t;
+#undef TM_STATS_ID
+
+typedef struct {
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint64_t sum_sq;
+    uint32_t below;             // Samples under the low limit
+    uint32_t above;             // Samples over the high limit
+    uint32_t hist[TM_STATS_HIST_BINS];
+} TmStatsAgg_t;
+
+// Page trailer, big-endian: | stats:8 | per stat: count:16 min:16 max:16
+// sum:32 sum_sq:64 below:8 above:8 hist:8 x BINS | CRC-16:16 |
+// Per-page counts are bounded by the records a page holds, so the narrow
+// fields cannot overflow.
+#define TM_STATS_PAGE_STAT_LEN  (2 + 2 + 2 + 4 + 8 + 1 + 1 + TM_STATS_HIST_BINS)
+#define TM_STATS_TRAILER_LEN    (1 + TM_STATS_COUNT * TM_STATS_PAGE_STAT_LEN + 2)
+
+// Summary frame (APID_TM_SUMMARY), big-endian:
+// | request_ts:32 | first_ts:32 | last_ts:32 | pages:16 | pages_missing:16 |
+// per stat: | count:32 | min:16 | max:16 | mean:16 | stddev:16 | below:16 |
+//           | above:16 | hist:8 x BINS |
+// | CRC-16:16 |
+// mean and stddev are rounded to the parameter's units; 16-bit counts saturate.
+// A histogram bin is its share of count in 1/255ths, which keeps the frame
+// inside one space packet (CCSDS_MAX_PACKET_LEN).
+#define TM_SUMMARY_HDR_LEN      16
+#define TM_SUMMARY_STAT_LEN     (4 + 2 * 6 + TM_STATS_HIST_BINS)
+#define TM_SUMMARY_WIRE_LEN     (TM_SUMMARY_HDR_LEN + TM_STATS_COUNT * TM_SUMMARY_STAT_LEN + 2)
+
+typedef struct {
+    uint32_t first_ts;          // Span actually covered (whole pages)
+    uint32_t last_ts;
+    uint32_t pages;             // Page aggregates merged, the RAM page included
+    uint32_t pages_missing;     // Overlapping pages without a valid trailer
+    TmStatsAgg_t stat[TM_STATS_COUNT];
+} TmStatsSummary_t;
+
+typedef struct {
+    // Aggregates of the records in the archive's RAM page
+    TmStatsAgg_t page[TM_STATS_COUNT];
+    uint32_t page_first_ts;
+    uint32_t page_last_ts;
+    uint32_t page_sets;
+
+    uint32_t sets;              // Sample sets added since init
+    uint32_t trailers;          // Page trailers written
+} TmStats_t;
+
+void tm_stats_init(TmStats_t *stats);
+
+// Adds the statistics parameters present in one sample set (the set as it
+// was archived, timestamp included)
+void tm_stats_add(TmStats_t *stats, const HkSampleSet_t *set);
+
+// TmArchiveTrailerFn_t: packs the page aggregates and starts a new page.
+// Install with tm_archive_set_trailer(archive, TM_STATS_TRAILER_LEN, tm_stats_fill_trailer, stats).
+void tm_stats_fill_trailer(void *ctx, uint8_t *trailer, uint16_t len);
+
+// Returns PKT_SCHEMA_OK, PKT_SCHEMA_BAD_LENGTH or PKT_SCHEMA_BAD_CRC
+int tm_stats_unpack_trailer(const uint8_t *trailer, size_t len, TmStatsAgg_t stat[TM_STATS_COUNT]);
+
+// Merges every page that overlaps [from, to] (inclusive, archive timestamps).
+// Returns 0, or -1 when nothing in the archive overlaps the window.
+int tm_stats_query(TmStats_t *stats, TmArchive_t *archive, uint32_t from, uint32_t to,
+                   TmStatsSummary_t *summary);
+
+void tm_stats_merge(TmStatsAgg_t *into, const TmStatsAgg_t *from);
+
+// Mean and standard deviation in the parameter's units (0 when empty)
+double tm_stats_mean(const TmStatsAgg_t *agg);
+double tm_stats_stddev(const TmStatsAgg_t *agg);
+
+const char *tm_stats_name(TmStatId_t id);
+
+// Summary frame as the ground decodes it
+typedef struct {
+    uint32_t count;
+    int16_t min;
+    int16_t max;
+    int16_t mean;
+    uint16_t stddev;
+    uint16_t below;
+    uint16_t above;
+    uint8_t hist[TM_STATS_HIST_BINS];     // Share of count, 255 = all
+} TmSummaryStat_t;
+
+typedef struct {
+    uint32_t request_ts;        // Timestamp of the TC that asked for it
+    uint32_t first_ts;
+    uint32_t last_ts;
+    uint16_t pages;
+    uint16_t pages_missing;
+    TmSummaryStat_t stat[TM_STATS_COUNT];
+} TmSummaryFrame_t;
+
+// pack writes TM_SUMMARY_WIRE_LEN bytes and returns that length. unpack
+// returns PKT_SCHEMA_OK, PKT_SCHEMA_BAD_LENGTH or PKT_SCHEMA_BAD_CRC.
+size_t tm_summary_pack(uint32_t request_ts, const TmStatsSummary_t *summary, uint8_t *wire);
+int tm_summary_unpack(const uint8_t *wire, size_t len, TmSummaryFrame_t *frame);
+
+#endif // TM_STATS_H
@@ -0,0 +1,93 @@
+// include/trace.h
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Binary event trace ---
+// Build with -DFSW_TRACE=1 to record compact events into one ring per core;
+// otherwise every TRACE_* macro compiles to nothing. Recording is lock-free
+// (one atomic increment claims a slot) and the oldest events are overwritten.
+// trace_dump() writes the rings out; tools/trace_decode.c turns the dump into
+// a timeline and a per-task CPU / latency summary.
+
+#ifndef FSW_TRACE
+#define FSW_TRACE 0
+#endif
+
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS   1024        // Per core, power of two
+#endif
+#define TRACE_MAX_NAMES     32
+#define TRACE_NAME_LEN      12
+#define TRACE_DUMP_MAGIC    0x54575346u // "FSWT"
+#define TRACE_DUMP_VERSION  1
+
+typedef enum {
+    TRACE_TASK_START = 1,   // object: -               (names the task)
+    TRACE_TASK_WAKE,        // object: what it waited on
+    TRACE_TASK_SLEEP,       // object: what it waits on (NULL for a delay)
+    TRACE_QUEUE_SEND,       // object: queue   arg: depth after the send
+    TRACE_QUEUE_RECEIVE,    // object: queue   arg: depth after the receive
+    TRACE_QUEUE_FULL,       // object: queue
+    TRACE_MUTEX_TAKE,       // object: mutex
+    TRACE_MUTEX_GIVE,       // object: mutex
+    TRACE_MUTEX_TIMEOUT,    // object: mutex
+    TRACE_WDT_PET,          // arg: WatchdogTaskID_t
+    TRACE_MODE_CHANGE,      // arg: new SystemMode_t
+    TRACE_EVENT_TYPE_COUNT
+} TraceEventType_t;
+
+// One event, 16 bytes. Tasks and objects are identified by the low 32 bits
+// of their handle; the dump carries the names registered for them.
+typedef struct {
+    uint32_t cycles;        // util_get_cycle_count() of the recording core
+    uint32_t task;
+    uint32_t object;
+    uint8_t type;           // TraceEventType_t
+    uint8_t core;
+    uint16_t arg;
+} TraceEvent_t;
+
+// --- Dump layout (little-endian, as recorded) ---
+//   TraceDumpHeader_t
+//   TraceName_t      names[name_count]
+//   per core: uint32_t head (events ever recorded), TraceEvent_t events[ring_events]
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t cores;
+    uint8_t name_count;
+    uint32_t ring_events;
+    uint32_t cycles_per_us;
+} TraceDumpHeader_t;
+
+typedef struct {
+    uint32_t id;
+    char name[TRACE_NAME_LEN];
+} TraceName_t;
+
+typedef int (*TraceWriteFn_t)(void *ctx, const void *data, size_t len);
+
+void trace_init(void);
+void trace_name(const void *handle, const char *name);
+void trace_task_start(void);
+void trace_record(TraceEventType_t type, const void *object, uint16_t arg);
+void trace_set_enabled(int enabled);    // Freeze the rings before a dump
+int trace_dump(TraceWriteFn_t write, void *ctx);
+
+#if FSW_TRACE
+#define TRACE_INIT()                    trace_init()
+#define TRACE_NAME(handle, name)        trace_name((handle), (name))
+#define TRACE_TASK_START()              trace_task_start()
+#define TRACE_EVENT(type, object, arg)  trace_record((type), (object), (uint16_t)(arg))
+#else
+#define TRACE_INIT()                    ((void)0)
+#define TRACE_NAME(handle, name)        ((void)0)
+#define TRACE_TASK_START()              ((void)0)
+#define TRACE_EVENT(type, object, arg)  ((void)0)
+#endif
+
+#endif // TRACE_H
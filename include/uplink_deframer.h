@@ -0,0 +1,125 @@
+// include/uplink_deframer.h
+
+#ifndef UPLINK_DEFRAMER_H
+#define UPLINK_DEFRAMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ccsds_packet.h"
+
+// --- Uplink frame synchronizer / deframer ---
+// The radio delivers a raw bit stream: idle fill, then space packets each
+// preceded by the 32-bit Attached Sync Marker. Bytes land in a ring buffer
+// (DMA or UART FIFO style) and the deframer finds the markers, follows the
+// packets and hands every packet whose CRC checks out to a callback, still
+// inside the ring. Nothing is copied on the way.
+//
+//   Producer (driver):  p = uplink_deframer_rx_reserve(&d, &n);  fill p[0..k);  uplink_deframer_rx_commit(&d, k);
+//   Consumer (task):    uplink_deframer_poll(&d);   -> on_packet(ctx, view) for each valid packet
+//
+// One producer and one consumer; they share only the two ring indices.
+//
+// Sync: the marker may start at any bit. It is searched a 32-bit word at a
+// time, all 32 alignments at once, accepting up to max_asm_errors wrong bits. Once locked the deframer
+// expects the next marker right after each packet and only looks
+// +/- slip_window_bits around that spot, so a slipped bit costs no packet.
+// The CRC runs as the bytes arrive; packets that arrived off byte alignment
+// are shifted into place in the ring just before the handoff.
+
+#define UPLINK_ASM              CCSDS_ASM
+#define UPLINK_ASM_LEN          CCSDS_ASM_LEN
+#define UPLINK_MAX_ASM_ERRORS   3
+#define UPLINK_MAX_SLIP_BITS    7
+
+typedef struct {
+    uint8_t max_asm_errors;     // Wrong marker bits still accepted, 0..UPLINK_MAX_ASM_ERRORS
+    uint8_t slip_window_bits;   // Re-lock search around the expected marker, 0..UPLINK_MAX_SLIP_BITS
+    uint16_t max_packet_len;    // Longest space packet accepted, CRC included
+} UplinkDeframerConfig_t;
+
+typedef struct {
+    uint32_t bytes_in;          // Committed by the producer
+    uint32_t overrun_bytes;     // Offered while the ring was full (lost)
+    uint32_t packets;           // Handed to the callback
+    uint32_t acquisitions;      // Markers found while hunting
+    uint32_t asm_corrected;     // Markers accepted with bit errors
+    uint32_t bit_slips;         // Markers found off the expected bit, lock kept
+    uint32_t sync_losses;       // Expected marker missing: back to hunting
+    uint32_t header_errors;     // Marker followed by an impossible header
+    uint32_t crc_failures;
+} UplinkDeframerStats_t;
+
+// A validated packet inside the ring. seg[1] is only used when the packet
+// wraps the end of the ring. Valid until the callback returns.
+typedef struct {
+    const uint8_t *seg[2];
+    uint16_t seg_len[2];
+    uint16_t length;            // seg_len[0] + seg_len[1], CRC included
+    uint8_t bit_offset;         // Alignment it arrived with
+    uint8_t asm_errors;
+} UplinkPacketView_t;
+
+typedef void (*UplinkPacketFn_t)(void *ctx, const UplinkPacketView_t *packet);
+
+typedef enum {
+    DEFRAMER_HUNT,              // Searching for a marker anywhere
+    DEFRAMER_PACKET,            // Following a packet after its marker
+    DEFRAMER_CHECK              // Expecting the next marker right after the last packet
+} UplinkDeframerState_t;
+
+typedef struct {
+    // Ring (power of two). head is written by the producer, tail by the
+    // consumer; both are free-running byte counters.
+    uint8_t *ring;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t tail;
+
+    UplinkDeframerConfig_t cfg;
+    UplinkPacketFn_t on_packet;
+    void *ctx;
+    UplinkDeframerState_t state;
+
+    // Hunt: pos is the next byte to load, window the last bits loaded
+    uint32_t pos;
+    uint64_t window;
+    uint32_t window_bits;
+    uint32_t skip_byte;         // After a rejected packet: ignore markers whose
+    uint8_t skip_bit;           // packet starts at or before (skip_byte, skip_bit)
+    uint8_t skip_active;
+
+    // Packet in progress (or, in CHECK, the one just delivered)
+    uint32_t start;             // Byte holding its first bit
+    uint8_t bit;                // Bit offset of its first bit, 0..7 from the MSB
+    uint8_t asm_errors;
+    uint16_t length;            // 0 until the primary header is in
+    uint16_t crc_done;          // Bytes already in crc
+    uint16_t crc;
+    uint8_t last_raw;           // Byte before the expected marker as received
+
+    UplinkDeframerStats_t stats;
+} UplinkDeframer_t;
+
+// ring_size must be a power of two of at least 2 * max_packet_len.
+// Returns 0, or -1 on a bad configuration.
+int uplink_deframer_init(UplinkDeframer_t *d, uint8_t *ring, uint32_t ring_size,
+                         const UplinkDeframerConfig_t *cfg,
+                         UplinkPacketFn_t on_packet, void *ctx);
+
+// --- Producer side ---
+// Contiguous free span at the write index (*len may be 0 when the ring is full)
+uint8_t *uplink_deframer_rx_reserve(UplinkDeframer_t *d, size_t *len);
+void uplink_deframer_rx_commit(UplinkDeframer_t *d, size_t len);
+
+// Copying variant for byte-oriented drivers. Returns the bytes accepted; the
+// rest is counted as overrun.
+size_t uplink_deframer_rx_write(UplinkDeframer_t *d, const uint8_t *data, size_t len);
+
+// --- Consumer side ---
+// Processes everything committed so far. Returns the packets delivered.
+uint32_t uplink_deframer_poll(UplinkDeframer_t *d);
+
+// Counter snapshot (the caller serializes against the consumer)
+void uplink_deframer_get_stats(const UplinkDeframer_t *d, UplinkDeframerStats_t *stats);
+
+#endif // UPLINK_DEFRAMER_H
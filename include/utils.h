@@ -5,10 +5,17 @@
 
 #include <stdint.h>
 #include <stddef.h> // For size_t
+#include "crc16.h"  // CRC16_POLY, CRC16_INITIAL and the streaming CRC API
 
-#define CRC16_POLY 0x1021 
-#define CRC16_INITIAL 0xFFFF
-
+// One-shot CRC over a contiguous buffer (init -> update -> final).
 uint16_t crc16_ccitt(const uint8_t *data, size_t length);
 
-#endif // UTILS_H
\ No newline at end of file
+// Free-running CPU cycle counter for profiling short code sections.
+// Xtensa CCOUNT on target, TSC (or a ns clock) on host. Wraps; use unsigned deltas.
+uint32_t util_get_cycle_count(void);
+
+// Microsecond clock shared by both cores (esp_timer on target, CLOCK_MONOTONIC
+// on host), for latencies measured across tasks. Wraps after ~71 minutes.
+uint32_t util_get_time_us(void);
+
+#endif // UTILS_H
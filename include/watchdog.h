@@ -3,12 +3,83 @@
 #ifndef WATCHDOG_H
 #define WATCHDOG_H
 
+#include "freertos/FreeRTOS.h"
 #include "satellite_types.h" // Needed for WatchdogTaskID_t
 
+// --- Deadline-based software watchdog ---
+// Every supervised task has its own pet period and deadline. The monitor
+// sleeps until the earliest deadline and escalates any task that has not
+// pet by then; a task that pets again is supervised again.
+
+// What happens when a task misses its deadline
+typedef enum {
+    WDT_ACTION_LOG,         // Report only
+    WDT_ACTION_CRITICAL,    // Force MODE_CRITICAL
+    WDT_ACTION_RESTART      // Call the restart hook (MODE_CRITICAL if none is set)
+} WatchdogAction_t;
+
+typedef struct {
+    uint32_t period_ms;     // Nominal pet interval, the reference for jitter
+    uint32_t deadline_ms;   // Longest gap between pets before escalation
+    WatchdogAction_t action;
+} WatchdogConfig_t;
+
+typedef void (*WatchdogRestartHook_t)(WatchdogTaskID_t task_id);
+
+// Pet-interval statistics, in ticks. Intervals are only counted from the
+// second pet on, so the boot skew of each task is left out.
+typedef struct {
+    uint32_t pets;
+    uint32_t interval_min_ticks;
+    uint32_t interval_max_ticks;
+    uint32_t interval_sum_ticks;    // Mean = interval_sum_ticks / (pets - 1)
+    uint32_t jitter_max_ticks;      // Largest |interval - period|
+    uint32_t jitter_sum_ticks;
+    uint32_t slack_min_ticks;       // Closest a pet came to the deadline
+    uint32_t expiries;
+} WatchdogTaskStats_t;
+
+// --- Reset causes ---
+// Kept in the warm-restart checkpoint (checkpoint.h): the task that last
+// missed its deadline, and one entry per warm reset, newest first, telling
+// why the CPU restarted and which expiry, if any, preceded it.
+#define WATCHDOG_RESET_HISTORY  3
+
+typedef struct {
+    uint8_t reason;             // CheckpointReset_t
+    uint8_t last_expired;       // Task that last expired before the reset + 1 (0: none)
+    uint16_t reserved;
+    uint32_t boot;              // Boot that ended with this reset
+    uint32_t alive_tick;        // Its last sign of life
+} WatchdogResetEntry_t;
+
+typedef struct {
+    uint16_t last_expired;      // Task that last expired in this boot + 1 (0: none)
+    uint16_t count;             // Valid history entries
+    uint32_t warm_resets;       // Since power-on
+    WatchdogResetEntry_t history[WATCHDOG_RESET_HISTORY];
+} WatchdogResetLog_t;
+
+// Starts every deadline from now and clears the statistics (called once
+// from app_main, after checkpoint_open()). A warm reset is added to the
+// reset history.
+void watchdog_init(void);
+
+void watchdog_get_reset_log(WatchdogResetLog_t *log);
+
+BaseType_t watchdog_configure(WatchdogTaskID_t task_id, const WatchdogConfig_t *config);
+void watchdog_set_restart_hook(WatchdogRestartHook_t hook);
+
 // Public API for tasks to signal they are alive
 void watchdog_pet(WatchdogTaskID_t task_id);
 
+BaseType_t watchdog_get_stats(WatchdogTaskID_t task_id, WatchdogTaskStats_t *stats);
+
+// One supervision pass at `now`: escalates every task past its deadline and
+// returns the ticks until the next deadline (portMAX_DELAY if none is pending).
+TickType_t watchdog_check(TickType_t now);
+
 // Public API for FSW Initialization (called by main.c to launch the task)
 void vSoftwareWatchdogTask(void *pvParameters);
 
-#endif // WATCHDOG_H
\ No newline at end of file
+#endif // WATCHDOG_H
@@ -0,0 +1,78 @@
+// src/ccsds_packet.c
+
+#include "ccsds_packet.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+
+int ccsds_decode_primary(const uint8_t *buf, size_t len, CCSDS_PrimaryHeader_t *hdr) {
+    if (buf == NULL || len < CCSDS_PRIMARY_HEADER_LEN) {
+        return -1;
+    }
+
+    uint16_t word0 = ccsds_get_be16(&buf[0]);
+    uint16_t word1 = ccsds_get_be16(&buf[2]);
+
+    hdr->version      = (uint8_t)(word0 >> 13);
+    hdr->type         = (uint8_t)((word0 >> 12) & 0x1);
+    hdr->sec_hdr_flag = (uint8_t)((word0 >> 11) & 0x1);
+    hdr->apid         = word0 & CCSDS_APID_MASK;
+    hdr->seq_flags    = (uint8_t)(word1 >> 14);
+    hdr->seq_count    = word1 & CCSDS_SEQ_COUNT_MASK;
+    hdr->data_length  = ccsds_get_be16(&buf[4]);
+
+    // Version 1 packets carry 0b000 in the version field
+    if (hdr->version != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int ccsds_decode_secondary(const uint8_t *buf, size_t len, CCSDS_SecondaryHeader_t *sec) {
+    if (buf == NULL || len < CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN) {
+        return -1;
+    }
+    sec->met = ccsds_get_be64(&buf[CCSDS_PRIMARY_HEADER_LEN]);
+    return 0;
+}
+
+size_t ccsds_build_packet(uint8_t *buf, size_t cap, uint8_t type, uint16_t apid,
+                          uint16_t seq_count, uint64_t met,
+                          const uint8_t *user_data, size_t user_len) {
+    size_t total = CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + user_len + CCSDS_CRC_LEN;
+
+    if (buf == NULL || total > cap || (user_len > 0 && user_data == NULL)) {
+        return 0;
+    }
+
+    // 1. Primary header (secondary header always present)
+    ccsds_put_be16(&buf[0], (uint16_t)(((type & 0x1u) << 12) | (1u << 11) | (apid & CCSDS_APID_MASK)));
+    ccsds_put_be16(&buf[2], (uint16_t)((CCSDS_SEQ_UNSEGMENTED << 14) | (seq_count & CCSDS_SEQ_COUNT_MASK)));
+    ccsds_put_be16(&buf[4], (uint16_t)(total - CCSDS_PRIMARY_HEADER_LEN - 1));
+
+    // 2. Secondary header: MET
+    ccsds_put_be64(&buf[CCSDS_PRIMARY_HEADER_LEN], met);
+
+    // 3. User data + Packet Error Control
+    if (user_len > 0) {
+        memcpy(&buf[CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN], user_data, user_len);
+    }
+    ccsds_put_be16(&buf[total - CCSDS_CRC_LEN], crc16_ccitt(buf, total - CCSDS_CRC_LEN));
+
+    return total;
+}
+
+const uint8_t *ccsds_user_data(const uint8_t *packet, const CCSDS_PrimaryHeader_t *hdr,
+                               size_t *user_len) {
+    size_t offset = CCSDS_PRIMARY_HEADER_LEN + (hdr->sec_hdr_flag ? CCSDS_SECONDARY_HEADER_LEN : 0);
+    size_t total = ccsds_packet_length(hdr);
+
+    if (total < offset + CCSDS_CRC_LEN) {
+        *user_len = 0;
+        return NULL;
+    }
+    *user_len = total - offset - CCSDS_CRC_LEN;
+    return &packet[offset];
+}
@@ -0,0 +1,296 @@
+// src/cdhs_router.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "cdhs_router.h"
+#include "ccsds_packet.h"
+#include "packet_pool.h"
+#include "uplink_deframer.h"
+#include "satellite_types.h"
+#include "watchdog.h"
+#include "utils.h"
+#include "trace.h"
+#include "fsw_log.h"
+#include <stdio.h>
+#include <string.h>
+
+// --- ROUTING TABLES ---
+// s_apid_slot is the dense dispatch table: one byte per possible 11-bit APID,
+// so a lookup is a single indexed load. It points into s_routes, which holds
+// the destination and counters of each registered APID. Slot 0 is the
+// catch-all for APIDs that were never registered.
+static uint8_t s_apid_slot[CCSDS_APID_COUNT];
+
+static struct {
+    CdhsDestination_t dest;
+    CdhsApidStats_t stats;
+} s_routes[CDHS_MAX_ROUTED_APIDS + 1];
+
+static uint8_t s_route_count = 1;   // Slot 0 is always in use
+
+static QueueHandle_t s_dest_queue[CDHS_DEST_COUNT];
+static PacketPool_t *s_uplink_pool;
+static CdhsRouterStats_t s_router_stats;
+static portMUX_TYPE s_router_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Raw uplink: deframer ring filled by the radio driver, drained by the router task
+static uint8_t s_uplink_ring[CDHS_UPLINK_RING_SIZE];
+static UplinkDeframer_t s_deframer;
+static UplinkDeframerStats_t s_uplink_stats;    // Copy taken after every poll
+static TaskHandle_t s_router_task;
+
+static const char *const s_dest_names[CDHS_DEST_COUNT] = {
+    "NONE", "ADCS", "EPS", "CDHS", "HK"
+};
+
+static void on_uplink_packet(void *ctx, const UplinkPacketView_t *packet);
+
+// --- A. CONFIGURATION ---
+
+BaseType_t cdhs_router_init(PacketPool_t *uplink_pool) {
+    if (uplink_pool == NULL) {
+        return pdFAIL;
+    }
+
+    memset(s_apid_slot, 0, sizeof(s_apid_slot));
+    memset(s_routes, 0, sizeof(s_routes));
+    memset(s_dest_queue, 0, sizeof(s_dest_queue));
+    memset(&s_router_stats, 0, sizeof(s_router_stats));
+    s_routes[0].dest = CDHS_DEST_NONE;
+    s_route_count = 1;
+    s_uplink_pool = uplink_pool;
+
+    const UplinkDeframerConfig_t deframer_cfg = {
+        .max_asm_errors = CDHS_UPLINK_ASM_ERRORS,
+        .slip_window_bits = CDHS_UPLINK_SLIP_BITS,
+        .max_packet_len = CCSDS_MAX_PACKET_LEN,
+    };
+    if (uplink_deframer_init(&s_deframer, s_uplink_ring, sizeof(s_uplink_ring),
+                             &deframer_cfg, on_uplink_packet, NULL) != 0) {
+        return pdFAIL;
+    }
+    memset(&s_uplink_stats, 0, sizeof(s_uplink_stats));
+
+    // Default routes (see README: Telecommand Routing)
+    cdhs_router_register_apid(APID_ADCS, CDHS_DEST_ADCS);
+    cdhs_router_register_apid(APID_EPS, CDHS_DEST_EPS);
+    cdhs_router_register_apid(APID_CDHS, CDHS_DEST_CDHS);
+    cdhs_router_register_apid(APID_HOUSEKEEPING, CDHS_DEST_HK);
+
+    return pdPASS;
+}
+
+BaseType_t cdhs_router_set_destination(CdhsDestination_t dest, QueueHandle_t queue) {
+    if (dest <= CDHS_DEST_NONE || dest >= CDHS_DEST_COUNT) {
+        return pdFAIL;
+    }
+    s_dest_queue[dest] = queue;
+    return pdPASS;
+}
+
+BaseType_t cdhs_router_register_apid(uint16_t apid, CdhsDestination_t dest) {
+    BaseType_t result = pdPASS;
+
+    if (apid > CCSDS_APID_MASK || dest >= CDHS_DEST_COUNT) {
+        return pdFAIL;
+    }
+
+    portENTER_CRITICAL(&s_router_mux);
+    uint8_t slot = s_apid_slot[apid];
+    if (slot != 0) {
+        s_routes[slot].dest = dest;                 // Existing route: just move it
+    } else if (s_route_count <= CDHS_MAX_ROUTED_APIDS) {
+        slot = s_route_count++;
+        s_routes[slot].dest = dest;
+        s_routes[slot].stats.apid = apid;
+        s_apid_slot[apid] = slot;
+    } else {
+        result = pdFAIL;                            // Route table full
+    }
+    portEXIT_CRITICAL(&s_router_mux);
+
+    if (result != pdPASS) {
+        printf("CDHS ROUTER: ERROR! No room to route APID 0x%03X.\n", apid);
+    }
+    return result;
+}
+
+// --- B. FRAME OWNERSHIP ---
+
+CCSDS_Frame_t *cdhs_router_alloc_frame(void) {
+    return (CCSDS_Frame_t *)packet_pool_alloc(s_uplink_pool);
+}
+
+BaseType_t cdhs_router_submit(CCSDS_Frame_t *frame) {
+    frame->submit_time_us = util_get_time_us();    // Start of the TC latency chain
+    return packet_pool_submit(s_uplink_pool, frame);
+}
+
+void cdhs_router_release(CCSDS_Frame_t *frame) {
+    packet_pool_release(s_uplink_pool, frame);
+}
+
+// --- C. DISPATCH ---
+
+void cdhs_router_route(CCSDS_Frame_t *frame) {
+    CCSDS_PrimaryHeader_t hdr;
+    uint16_t length = frame->length;   // The frame may be released as soon as it is queued
+    int delivered = 0;
+
+    // 1. Header sanity: version, minimum size and announced length must agree
+    if (length > CCSDS_MAX_PACKET_LEN ||
+        ccsds_decode_primary(frame->data, length, &hdr) != 0 ||
+        ccsds_packet_length(&hdr) != length ||
+        length < CCSDS_PRIMARY_HEADER_LEN + CCSDS_CRC_LEN ||
+        (hdr.sec_hdr_flag && length < CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + CCSDS_CRC_LEN)) {
+        portENTER_CRITICAL(&s_router_mux);
+        s_router_stats.received++;
+        s_router_stats.malformed++;
+        portEXIT_CRITICAL(&s_router_mux);
+        cdhs_router_release(frame);
+        return;
+    }
+
+    // 2. O(1) lookup
+    uint8_t slot = s_apid_slot[hdr.apid];
+    CdhsDestination_t dest = s_routes[slot].dest;
+
+    // 3. Packet Error Control over everything but the trailing CRC
+    size_t crc_len = length - CCSDS_CRC_LEN;
+    int crc_ok = crc16_ccitt(frame->data, crc_len) == ccsds_get_be16(&frame->data[crc_len]);
+
+    // 4. Non-blocking handoff: a full queue only costs its own subsystem a packet
+    if (crc_ok && dest != CDHS_DEST_NONE && s_dest_queue[dest] != NULL) {
+        delivered = (xQueueSend(s_dest_queue[dest], &frame, 0) == pdPASS);
+        TRACE_EVENT(delivered ? TRACE_QUEUE_SEND : TRACE_QUEUE_FULL, s_dest_queue[dest],
+                    uxQueueMessagesWaiting(s_dest_queue[dest]));
+    }
+
+    portENTER_CRITICAL(&s_router_mux);
+    CdhsApidStats_t *stats = &s_routes[slot].stats;
+    s_router_stats.received++;
+    if (!crc_ok) {
+        stats->crc_failures++;
+    } else if (delivered) {
+        stats->packets++;
+        stats->bytes += length;
+    } else {
+        stats->drops++;
+        if (dest == CDHS_DEST_NONE) {
+            s_router_stats.unrouted++;
+        }
+    }
+    portEXIT_CRITICAL(&s_router_mux);
+
+    if (!delivered) {
+        if (!crc_ok) {
+            FSW_LOGW(LOG_MOD_ROUTER, "CDHS ROUTER: CRC failure on APID 0x%03X. Packet dropped.\n", hdr.apid);
+        } else {
+            FSW_LOGW(LOG_MOD_ROUTER, "CDHS ROUTER: Could not deliver APID 0x%03X to %s. Packet dropped.\n",
+                     hdr.apid, s_dest_names[dest]);
+        }
+        cdhs_router_release(frame);
+    }
+}
+
+// --- D. RAW UPLINK ---
+
+BaseType_t cdhs_router_rx_bytes(const uint8_t *data, size_t len) {
+    size_t accepted = uplink_deframer_rx_write(&s_deframer, data, len);
+
+    if (s_router_task != NULL) {
+        xTaskNotifyGive(s_router_task);
+    }
+    return (accepted == len) ? pdPASS : pdFAIL;
+}
+
+// Deframer callback: the packet is still in the ring and already passed the
+// CRC, so this is the only copy on the uplink path. Routing re-checks it
+// like any other frame.
+static void on_uplink_packet(void *ctx, const UplinkPacketView_t *packet) {
+    CCSDS_Frame_t *frame = cdhs_router_alloc_frame();
+
+    (void)ctx;
+    if (frame == NULL || packet->length > sizeof(frame->data)) {
+        portENTER_CRITICAL(&s_router_mux);
+        s_router_stats.uplink_drops++;
+        portEXIT_CRITICAL(&s_router_mux);
+        if (frame != NULL) {
+            cdhs_router_release(frame);
+        }
+        return;
+    }
+
+    memcpy(frame->data, packet->seg[0], packet->seg_len[0]);
+    if (packet->seg_len[1] != 0) {
+        memcpy(&frame->data[packet->seg_len[0]], packet->seg[1], packet->seg_len[1]);
+    }
+    frame->length = packet->length;
+    frame->submit_time_us = util_get_time_us();    // Start of the TC latency chain
+    cdhs_router_route(frame);
+}
+
+static void service_uplink_stream(void) {
+    uplink_deframer_poll(&s_deframer);
+
+    portENTER_CRITICAL(&s_router_mux);
+    uplink_deframer_get_stats(&s_deframer, &s_uplink_stats);
+    portEXIT_CRITICAL(&s_router_mux);
+}
+
+// --- E. TELEMETRY SURFACE ---
+
+BaseType_t cdhs_router_get_apid_stats(uint16_t apid, CdhsApidStats_t *stats) {
+    if (apid > CCSDS_APID_MASK) {
+        return pdFAIL;
+    }
+
+    portENTER_CRITICAL(&s_router_mux);
+    uint8_t slot = s_apid_slot[apid];
+    *stats = s_routes[slot].stats;
+    portEXIT_CRITICAL(&s_router_mux);
+
+    // Slot 0 aggregates every unregistered APID
+    return (slot != 0) ? pdPASS : pdFAIL;
+}
+
+void cdhs_router_get_stats(CdhsRouterStats_t *stats) {
+    portENTER_CRITICAL(&s_router_mux);
+    *stats = s_router_stats;
+    portEXIT_CRITICAL(&s_router_mux);
+}
+
+void cdhs_router_get_uplink_stats(UplinkDeframerStats_t *stats) {
+    portENTER_CRITICAL(&s_router_mux);
+    *stats = s_uplink_stats;
+    portEXIT_CRITICAL(&s_router_mux);
+}
+
+// --- F. ROUTER TASK ---
+
+void vCdhsRouterTask(void *pvParameters) {
+    CCSDS_Frame_t *frame;
+
+    // Framed submissions and raw uplink bytes both arrive as notifications
+    s_router_task = xTaskGetCurrentTaskHandle();
+    packet_pool_set_consumer(s_uplink_pool, s_router_task);
+
+    printf("CDHS Router Task initialized, waiting for uplink packets.\n");
+    TRACE_TASK_START();
+
+    for (;;) {
+        // Event-driven; the timeout only keeps the watchdog fed on a quiet link
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        // 1. Frames a producer already built
+        while ((frame = (CCSDS_Frame_t *)packet_pool_receive(s_uplink_pool, 0)) != NULL) {
+            cdhs_router_route(frame);
+        }
+
+        // 2. Packets in the raw uplink stream
+        service_uplink_stream();
+
+        watchdog_pet(WDT_TASK_ROUTER);
+    }
+}
@@ -0,0 +1,186 @@
+// src/checkpoint.c
+
+#include "checkpoint.h"
+#include "utils.h"
+#include <string.h>
+
+#define CRC_SPAN            offsetof(CheckpointHeader_t, crc)
+
+#define CHECKPOINT_RESERVED(name, bytes) bytes,
+static const uint16_t s_reserved[CHECKPOINT_SECTION_COUNT] = {
+    CHECKPOINT_TABLE(CHECKPOINT_RESERVED)
+};
+#undef CHECKPOINT_RESERVED
+
+static uint8_t *s_region;
+static CheckpointSyncFn_t s_sync;
+static void *s_sync_ctx;
+
+// Per section: which slot holds the newest valid copy (-1: none) and its
+// generation. Only the section's writer changes them after init.
+static int8_t s_newest[CHECKPOINT_SECTION_COUNT];
+static uint32_t s_generation[CHECKPOINT_SECTION_COUNT];
+static CheckpointStats_t s_stats;
+
+static uint32_t slot_offset(CheckpointSection_t section, int slot) {
+    uint32_t offset = 0;
+
+    for (uint32_t s = 0; s < (uint32_t)section; s++) {
+        offset += 2u * (uint32_t)CHECKPOINT_SLOT_BYTES(s_reserved[s]);
+    }
+    return offset + (uint32_t)slot * (uint32_t)CHECKPOINT_SLOT_BYTES(s_reserved[section]);
+}
+
+static uint16_t slot_crc(const CheckpointHeader_t *hdr, const uint8_t *payload) {
+    uint16_t crc = crc16_init();
+    crc = crc16_update(crc, (const uint8_t *)hdr, CRC_SPAN);
+    crc = crc16_update(crc, payload, hdr->len);
+    return crc16_final(crc);
+}
+
+// 1 if the slot holds a complete record of its section
+static int slot_valid(CheckpointSection_t section, int slot, CheckpointHeader_t *hdr) {
+    const uint8_t *base = s_region + slot_offset(section, slot);
+
+    memcpy(hdr, base, sizeof(*hdr));
+    return hdr->magic == (uint16_t)(CHECKPOINT_MAGIC + section) && hdr->len <= s_reserved[section] &&
+           slot_crc(hdr, base + sizeof(*hdr)) == hdr->crc;
+}
+
+const char *checkpoint_reset_name(CheckpointReset_t reset) {
+    switch (reset) {
+        case CHECKPOINT_RESET_POWER_ON: return "power-on";
+        case CHECKPOINT_RESET_SOFTWARE: return "software";
+        case CHECKPOINT_RESET_WATCHDOG: return "watchdog";
+        case CHECKPOINT_RESET_BROWNOUT: return "brown-out";
+        case CHECKPOINT_RESET_PANIC:    return "panic";
+        default:                        return "other";
+    }
+}
+
+// --- A. BOOT ---
+
+int checkpoint_init(void *region, CheckpointReset_t reset, CheckpointSyncFn_t sync, void *sync_ctx) {
+    uint32_t t0 = util_get_time_us();
+    int found_boot = 0;
+    uint32_t newest_boot = 0;
+
+    if (region == NULL) {
+        return -1;
+    }
+    s_region = (uint8_t *)region;
+    s_sync = sync;
+    s_sync_ctx = sync_ctx;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.reset = reset;
+
+    // 1. Power-on: whatever the region holds is noise
+    if (reset == CHECKPOINT_RESET_POWER_ON) {
+        memset(s_region, 0, CHECKPOINT_REGION_BYTES);
+        if (s_sync != NULL && s_sync(s_sync_ctx, 0, s_region, CHECKPOINT_REGION_BYTES) != 0) {
+            s_stats.write_errors++;
+        }
+    }
+
+    // 2. One pass: newest valid slot of every section
+    for (int section = 0; section < CHECKPOINT_SECTION_COUNT; section++) {
+        s_newest[section] = -1;
+        s_generation[section] = 0;
+        for (int slot = 0; slot < 2; slot++) {
+            CheckpointHeader_t hdr;
+
+            if (!slot_valid((CheckpointSection_t)section, slot, &hdr)) {
+                if (hdr.magic != 0 || hdr.crc != 0) {
+                    s_stats.corrupt_slots++;        // Written once, torn or bit-flipped since
+                }
+                continue;
+            }
+            if (s_newest[section] < 0 || (int32_t)(hdr.generation - s_generation[section]) > 0) {
+                s_newest[section] = (int8_t)slot;
+                s_generation[section] = hdr.generation;
+            }
+
+            // The previous boot is the newest one on record; its latest tick is
+            // the last moment the FSW is known to have been alive
+            if (!found_boot || (int32_t)(hdr.boot - newest_boot) > 0) {
+                found_boot = 1;
+                newest_boot = hdr.boot;
+                s_stats.last_alive_tick = hdr.tick;
+            } else if (hdr.boot == newest_boot && (int32_t)(hdr.tick - s_stats.last_alive_tick) > 0) {
+                s_stats.last_alive_tick = hdr.tick;
+            }
+        }
+        if (s_newest[section] >= 0) {
+            s_stats.restored++;
+        }
+    }
+
+    s_stats.boot = found_boot ? newest_boot + 1u : 0;
+    s_stats.last_alive_valid = (uint8_t)found_boot;
+    s_stats.restore_us = util_get_time_us() - t0;
+    return 0;
+}
+
+int checkpoint_get(CheckpointSection_t section, void *payload, uint16_t len, CheckpointInfo_t *info) {
+    CheckpointHeader_t hdr;
+    int slot;
+
+    if (s_region == NULL || (uint32_t)section >= CHECKPOINT_SECTION_COUNT) {
+        return -1;
+    }
+    slot = s_newest[section];
+    if (slot < 0 || !slot_valid(section, slot, &hdr) || hdr.len != len) {
+        return -1;
+    }
+    memcpy(payload, s_region + slot_offset(section, slot) + sizeof(hdr), len);
+    if (info != NULL) {
+        info->generation = hdr.generation;
+        info->boot = hdr.boot;
+        info->tick = hdr.tick;
+    }
+    return 0;
+}
+
+// --- B. WRITER SIDE ---
+
+int checkpoint_write(CheckpointSection_t section, const void *payload, uint16_t len, uint32_t tick) {
+    CheckpointHeader_t hdr;
+
+    if (s_region == NULL || (uint32_t)section >= CHECKPOINT_SECTION_COUNT || len > s_reserved[section]) {
+        __atomic_add_fetch(&s_stats.write_errors, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    // 1. The slot without the newest copy; that copy stands until this one is complete
+    int slot = (s_newest[section] == 0) ? 1 : 0;
+    uint8_t *base = s_region + slot_offset(section, slot);
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = (uint16_t)(CHECKPOINT_MAGIC + section);
+    hdr.len = len;
+    hdr.generation = s_generation[section] + 1u;
+    hdr.boot = s_stats.boot;
+    hdr.tick = tick;
+    hdr.crc = slot_crc(&hdr, (const uint8_t *)payload);
+
+    // 2. Payload first, header last
+    memcpy(base + sizeof(hdr), payload, len);
+    memcpy(base, &hdr, sizeof(hdr));
+    s_newest[section] = (int8_t)slot;
+    s_generation[section] = hdr.generation;
+
+    __atomic_add_fetch(&s_stats.writes, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s_stats.write_bytes, (uint32_t)(sizeof(hdr) + len), __ATOMIC_RELAXED);
+    if (s_sync != NULL && s_sync(s_sync_ctx, slot_offset(section, slot), base, sizeof(hdr) + len) != 0) {
+        __atomic_add_fetch(&s_stats.write_errors, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    return 0;
+}
+
+void checkpoint_get_stats(CheckpointStats_t *stats) {
+    *stats = s_stats;
+    stats->writes = __atomic_load_n(&s_stats.writes, __ATOMIC_RELAXED);
+    stats->write_bytes = __atomic_load_n(&s_stats.write_bytes, __ATOMIC_RELAXED);
+    stats->write_errors = __atomic_load_n(&s_stats.write_errors, __ATOMIC_RELAXED);
+}
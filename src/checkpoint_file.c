@@ -0,0 +1,56 @@
+// src/checkpoint_file.c
+// Host backend: the checkpoint region mirrored into a file, which outlives
+// the process the way RTC memory outlives a warm reset.
+
+#ifndef ESP_PLATFORM
+
+#include "checkpoint.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t s_region[CHECKPOINT_REGION_BYTES];
+static CheckpointReset_t s_reset = CHECKPOINT_RESET_POWER_ON;
+static FILE *s_fp;
+
+void checkpoint_host_set_reset(CheckpointReset_t reset) {
+    s_reset = reset;
+}
+
+// Writers of different sections share the FILE; the host runtime runs one
+// task at a time, so their seek-and-write pairs never interleave
+static int checkpoint_file_sync(void *ctx, uint32_t offset, const void *data, size_t len) {
+    FILE *fp = (FILE *)ctx;
+
+    if (fseek(fp, (long)offset, SEEK_SET) != 0 || fwrite(data, 1, len, fp) != len) {
+        return -1;
+    }
+    return (fflush(fp) == 0) ? 0 : -1;
+}
+
+int checkpoint_open(void) {
+    if (s_fp != NULL) {
+        fclose(s_fp);
+        s_fp = NULL;
+    }
+    memset(s_region, 0, sizeof(s_region));
+
+    // 1. Warm: load what the previous run left; a missing or short file reads as empty
+    if (s_reset != CHECKPOINT_RESET_POWER_ON) {
+        s_fp = fopen(CHECKPOINT_HOST_IMAGE, "r+b");
+        if (s_fp != NULL && fread(s_region, 1, sizeof(s_region), s_fp) < sizeof(s_region)) {
+            clearerr(s_fp);
+        }
+    }
+    if (s_fp == NULL) {
+        s_fp = fopen(CHECKPOINT_HOST_IMAGE, "w+b");
+        if (s_fp == NULL) {
+            printf("CHECKPOINT: cannot open %s\n", CHECKPOINT_HOST_IMAGE);
+            return checkpoint_init(s_region, s_reset, NULL, NULL);
+        }
+    }
+
+    // 2. Power-on wipes the region, and checkpoint_init() syncs that to the file
+    return checkpoint_init(s_region, s_reset, checkpoint_file_sync, s_fp);
+}
+
+#endif // !ESP_PLATFORM
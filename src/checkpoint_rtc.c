@@ -0,0 +1,31 @@
+// src/checkpoint_rtc.c
+// Target backend: the checkpoint region in RTC slow memory. RTC_NOINIT_ATTR
+// keeps the startup code from zeroing it, so it survives every reset except
+// a power cycle, and it needs no sync.
+
+#ifdef ESP_PLATFORM
+
+#include "checkpoint.h"
+#include "esp_attr.h"
+#include "esp_system.h"
+
+RTC_NOINIT_ATTR static uint8_t s_region[CHECKPOINT_REGION_BYTES];
+
+static CheckpointReset_t map_reset_reason(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:   return CHECKPOINT_RESET_POWER_ON;
+        case ESP_RST_SW:        return CHECKPOINT_RESET_SOFTWARE;
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:       return CHECKPOINT_RESET_WATCHDOG;
+        case ESP_RST_BROWNOUT:  return CHECKPOINT_RESET_BROWNOUT;
+        case ESP_RST_PANIC:     return CHECKPOINT_RESET_PANIC;
+        default:                return CHECKPOINT_RESET_OTHER;
+    }
+}
+
+int checkpoint_open(void) {
+    return checkpoint_init(s_region, map_reset_reason(esp_reset_reason()), NULL, NULL);
+}
+
+#endif // ESP_PLATFORM
@@ -5,16 +5,84 @@
 #include "freertos/queue.h"
 #include "satellite_types.h"
 #include "utils.h"
+#include "ccsds_packet.h"
+#include "cdhs_router.h"
+#include "packet_schema.h"
+#include "data_logger.h"
+#include "rtos_alloc.h"
+#include "trace.h"
 #include <string.h>
 #include <stdio.h>
 
-extern QueueHandle_t xCommandQueue;
-extern DownlinkMode_t g_downlink_mode;
+// Length of the simulated ground station pass
+#define SIM_PASS_DURATION_MS   (8 * 60 * 1000)
+
+static uint16_t s_uplink_seq;
+
+// --- SIMULATED RADIO CHANNEL ---
+// The radio delivers a bit stream, not packets: idle fill, then every packet
+// behind the Attached Sync Marker. A burst is built bit by bit so the
+// scenario can flip marker bits and slip the stream by a stray bit, which
+// the router's deframer has to ride through.
+#define CHANNEL_IDLE            0x55
+#define CHANNEL_IDLE_BYTES      6
+#define CHANNEL_BURST_MAX       (2 * CHANNEL_IDLE_BYTES + 3 * (UPLINK_ASM_LEN + CCSDS_MAX_PACKET_LEN) + 1)
+
+static uint8_t s_burst[CHANNEL_BURST_MAX];
+static uint32_t s_burst_bits;
+
+static void channel_put_bits(uint32_t value, unsigned count) {
+    while (count-- > 0 && (s_burst_bits >> 3) < sizeof(s_burst)) {
+        uint8_t mask = (uint8_t)(0x80u >> (s_burst_bits & 7u));
+        if ((value >> count) & 1u) {
+            s_burst[s_burst_bits >> 3] |= mask;
+        } else {
+            s_burst[s_burst_bits >> 3] &= (uint8_t)~mask;
+        }
+        s_burst_bits++;
+    }
+}
+
+static void channel_begin(void) {
+    s_burst_bits = 0;
+    for (int i = 0; i < CHANNEL_IDLE_BYTES; i++) {
+        channel_put_bits(CHANNEL_IDLE, 8);
+    }
+}
+
+// Idle fill after the last packet, then the whole burst goes to the radio
+static BaseType_t channel_send(void) {
+    for (int i = 0; i < CHANNEL_IDLE_BYTES || (s_burst_bits & 7u) != 0; i++) {
+        channel_put_bits(CHANNEL_IDLE, (s_burst_bits & 7u) ? 8u - (s_burst_bits & 7u) : 8u);
+    }
+    return cdhs_router_rx_bytes(s_burst, s_burst_bits >> 3);
+}
+
+// Serializes the TC, wraps it in a CCSDS space packet for the CDHS APID, as
+// the ground station would, and appends it to the current burst behind the
+// sync marker (asm_flips: marker bits the channel corrupts). Returns the
+// wire CRC through *crc.
+static void inject_telecommand(const TelecommandPacket_t *tc, uint32_t asm_flips, uint16_t *crc) {
+    uint8_t wire[TC_WIRE_LEN];
+    uint8_t packet[CCSDS_MAX_PACKET_LEN];
+    size_t wire_len = tc_pack(tc, wire);
+    size_t len;
+
+    *crc = ccsds_get_be16(&wire[TC_OFF_crc]);
+    len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TC, APID_CDHS, s_uplink_seq++,
+                             xTaskGetTickCount(), wire, wire_len);
+
+    channel_put_bits(UPLINK_ASM ^ asm_flips, 32);
+    for (size_t i = 0; i < len; i++) {
+        channel_put_bits(packet[i], 8);
+    }
+}
 
 void vCommandInjectionTask(void *pvParameters) {
     TelecommandPacket_t tx_command;
+    uint16_t crc;
 
-    size_t crc_data_length = sizeof(TelecommandPacket_t) - sizeof(uint16_t);
+    TRACE_TASK_START();
 
     // 1. Wait 5 seconds after boot to ensure all system tasks are initialized
     vTaskDelay(pdMS_TO_TICKS(5000));
@@ -27,13 +95,13 @@ void vCommandInjectionTask(void *pvParameters) {
     // Payload: Send the new mode (MODE_NOMINAL = 1) in the first byte
     tx_command.payload[0] = MODE_NOMINAL; 
 
-    tx_command.crc = crc16_ccitt((const uint8_t *)&tx_command, crc_data_length);
-
-    printf("INJECTOR: Sending TC_SET_MODE to NOMINAL (Payload: %d, CRC: 0x%X)\n", tx_command.payload[0], tx_command.crc);
-
-    // Send the packet to the Command Queue (Wait 100ms max)
-    if (xQueueSend(xCommandQueue, &tx_command, pdMS_TO_TICKS(100)) != pdPASS) {
-        printf("INJECTOR: ERROR! Command Queue full or unavailable.\n");
+    // Send it through the radio with two marker bits flipped
+    channel_begin();
+    inject_telecommand(&tx_command, 0x00400100u, &crc);
+    if (channel_send() != pdPASS) {
+        printf("INJECTOR: ERROR! Uplink ring full.\n");
+    } else {
+        printf("INJECTOR: Sent TC_SET_MODE to NOMINAL (Payload: %d, CRC: 0x%X)\n", tx_command.payload[0], crc);
     }
 
     // 2. Wait another 15 seconds to simulate ground station delay
@@ -44,17 +112,50 @@ void vCommandInjectionTask(void *pvParameters) {
     tx_command.timestamp = xTaskGetTickCount();
     tx_command.command_id = TC_NO_OP;
 
-    tx_command.crc = crc16_ccitt((const uint8_t *)&tx_command, crc_data_length);
-    
-    printf("INJECTOR: Sending TC_NO-OP command (CRC: 0x%X).\n", tx_command.crc);
-    xQueueSend(xCommandQueue, &tx_command, pdMS_TO_TICKS(100));
+    channel_begin();
+    inject_telecommand(&tx_command, 0, &crc);
+    printf("INJECTOR: Sent TC_NO-OP command (CRC: 0x%X).\n", crc);
+
+    // --- TEST 2b: Ask for housekeeping now (answered on the priority lane) ---
+    // Same burst, but the channel slips a stray bit in before its marker
+    memset(&tx_command, 0, sizeof(TelecommandPacket_t));
+    tx_command.timestamp = xTaskGetTickCount();
+    tx_command.command_id = TC_REQUEST_HK;
+
+    channel_put_bits(1, 1);
+    inject_telecommand(&tx_command, 0, &crc);
+    printf("INJECTOR: Sent TC_REQUEST_HK (T: %lu, CRC: 0x%X).\n",
+           (unsigned long)tx_command.timestamp, crc);
+
+    if (channel_send() != pdPASS) {
+        printf("INJECTOR: ERROR! Uplink ring full.\n");
+    }
 
     // --- TEST 3: Trigger the Downlink Window (After 20s) ---
     vTaskDelay(pdMS_TO_TICKS(5000)); // Wait another 5 seconds
 
-    g_downlink_mode = DOWNLINK_ACTIVE; // <<< Simulate entering Ground Station visibility
-    printf("INJECTOR: Ground Station Pass Detected! Setting Downlink ACTIVE.\n");
+    // Simulate entering Ground Station visibility
+    printf("INJECTOR: Ground Station Pass Detected! Requesting Downlink pass.\n");
+    if (data_logger_request_pass(SIM_PASS_DURATION_MS) != pdPASS) {
+        printf("INJECTOR: ERROR! Downlink request rejected.\n");
+    }
+
+    // --- TEST 4: Ask for statistics of everything archived so far (T+120 s) ---
+    vTaskDelay(pdMS_TO_TICKS(95000));
+
+    memset(&tx_command, 0, sizeof(TelecommandPacket_t));
+    tx_command.timestamp = xTaskGetTickCount();
+    tx_command.command_id = TC_REQUEST_SUMMARY;
+    ccsds_put_be32(&tx_command.payload[0], 0);
+    ccsds_put_be32(&tx_command.payload[4], data_logger_archive_time(tx_command.timestamp));
+
+    channel_begin();
+    inject_telecommand(&tx_command, 0, &crc);
+    if (channel_send() == pdPASS) {
+        printf("INJECTOR: Sent TC_REQUEST_SUMMARY for T: 0..%lu (CRC: 0x%X).\n",
+               (unsigned long)ccsds_get_be32(&tx_command.payload[4]), crc);
+    }
 
     // The task has completed its simulation job and self-suspends
-    vTaskDelete(NULL); 
+    rtos_task_delete_self();
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+// src/crc16.c
+
+#include "crc16.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// --- A. COMPILE-TIME TABLE GENERATION ---
+// CRC is linear over GF(2): the table entry for byte v is the XOR of the
+// entries for each set bit of v. Entry (1 << b) of slice table k is
+// x^(16 + 8k + b) mod P, so the whole set of tables follows from the chain
+// of powers x^16 .. x^79 below, each one a single "multiply by x" step away
+// from the previous. Everything folds to constants; nothing runs at boot.
+
+#define CRC16_MULX(c) ((((c) << 1) & 0xFFFF) ^ (((c) & 0x8000) ? CRC16_POLY : 0))
+
+enum {
+    CRC16_X16 = CRC16_POLY,
+    CRC16_X17 = CRC16_MULX(CRC16_X16),
+    CRC16_X18 = CRC16_MULX(CRC16_X17),
+    CRC16_X19 = CRC16_MULX(CRC16_X18),
+    CRC16_X20 = CRC16_MULX(CRC16_X19),
+    CRC16_X21 = CRC16_MULX(CRC16_X20),
+    CRC16_X22 = CRC16_MULX(CRC16_X21),
+    CRC16_X23 = CRC16_MULX(CRC16_X22),
+    CRC16_X24 = CRC16_MULX(CRC16_X23),
+    CRC16_X25 = CRC16_MULX(CRC16_X24),
+    CRC16_X26 = CRC16_MULX(CRC16_X25),
+    CRC16_X27 = CRC16_MULX(CRC16_X26),
+    CRC16_X28 = CRC16_MULX(CRC16_X27),
+    CRC16_X29 = CRC16_MULX(CRC16_X28),
+    CRC16_X30 = CRC16_MULX(CRC16_X29),
+    CRC16_X31 = CRC16_MULX(CRC16_X30),
+    CRC16_X32 = CRC16_MULX(CRC16_X31),
+    CRC16_X33 = CRC16_MULX(CRC16_X32),
+    CRC16_X34 = CRC16_MULX(CRC16_X33),
+    CRC16_X35 = CRC16_MULX(CRC16_X34),
+    CRC16_X36 = CRC16_MULX(CRC16_X35),
+    CRC16_X37 = CRC16_MULX(CRC16_X36),
+    CRC16_X38 = CRC16_MULX(CRC16_X37),
+    CRC16_X39 = CRC16_MULX(CRC16_X38),
+    CRC16_X40 = CRC16_MULX(CRC16_X39),
+    CRC16_X41 = CRC16_MULX(CRC16_X40),
+    CRC16_X42 = CRC16_MULX(CRC16_X41),
+    CRC16_X43 = CRC16_MULX(CRC16_X42),
+    CRC16_X44 = CRC16_MULX(CRC16_X43),
+    CRC16_X45 = CRC16_MULX(CRC16_X44),
+    CRC16_X46 = CRC16_MULX(CRC16_X45),
+    CRC16_X47 = CRC16_MULX(CRC16_X46),
+    CRC16_X48 = CRC16_MULX(CRC16_X47),
+    CRC16_X49 = CRC16_MULX(CRC16_X48),
+    CRC16_X50 = CRC16_MULX(CRC16_X49),
+    CRC16_X51 = CRC16_MULX(CRC16_X50),
+    CRC16_X52 = CRC16_MULX(CRC16_X51),
+    CRC16_X53 = CRC16_MULX(CRC16_X52),
+    CRC16_X54 = CRC16_MULX(CRC16_X53),
+    CRC16_X55 = CRC16_MULX(CRC16_X54),
+    CRC16_X56 = CRC16_MULX(CRC16_X55),
+    CRC16_X57 = CRC16_MULX(CRC16_X56),
+    CRC16_X58 = CRC16_MULX(CRC16_X57),
+    CRC16_X59 = CRC16_MULX(CRC16_X58),
+    CRC16_X60 = CRC16_MULX(CRC16_X59),
+    CRC16_X61 = CRC16_MULX(CRC16_X60),
+    CRC16_X62 = CRC16_MULX(CRC16_X61),
+    CRC16_X63 = CRC16_MULX(CRC16_X62),
+    CRC16_X64 = CRC16_MULX(CRC16_X63),
+    CRC16_X65 = CRC16_MULX(CRC16_X64),
+    CRC16_X66 = CRC16_MULX(CRC16_X65),
+    CRC16_X67 = CRC16_MULX(CRC16_X66),
+    CRC16_X68 = CRC16_MULX(CRC16_X67),
+    CRC16_X69 = CRC16_MULX(CRC16_X68),
+    CRC16_X70 = CRC16_MULX(CRC16_X69),
+    CRC16_X71 = CRC16_MULX(CRC16_X70),
+    CRC16_X72 = CRC16_MULX(CRC16_X71),
+    CRC16_X73 = CRC16_MULX(CRC16_X72),
+    CRC16_X74 = CRC16_MULX(CRC16_X73),
+    CRC16_X75 = CRC16_MULX(CRC16_X74),
+    CRC16_X76 = CRC16_MULX(CRC16_X75),
+    CRC16_X77 = CRC16_MULX(CRC16_X76),
+    CRC16_X78 = CRC16_MULX(CRC16_X77),
+    CRC16_X79 = CRC16_MULX(CRC16_X78),
+};
+
+#define CRC16_BIT(v, b, x) ((((v) >> (b)) & 1) ? (x) : 0)
+#define CRC16_ENTRY(v, x0, x1, x2, x3, x4, x5, x6, x7) \
+    (uint16_t)(CRC16_BIT(v, 0, x0) ^ CRC16_BIT(v, 1, x1) ^ CRC16_BIT(v, 2, x2) ^ CRC16_BIT(v, 3, x3) ^ \
+               CRC16_BIT(v, 4, x4) ^ CRC16_BIT(v, 5, x5) ^ CRC16_BIT(v, 6, x6) ^ CRC16_BIT(v, 7, x7))
+
+// T0 is the classic 256-entry table; Tk advances the CRC past k extra bytes.
+#define CRC16_T0(v) CRC16_ENTRY(v, CRC16_X16, CRC16_X17, CRC16_X18, CRC16_X19, CRC16_X20, CRC16_X21, CRC16_X22, CRC16_X23)
+#define CRC16_T1(v) CRC16_ENTRY(v, CRC16_X24, CRC16_X25, CRC16_X26, CRC16_X27, CRC16_X28, CRC16_X29, CRC16_X30, CRC16_X31)
+#define CRC16_T2(v) CRC16_ENTRY(v, CRC16_X32, CRC16_X33, CRC16_X34, CRC16_X35, CRC16_X36, CRC16_X37, CRC16_X38, CRC16_X39)
+#define CRC16_T3(v) CRC16_ENTRY(v, CRC16_X40, CRC16_X41, CRC16_X42, CRC16_X43, CRC16_X44, CRC16_X45, CRC16_X46, CRC16_X47)
+#define CRC16_T4(v) CRC16_ENTRY(v, CRC16_X48, CRC16_X49, CRC16_X50, CRC16_X51, CRC16_X52, CRC16_X53, CRC16_X54, CRC16_X55)
+#define CRC16_T5(v) CRC16_ENTRY(v, CRC16_X56, CRC16_X57, CRC16_X58, CRC16_X59, CRC16_X60, CRC16_X61, CRC16_X62, CRC16_X63)
+#define CRC16_T6(v) CRC16_ENTRY(v, CRC16_X64, CRC16_X65, CRC16_X66, CRC16_X67, CRC16_X68, CRC16_X69, CRC16_X70, CRC16_X71)
+#define CRC16_T7(v) CRC16_ENTRY(v, CRC16_X72, CRC16_X73, CRC16_X74, CRC16_X75, CRC16_X76, CRC16_X77, CRC16_X78, CRC16_X79)
+
+#define CRC16_ROW(T, r) \
+    T(r + 0x0), T(r + 0x1), T(r + 0x2), T(r + 0x3), T(r + 0x4), T(r + 0x5), T(r + 0x6), T(r + 0x7), \
+    T(r + 0x8), T(r + 0x9), T(r + 0xA), T(r + 0xB), T(r + 0xC), T(r + 0xD), T(r + 0xE), T(r + 0xF)
+
+#define CRC16_TABLE(T) { \
+    CRC16_ROW(T, 0x00), CRC16_ROW(T, 0x10), CRC16_ROW(T, 0x20), CRC16_ROW(T, 0x30), \
+    CRC16_ROW(T, 0x40), CRC16_ROW(T, 0x50), CRC16_ROW(T, 0x60), CRC16_ROW(T, 0x70), \
+    CRC16_ROW(T, 0x80), CRC16_ROW(T, 0x90), CRC16_ROW(T, 0xA0), CRC16_ROW(T, 0xB0), \
+    CRC16_ROW(T, 0xC0), CRC16_ROW(T, 0xD0), CRC16_ROW(T, 0xE0), CRC16_ROW(T, 0xF0) }
+
+// One object per back-end, so a --gc-sections link keeps only the tables of
+// the back-ends that are called: T0 alone for TABLE, T0..T3 for SLICE4.
+static const uint16_t crc16_table_t0[256] = CRC16_TABLE(CRC16_T0);
+static const uint16_t crc16_table_t1_t3[3][256] = {
+    CRC16_TABLE(CRC16_T1), CRC16_TABLE(CRC16_T2), CRC16_TABLE(CRC16_T3)
+};
+static const uint16_t crc16_table_t4_t7[4][256] = {
+    CRC16_TABLE(CRC16_T4), CRC16_TABLE(CRC16_T5), CRC16_TABLE(CRC16_T6), CRC16_TABLE(CRC16_T7)
+};
+
+// Spot checks so a broken macro fails the build instead of the uplink.
+typedef char crc16_check_t0_1[(CRC16_T0(0x01) == 0x1021) ? 1 : -1];
+typedef char crc16_check_t0_ff[(CRC16_T0(0xFF) == 0x1EF0) ? 1 : -1];
+
+// --- B. BACK-ENDS ---
+
+uint16_t crc16_update_bitwise(uint16_t crc, const uint8_t *data, size_t length) {
+    size_t i, j;
+
+    for (i = 0; i < length; i++) {
+        crc ^= ((uint16_t)data[i] << 8);
+        for (j = 0; j < 8; j++) {
+            if (crc & 0x8000) {
+                crc = (crc << 1) ^ CRC16_POLY;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+uint16_t crc16_update_table(uint16_t crc, const uint8_t *data, size_t length) {
+    const uint16_t *t0 = crc16_table_t0;
+
+    while (length--) {
+        crc = (uint16_t)((crc << 8) ^ t0[(uint8_t)((crc >> 8) ^ *data++)]);
+    }
+    return crc;
+}
+
+uint16_t crc16_update_slice4(uint16_t crc, const uint8_t *data, size_t length) {
+    // Bytes are read one at a time, so the result does not depend on
+    // alignment or on the endianness of the CPU.
+    while (length >= 4) {
+        crc = crc16_table_t1_t3[2][(uint8_t)(data[0] ^ (crc >> 8))] ^
+              crc16_table_t1_t3[1][(uint8_t)(data[1] ^ crc)] ^
+              crc16_table_t1_t3[0][data[2]] ^
+              crc16_table_t0[data[3]];
+        data += 4;
+        length -= 4;
+    }
+    return crc16_update_table(crc, data, length);
+}
+
+uint16_t crc16_update_slice8(uint16_t crc, const uint8_t *data, size_t length) {
+    while (length >= 8) {
+        crc = crc16_table_t4_t7[3][(uint8_t)(data[0] ^ (crc >> 8))] ^
+              crc16_table_t4_t7[2][(uint8_t)(data[1] ^ crc)] ^
+              crc16_table_t4_t7[1][data[2]] ^
+              crc16_table_t4_t7[0][data[3]] ^
+              crc16_table_t1_t3[2][data[4]] ^
+              crc16_table_t1_t3[1][data[5]] ^
+              crc16_table_t1_t3[0][data[6]] ^
+              crc16_table_t0[data[7]];
+        data += 8;
+        length -= 8;
+    }
+    return crc16_update_slice4(crc, data, length);
+}
+
+// --- C. SELECTED BACK-END ---
+
+uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t length) {
+#if CRC16_BACKEND == CRC16_BACKEND_BITWISE
+    return crc16_update_bitwise(crc, data, length);
+#elif CRC16_BACKEND == CRC16_BACKEND_TABLE
+    return crc16_update_table(crc, data, length);
+#elif CRC16_BACKEND == CRC16_BACKEND_SLICE4
+    return crc16_update_slice4(crc, data, length);
+#elif CRC16_BACKEND == CRC16_BACKEND_SLICE8
+    return crc16_update_slice8(crc, data, length);
+#else
+#error "Unknown CRC16_BACKEND"
+#endif
+}
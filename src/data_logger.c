@@ -4,53 +4,532 @@
 #include "satellite_types.h"
 #include "state_manager.h"
 #include "watchdog.h"
+#include "packet_pool.h"
+#include "data_logger.h"
+#include "flash_backend.h"
+#include "downlink.h"
+#include "packet_schema.h"
+#include "hk_sched.h"
+#include "tm_stats.h"
+#include "tc_proc.h"
+#include "ccsds_packet.h"
+#include "utils.h"
+#include "rtos_alloc.h"
+#include "trace.h"
+#include "fsw_log.h"
+#include "checkpoint.h"
 #include <stdio.h>
 
-extern QueueHandle_t xTelemetryQueue;
-DownlinkMode_t g_downlink_mode = DOWNLINK_INACTIVE;
+extern PacketPool_t g_telemetry_pool;
+extern PacketPool_t g_hk_response_pool;
+
+TmArchive_t g_tm_archive;
+static FlashBackend_t s_archive_flash;
+static int s_archive_ready = 0;
+static uint32_t s_unarchived;           // HK sample sets received while the archive was down
+
+#define DATA_LOGGER_UNARCHIVED_REPORT   60
+
+// --- DOWNLINK ---
+// Pass requests come from other tasks through this queue; only the logger
+// changes the downlink state, so nothing races on it.
+#define DOWNLINK_LINK_RATE_BPS  9600
+#define DOWNLINK_POLICY         DOWNLINK_NEWEST_FIRST
+#define DOWNLINK_COMPRESS_HK    1       // Delta/bit-packed HK frames (APID_HK_COMPRESSED)
+#define DOWNLINK_REQUEST_DEPTH  2
+
+static Downlink_t s_downlink;
+static QueueHandle_t xDownlinkRequestQueue;
+static DownlinkSendFn_t s_radio_tap;
+static void *s_radio_tap_ctx;
+
+// Channel coding in front of the radio for everything the logger sends.
+// The downlink engine paces packets at the rate left after the coding
+// overhead, so the codeblocks fit the link.
+static DownlinkFec_t s_fec;
+static DownlinkFecStats_t s_fec_stats;         // Copy published by the logger
+static portMUX_TYPE s_fec_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Mode as last delivered by the mode-change bus (see state_manager.h)
+static int s_mode_sub = -1;
+static SystemMode_t s_logger_mode;
+
+// Priority lane for TC_REQUEST_HK answers
+static HkResponseStats_t s_hk_rsp_stats;
+static uint16_t s_hk_rsp_seq;
+static portMUX_TYPE s_hk_rsp_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- TELEMETRY SUMMARIES ---
+// Every archived sample set also feeds the statistics, whose per-page
+// aggregates ride in the archive's page trailers (tm_stats.h).
+// TC_REQUEST_SUMMARY asks for a window; the logger answers it on the radio
+// like an HK response, in any mode and outside any pass budget.
+#define SUMMARY_REQUEST_DEPTH   2
+
+typedef struct {
+    uint32_t from;
+    uint32_t to;
+    uint32_t request_ts;
+} SummaryRequest_t;
+
+static TmStats_t s_tm_stats;
+static QueueHandle_t xSummaryRequestQueue;
+static TaskHandle_t s_logger_task;
+static SummaryServiceStats_t s_summary_stats;
+static uint16_t s_summary_seq;
+static portMUX_TYPE s_summary_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- WARM RESTART ---
+// Packet sequences and the downlink resume state go into the checkpoint
+// whenever they change, so a reset neither restarts the counts ground sees
+// nor resends what an earlier pass already delivered. The archive time
+// base goes with them so the next boot can continue the clock.
+typedef struct {
+    uint16_t hk_rsp_seq;
+    uint16_t summary_seq;
+    uint32_t time_base;
+    DownlinkResume_t downlink;
+} LoggerCheckpoint_t;
+
+static LoggerCheckpoint_t s_checkpoint;    // Last record written or restored
+static FirstTelemetry_t s_first_tm;
+static uint32_t s_time_base;               // Archive time at tick 0 of this boot
+
+static void save_checkpoint(void) {
+    s_checkpoint.hk_rsp_seq = s_hk_rsp_seq;
+    s_checkpoint.summary_seq = s_summary_seq;
+    s_checkpoint.time_base = s_time_base;
+    if (s_archive_ready) {
+        downlink_save_resume(&s_downlink, &s_checkpoint.downlink);
+    }
+    checkpoint_write(CHECKPOINT_LOGGER, &s_checkpoint, sizeof(s_checkpoint), (uint32_t)xTaskGetTickCount());
+}
+
+uint32_t data_logger_archive_time(TickType_t tick) {
+    return s_time_base + (uint32_t)tick;
+}
+
+// This boot's clock starts where the previous one stopped: its last sign of
+// life from the checkpoint if there is one, and never before the newest
+// record, which is all a power-on reset leaves
+static void start_archive_time(int restored, const CheckpointInfo_t *info) {
+    CheckpointStats_t cp;
+    uint32_t last_ts;
+
+    s_time_base = 0;
+    if (restored) {
+        checkpoint_get_stats(&cp);
+        uint32_t ticks = (cp.last_alive_valid && info->boot + 1u == cp.boot) ? cp.last_alive_tick : info->tick;
+        s_time_base = s_checkpoint.time_base + ticks + 1u;
+    }
+    if (tm_archive_last_timestamp(&g_tm_archive, &last_ts) == 0 && last_ts >= s_time_base) {
+        s_time_base = last_ts + 1u;
+    }
+}
+
+void data_logger_get_first_telemetry(FirstTelemetry_t *first) {
+    *first = s_first_tm;
+    first->valid = __atomic_load_n(&s_first_tm.valid, __ATOMIC_ACQUIRE);
+}
+
+// Placeholder radio driver: the Comms subsystem would take the codeblock here
+static int radio_transmit(void *ctx, const uint8_t *frame, size_t len) {
+    (void)ctx;
+    if (s_radio_tap != NULL) {
+        s_radio_tap(s_radio_tap_ctx, frame, len);
+    }
+    return 0;
+}
+
+// Every packet source goes through the coder
+static int radio_send(void *ctx, const uint8_t *frame, size_t len) {
+    (void)ctx;
+    return downlink_fec_send(&s_fec, frame, len);
+}
+
+static void publish_fec_stats(void) {
+    portENTER_CRITICAL(&s_fec_mux);
+    s_fec_stats = s_fec.stats;
+    portEXIT_CRITICAL(&s_fec_mux);
+}
+
+void data_logger_get_fec_stats(DownlinkFecStats_t *stats) {
+    portENTER_CRITICAL(&s_fec_mux);
+    *stats = s_fec_stats;
+    portEXIT_CRITICAL(&s_fec_mux);
+}
+
+void data_logger_set_radio_tap(DownlinkSendFn_t tap, void *ctx) {
+    s_radio_tap_ctx = ctx;
+    s_radio_tap = tap;
+}
+
+void data_logger_get_hk_response_stats(HkResponseStats_t *stats) {
+    portENTER_CRITICAL(&s_hk_rsp_mux);
+    *stats = s_hk_rsp_stats;
+    portEXIT_CRITICAL(&s_hk_rsp_mux);
+}
+
+void data_logger_get_summary_stats(SummaryServiceStats_t *stats) {
+    portENTER_CRITICAL(&s_summary_mux);
+    *stats = s_summary_stats;
+    portEXIT_CRITICAL(&s_summary_mux);
+}
+
+static uint32_t now_ms(void) {
+    return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+BaseType_t data_logger_request_pass(uint32_t duration_ms) {
+    if (xDownlinkRequestQueue == NULL) {
+        return pdFAIL;
+    }
+    return xQueueSend(xDownlinkRequestQueue, &duration_ms, 0);
+}
+
+void data_logger_get_last_pass(DownlinkPassStats_t *pass) {
+    downlink_get_last_pass(&s_downlink, pass);
+}
+
+static void print_pass_report(void) {
+    DownlinkPassStats_t pass;
+
+    downlink_get_last_pass(&s_downlink, &pass);
+    printf("DATA LOGGER: --- DOWNLINK PASS %lu COMPLETE --- %lu records in %lu frames, %lu/%lu B (%u%% of link), "
+           "backlog %lu records (%lu B), %lu send errors. Resuming Archiving.\n",
+           (unsigned long)pass.pass_number, (unsigned long)pass.records_sent, (unsigned long)pass.frames_sent,
+           (unsigned long)pass.bytes_sent, (unsigned long)pass.budget_bytes,
+           (unsigned)pass.utilization_pct, (unsigned long)pass.backlog_records,
+           (unsigned long)pass.backlog_bytes, (unsigned long)pass.send_errors);
+}
+
+// Applies pass requests and streams frames while a pass is open
+static void service_downlink(void) {
+    uint32_t duration_ms;
+
+    // 1. Requests: a non-zero duration opens a pass, zero closes it (LOS)
+    while (xQueueReceive(xDownlinkRequestQueue, &duration_ms, 0) == pdPASS) {
+        if (duration_ms == 0) {
+            if (downlink_is_active(&s_downlink)) {
+                downlink_pass_end(&s_downlink, now_ms());
+                print_pass_report();
+            }
+        } else if (s_logger_mode != MODE_NOMINAL) {
+            FSW_LOGW(LOG_MOD_LOGGER, "DATA LOGGER: Downlink pass refused, system not in NOMINAL mode.\n");
+        } else {
+            // Make the packets still sitting in the RAM page readable
+            tm_archive_flush(&g_tm_archive);
+            if (downlink_pass_begin(&s_downlink, now_ms(), duration_ms) == 0) {
+                FSW_LOGI(LOG_MOD_LOGGER, "DATA LOGGER: --- DOWNLINK PASS ACTIVE --- %lu ms at %u bps\n",
+                         (unsigned long)duration_ms, (unsigned)DOWNLINK_LINK_RATE_BPS);
+            }
+        }
+    }
+
+    if (!downlink_is_active(&s_downlink)) {
+        return;
+    }
+
+    // 2. Leaving NOMINAL mode closes the pass early
+    if (s_logger_mode != MODE_NOMINAL) {
+        downlink_pass_end(&s_downlink, now_ms());
+    } else {
+        downlink_service(&s_downlink, now_ms());
+    }
+    if (!downlink_is_active(&s_downlink)) {
+        print_pass_report();
+    }
+}
+
+// TC_REQUEST_SUMMARY payload: [0..3] from, [4..7] to (archive time, big-endian)
+static int validate_request_summary(const TelecommandPacket_t *tc) {
+    uint32_t from = ccsds_get_be32(&tc->payload[0]);
+    uint32_t to = ccsds_get_be32(&tc->payload[4]);
+    return (to >= from) ? 0 : -1;
+}
+
+// Runs in the TC processor: the query itself reads flash, so it is left to
+// the logger, which owns the archive
+static void handle_request_summary(const TelecommandPacket_t *tc) {
+    SummaryRequest_t req;
+
+    req.from = ccsds_get_be32(&tc->payload[0]);
+    req.to = ccsds_get_be32(&tc->payload[4]);
+    req.request_ts = tc->timestamp;
+    if (xQueueSend(xSummaryRequestQueue, &req, 0) != pdPASS) {
+        FSW_LOGW(LOG_MOD_LOGGER, "DATA LOGGER: Summary request dropped, queue full.\n");
+        return;
+    }
+    if (s_logger_task != NULL) {
+        xTaskNotifyGive(s_logger_task);
+    }
+}
+
+BaseType_t data_logger_init(void) {
+    CheckpointInfo_t info;
+    int restored = (checkpoint_get(CHECKPOINT_LOGGER, &s_checkpoint, sizeof(s_checkpoint), &info) == 0);
+
+    if (restored) {
+        s_hk_rsp_seq = s_checkpoint.hk_rsp_seq;
+        s_summary_seq = s_checkpoint.summary_seq;
+    }
+
+    // 0. Radio coding first: HK responses go out even without an archive
+    if (downlink_fec_init(&s_fec, DATA_LOGGER_FEC_DEPTH, radio_transmit, NULL) != 0) {
+        printf("DATA LOGGER: ERROR! Downlink coder unavailable.\n");
+        return pdFAIL;
+    }
+
+    // 1. Open the flash region behind the archive
+#ifdef ESP_PLATFORM
+    int opened = flash_partition_open(&s_archive_flash, "tm_archive");
+#else
+    int opened = flash_file_open(&s_archive_flash, DATA_LOGGER_HOST_IMAGE,
+                                 DATA_LOGGER_SECTOR_SIZE, DATA_LOGGER_SECTOR_COUNT);
+#endif
+    if (opened != 0) {
+        printf("DATA LOGGER: ERROR! Archive flash unavailable. Logging to console only.\n");
+        return pdFAIL;
+    }
+
+    // 2. Recover the log from page headers; start a fresh one if that fails
+    if (tm_archive_mount(&g_tm_archive, &s_archive_flash) != 0 &&
+        tm_archive_format(&g_tm_archive, &s_archive_flash) != 0) {
+        printf("DATA LOGGER: ERROR! Archive mount and format failed. Logging to console only.\n");
+        return pdFAIL;
+    }
+
+    start_archive_time(restored, &info);
+    printf("DATA LOGGER: Archive mounted. %lu pages recovered, %lu corrupt, time base %lu.\n",
+           (unsigned long)g_tm_archive.stats.pages_recovered,
+           (unsigned long)g_tm_archive.stats.pages_corrupt, (unsigned long)s_time_base);
+
+    // 3. Downlink engine on top of the archive
+    xDownlinkRequestQueue = rtos_queue_create("DL_REQUEST", DOWNLINK_REQUEST_DEPTH, sizeof(uint32_t));
+    if (xDownlinkRequestQueue == NULL ||
+        downlink_init(&s_downlink, &g_tm_archive,
+                      downlink_fec_info_rate(DOWNLINK_LINK_RATE_BPS, DATA_LOGGER_FEC_DEPTH),
+                      DOWNLINK_POLICY, radio_send, NULL) != 0) {
+        printf("DATA LOGGER: ERROR! Downlink engine unavailable.\n");
+        return pdFAIL;
+    }
+    downlink_set_compression(&s_downlink, DOWNLINK_COMPRESS_HK);
+    if (restored) {
+        uint32_t kept = downlink_restore_resume(&s_downlink, &s_checkpoint.downlink);
+        printf("DATA LOGGER: Downlink resumed after pass %lu, %lu pages already sent.\n",
+               (unsigned long)s_checkpoint.downlink.pass_number, (unsigned long)kept);
+    }
+
+    // 4. Statistics in the page trailers, summaries on request
+    tm_stats_init(&s_tm_stats);
+    xSummaryRequestQueue = rtos_queue_create("SUM_REQUEST", SUMMARY_REQUEST_DEPTH, sizeof(SummaryRequest_t));
+    if (xSummaryRequestQueue == NULL ||
+        tm_archive_set_trailer(&g_tm_archive, TM_STATS_TRAILER_LEN, tm_stats_fill_trailer, &s_tm_stats) != 0 ||
+        tc_proc_register_handler(TC_REQUEST_SUMMARY, "REQUEST_SUMMARY", validate_request_summary,
+                                 handle_request_summary) != pdPASS) {
+        printf("DATA LOGGER: ERROR! Telemetry summaries unavailable.\n");
+        return pdFAIL;
+    }
+
+    s_archive_ready = 1;
+    save_checkpoint();      // The next boot continues from this base
+    return pdPASS;
+}
+
+// Sends every waiting HK response before anything else the logger does
+static void service_hk_responses(void) {
+    static uint8_t packet[CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN +
+                          HK_RESP_WIRE_LEN + CCSDS_CRC_LEN];
+    uint8_t wire[HK_RESP_WIRE_LEN];
+    HK_Response_t *rsp;
+    int sent = 0;
+
+    while ((rsp = (HK_Response_t *)packet_pool_receive(&g_hk_response_pool, 0)) != NULL) {
+        // 1. Record and TC timestamp into one space packet of its own APID
+        size_t wire_len = hk_response_pack(rsp->request_timestamp, &rsp->hk, wire);
+        size_t len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TM, APID_HK_RESPONSE,
+                                        s_hk_rsp_seq++, xTaskGetTickCount(), wire, wire_len);
+        int status = (len > 0) ? radio_send(NULL, packet, len) : -1;
+        sent++;
+
+        // 2. Command-to-telemetry latency
+        uint32_t latency_us = util_get_time_us() - rsp->request_us;
+        uint32_t latency_ticks = (uint32_t)xTaskGetTickCount() - rsp->request_tick;
+
+        portENTER_CRITICAL(&s_hk_rsp_mux);
+        if (status != 0) {
+            s_hk_rsp_stats.send_errors++;
+        } else {
+            s_hk_rsp_stats.sent++;
+            s_hk_rsp_stats.latency_last_us = latency_us;
+            s_hk_rsp_stats.latency_sum_us += latency_us;
+            if (latency_us > s_hk_rsp_stats.latency_max_us) {
+                s_hk_rsp_stats.latency_max_us = latency_us;
+            }
+            if (latency_ticks > s_hk_rsp_stats.latency_max_ticks) {
+                s_hk_rsp_stats.latency_max_ticks = latency_ticks;
+            }
+        }
+        portEXIT_CRITICAL(&s_hk_rsp_mux);
+
+        FSW_LOGI(LOG_MOD_LOGGER, "DATA LOGGER: HK response for request T: %lu sent in %lu us.\n",
+                 (unsigned long)rsp->request_timestamp, (unsigned long)latency_us);
+        packet_pool_release(&g_hk_response_pool, rsp);
+    }
+
+    // Priority lane: the answers leave now, not when a codeblock fills up
+    if (sent > 0) {
+        downlink_fec_flush(&s_fec);
+    }
+}
+
+// Answers every waiting TC_REQUEST_SUMMARY from the page aggregates
+static void service_summaries(void) {
+    static uint8_t packet[CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN +
+                          TM_SUMMARY_WIRE_LEN + CCSDS_CRC_LEN];
+    static TmStatsSummary_t summary;
+    uint8_t wire[TM_SUMMARY_WIRE_LEN];
+    SummaryRequest_t req;
+
+    while (xQueueReceive(xSummaryRequestQueue, &req, 0) == pdPASS) {
+        // 1. Merge the trailers of the window (an empty window still gets an answer)
+        uint32_t t0 = util_get_time_us();
+        tm_stats_query(&s_tm_stats, &g_tm_archive, req.from, req.to, &summary);
+        uint32_t query_us = util_get_time_us() - t0;
+
+        // 2. One space packet of its own APID
+        size_t wire_len = tm_summary_pack(req.request_ts, &summary, wire);
+        size_t len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TM, APID_TM_SUMMARY,
+                                        s_summary_seq++, xTaskGetTickCount(), wire, wire_len);
+        int status = (len > 0) ? radio_send(NULL, packet, len) : -1;
+
+        portENTER_CRITICAL(&s_summary_mux);
+        if (status != 0) {
+            s_summary_stats.send_errors++;
+        } else {
+            s_summary_stats.sent++;
+        }
+        s_summary_stats.query_us_last = query_us;
+        if (query_us > s_summary_stats.query_us_max) {
+            s_summary_stats.query_us_max = query_us;
+        }
+        s_summary_stats.last = summary;
+        portEXIT_CRITICAL(&s_summary_mux);
+
+        FSW_LOGI(LOG_MOD_LOGGER, "DATA LOGGER: Summary %lu..%lu sent, %lu pages (%lu missing).\n",
+                 (unsigned long)summary.first_ts, (unsigned long)summary.last_ts,
+                 (unsigned long)summary.pages, (unsigned long)summary.pages_missing);
+    }
+}
+
+static void apply_mode_events(void) {
+    ModeChangeEvent_t event;
+
+    if (s_mode_sub < 0) {
+        s_logger_mode = get_system_mode();      // No subscription: fall back to polling
+    } else if (mode_take_event(s_mode_sub, &event)) {
+        s_logger_mode = event.new_mode;
+        FSW_LOGD(LOG_MOD_LOGGER, "DATA LOGGER: Mode %d -> %d (gen %lu)\n", event.old_mode,
+                 event.new_mode, (unsigned long)event.generation);
+    }
+}
 
 void vDataLoggerTask(void *pvParameters){
-    HK_Telemetry_t rx_log_packet;
-    const TickType_t xLogWaitTime = pdMS_TO_TICKS(100);
+    HkSampleFrame_t *rx_log_packet;
+    HkSampleSet_t set;
+    TickType_t xLogWaitTime;
 
-    printf("DATA LOGGER: Task initialized, monitoring telemetry queue.\n");
+    // Telemetry, HK responses, summary requests and mode changes all arrive
+    // as task notifications
+    s_logger_task = xTaskGetCurrentTaskHandle();
+    s_mode_sub = mode_subscribe(xTaskGetCurrentTaskHandle(), &s_logger_mode);
+    packet_pool_set_consumer(&g_telemetry_pool, xTaskGetCurrentTaskHandle());
+    packet_pool_set_consumer(&g_hk_response_pool, xTaskGetCurrentTaskHandle());
+
+    printf("DATA LOGGER: Task initialized, monitoring telemetry pool.\n");
+    TRACE_TASK_START();
 
     for(;;){
-        // Attempt to retrieve a packet from the Telemetry Queue
-        if (xQueueReceive(xTelemetryQueue, &rx_log_packet, xLogWaitTime) == pdPASS) {
-            
-            // --- DATA RETRIEVED: SIMULATE WRITING TO FLASH/SD CARD ---
-            // The FSW is now guaranteed safe access to this data.
+        // During a pass the logger wakes every tick so the link stays busy
+        xLogWaitTime = (s_archive_ready && downlink_is_active(&s_downlink)) ? 1 : pdMS_TO_TICKS(100);
+        uint16_t hk_rsp_seq = s_hk_rsp_seq;
+        uint16_t summary_seq = s_summary_seq;
+        uint16_t tm_sequence = s_downlink.tm_sequence;
+        int pass_active = downlink_is_active(&s_downlink);
 
-            printf("DATA LOGGER: SUCCESS! Archived packet T: %lu | V: %.2f V\n",
-                   rx_log_packet.timestamp, 
-                   (double)rx_log_packet.bus_voltage);
+        TRACE_EVENT(TRACE_TASK_SLEEP, NULL, 0);
+        ulTaskNotifyTake(pdTRUE, xLogWaitTime);
+        TRACE_EVENT(TRACE_TASK_WAKE, NULL, 0);
+        apply_mode_events();
+        service_hk_responses();
+
+        // Drain the Telemetry Pool (pointers, no copy)
+        while ((rx_log_packet = (HkSampleFrame_t *)packet_pool_receive(&g_telemetry_pool, 0)) != NULL) {
             
-            // Placeholder: In a real system, SPIFFS or FATFS write functions 
-            // would be called here to save the data persistently.
-        
-        } else {
-            // Log queue status (optional, for debug)
-            // printf("DATA LOGGER: Queue empty, sleeping...\n");
+            // --- DATA RETRIEVED: APPEND TO THE FLASH ARCHIVE ---
+            // The logger owns this slot until it is released below. Sample
+            // sets arrive in wire format (hk_sched.h) and are archived as
+            // they are, tagged so the downlink sends them on APID_HK_SAMPLES.
+            // Appends are buffered in RAM and reach flash one full page at a
+            // time. The statistics count the set once it is in the page, so
+            // they describe exactly what the archive holds.
+
+            uint32_t archive_ts = data_logger_archive_time(rx_log_packet->timestamp);
+            uint32_t write_errors = g_tm_archive.stats.write_errors;
+            if (!s_archive_ready) {
+                // Reported on the first lost set, then every DATA_LOGGER_UNARCHIVED_REPORT
+                if (s_unarchived++ % DATA_LOGGER_UNARCHIVED_REPORT == 0) {
+                    FSW_LOGW(LOG_MOD_LOGGER, "DATA LOGGER: Archive unavailable, HK sample set T: %lu not stored (%lu lost).\n",
+                             (unsigned long)archive_ts, (unsigned long)s_unarchived);
+                }
+            } else if (tm_archive_append_kind(&g_tm_archive, TM_RECORD_HK_SAMPLES, archive_ts,
+                                              rx_log_packet->wire, rx_log_packet->length) != 0) {
+                FSW_LOGE(LOG_MOD_LOGGER, "DATA LOGGER: ERROR! Archive rejected packet T: %lu\n",
+                         (unsigned long)archive_ts);
+            } else {
+                if (g_tm_archive.stats.write_errors != write_errors) {
+                    FSW_LOGE(LOG_MOD_LOGGER, "DATA LOGGER: ERROR! Archive page lost before T: %lu\n",
+                             (unsigned long)archive_ts);
+                }
+                if (hk_samples_unpack(rx_log_packet->wire, rx_log_packet->length, &set) == PKT_SCHEMA_OK) {
+                    set.timestamp = archive_ts;
+                    tm_stats_add(&s_tm_stats, &set);
+                }
+                FSW_LOGD(LOG_MOD_LOGGER, "DATA LOGGER: SUCCESS! Archived HK sample set T: %lu (%u B)\n",
+                         (unsigned long)archive_ts, (unsigned)rx_log_packet->length);
+
+                // Boot-to-first-telemetry: the first set that made it into the archive
+                if (!s_first_tm.valid) {
+                    s_first_tm.tick = (uint32_t)xTaskGetTickCount();
+                    s_first_tm.time_us = util_get_time_us();
+                    s_first_tm.mode = s_logger_mode;
+                    __atomic_store_n(&s_first_tm.valid, 1, __ATOMIC_RELEASE);
+                }
+            }
+
+            packet_pool_release(&g_telemetry_pool, rx_log_packet);
+        }
+
+        if (s_archive_ready) {
+            service_summaries();
         }
 
-        // --- DOWNLINK STRATEGY: RETRIEVE ARCHIVED DATA ---
+        // --- DOWNLINK STRATEGY: STREAM ARCHIVED DATA ---
         // Downlink only happens if we are over a ground station AND in the correct FSW mode
 
-        if (g_downlink_mode == DOWNLINK_ACTIVE && get_system_mode() == MODE_NOMINAL) {
-            // Placeholder: Retrieve data from simulated archive (e.g., SD card)
-            // For simplicity, I just print a burst signal.
-            printf("DATA LOGGER: --- DOWNLINK BURST ACTIVE --- \n");
-        
+        if (s_archive_ready) {
+            service_downlink();
+        }
 
-            for(int i = 0; i<5 ;i++){
-                // In a real system, retrieve archived_packet[i] and send via radio queue.
-                printf("DATA LOGGER: Sending Archived Packet %d... \n", i + 1);
-            }
-            printf("DATA LOGGER: --- DOWNLINK COMPLETE. Resuming Archiving. ---\n");
+        // Outside a pass nothing else will fill the current codeblock
+        if (!downlink_is_active(&s_downlink)) {
+            downlink_fec_flush(&s_fec);
+        }
+        publish_fec_stats();
 
-            // After downlink, signal the window is closed
-            g_downlink_mode = DOWNLINK_INACTIVE;
+        if (hk_rsp_seq != s_hk_rsp_seq || summary_seq != s_summary_seq ||
+            tm_sequence != s_downlink.tm_sequence || pass_active != downlink_is_active(&s_downlink)) {
+            save_checkpoint();
         }
 
         watchdog_pet(WDT_TASK_DATA_LOG);
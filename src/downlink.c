@@ -0,0 +1,380 @@
+// src/downlink.c
+
+#include "downlink.h"
+#include "ccsds_packet.h"
+#include "tm_archive.h"
+#include "hk_compress.h"
+#include "packet_schema.h"
+#include "satellite_types.h"
+#include <stdint.h>
+#include <string.h>
+
+#define DOWNLINK_MAX_USER_DATA  (CCSDS_MAX_PACKET_LEN - DOWNLINK_FRAME_OVERHEAD)
+
+// --- HELPERS: SENT BITMAP ---
+
+// Bits only describe the sector generation they were set for. Once the
+// archive erases and rewrites a sector, its old bits are meaningless.
+static void sync_sector(Downlink_t *dl, uint32_t page) {
+    uint32_t pps = dl->archive->pages_per_sector;
+    uint32_t sector = page / pps;
+    uint32_t seq = dl->archive->index[sector].first_seq;
+
+    if (dl->sector_seq[sector] != seq) {
+        for (uint32_t p = sector * pps; p < (sector + 1) * pps; p++) {
+            dl->sent[p / 8] &= (uint8_t)~(1u << (p % 8));
+        }
+        dl->sector_seq[sector] = seq;
+    }
+}
+
+static int page_sent(Downlink_t *dl, uint32_t page) {
+    sync_sector(dl, page);
+    return (dl->sent[page / 8] >> (page % 8)) & 1u;
+}
+
+static void mark_sent(Downlink_t *dl, uint32_t page) {
+    sync_sector(dl, page);
+    dl->sent[page / 8] |= (uint8_t)(1u << (page % 8));
+}
+
+// On-air size of a page's records once each one is wrapped in a TM packet
+static uint32_t frame_bytes(uint32_t records, uint32_t record_bytes) {
+    return record_bytes - records * TM_ARCHIVE_RECORD_HDR_LEN + records * DOWNLINK_FRAME_OVERHEAD;
+}
+
+// --- HELPERS: SCAN ORDER ---
+
+static uint32_t scan_page(const Downlink_t *dl, uint32_t step) {
+    uint32_t total = tm_archive_page_count(dl->archive);
+
+    if (dl->policy == DOWNLINK_OLDEST_FIRST) {
+        return (dl->scan_origin + step) % total;               // Oldest page follows the write page
+    }
+    return (dl->scan_origin + total - 1 - step) % total;       // Newest page precedes it
+}
+
+// Opens the next unsent page in policy order. Returns 0 if there is one.
+static int open_next_page(Downlink_t *dl) {
+    TmArchivePageHeader_t hdr;
+    uint32_t total = tm_archive_page_count(dl->archive);
+
+    while (dl->scan_step < total) {
+        uint32_t page = scan_page(dl, dl->scan_step++);
+        if (page_sent(dl, page) || tm_archive_open_page(dl->archive, page, &hdr, &dl->cursor) != 0) {
+            continue;
+        }
+
+        // The page cut off by the end of the previous pass continues where it stopped
+        if (dl->resume_valid && dl->resume.page == page && dl->resume.sequence == hdr.sequence) {
+            dl->cursor = dl->resume;
+            dl->resume_valid = 0;
+        }
+        dl->page_records = hdr.record_count;
+        dl->page_open = 1;
+        return 0;
+    }
+    return -1;
+}
+
+// Gives up the page under `at` after a failed read. A page that is still in
+// place has bad data and is never retried; an overwritten one is left to the
+// sector generation check.
+static void abandon_page(Downlink_t *dl, const TmArchiveCursor_t *at) {
+    TmArchivePageHeader_t hdr;
+    TmArchiveCursor_t probe;
+
+    if (tm_archive_open_page(dl->archive, at->page, &hdr, &probe) == 0 && hdr.sequence == at->sequence) {
+        mark_sent(dl, at->page);
+    }
+    dl->page_open = 0;
+}
+
+// --- HELPERS: FRAMING ---
+
+typedef struct {
+    uint16_t apid;
+    uint32_t met;               // Timestamp of the first record
+    size_t user_len;
+    uint32_t records;
+} FramedRecords_t;
+
+// One archive record as the user data of one TM packet. Returns 0 with a
+// record framed, -1 if it was skipped or the page was given up.
+static int pack_plain(Downlink_t *dl, uint8_t *user, FramedRecords_t *out) {
+    TmArchiveCursor_t here = dl->cursor;
+    uint16_t len;
+
+    if (tm_archive_read_next(dl->archive, &dl->cursor, &out->met, user, DOWNLINK_MAX_USER_DATA, &len) != 1 ||
+        dl->cursor.page != here.page) {
+        abandon_page(dl, &here);
+        return -1;
+    }
+    if (len > DOWNLINK_MAX_USER_DATA) {
+        dl->pass.send_errors++; // Does not fit a TM packet: skip it
+        return -1;
+    }
+
+    out->apid = (dl->cursor.kind == TM_RECORD_HK_SAMPLES) ? APID_HK_SAMPLES : APID_HOUSEKEEPING;
+    out->user_len = len;
+    out->records = 1;
+    return 0;
+}
+
+// As many HK records of the open page as one compressed frame holds
+static int pack_compressed(Downlink_t *dl, uint8_t *user, FramedRecords_t *out) {
+    HkEncoder_t enc;
+    HK_Telemetry_t pkt;
+    uint8_t wire[HK_TM_WIRE_LEN];
+
+    hk_encoder_begin(&enc, user, DOWNLINK_MAX_USER_DATA);
+    while (dl->cursor.record < dl->page_records) {
+        TmArchiveCursor_t before = dl->cursor;
+        uint32_t ts;
+        uint16_t len;
+
+        int got = tm_archive_read_next(dl->archive, &dl->cursor, &ts, wire, sizeof(wire), &len);
+        if (got != 1 || dl->cursor.page != before.page || dl->cursor.kind != TM_RECORD_HK ||
+            hk_tm_unpack(wire, len, &pkt) != PKT_SCHEMA_OK || hk_encoder_add(&enc, &pkt) != 0) {
+            // Stop here; a record that cannot be packed is handled on its own next time
+            dl->cursor = before;
+            if (enc.count == 0) {
+                return pack_plain(dl, user, out);
+            }
+            break;
+        }
+        if (enc.count == 1) {
+            out->met = ts;
+        }
+    }
+
+    out->apid = APID_HK_COMPRESSED;
+    out->user_len = hk_encoder_finish(&enc);
+    out->records = enc.count;
+    return 0;
+}
+
+// --- A. CONFIGURATION ---
+
+int downlink_init(Downlink_t *dl, TmArchive_t *archive, uint32_t link_rate_bps,
+                  DownlinkPolicy_t policy, DownlinkSendFn_t send, void *send_ctx) {
+    if (archive == NULL || send == NULL || link_rate_bps == 0 ||
+        tm_archive_page_count(archive) > DOWNLINK_MAX_PAGES) {
+        return -1;
+    }
+
+    memset(dl, 0, sizeof(*dl));
+    dl->archive = archive;
+    dl->send = send;
+    dl->send_ctx = send_ctx;
+    dl->link_rate_bps = link_rate_bps;
+    dl->policy = policy;
+    dl->mode = DOWNLINK_INACTIVE;
+    return 0;
+}
+
+void downlink_set_policy(Downlink_t *dl, DownlinkPolicy_t policy) {
+    dl->policy = policy;    // Takes effect at the next pass
+}
+
+void downlink_set_compression(Downlink_t *dl, int enable) {
+    dl->compress = (enable != 0);
+}
+
+// --- B. PASS CONTROL ---
+
+int downlink_pass_begin(Downlink_t *dl, uint32_t now_ms, uint32_t duration_ms) {
+    if (dl->mode == DOWNLINK_ACTIVE) {
+        return -1;
+    }
+
+    memset(&dl->pass, 0, sizeof(dl->pass));
+    dl->pass.pass_number = dl->last_pass.pass_number + 1;
+
+    dl->pass_start_ms = now_ms;
+    dl->pass_end_ms = now_ms + duration_ms;
+    dl->last_refill_ms = now_ms;
+    dl->tokens = 0;
+
+    dl->scan_origin = tm_archive_write_page(dl->archive);
+    dl->scan_step = 0;
+    dl->page_open = 0;
+    dl->mode = DOWNLINK_ACTIVE;
+    return 0;
+}
+
+void downlink_pass_end(Downlink_t *dl, uint32_t now_ms) {
+    TmArchivePageHeader_t hdr;
+    TmArchiveCursor_t probe;
+    DownlinkPassStats_t *pass = &dl->pass;
+
+    if (dl->mode != DOWNLINK_ACTIVE) {
+        return;
+    }
+
+    // 1. Remember how far the page in flight got
+    if (dl->page_open) {
+        dl->resume = dl->cursor;
+        dl->resume_valid = 1;
+        dl->page_open = 0;
+    }
+
+    // 2. Link usage against the budget of the time actually spent in the pass
+    if ((int32_t)(now_ms - dl->pass_end_ms) > 0) {
+        now_ms = dl->pass_end_ms;
+    }
+    pass->duration_ms = now_ms - dl->pass_start_ms;
+    pass->budget_bytes = (uint32_t)(((uint64_t)pass->duration_ms * dl->link_rate_bps) / 8000u);
+    pass->utilization_pct = (pass->budget_bytes > 0) ?
+        (uint16_t)(((uint64_t)pass->bytes_sent * 100u) / pass->budget_bytes) : 0;
+
+    // 3. Backlog: every unsent page, minus what the cut-off page already delivered
+    for (uint32_t page = 0; page < tm_archive_page_count(dl->archive); page++) {
+        if (page_sent(dl, page) || tm_archive_open_page(dl->archive, page, &hdr, &probe) != 0) {
+            continue;
+        }
+        uint32_t records = hdr.record_count;
+        uint32_t bytes = hdr.used_bytes;
+        if (dl->resume_valid && dl->resume.page == page && dl->resume.sequence == hdr.sequence) {
+            records -= dl->resume.record;
+            bytes -= (uint32_t)(dl->resume.offset - sizeof(TmArchivePageHeader_t));
+        }
+        pass->backlog_records += records;
+        pass->backlog_bytes += frame_bytes(records, bytes);
+    }
+
+    dl->last_pass = *pass;
+    dl->mode = DOWNLINK_INACTIVE;
+}
+
+void downlink_get_last_pass(const Downlink_t *dl, DownlinkPassStats_t *stats) {
+    *stats = dl->last_pass;
+}
+
+// --- C. RESUME ACROSS RESETS ---
+
+void downlink_save_resume(Downlink_t *dl, DownlinkResume_t *out) {
+    uint32_t pps = dl->archive->pages_per_sector;
+
+    memset(out, 0, sizeof(*out));
+
+    // 1. Drop the marks of reused sectors now; the snapshot has no generations
+    for (uint32_t sector = 0; sector < dl->archive->sector_count; sector++) {
+        sync_sector(dl, sector * pps);
+    }
+    memcpy(out->sent, dl->sent, sizeof(out->sent));
+    out->archive_sequence = dl->archive->next_sequence;
+
+    // 2. The page in flight resumes where the service loop left it
+    if (dl->mode == DOWNLINK_ACTIVE && dl->page_open) {
+        out->resume = dl->cursor;
+        out->resume_valid = 1;
+    } else {
+        out->resume = dl->resume;
+        out->resume_valid = dl->resume_valid;
+    }
+    out->tm_sequence = dl->tm_sequence;
+    out->pass_number = (dl->mode == DOWNLINK_ACTIVE) ? dl->pass.pass_number : dl->last_pass.pass_number;
+}
+
+uint32_t downlink_restore_resume(Downlink_t *dl, const DownlinkResume_t *in) {
+    uint32_t pps = dl->archive->pages_per_sector;
+    uint32_t kept = 0;
+    int archive_intact = (int32_t)(dl->archive->next_sequence - in->archive_sequence) >= 0;
+
+    dl->tm_sequence = in->tm_sequence;
+    dl->last_pass.pass_number = in->pass_number;
+    if (!archive_intact) {
+        return 0;
+    }
+
+    // A sector is the one the marks were set for if it started before the save
+    for (uint32_t sector = 0; sector < dl->archive->sector_count; sector++) {
+        uint32_t seq = dl->archive->index[sector].first_seq;
+        int same = (seq != 0 && (int32_t)(seq - in->archive_sequence) < 0);
+
+        dl->sector_seq[sector] = seq;
+        for (uint32_t p = sector * pps; p < (sector + 1) * pps; p++) {
+            uint8_t bit = (uint8_t)(1u << (p % 8));
+            if (same && (in->sent[p / 8] & bit)) {
+                dl->sent[p / 8] |= bit;
+                kept++;
+            } else {
+                dl->sent[p / 8] &= (uint8_t)~bit;
+            }
+        }
+    }
+    dl->resume = in->resume;
+    dl->resume_valid = in->resume_valid;
+    return kept;
+}
+
+// --- D. STREAMING ---
+
+uint32_t downlink_service(Downlink_t *dl, uint32_t now_ms) {
+    uint8_t frame[CCSDS_MAX_PACKET_LEN];
+    uint8_t user[DOWNLINK_MAX_USER_DATA];
+    uint32_t frames = 0;
+
+    if (dl->mode != DOWNLINK_ACTIVE) {
+        return 0;
+    }
+
+    // 1. Loss of signal
+    if ((int32_t)(now_ms - dl->pass_end_ms) >= 0) {
+        downlink_pass_end(dl, now_ms);
+        return 0;
+    }
+
+    // 2. Token bucket refill; time is only consumed in whole bytes so slow
+    //    links and short service periods do not round the rate down to zero
+    uint32_t earned = (uint32_t)(((uint64_t)(now_ms - dl->last_refill_ms) * dl->link_rate_bps) / 8000u);
+    if (earned > 0) {
+        dl->last_refill_ms += (uint32_t)(((uint64_t)earned * 8000u) / dl->link_rate_bps);
+        dl->tokens += earned;
+        if (dl->tokens > DOWNLINK_BURST_BYTES) {
+            dl->tokens = DOWNLINK_BURST_BYTES;
+        }
+    }
+
+    // 3. Stream frames while the budget lasts
+    for (;;) {
+        if (!dl->page_open && open_next_page(dl) != 0) {
+            break; // Backlog drained; pages written during the pass go out next pass
+        }
+        if (dl->cursor.record >= dl->page_records) {
+            mark_sent(dl, dl->cursor.page);
+            dl->page_open = 0;
+            continue;
+        }
+
+        TmArchiveCursor_t here = dl->cursor;
+        FramedRecords_t framed;
+        if ((dl->compress ? pack_compressed(dl, user, &framed) : pack_plain(dl, user, &framed)) != 0) {
+            continue;   // Record skipped or page given up
+        }
+
+        size_t frame_len = DOWNLINK_FRAME_OVERHEAD + framed.user_len;
+        if (dl->tokens < frame_len) {
+            dl->cursor = here;
+            break;
+        }
+
+        frame_len = ccsds_build_packet(frame, sizeof(frame), CCSDS_TYPE_TM, framed.apid,
+                                       dl->tm_sequence, framed.met, user, framed.user_len);
+        if (dl->send(dl->send_ctx, frame, frame_len) != 0) {
+            dl->pass.send_errors++;
+            dl->cursor = here;  // Radio busy: retry at the next service
+            break;
+        }
+
+        dl->tm_sequence++;
+        dl->tokens -= (uint32_t)frame_len;
+        dl->pass.frames_sent++;
+        dl->pass.records_sent += framed.records;
+        dl->pass.bytes_sent += (uint32_t)frame_len;
+        frames++;
+    }
+
+    return frames;
+}
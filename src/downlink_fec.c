@@ -0,0 +1,143 @@
+// src/downlink_fec.c
+
+#include "downlink_fec.h"
+#include "ccsds_packet.h"
+#include "rs_fec.h"
+#include "utils.h"
+#include <string.h>
+
+// Smallest space packet; a block with less room than this left goes out
+#define DOWNLINK_FEC_MIN_PACKET (CCSDS_PRIMARY_HEADER_LEN + CCSDS_CRC_LEN)
+
+// --- A. FLIGHT SIDE ---
+
+int downlink_fec_init(DownlinkFec_t *fec, unsigned depth, DownlinkSendFn_t send, void *send_ctx) {
+    if (depth > DOWNLINK_FEC_MAX_DEPTH || send == NULL) {
+        return -1;
+    }
+    memset(fec, 0, sizeof(*fec));
+    fec->depth = (uint8_t)depth;
+    fec->send = send;
+    fec->send_ctx = send_ctx;
+    return 0;
+}
+
+int downlink_fec_flush(DownlinkFec_t *fec) {
+    unsigned depth = fec->depth;
+    size_t data_len = DOWNLINK_FEC_DATA_LEN(depth);
+    uint8_t *data = &fec->block[CCSDS_ASM_LEN];
+
+    if (depth == 0 || fec->used == 0) {
+        return 0;
+    }
+
+    // 1. Fill, marker, then one RS codeword per interleave lane
+    uint32_t t0 = util_get_cycle_count();
+    memset(&data[fec->used], DOWNLINK_FEC_FILL, data_len - fec->used);
+    ccsds_put_be32(fec->block, CCSDS_ASM);
+    for (unsigned lane = 0; lane < depth; lane++) {
+        rs_encode(&data[lane], RS_K, depth, &data[data_len + lane]);
+    }
+    uint32_t cycles = util_get_cycle_count() - t0;
+
+    // 2. Radio
+    int status = fec->send(fec->send_ctx, fec->block, DOWNLINK_FEC_BLOCK_LEN(depth));
+    if (status != 0) {
+        fec->stats.send_errors++;
+    }
+    fec->stats.blocks++;
+    fec->stats.fill_bytes += (uint32_t)(data_len - fec->used);
+    if (cycles > fec->stats.encode_cycles_max) {
+        fec->stats.encode_cycles_max = cycles;
+    }
+    fec->used = 0;
+    return status;
+}
+
+int downlink_fec_send(void *ctx, const uint8_t *packet, size_t len) {
+    DownlinkFec_t *fec = (DownlinkFec_t *)ctx;
+    size_t data_len = DOWNLINK_FEC_DATA_LEN(fec->depth);
+    int status = 0;
+
+    if (fec->depth == 0) {
+        status = fec->send(fec->send_ctx, packet, len);
+        if (status != 0) {
+            fec->stats.send_errors++;
+            return status;
+        }
+    } else {
+        if (len == 0 || len > data_len) {
+            fec->stats.send_errors++;
+            return -1;
+        }
+        // A failed block only costs the packets already in it
+        if (fec->used + len > data_len) {
+            status = downlink_fec_flush(fec);
+        }
+        memcpy(&fec->block[CCSDS_ASM_LEN + fec->used], packet, len);
+        fec->used = (uint16_t)(fec->used + len);
+        if (data_len - fec->used < DOWNLINK_FEC_MIN_PACKET) {
+            status = downlink_fec_flush(fec);
+        }
+    }
+
+    fec->stats.packets++;
+    fec->stats.packet_bytes += (uint32_t)len;
+    return status;
+}
+
+uint32_t downlink_fec_info_rate(uint32_t link_rate_bps, unsigned depth) {
+    if (depth == 0) {
+        return link_rate_bps;
+    }
+    return (uint32_t)(((uint64_t)link_rate_bps * DOWNLINK_FEC_DATA_LEN(depth)) / DOWNLINK_FEC_BLOCK_LEN(depth));
+}
+
+// --- B. GROUND SIDE ---
+
+int downlink_fec_decode_block(uint8_t *block, unsigned depth, DownlinkFecPacketFn_t on_packet,
+                              void *ctx, DownlinkFecRxStats_t *stats) {
+    size_t data_len = DOWNLINK_FEC_DATA_LEN(depth);
+    uint8_t *data = &block[CCSDS_ASM_LEN];
+    int result = 0;
+
+    if (depth == 0 || depth > DOWNLINK_FEC_MAX_DEPTH) {
+        return -1;
+    }
+
+    // 1. Correct every lane where it lies
+    stats->blocks++;
+    for (unsigned lane = 0; lane < depth; lane++) {
+        int fixed = rs_decode(&data[lane], RS_K, depth);
+        stats->codewords++;
+        if (fixed < 0) {
+            stats->uncorrectable++;
+            result = -1;
+        } else {
+            stats->corrected += (uint32_t)fixed;
+        }
+    }
+
+    // 2. Packets up to the fill; each one still has to pass its own CRC
+    size_t off = 0;
+    while (off + CCSDS_PRIMARY_HEADER_LEN <= data_len && data[off] != DOWNLINK_FEC_FILL) {
+        CCSDS_PrimaryHeader_t hdr;
+        size_t len;
+
+        if (ccsds_decode_primary(&data[off], data_len - off, &hdr) != 0 ||
+            (len = ccsds_packet_length(&hdr)) < DOWNLINK_FEC_MIN_PACKET || off + len > data_len) {
+            stats->bad_packets++;
+            break;                              // Length unknown: nothing after it can be found
+        }
+        if (crc16_ccitt(&data[off], len - CCSDS_CRC_LEN) == ccsds_get_be16(&data[off + len - CCSDS_CRC_LEN])) {
+            stats->packets++;
+            if (on_packet != NULL) {
+                on_packet(ctx, &data[off], len);
+            }
+        } else {
+            stats->bad_packets++;
+        }
+        off += len;
+    }
+    return result;
+}
@@ -2,47 +2,177 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "eps_control.h"
+#include "param_store.h"
 #include "state_manager.h"
 #include "watchdog.h"
+#include "utils.h"
+#include "trace.h"
+#include "fsw_log.h"
 #include <stdio.h>
 
-#define CRITICAL_BUS_VOLTAGE 2.5f
+#ifndef ESP_PLATFORM
+// The simulated bus of the host day: 3.3 V with noise and a deep one-sample
+// glitch every ~8 s (must not trip), collapsing to 2.4 V at T+30 s (must trip).
+static EpsSynthConfig_t s_sim_bus = {
+    .nominal_mv = 3300,
+    .fault_mv = 2400,
+    .noise_mv = 30,
+    .glitch_mv = 900,
+    .glitch_every = 7919,
+    .fault_onset_ms = 30000,
+    .rng = 0x45505331u,
+};
+#endif
+
+static const EpsFdirConfig_t s_fdir_config = {
+    .trip_mv = EPS_TRIP_MV,
+    .clear_mv = EPS_CLEAR_MV,
+    .trip_batches = EPS_TRIP_BATCHES,
+    .clear_batches = EPS_CLEAR_BATCHES,
+};
+
+static EpsSampleSource_t s_source;
+static EpsFilter_t s_filter;
+static EpsFdir_t s_fdir;
+static EPS_Status_t s_eps_status;      // Working copy, owned by the EPS task
+
+#ifdef ESP_PLATFORM
+// Stands in for an ADC that failed to configure: every batch is a read error
+static int eps_source_dead_read(void *ctx, uint16_t *samples_mv, size_t count) {
+    (void)ctx;
+    (void)samples_mv;
+    (void)count;
+    return -1;
+}
+#endif
+
+void eps_control_set_source(const EpsSampleSource_t *source) {
+    s_source = *source;
+}
+
+void eps_get_status(EPS_Status_t *status) {
+    ParamSnapshot_t snap;
+
+    param_read_group(PARAM_GROUP_EPS, &snap);
+    status->fault_code = (uint8_t)snap.value[PARAM_eps_fault_code];
+    status->bus_mv = (uint16_t)snap.value[PARAM_eps_bus_mv];
+    status->bus_ewma_mv = (uint16_t)snap.value[PARAM_eps_bus_ewma_mv];
+    status->batch_min_mv = (uint16_t)snap.value[PARAM_eps_batch_min_mv];
+    status->batch_max_mv = (uint16_t)snap.value[PARAM_eps_batch_max_mv];
+    status->samples = (uint32_t)snap.value[PARAM_eps_samples];
+    status->batches = (uint32_t)snap.value[PARAM_eps_batches];
+    status->read_errors = (uint32_t)snap.value[PARAM_eps_read_errors];
+    status->undervoltage_events = (uint32_t)snap.value[PARAM_eps_trips];
+    status->last_trip_tick = (uint32_t)snap.value[PARAM_eps_last_trip_tick];
+    status->filter_cycles_max = (uint32_t)snap.value[PARAM_eps_filter_cycles_max];
+}
+
+// One publish of the EPS group: readers see a whole batch or the previous one
+static void publish_status(const EPS_Status_t *status) {
+    param_write_begin(PARAM_GROUP_EPS);
+    param_write(PARAM_eps_fault_code, status->fault_code);
+    param_write(PARAM_eps_bus_mv, status->bus_mv);
+    param_write(PARAM_eps_bus_ewma_mv, status->bus_ewma_mv);
+    param_write(PARAM_eps_batch_min_mv, status->batch_min_mv);
+    param_write(PARAM_eps_batch_max_mv, status->batch_max_mv);
+    param_write(PARAM_eps_samples, (int32_t)status->samples);
+    param_write(PARAM_eps_batches, (int32_t)status->batches);
+    param_write(PARAM_eps_read_errors, (int32_t)status->read_errors);
+    param_write(PARAM_eps_trips, (int32_t)status->undervoltage_events);
+    param_write(PARAM_eps_last_trip_tick, (int32_t)status->last_trip_tick);
+    param_write(PARAM_eps_filter_cycles_max, (int32_t)status->filter_cycles_max);
+    param_write_end(PARAM_GROUP_EPS);
+}
 
 void vEPSMonitoringTask(void *pvParameters) {
-    
-    float current_bus_voltage = 3.2f;
+    uint16_t batch[EPS_BATCH_SAMPLES];
+    EpsBatchResult_t result = {0};
+    EpsHealth_t health = EPS_HEALTH_NOMINAL;
+    TickType_t last_wake;
+
+    // Default source: the ADC on the target, the simulated bus on the host
+    if (s_source.read == NULL) {
+#ifdef ESP_PLATFORM
+        if (eps_source_adc_open(&s_source, EPS_SAMPLE_RATE_HZ) != 0) {
+            FSW_LOGE(LOG_MOD_EPS, "EPS MON: ERROR! No bus voltage source, FDIR blind.\n");
+            s_source.sample_rate_hz = EPS_SAMPLE_RATE_HZ;
+            s_source.ctx = NULL;
+            s_source.read = eps_source_dead_read;
+        }
+#else
+        eps_source_synth_open(&s_source, &s_sim_bus, EPS_SAMPLE_RATE_HZ);
+#endif
+    }
+    eps_fdir_init(&s_fdir, &s_fdir_config);
+
+    printf("EPS Monitoring Task initialized, %u Hz in %u-sample batches.\n",
+           (unsigned)EPS_SAMPLE_RATE_HZ, (unsigned)EPS_BATCH_SAMPLES);
+    TRACE_TASK_START();
+    last_wake = xTaskGetTickCount();
 
-    printf("EPS Monitoring Task initialized and running.\n");
     for(;;) {
-        
-        // 1. Simulate Reading Voltage
-        // NOTE: We'll intentionally simulate a fault after 20 seconds.
-        if(xTaskGetTickCount() > pdMS_TO_TICKS(20000)) {
-            current_bus_voltage = 2.4f; // Injecting a simulated fault
+        TRACE_EVENT(TRACE_TASK_SLEEP, NULL, 0);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(EPS_BATCH_PERIOD_MS));
+        TRACE_EVENT(TRACE_TASK_WAKE, NULL, 0);
+
+        // 1. Acquire the samples taken during the period that just ended
+        int count = s_source.read(s_source.ctx, batch, EPS_BATCH_SAMPLES);
+        EpsHealth_t previous = health;
+        uint32_t c0 = util_get_cycle_count();
+
+        // 2. Filter and FDIR (fixed point only)
+        if (count > 0) {
+            if (s_eps_status.batches == 0) {
+                eps_filter_init(&s_filter, batch[0], EPS_EWMA_SHIFT);
+            }
+            eps_filter_run(&s_filter, batch, (size_t)count, &result);
+            health = eps_fdir_update(&s_fdir, result.mean_min_mv);
         }
-        // 2. FDIR (Fault Detection and Isolation) Logic
+        uint32_t cycles = util_get_cycle_count() - c0;
+
+        // 3. Update EPS_Status_t and publish it to the parameter store
+        if (count > 0) {
+            s_eps_status.bus_mv = result.mean_mv;
+            s_eps_status.bus_ewma_mv = result.ewma_mv;
+            s_eps_status.batch_min_mv = result.min_mv;
+            s_eps_status.batch_max_mv = result.max_mv;
+            s_eps_status.samples += (uint32_t)count;
+            s_eps_status.batches++;
+        } else if (count < 0) {
+            s_eps_status.read_errors++;
+        }
+        s_eps_status.fault_code = (health == EPS_HEALTH_UNDERVOLTAGE) ? EPS_FAULT_UVLO : EPS_FAULT_NONE;
+        if (health == EPS_HEALTH_UNDERVOLTAGE && previous != health) {
+            s_eps_status.undervoltage_events++;
+            s_eps_status.last_trip_tick = (uint32_t)xTaskGetTickCount();
+        }
+        if (cycles > s_eps_status.filter_cycles_max) {
+            s_eps_status.filter_cycles_max = cycles;
+        }
+        publish_status(&s_eps_status);
+
+        // 4. FDIR (Fault Detection and Isolation) action
+        if (health == EPS_HEALTH_UNDERVOLTAGE && get_system_mode() != MODE_CRITICAL) {
+            FSW_LOGE(LOG_MOD_EPS, "EPS MON: !!! CRITICAL FAULT DETECTED (V: %.2f V) !!!\n",
+                     (double)result.mean_min_mv / 1000.0);
 
-        if(current_bus_voltage < CRITICAL_BUS_VOLTAGE && get_system_mode() != MODE_CRITICAL){
-            printf("EPS MON: !!! CRITICAL FAULT DETECTED (V: %.2f V) !!!\n", current_bus_voltage);
-            
-            // 3. Recovery Action (Highest Authority)
             // Force FSW into the safest state using the protected function
             set_system_mode(MODE_CRITICAL);
-            
-            printf("EPS MON: FDIR complete. System forced into MODE_CRITICAL.\n");   
-        }
-        else {
-            // Nominal operation
-            // printf("EPS MON: Voltage nominal (%.2f V).\n", current_bus_voltage);
+
+            FSW_LOGW(LOG_MOD_EPS, "EPS MON: FDIR complete. System forced into MODE_CRITICAL.\n");
+        } else if (health == EPS_HEALTH_NOMINAL && previous != health) {
+            // Recovery is a ground decision; only report it
+            FSW_LOGW(LOG_MOD_EPS, "EPS MON: Bus recovered (%.2f V). Mode left to ground.\n",
+                     (double)result.mean_mv / 1000.0);
+        } else {
+            FSW_LOGD(LOG_MOD_EPS, "EPS MON: Voltage nominal (%.2f V).\n", (double)result.mean_mv / 1000.0);
         }
-        
+
         watchdog_pet(WDT_TASK_EPS_MON);
-        
-        vTaskDelay(pdMS_TO_TICKS(10000)); // Check every 10 seconds
     }
 }
 
 
 void vEPS_SetSafeModePower(int mode_id) {
     printf("STUB CALLED: EPS received power command (Mode ID: %d).\n", mode_id);
-}
\ No newline at end of file
+}
@@ -0,0 +1,89 @@
+// src/eps_filter.c
+
+#include "eps_filter.h"
+
+// --- A. FILTER KERNELS ---
+
+void eps_filter_init(EpsFilter_t *filter, uint16_t initial_mv, uint8_t ewma_shift) {
+    for (uint32_t i = 0; i < EPS_FILTER_MA_WINDOW; i++) {
+        filter->window[i] = initial_mv;
+    }
+    filter->sum = (uint32_t)initial_mv << EPS_FILTER_MA_LOG2;
+    filter->index = 0;
+    filter->ewma_q16 = (uint32_t)initial_mv << 16;
+    filter->ewma_shift = ewma_shift;
+}
+
+void eps_filter_run(EpsFilter_t *filter, const uint16_t *samples_mv, size_t count,
+                    EpsBatchResult_t *result) {
+    uint32_t sum = filter->sum;
+    uint32_t index = filter->index;
+    int32_t ewma = (int32_t)filter->ewma_q16;
+    uint32_t lo = UINT16_MAX, hi = 0;
+    uint32_t mean_min = UINT32_MAX;
+    uint8_t shift = filter->ewma_shift;
+
+    // Branch-free body: with a noisy bus every compare is a coin toss, and a
+    // mispredicted branch costs more than the arithmetic around it
+    for (size_t i = 0; i < count; i++) {
+        uint32_t x = samples_mv[i];
+
+        // 1. Raw extremes
+        lo = (x < lo) ? x : lo;
+        hi = (x > hi) ? x : hi;
+
+        // 2. Moving average: drop the oldest sample, add the new one
+        uint32_t slot = index & (EPS_FILTER_MA_WINDOW - 1u);
+        sum += x - filter->window[slot];
+        filter->window[slot] = (uint16_t)x;
+        index++;
+        uint32_t mean = sum >> EPS_FILTER_MA_LOG2;
+        mean_min = (mean < mean_min) ? mean : mean_min;
+
+        // 3. EWMA: y += (x - y) * 2^-shift, in Q16.16
+        ewma += (((int32_t)x << 16) - ewma) >> shift;
+    }
+
+    filter->sum = sum;
+    filter->index = index;
+    filter->ewma_q16 = (uint32_t)ewma;
+
+    result->mean_mv = (uint16_t)(sum >> EPS_FILTER_MA_LOG2);
+    result->ewma_mv = (uint16_t)(((uint32_t)ewma + 0x8000u) >> 16);
+    result->min_mv = (count > 0) ? (uint16_t)lo : result->mean_mv;
+    result->max_mv = (count > 0) ? (uint16_t)hi : result->mean_mv;
+    result->mean_min_mv = (count > 0) ? (uint16_t)mean_min : result->mean_mv;
+}
+
+// --- B. HYSTERESIS FDIR ---
+
+int eps_fdir_init(EpsFdir_t *fdir, const EpsFdirConfig_t *config) {
+    if (config->clear_mv <= config->trip_mv ||
+        config->trip_batches == 0 || config->clear_batches == 0) {
+        return -1;
+    }
+    fdir->config = *config;
+    fdir->state = EPS_HEALTH_NOMINAL;
+    fdir->streak = 0;
+    return 0;
+}
+
+EpsHealth_t eps_fdir_update(EpsFdir_t *fdir, uint16_t level_mv) {
+    const EpsFdirConfig_t *cfg = &fdir->config;
+
+    // Levels between trip_mv and clear_mv argue for neither state
+    if (fdir->state == EPS_HEALTH_NOMINAL) {
+        fdir->streak = (level_mv < cfg->trip_mv) ? fdir->streak + 1 : 0;
+        if (fdir->streak >= cfg->trip_batches) {
+            fdir->state = EPS_HEALTH_UNDERVOLTAGE;
+            fdir->streak = 0;
+        }
+    } else {
+        fdir->streak = (level_mv >= cfg->clear_mv) ? fdir->streak + 1 : 0;
+        if (fdir->streak >= cfg->clear_batches) {
+            fdir->state = EPS_HEALTH_NOMINAL;
+            fdir->streak = 0;
+        }
+    }
+    return fdir->state;
+}
@@ -0,0 +1,48 @@
+// src/eps_source_adc.c
+// Target source: bus voltage on an ADC1 channel behind a resistive divider.
+
+#ifdef ESP_PLATFORM
+
+#include "eps_source.h"
+#include "driver/adc.h"
+#include "esp_adc_cal.h"
+#include <stdio.h>
+
+#define EPS_ADC_CHANNEL         ADC1_CHANNEL_6      // GPIO34
+#define EPS_ADC_ATTEN           ADC_ATTEN_DB_11     // Up to ~3.1 V at the pin
+#define EPS_ADC_DIVIDER_NUM     2                   // Bus = pin * NUM / DEN (1:1 divider)
+#define EPS_ADC_DIVIDER_DEN     1
+#define EPS_ADC_VREF_MV         1100                // Used only without eFuse calibration
+
+static esp_adc_cal_characteristics_t s_adc_chars;
+
+// One-shot conversions taken back to back (~40 us each). The caller's batch
+// period sets the effective rate; the moving average smooths the burst.
+static int eps_adc_read(void *ctx, uint16_t *samples_mv, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int raw = adc1_get_raw(EPS_ADC_CHANNEL);
+        if (raw < 0) {
+            return -1;
+        }
+        uint32_t pin_mv = esp_adc_cal_raw_to_voltage((uint32_t)raw, &s_adc_chars);
+        uint32_t bus_mv = pin_mv * EPS_ADC_DIVIDER_NUM / EPS_ADC_DIVIDER_DEN;
+        samples_mv[i] = (uint16_t)((bus_mv > UINT16_MAX) ? UINT16_MAX : bus_mv);
+    }
+    return (int)count;
+}
+
+int eps_source_adc_open(EpsSampleSource_t *source, uint32_t sample_rate_hz) {
+    if (adc1_config_width(ADC_WIDTH_BIT_12) != ESP_OK ||
+        adc1_config_channel_atten(EPS_ADC_CHANNEL, EPS_ADC_ATTEN) != ESP_OK) {
+        printf("EPS: ERROR! ADC1 configuration failed.\n");
+        return -1;
+    }
+    esp_adc_cal_characterize(ADC_UNIT_1, EPS_ADC_ATTEN, ADC_WIDTH_BIT_12, EPS_ADC_VREF_MV, &s_adc_chars);
+
+    source->sample_rate_hz = sample_rate_hz;
+    source->ctx = NULL;
+    source->read = eps_adc_read;
+    return 0;
+}
+
+#endif // ESP_PLATFORM
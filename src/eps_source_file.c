@@ -0,0 +1,62 @@
+// src/eps_source_file.c
+// Host-only replay of a recorded bus voltage trace.
+
+#ifndef ESP_PLATFORM
+
+#include "eps_source.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    FILE *fp;
+    uint16_t last_mv;
+} EpsTraceFile_t;
+
+static int eps_file_read(void *ctx, uint16_t *samples_mv, size_t count) {
+    EpsTraceFile_t *f = (EpsTraceFile_t *)ctx;
+
+    for (size_t i = 0; i < count; i++) {
+        unsigned long mv;
+        if (f->fp != NULL && fscanf(f->fp, "%lu", &mv) == 1) {
+            f->last_mv = (uint16_t)((mv > UINT16_MAX) ? UINT16_MAX : mv);
+        } else if (f->fp != NULL) {
+            // End of the recording: hold the last level from here on
+            fclose(f->fp);
+            f->fp = NULL;
+        }
+        samples_mv[i] = f->last_mv;
+    }
+    return (int)count;
+}
+
+int eps_source_file_open(EpsSampleSource_t *source, const char *path, uint32_t sample_rate_hz) {
+    EpsTraceFile_t *f = calloc(1, sizeof(*f));
+    if (f == NULL) {
+        return -1;
+    }
+
+    f->fp = fopen(path, "r");
+    if (f->fp == NULL) {
+        printf("EPS: ERROR! Cannot open voltage trace %s.\n", path);
+        free(f);
+        return -1;
+    }
+
+    source->sample_rate_hz = sample_rate_hz;
+    source->ctx = f;
+    source->read = eps_file_read;
+    return 0;
+}
+
+void eps_source_file_close(EpsSampleSource_t *source) {
+    EpsTraceFile_t *f = (EpsTraceFile_t *)source->ctx;
+    if (f != NULL) {
+        if (f->fp != NULL) {
+            fclose(f->fp);
+        }
+        free(f);
+        source->ctx = NULL;
+    }
+}
+
+#endif // !ESP_PLATFORM
@@ -0,0 +1,39 @@
+// src/eps_source_synth.c
+// Synthetic bus voltage for the host run and for boards without the EPS ADC.
+
+#include "eps_source.h"
+
+static int eps_synth_read(void *ctx, uint16_t *samples_mv, size_t count) {
+    EpsSynthConfig_t *cfg = (EpsSynthConfig_t *)ctx;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t n = cfg->sample_index++;
+        uint32_t t_ms = (uint32_t)(((uint64_t)n * 1000u) / cfg->sample_rate_hz);
+        int32_t mv = (cfg->fault_onset_ms != 0 && t_ms >= cfg->fault_onset_ms) ? cfg->fault_mv
+                                                                              : cfg->nominal_mv;
+
+        // 1. Uniform noise from a 32-bit LCG (Numerical Recipes constants)
+        if (cfg->noise_mv > 0) {
+            cfg->rng = cfg->rng * 1664525u + 1013904223u;
+            mv += (int32_t)((cfg->rng >> 16) % (2u * cfg->noise_mv + 1u)) - cfg->noise_mv;
+        }
+
+        // 2. Single-sample glitch (ESD, load switching)
+        if (cfg->glitch_every != 0 && n % cfg->glitch_every == cfg->glitch_every - 1u) {
+            mv -= cfg->glitch_mv;
+        }
+
+        samples_mv[i] = (uint16_t)((mv < 0) ? 0 : (mv > UINT16_MAX) ? UINT16_MAX : mv);
+    }
+    return (int)count;
+}
+
+void eps_source_synth_open(EpsSampleSource_t *source, EpsSynthConfig_t *config,
+                           uint32_t sample_rate_hz) {
+    config->sample_rate_hz = sample_rate_hz;
+    config->sample_index = 0;
+
+    source->sample_rate_hz = sample_rate_hz;
+    source->ctx = config;
+    source->read = eps_synth_read;
+}
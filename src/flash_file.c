@@ -0,0 +1,118 @@
+// src/flash_file.c
+// Host-only stand-in for the archive flash partition.
+
+#ifndef ESP_PLATFORM
+
+#include "flash_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    FILE *fp;
+    uint32_t size;
+    uint32_t sector_size;
+} FlashFile_t;
+
+static int file_in_range(const FlashFile_t *f, uint32_t addr, size_t len) {
+    return (size_t)addr + len <= f->size;
+}
+
+static int flash_file_read(void *ctx, uint32_t addr, void *buf, size_t len) {
+    FlashFile_t *f = (FlashFile_t *)ctx;
+
+    if (!file_in_range(f, addr, len) || fseek(f->fp, (long)addr, SEEK_SET) != 0) {
+        return -1;
+    }
+    return (fread(buf, 1, len, f->fp) == len) ? 0 : -1;
+}
+
+static int flash_file_program(void *ctx, uint32_t addr, const void *buf, size_t len) {
+    FlashFile_t *f = (FlashFile_t *)ctx;
+    const uint8_t *src = (const uint8_t *)buf;
+    uint8_t chunk[256];
+
+    if (!file_in_range(f, addr, len)) {
+        return -1;
+    }
+
+    // NOR rule: programming can only turn 1s into 0s
+    while (len > 0) {
+        size_t n = (len < sizeof(chunk)) ? len : sizeof(chunk);
+        if (flash_file_read(ctx, addr, chunk, n) != 0) {
+            return -1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            chunk[i] &= src[i];
+        }
+        if (fseek(f->fp, (long)addr, SEEK_SET) != 0 || fwrite(chunk, 1, n, f->fp) != n) {
+            return -1;
+        }
+        addr += (uint32_t)n;
+        src += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int flash_file_erase_sector(void *ctx, uint32_t sector) {
+    FlashFile_t *f = (FlashFile_t *)ctx;
+    uint8_t blank[256];
+
+    if ((sector + 1u) * f->sector_size > f->size ||
+        fseek(f->fp, (long)(sector * f->sector_size), SEEK_SET) != 0) {
+        return -1;
+    }
+
+    memset(blank, 0xFF, sizeof(blank));
+    for (uint32_t done = 0; done < f->sector_size; done += sizeof(blank)) {
+        size_t n = (f->sector_size - done < sizeof(blank)) ? f->sector_size - done : sizeof(blank);
+        if (fwrite(blank, 1, n, f->fp) != n) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int flash_file_open(FlashBackend_t *flash, const char *path,
+                    uint32_t sector_size, uint32_t sector_count) {
+    FlashFile_t *f = (FlashFile_t *)calloc(1, sizeof(*f));
+    if (f == NULL) {
+        return -1;
+    }
+    f->sector_size = sector_size;
+    f->size = sector_size * sector_count;
+
+    // Reuse an existing image: that is what power-cut recovery runs against
+    f->fp = fopen(path, "r+b");
+    if (f->fp == NULL) {
+        f->fp = fopen(path, "w+b");
+        if (f->fp == NULL) {
+            free(f);
+            return -1;
+        }
+        for (uint32_t s = 0; s < sector_count; s++) {
+            flash_file_erase_sector(f, s);
+        }
+    }
+
+    flash->sector_size = sector_size;
+    flash->sector_count = sector_count;
+    flash->ctx = f;
+    flash->read = flash_file_read;
+    flash->program = flash_file_program;
+    flash->erase_sector = flash_file_erase_sector;
+    return 0;
+}
+
+void flash_file_close(FlashBackend_t *flash) {
+    FlashFile_t *f = (FlashFile_t *)flash->ctx;
+
+    if (f != NULL) {
+        fclose(f->fp);
+        free(f);
+    }
+    flash->ctx = NULL;
+}
+
+#endif // !ESP_PLATFORM
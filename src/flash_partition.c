@@ -0,0 +1,42 @@
+// src/flash_partition.c
+// Target backend: raw data partition on the ESP32 SPI flash.
+
+#ifdef ESP_PLATFORM
+
+#include "flash_backend.h"
+#include "esp_partition.h"
+#include <stdio.h>
+
+#define PARTITION_SECTOR_SIZE 4096   // SPI NOR erase unit on the ESP32
+
+static int flash_partition_read(void *ctx, uint32_t addr, void *buf, size_t len) {
+    return (esp_partition_read((const esp_partition_t *)ctx, addr, buf, len) == ESP_OK) ? 0 : -1;
+}
+
+static int flash_partition_program(void *ctx, uint32_t addr, const void *buf, size_t len) {
+    return (esp_partition_write((const esp_partition_t *)ctx, addr, buf, len) == ESP_OK) ? 0 : -1;
+}
+
+static int flash_partition_erase_sector(void *ctx, uint32_t sector) {
+    const esp_partition_t *part = (const esp_partition_t *)ctx;
+    return (esp_partition_erase_range(part, sector * PARTITION_SECTOR_SIZE, PARTITION_SECTOR_SIZE) == ESP_OK) ? 0 : -1;
+}
+
+int flash_partition_open(FlashBackend_t *flash, const char *label) {
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL) {
+        printf("FLASH: ERROR! Partition '%s' not found.\n", label);
+        return -1;
+    }
+
+    flash->sector_size = PARTITION_SECTOR_SIZE;
+    flash->sector_count = part->size / PARTITION_SECTOR_SIZE;
+    flash->ctx = (void *)part;
+    flash->read = flash_partition_read;
+    flash->program = flash_partition_program;
+    flash->erase_sector = flash_partition_erase_sector;
+    return 0;
+}
+
+#endif // ESP_PLATFORM
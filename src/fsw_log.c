@@ -0,0 +1,273 @@
+// src/fsw_log.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "fsw_log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FSW_LOG_RING_MASK   (FSW_LOG_RING_DEPTH - 1u)
+
+typedef char fsw_log_ring_is_power_of_two[((FSW_LOG_RING_DEPTH & FSW_LOG_RING_MASK) == 0) ? 1 : -1];
+
+// How each conversion is pulled from the va_list and handed back to snprintf
+typedef enum {
+    ARG_INT = 0,
+    ARG_UINT,
+    ARG_LONG,
+    ARG_ULONG,
+    ARG_SIZE,
+    ARG_DOUBLE,
+    ARG_STR,
+    ARG_PTR
+} FswLogArgType_t;
+
+uint8_t g_fsw_log_level[LOG_MOD_COUNT];
+
+static FswLogRecord_t s_ring[FSW_LOG_RING_DEPTH];
+static uint32_t s_head;             // Next record to write
+static uint32_t s_tail;             // Next record to drain
+static uint32_t s_drops_reported;
+static FswLogStats_t s_log_stats;
+static TaskHandle_t s_drain_task;
+static portMUX_TYPE s_log_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- A. FORMAT PARSING ---
+
+// Steps over one conversion starting after its '%'. Returns the character
+// after it, or NULL for "%%" and anything this logger does not support.
+static const char *scan_conversion(const char *p, uint8_t *type) {
+    int longs = 0, size = 0;
+
+    while (*p != '\0' && strchr("-+ #0", *p) != NULL) {
+        p++;
+    }
+    while ((*p >= '0' && *p <= '9') || *p == '.') {
+        p++;
+    }
+    for (; *p == 'l' || *p == 'h' || *p == 'z'; p++) {
+        longs += (*p == 'l');
+        size |= (*p == 'z');
+    }
+
+    switch (*p) {
+        case 'd': case 'i':
+            *type = size ? ARG_SIZE : (longs ? ARG_LONG : ARG_INT);
+            break;
+        case 'u': case 'x': case 'X': case 'o': case 'c':
+            *type = size ? ARG_SIZE : (longs ? ARG_ULONG : ARG_UINT);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            *type = ARG_DOUBLE;
+            break;
+        case 's':
+            *type = ARG_STR;
+            break;
+        case 'p':
+            *type = ARG_PTR;
+            break;
+        default:
+            return NULL;
+    }
+    return p + 1;
+}
+
+static void parse_site(FswLogSite_t *site) {
+    uint8_t count = 0;
+
+    for (const char *p = site->format; *p != '\0' && count < FSW_LOG_MAX_ARGS; ) {
+        uint8_t type;
+        const char *next;
+
+        if (*p++ != '%') {
+            continue;
+        }
+        next = scan_conversion(p, &type);
+        if (next == NULL) {
+            p += (*p == '%');
+            continue;
+        }
+        site->arg_types[count++] = type;
+        p = next;
+    }
+    site->arg_count = count;     // Written last: a racing writer just parses again
+}
+
+// --- B. PRODUCER ---
+
+void fsw_log_init(void) {
+    portENTER_CRITICAL(&s_log_mux);
+    s_head = 0;
+    s_tail = 0;
+    s_drops_reported = 0;
+    memset(&s_log_stats, 0, sizeof(s_log_stats));
+    portEXIT_CRITICAL(&s_log_mux);
+
+    for (int i = 0; i < LOG_MOD_COUNT; i++) {
+        g_fsw_log_level[i] = LOG_LEVEL_INFO;
+    }
+}
+
+void fsw_log_set_level(FswLogModule_t module, FswLogLevel_t level) {
+    if ((uint32_t)module < LOG_MOD_COUNT) {
+        g_fsw_log_level[module] = (uint8_t)level;
+    }
+}
+
+void fsw_log_get_stats(FswLogStats_t *stats) {
+    portENTER_CRITICAL(&s_log_mux);
+    *stats = s_log_stats;
+    portEXIT_CRITICAL(&s_log_mux);
+}
+
+void fsw_log_write(FswLogSite_t *site, ...) {
+    FswLogArg_t args[FSW_LOG_MAX_ARGS];
+    va_list ap;
+    int was_empty = 0;
+
+    if (site->arg_count == FSW_LOG_UNPARSED) {
+        parse_site(site);
+    }
+
+    // 1. Capture the raw arguments (bounded by FSW_LOG_MAX_ARGS)
+    va_start(ap, site);
+    for (uint8_t i = 0; i < site->arg_count; i++) {
+        switch (site->arg_types[i]) {
+            case ARG_INT:    args[i].i = va_arg(ap, int); break;
+            case ARG_UINT:   args[i].u = va_arg(ap, unsigned int); break;
+            case ARG_LONG:   args[i].i = (int32_t)va_arg(ap, long); break;
+            case ARG_ULONG:  args[i].u = (uint32_t)va_arg(ap, unsigned long); break;
+            case ARG_SIZE:   args[i].u = (uint32_t)va_arg(ap, size_t); break;
+            case ARG_DOUBLE: args[i].f = (float)va_arg(ap, double); break;
+            case ARG_STR:    args[i].s = va_arg(ap, const char *); break;
+            default:         args[i].s = (const char *)va_arg(ap, void *); break;
+        }
+    }
+    va_end(ap);
+
+    // 2. Claim a record; a full ring drops the new one
+    portENTER_CRITICAL(&s_log_mux);
+    uint32_t depth = s_head - s_tail;
+    if (depth >= FSW_LOG_RING_DEPTH) {
+        s_log_stats.dropped++;
+    } else {
+        FswLogRecord_t *record = &s_ring[s_head & FSW_LOG_RING_MASK];
+        record->site = site;
+        memcpy(record->args, args, sizeof(args));
+        s_head++;
+        s_log_stats.written++;
+        if (depth + 1 > s_log_stats.high_water) {
+            s_log_stats.high_water = depth + 1;
+        }
+        was_empty = (depth == 0);
+    }
+    portEXIT_CRITICAL(&s_log_mux);
+
+    // 3. The drain empties the ring on every wake, so only the first record needs one
+    if (was_empty && s_drain_task != NULL) {
+        xTaskNotifyGive(s_drain_task);
+    }
+}
+
+// --- C. CONSUMER ---
+
+int fsw_log_pop(FswLogRecord_t *record) {
+    int result = -1;
+
+    portENTER_CRITICAL(&s_log_mux);
+    if (s_tail != s_head) {
+        *record = s_ring[s_tail & FSW_LOG_RING_MASK];
+        s_tail++;
+        result = 0;
+    }
+    portEXIT_CRITICAL(&s_log_mux);
+    return result;
+}
+
+size_t fsw_log_format(const FswLogRecord_t *record, char *buf, size_t len) {
+    const FswLogSite_t *site = record->site;
+    const char *p = site->format;
+    size_t out = 0;
+    uint8_t arg = 0;
+
+    if (len == 0) {
+        return 0;
+    }
+
+    while (*p != '\0' && out + 1 < len) {
+        const char *next;
+        uint8_t type;
+        char spec[16];
+        int n;
+
+        // 1. Literal text (and "%%")
+        if (*p != '%' || arg >= site->arg_count ||
+            (next = scan_conversion(p + 1, &type)) == NULL ||
+            (size_t)(next - p) >= sizeof(spec)) {
+            if (p[0] == '%' && p[1] == '%') {
+                p++;
+            }
+            buf[out++] = *p++;
+            continue;
+        }
+
+        // 2. One conversion, formatted with the type it was captured as
+        memcpy(spec, p, (size_t)(next - p));
+        spec[next - p] = '\0';
+        const FswLogArg_t *a = &record->args[arg++];
+
+        switch (type) {
+            case ARG_INT:    n = snprintf(&buf[out], len - out, spec, (int)a->i); break;
+            case ARG_UINT:   n = snprintf(&buf[out], len - out, spec, (unsigned int)a->u); break;
+            case ARG_LONG:   n = snprintf(&buf[out], len - out, spec, (long)a->i); break;
+            case ARG_ULONG:  n = snprintf(&buf[out], len - out, spec, (unsigned long)a->u); break;
+            case ARG_SIZE:   n = snprintf(&buf[out], len - out, spec, (size_t)a->u); break;
+            case ARG_DOUBLE: n = snprintf(&buf[out], len - out, spec, (double)a->f); break;
+            case ARG_STR:    n = snprintf(&buf[out], len - out, spec, a->s ? a->s : "(null)"); break;
+            default:         n = snprintf(&buf[out], len - out, spec, (const void *)a->s); break;
+        }
+        if (n < 0) {
+            break;
+        }
+        out += ((size_t)n < len - out) ? (size_t)n : len - out - 1;
+        p = next;
+    }
+    buf[out] = '\0';
+    return out;
+}
+
+uint32_t fsw_log_drain(uint32_t max_records) {
+    FswLogRecord_t record;
+    char line[FSW_LOG_LINE_MAX];
+    uint32_t drained = 0;
+
+    while (drained < max_records && fsw_log_pop(&record) == 0) {
+        fsw_log_format(&record, line, sizeof(line));
+        fputs(line, stdout);
+        drained++;
+    }
+
+    // Report losses once per burst, not once per lost record
+    portENTER_CRITICAL(&s_log_mux);
+    uint32_t dropped = s_log_stats.dropped - s_drops_reported;
+    s_drops_reported = s_log_stats.dropped;
+    s_log_stats.drained += drained;
+    portEXIT_CRITICAL(&s_log_mux);
+
+    if (dropped > 0) {
+        printf("LOG: %lu records dropped, ring full.\n", (unsigned long)dropped);
+    }
+    return drained;
+}
+
+// LOG DRAIN TASK (lowest priority: runs when the flight tasks are idle)
+void vLogDrainTask(void *pvParameters) {
+    s_drain_task = xTaskGetCurrentTaskHandle();
+
+    for (;;) {
+        // Catches records written before the handle above was visible
+        fsw_log_drain(UINT32_MAX);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
@@ -0,0 +1,257 @@
+// src/hk_compress.c
+
+#include "hk_compress.h"
+#include "satellite_types.h"
+#include "packet_schema.h"   // Status flag byte, wire CRC
+#include "ccsds_packet.h"   // Big-endian helpers
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+#define HK_FRAME_HDR_LEN    3       // magic + count
+#define HK_QUANT_INVALID    INT32_MIN
+
+// --- HELPERS: FIELD CONVERSION ---
+
+static int32_t quantize(float value, float lsb) {
+    float q = value / lsb;
+
+    if (q != q) {
+        return HK_QUANT_INVALID;                    // NaN survives the round trip
+    }
+    if (q >= 2147483520.0f) {
+        return INT32_MAX;
+    }
+    if (q <= -2147483520.0f) {
+        return INT32_MIN + 1;
+    }
+    return (int32_t)(q + ((q >= 0.0f) ? 0.5f : -0.5f));
+}
+
+static float dequantize(int32_t q, float lsb) {
+    return (q == HK_QUANT_INVALID) ? NAN : (float)q * lsb;
+}
+
+static int fits_signed(int64_t v, unsigned bits) {
+    return v >= -((int64_t)1 << (bits - 1)) && v < ((int64_t)1 << (bits - 1));
+}
+
+static int32_t sign_extend(uint32_t v, unsigned bits) {
+    uint32_t sign = 1u << (bits - 1);
+    return (int32_t)((v ^ sign) - sign);
+}
+
+// --- A. ENCODER ---
+
+// Writes the low `n` bits of `value`, MSB first, a byte-sized chunk at a time
+static int put_bits(HkEncoder_t *enc, uint32_t value, unsigned n) {
+    if (enc->bits + n > enc->cap_bits) {
+        return -1;
+    }
+
+    while (n > 0) {
+        unsigned used = (unsigned)(enc->bits % 8);
+        unsigned room = 8 - used;
+        unsigned take = (n < room) ? n : room;
+        uint8_t *byte = &enc->buf[HK_FRAME_HDR_LEN + enc->bits / 8];
+        uint8_t chunk = (uint8_t)((value >> (n - take)) & ((1u << take) - 1u));
+
+        if (used == 0) {
+            *byte = 0;
+        }
+        *byte |= (uint8_t)(chunk << (room - take));
+        enc->bits += take;
+        n -= take;
+    }
+    return 0;
+}
+
+// '0' for no change, then three widening escapes; the last one carries `raw`
+static int put_varying(HkEncoder_t *enc, int64_t delta, unsigned short_bits,
+                       unsigned long_bits, uint32_t raw) {
+    if (delta == 0) {
+        return put_bits(enc, 0x0, 1);
+    }
+    if (fits_signed(delta, short_bits)) {
+        return (put_bits(enc, 0x2, 2) == 0 && put_bits(enc, (uint32_t)delta, short_bits) == 0) ? 0 : -1;
+    }
+    if (fits_signed(delta, long_bits)) {
+        return (put_bits(enc, 0x6, 3) == 0 && put_bits(enc, (uint32_t)delta, long_bits) == 0) ? 0 : -1;
+    }
+    return (put_bits(enc, 0x7, 3) == 0 && put_bits(enc, raw, 32) == 0) ? 0 : -1;
+}
+
+int hk_encoder_begin(HkEncoder_t *enc, uint8_t *buf, size_t cap) {
+    if (buf == NULL || cap < HK_FRAME_OVERHEAD + HK_KEYFRAME_BITS / 8) {
+        return -1;
+    }
+
+    memset(enc, 0, sizeof(*enc));
+    enc->buf = buf;
+    enc->cap_bits = (cap - HK_FRAME_OVERHEAD) * 8;
+    return 0;
+}
+
+int hk_encoder_add(HkEncoder_t *enc, const HK_Telemetry_t *pkt) {
+    HkEncoder_t saved = *enc;
+    int32_t volt_q = quantize(pkt->bus_voltage, HK_VOLT_LSB);
+    int32_t temp_q = quantize(pkt->ext_temp_c, HK_TEMP_LSB);
+    uint8_t flags = hk_flags_pack(&pkt->status_flags);
+    int32_t step = (int32_t)(pkt->timestamp - enc->last_ts);
+    int result;
+
+    if (enc->count == UINT16_MAX) {
+        return -1;
+    }
+
+    if (enc->count == 0) {
+        // 1. Keyframe: every field in full
+        result = (put_bits(enc, pkt->timestamp, 32) == 0 &&
+                  put_bits(enc, pkt->sequence_count, 16) == 0 &&
+                  put_bits(enc, flags, 8) == 0 &&
+                  put_bits(enc, (uint32_t)volt_q, 32) == 0 &&
+                  put_bits(enc, (uint32_t)temp_q, 32) == 0) ? 0 : -1;
+        step = 0;
+    } else {
+        // 2. Delta record: timestamp as delta-of-delta, the rest against the last sample
+        int seq_next = (pkt->sequence_count == (uint16_t)(enc->last_seq + 1));
+        result = (put_varying(enc, (int64_t)step - enc->last_step, 8, 16, (uint32_t)step) == 0 &&
+                  (seq_next ? put_bits(enc, 0x0, 1)
+                            : (put_bits(enc, 0x1, 1) == 0 ? put_bits(enc, pkt->sequence_count, 16) : -1)) == 0 &&
+                  (flags == enc->last_flags ? put_bits(enc, 0x0, 1)
+                                            : (put_bits(enc, 0x1, 1) == 0 ? put_bits(enc, flags, 8) : -1)) == 0 &&
+                  put_varying(enc, (int64_t)volt_q - enc->last_volt_q, 4, 10, (uint32_t)volt_q) == 0 &&
+                  put_varying(enc, (int64_t)temp_q - enc->last_temp_q, 4, 10, (uint32_t)temp_q) == 0) ? 0 : -1;
+    }
+
+    // 3. Frame full: roll back, clearing any bits written past the old end
+    if (result != 0) {
+        *enc = saved;
+        if (enc->bits % 8 != 0) {
+            enc->buf[HK_FRAME_HDR_LEN + enc->bits / 8] &= (uint8_t)(0xFFu << (8 - enc->bits % 8));
+        }
+        return -1;
+    }
+
+    enc->last_ts = pkt->timestamp;
+    enc->last_step = step;
+    enc->last_seq = pkt->sequence_count;
+    enc->last_flags = flags;
+    enc->last_volt_q = volt_q;
+    enc->last_temp_q = temp_q;
+    enc->count++;
+    return 0;
+}
+
+size_t hk_encoder_finish(HkEncoder_t *enc) {
+    if (enc->count == 0) {
+        return 0;
+    }
+
+    size_t len = HK_FRAME_HDR_LEN + (enc->bits + 7) / 8;
+    enc->buf[0] = HK_FRAME_MAGIC;
+    ccsds_put_be16(&enc->buf[1], enc->count);
+    ccsds_put_be16(&enc->buf[len], crc16_ccitt(enc->buf, len));
+    return len + 2;
+}
+
+// --- B. DECODER ---
+
+typedef struct {
+    const uint8_t *data;
+    size_t bits;
+    size_t pos;
+    int overrun;
+} BitReader_t;
+
+static uint32_t get_bits(BitReader_t *rd, unsigned n) {
+    uint32_t value = 0;
+
+    if (rd->pos + n > rd->bits) {
+        rd->overrun = 1;
+        return 0;
+    }
+    for (unsigned i = 0; i < n; i++, rd->pos++) {
+        value = (value << 1) | ((rd->data[rd->pos / 8] >> (7 - rd->pos % 8)) & 1u);
+    }
+    return value;
+}
+
+// Returns the new value given the previous one (mirror of put_varying)
+static int64_t get_varying(BitReader_t *rd, int64_t previous, unsigned short_bits,
+                           unsigned long_bits) {
+    if (get_bits(rd, 1) == 0) {
+        return previous;
+    }
+    if (get_bits(rd, 1) == 0) {
+        return previous + sign_extend(get_bits(rd, short_bits), short_bits);
+    }
+    if (get_bits(rd, 1) == 0) {
+        return previous + sign_extend(get_bits(rd, long_bits), long_bits);
+    }
+    return (int32_t)get_bits(rd, 32);
+}
+
+int hk_decode_frame(const uint8_t *frame, size_t len, HK_Telemetry_t *out,
+                    size_t max_packets, size_t *count) {
+    BitReader_t rd;
+    uint32_t ts = 0;
+    int32_t step = 0;
+    uint16_t seq = 0;
+    uint8_t flags = 0;
+    int32_t volt_q = 0, temp_q = 0;
+
+    // 1. Envelope
+    if (frame == NULL || len < HK_FRAME_OVERHEAD || frame[0] != HK_FRAME_MAGIC ||
+        crc16_ccitt(frame, len - 2) != ccsds_get_be16(&frame[len - 2])) {
+        return -1;
+    }
+    uint16_t n = ccsds_get_be16(&frame[1]);
+    if (n > max_packets) {
+        return -1;
+    }
+
+    rd.data = &frame[HK_FRAME_HDR_LEN];
+    rd.bits = (len - HK_FRAME_OVERHEAD) * 8;
+    rd.pos = 0;
+    rd.overrun = 0;
+
+    // 2. Records
+    for (uint16_t i = 0; i < n; i++) {
+        if (i == 0) {
+            ts = get_bits(&rd, 32);
+            seq = (uint16_t)get_bits(&rd, 16);
+            flags = (uint8_t)get_bits(&rd, 8);
+            volt_q = (int32_t)get_bits(&rd, 32);
+            temp_q = (int32_t)get_bits(&rd, 32);
+        } else {
+            step = (int32_t)get_varying(&rd, step, 8, 16);
+            ts += (uint32_t)step;
+            seq = get_bits(&rd, 1) ? (uint16_t)get_bits(&rd, 16) : (uint16_t)(seq + 1);
+            if (get_bits(&rd, 1)) {
+                flags = (uint8_t)get_bits(&rd, 8);
+            }
+            volt_q = (int32_t)get_varying(&rd, volt_q, 4, 10);
+            temp_q = (int32_t)get_varying(&rd, temp_q, 4, 10);
+        }
+        if (rd.overrun) {
+            return -1;
+        }
+
+        HK_Telemetry_t *pkt = &out[i];
+        memset(pkt, 0, sizeof(*pkt));
+        pkt->timestamp = ts;
+        pkt->sequence_count = seq;
+        hk_flags_unpack(&pkt->status_flags, flags);
+        pkt->bus_voltage = dequantize(volt_q, HK_VOLT_LSB);
+        pkt->ext_temp_c = dequantize(temp_q, HK_TEMP_LSB);
+
+        // The checksum this record carries on the wire
+        uint8_t wire[HK_TM_WIRE_LEN];
+        hk_tm_pack(pkt, wire);
+        pkt->crc_checksum = ccsds_get_be16(&wire[HK_TM_OFF_crc]);
+    }
+
+    *count = n;
+    return 0;
+}
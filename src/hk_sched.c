@@ -0,0 +1,209 @@
+// src/hk_sched.c
+
+#include "hk_sched.h"
+#include "ccsds_packet.h"
+#include "utils.h"
+#include <string.h>
+
+// --- A. PARAMETER TABLE ---
+
+typedef enum {
+    TYPE_U8,
+    TYPE_U16,
+    TYPE_I16,
+    TYPE_U32
+} ParamType_t;
+
+typedef struct {
+    const char *name;
+    ParamType_t type;
+    uint16_t period_s[MODE_CRITICAL + 1];
+    int32_t deadband;
+} HkParamDef_t;
+
+#define HK_PARAM_DEF(name, type, safe_s, nominal_s, critical_s, deadband) \
+    { #name, TYPE_##type, { safe_s, nominal_s, critical_s }, deadband },
+static const HkParamDef_t s_params[HK_PARAM_COUNT] = {
+    HK_PARAM_TABLE(HK_PARAM_DEF)
+};
+#undef HK_PARAM_DEF
+
+uint32_t hk_sched_period_ms(HkParamId_t id, SystemMode_t mode) {
+    if ((uint32_t)id >= HK_PARAM_COUNT || (uint32_t)mode > MODE_CRITICAL) {
+        return 0;
+    }
+    return (uint32_t)s_params[id].period_s[mode] * 1000u;
+}
+
+const char *hk_param_name(HkParamId_t id) {
+    return ((uint32_t)id < HK_PARAM_COUNT) ? s_params[id].name : "?";
+}
+
+// --- B. FIELD CODECS ---
+// Values are held as int32_t and clamped to their wire type before the
+// deadband check, so what is compared is what the ground will see.
+
+static int32_t clamp_to_type(ParamType_t type, int32_t v) {
+    switch (type) {
+        case TYPE_U8:  return (v < 0) ? 0 : (v > UINT8_MAX) ? UINT8_MAX : v;
+        case TYPE_U16: return (v < 0) ? 0 : (v > UINT16_MAX) ? UINT16_MAX : v;
+        case TYPE_I16: return (v < INT16_MIN) ? INT16_MIN : (v > INT16_MAX) ? INT16_MAX : v;
+        case TYPE_U32:
+        default:       return (v < 0) ? 0 : v;
+    }
+}
+
+static size_t type_size(ParamType_t type) {
+    switch (type) {
+        case TYPE_U8:  return WIRE_SIZE_U8;
+        case TYPE_U16: return WIRE_SIZE_U16;
+        case TYPE_I16: return WIRE_SIZE_I16;
+        case TYPE_U32:
+        default:       return WIRE_SIZE_U32;
+    }
+}
+
+static size_t put_value(uint8_t *p, ParamType_t type, int32_t v) {
+    switch (type) {
+        case TYPE_U8:  p[0] = (uint8_t)v;                         return WIRE_SIZE_U8;
+        case TYPE_U16: ccsds_put_be16(p, (uint16_t)v);            return WIRE_SIZE_U16;
+        case TYPE_I16: ccsds_put_be16(p, (uint16_t)(int16_t)v);   return WIRE_SIZE_I16;
+        case TYPE_U32:
+        default:       ccsds_put_be32(p, (uint32_t)v);            return WIRE_SIZE_U32;
+    }
+}
+
+static size_t get_value(const uint8_t *p, ParamType_t type, int32_t *v) {
+    switch (type) {
+        case TYPE_U8:  *v = p[0];                                 return WIRE_SIZE_U8;
+        case TYPE_U16: *v = ccsds_get_be16(p);                    return WIRE_SIZE_U16;
+        case TYPE_I16: *v = (int16_t)ccsds_get_be16(p);           return WIRE_SIZE_I16;
+        case TYPE_U32:
+        default:       *v = (int32_t)ccsds_get_be32(p);           return WIRE_SIZE_U32;
+    }
+}
+
+// --- C. SCHEDULING ---
+
+void hk_sched_init(HkSched_t *sched, SystemMode_t mode, uint32_t now_ms) {
+    memset(sched, 0, sizeof(*sched));
+    hk_sched_set_mode(sched, mode, now_ms);
+}
+
+void hk_sched_set_mode(HkSched_t *sched, SystemMode_t mode, uint32_t now_ms) {
+    sched->mode = mode;
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        sched->next_due_ms[i] = now_ms;
+    }
+}
+
+size_t hk_sched_step(HkSched_t *sched, uint32_t now_ms, uint32_t timestamp,
+                     const int32_t value[HK_PARAM_COUNT], uint8_t *frame) {
+    uint16_t send = 0;
+    uint16_t scheduled = 0;     // Due or merged: these move on to their next slot
+    int32_t sample[HK_PARAM_COUNT];
+
+    sched->stats.steps++;
+
+    // 1. Due parameters, and parameters that left their deadband
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        const HkParamDef_t *def = &s_params[i];
+        uint16_t bit = (uint16_t)(1u << i);
+
+        sample[i] = clamp_to_type(def->type, value[i]);
+        if (def->period_s[sched->mode] == 0) {
+            continue;
+        }
+        if ((int32_t)(now_ms - sched->next_due_ms[i]) >= 0) {
+            send |= bit;
+            scheduled |= bit;
+            sched->stats.sent_due++;
+        } else {
+            int32_t delta = sample[i] - sched->last_sent[i];
+            if (delta > def->deadband || -delta > def->deadband) {
+                send |= bit;
+                sched->stats.sent_changed++;
+            }
+        }
+    }
+    if (send == 0) {
+        return 0;
+    }
+
+    // 2. A frame is going out anyway: what falls due soon takes its slot now
+    // (pulled in, or already in the frame because it changed)
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        uint32_t period_ms = hk_sched_period_ms((HkParamId_t)i, sched->mode);
+        uint16_t bit = (uint16_t)(1u << i);
+
+        if (period_ms != 0 && !(scheduled & bit) &&
+            sched->next_due_ms[i] - now_ms <= period_ms * HK_SCHED_MERGE_PCT / 100u) {
+            if (!(send & bit)) {
+                send |= bit;
+                sched->stats.sent_merged++;
+            }
+            scheduled |= bit;
+        }
+    }
+
+    // 3. Pack in table order. Scheduled parameters advance on a fixed grid
+    // from the last mode change, so harmonic periods keep landing in the same
+    // frame; a change sent in between does not move the grid.
+    size_t len = HK_SAMPLES_OFF_values;
+    ccsds_put_be32(&frame[HK_SAMPLES_OFF_timestamp], timestamp);
+    ccsds_put_be16(&frame[HK_SAMPLES_OFF_present], send);
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        if (send & (1u << i)) {
+            len += put_value(&frame[len], s_params[i].type, sample[i]);
+            sched->last_sent[i] = sample[i];
+        }
+        if (scheduled & (1u << i)) {
+            uint32_t period_ms = hk_sched_period_ms((HkParamId_t)i, sched->mode);
+            sched->next_due_ms[i] += period_ms;
+            if ((int32_t)(now_ms - sched->next_due_ms[i]) >= 0) {
+                sched->next_due_ms[i] = now_ms + period_ms;     // Fell behind: restart the grid
+            }
+        }
+    }
+    ccsds_put_be16(&frame[len], crc16_ccitt(frame, len));
+    len += WIRE_CRC_LEN;
+
+    sched->stats.frames++;
+    sched->stats.bytes += (uint32_t)len;
+    return len;
+}
+
+// --- D. GROUND DECODER ---
+
+int hk_samples_unpack(const uint8_t *frame, size_t len, HkSampleSet_t *set) {
+    size_t pos = HK_SAMPLES_OFF_values;
+
+    if (len < HK_SAMPLES_OVERHEAD || len > HK_SAMPLES_MAX_LEN) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+    memset(set, 0, sizeof(*set));
+    set->timestamp = ccsds_get_be32(&frame[HK_SAMPLES_OFF_timestamp]);
+    set->present = ccsds_get_be16(&frame[HK_SAMPLES_OFF_present]);
+
+    // 1. The present mask fixes the length
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        if (set->present & (1u << i)) {
+            pos += type_size(s_params[i].type);
+        }
+    }
+    if ((set->present >> HK_PARAM_COUNT) != 0 || pos + WIRE_CRC_LEN != len) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+    if (crc16_ccitt(frame, pos) != ccsds_get_be16(&frame[pos])) {
+        return PKT_SCHEMA_BAD_CRC;
+    }
+
+    // 2. Values
+    pos = HK_SAMPLES_OFF_values;
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        if (set->present & (1u << i)) {
+            pos += get_value(&frame[pos], s_params[i].type, &set->value[i]);
+        }
+    }
+    return PKT_SCHEMA_OK;
+}
@@ -10,43 +10,173 @@
 #include "eps_control.h"
 #include "task_defs.h"
 #include "watchdog.h"
+#include "state_manager.h"
+#include "param_store.h"
+#include "packet_pool.h"
+#include "ccsds_packet.h"
+#include "cdhs_router.h"
+#include "subsystem_hub.h"
+#include "data_logger.h"
+#include "tc_scheduler.h"
+#include "trace.h"
+#include "fsw_log.h"
+#include "rtos_alloc.h"
+#include "checkpoint.h"
 
 void vCommandInjectionTask(void *pvParameters);
-void vDataLoggerTask(void *pvParameters);
 
-SystemMode_t g_current_mode = MODE_SAFE;
 SemaphoreHandle_t xModeMutex;
-QueueHandle_t xTelemetryQueue;
+PacketPool_t g_telemetry_pool;
+PacketPool_t g_uplink_pool;
+PacketPool_t g_hk_response_pool;
 QueueHandle_t xCommandQueue;
+QueueHandle_t xAdcsQueue;
+QueueHandle_t xEpsQueue;
+QueueHandle_t xHkQueue;
+
+// HK sample sets are filled in place and handed to the logger by pointer,
+// across the cores (one producer, one consumer: lock-free rings). HK data
+// ages quickly, so when the logger falls behind the oldest waiting set is
+// the one given up.
+#define TM_POOL_DEPTH   8
+#define TM_POOL_POLICY  POOL_DROP_OLDEST
+static HkSampleFrame_t s_telemetry_slots[TM_POOL_DEPTH];
+
+// Answers to TC_REQUEST_HK skip the archive and go to the radio at once,
+// over the same kind of cross-core pool. An operator waiting on one wants
+// the first, so a burst beyond the depth is refused rather than overwriting it.
+#define HK_RESPONSE_POOL_DEPTH  TM_GEN_REQUEST_DEPTH
+static HK_Response_t s_hk_response_slots[HK_RESPONSE_POOL_DEPTH];
+
+// Uplink space packets wait here for the CDHS Router. Commands already
+// accepted are never discarded for newer ones. Deep enough for a full
+// xCommandQueue plus the router and subsystem inboxes in flight.
+#define UPLINK_POOL_DEPTH  (TC_PROC_QUEUE_DEPTH + 8)
+static CCSDS_Frame_t s_uplink_slots[UPLINK_POOL_DEPTH];
+
+// Every FSW task: name, entry point, priority, core (see rtos_alloc.h).
+// Stack sizes come from task_sizing.h (TASK_STACK_<name>), which a
+// profiling run regenerates.
+#if FSW_PROFILE_SECONDS
+#define FSW_PROFILE_TASK(X) X(RTOS_PROFILE, vRtosProfileTask, 1, FSW_CORE_DATA)
+#else
+#define FSW_PROFILE_TASK(X)
+#endif
+
+#define FSW_TASKS(X) \
+    X(WDT_MON,      vSoftwareWatchdogTask,      6, FSW_CORE_CONTROL) \
+    X(CDHS_ROUTER,  vCdhsRouterTask,            5, FSW_CORE_CONTROL) \
+    X(CMD_PROC,     vCommandProcessorTask,      5, FSW_CORE_CONTROL) \
+    X(TC_SCHED,     vTcSchedulerTask,           5, FSW_CORE_CONTROL) \
+    X(SUBSYS_HUB,   vSubsystemHubTask,          4, FSW_CORE_CONTROL) \
+    X(EPS_MON,      vEPSMonitoringTask,         4, FSW_CORE_CONTROL) \
+    X(TM_GEN,       vTelemetryGeneratorTask,    3, FSW_CORE_CONTROL) \
+    X(CMD_INJECT,   vCommandInjectionTask,      1, FSW_CORE_CONTROL) \
+    X(DATA_LOG,     vDataLoggerTask,            4, FSW_CORE_DATA)    \
+    X(LOG_DRAIN,    vLogDrainTask,              1, FSW_CORE_DATA)    \
+    FSW_PROFILE_TASK(X)
+
+#if FSW_STATIC_ALLOC
+#define TASK_BUFFERS(name, entry, prio, core) \
+    static StackType_t s_stack_##name[TASK_STACK_##name / sizeof(StackType_t)]; \
+    static StaticTask_t s_tcb_##name;
+FSW_TASKS(TASK_BUFFERS)
+#undef TASK_BUFFERS
+#define TASK_STACK(name)    s_stack_##name
+#define TASK_TCB(name)      (&s_tcb_##name)
+#else
+#define TASK_STACK(name)    NULL
+#define TASK_TCB(name)      NULL
+#endif
 
 void app_main(void) {
     printf("C&DH FSW Initialization Started...\n");
+    TRACE_INIT();
+    fsw_log_init();
 
-    xTelemetryQueue = xQueueCreate(5, sizeof(HK_Telemetry_t));
+    // Producers publish into the store from their first cycle on
+    if (param_store_init() != 0) {
+        printf("CRITICAL ERROR: Parameter table groups are not contiguous! System HALT.\n");
+        return;
+    }
+
+    // Restored before any owner of checkpointed state initialises. Without a
+    // region the FSW simply boots cold.
+    if (checkpoint_open() != 0) {
+        printf("WARNING: Checkpoint region unavailable, cold start.\n");
+    } else {
+        CheckpointStats_t cp;
+        checkpoint_get_stats(&cp);
+        printf("CHECKPOINT: %s reset, boot %lu, %lu sections restored (%lu corrupt slots) in %lu us.\n",
+               checkpoint_reset_name(cp.reset), (unsigned long)cp.boot, (unsigned long)cp.restored,
+               (unsigned long)cp.corrupt_slots, (unsigned long)cp.restore_us);
+    }
 
-    if (xTelemetryQueue == NULL) {
-        printf("CRITICAL ERROR: Failed to create Telemetry Queue! System HALT.\n");
+    if (packet_pool_init_spsc(&g_telemetry_pool, "TM", s_telemetry_slots, sizeof(HkSampleFrame_t),
+                              TM_POOL_DEPTH, TM_POOL_POLICY) != pdPASS) {
+        printf("CRITICAL ERROR: Failed to create Telemetry Pool! System HALT.\n");
         return;
     }
     
-    xCommandQueue = xQueueCreate(3, sizeof(TelecommandPacket_t));
-    if (xCommandQueue == NULL) {
-        printf("CRITICAL ERROR: Failed to create Command Queue! System HALT.\n");
+    if (packet_pool_init_spsc(&g_hk_response_pool, "HK_RSP", s_hk_response_slots, sizeof(HK_Response_t),
+                              HK_RESPONSE_POOL_DEPTH, POOL_DROP_NEWEST) != pdPASS) {
+        printf("CRITICAL ERROR: Failed to create HK Response Pool! System HALT.\n");
+        return;
+    }
+
+    if (packet_pool_init(&g_uplink_pool, "UPLINK", s_uplink_slots, sizeof(CCSDS_Frame_t),
+                         UPLINK_POOL_DEPTH, POOL_DROP_NEWEST, 0) != pdPASS) {
+        printf("CRITICAL ERROR: Failed to create Uplink Pool! System HALT.\n");
         return;
     }
 
-    xModeMutex = xSemaphoreCreateMutex();
+    // Router destination queues carry CCSDS_Frame_t pointers
+    xCommandQueue = rtos_queue_create("TC_QUEUE", TC_PROC_QUEUE_DEPTH, sizeof(CCSDS_Frame_t *));
+    xAdcsQueue = rtos_queue_create("ADCS_INBOX", SUBSYSTEM_INBOX_DEPTH, sizeof(CCSDS_Frame_t *));
+    xEpsQueue = rtos_queue_create("EPS_INBOX", SUBSYSTEM_INBOX_DEPTH, sizeof(CCSDS_Frame_t *));
+    xHkQueue = rtos_queue_create("HK_INBOX", SUBSYSTEM_INBOX_DEPTH, sizeof(CCSDS_Frame_t *));
+    if (xCommandQueue == NULL || xAdcsQueue == NULL || xEpsQueue == NULL || xHkQueue == NULL) {
+        printf("CRITICAL ERROR: Failed to create Command Queues! System HALT.\n");
+        return;
+    }
+
+    cdhs_router_init(&g_uplink_pool);
+    cdhs_router_set_destination(CDHS_DEST_CDHS, xCommandQueue);
+    cdhs_router_set_destination(CDHS_DEST_ADCS, xAdcsQueue);
+    cdhs_router_set_destination(CDHS_DEST_EPS, xEpsQueue);
+    cdhs_router_set_destination(CDHS_DEST_HK, xHkQueue);
+
+    xModeMutex = rtos_mutex_create("MODE_MUTEX");
     if (xModeMutex == NULL) {
         printf("CRITICAL ERROR: Failed to create Mode Mutex! System HALT.\n");
         return;
     }
+    state_manager_init();
 
-    xTaskCreate(vSoftwareWatchdogTask, "WDT_MON", 2048, NULL, 6, NULL);
-    xTaskCreate(vCommandProcessorTask, "CMD_PROC", 4096, NULL, 5, NULL); 
-    xTaskCreate(vEPSMonitoringTask, "EPS_MON", 2048, NULL, 4, NULL); 
-    xTaskCreate(vTelemetryGeneratorTask, "TM_GEN", 2048, NULL, 3, NULL);
-    xTaskCreate(vCommandInjectionTask, "CMD_INJECT", 2048, NULL, 1, NULL);
-    xTaskCreate(vDataLoggerTask, "DATA_LOG", 2048, NULL, 4, NULL);
-    
+    if (tc_scheduler_init() != pdPASS) {
+        printf("CRITICAL ERROR: Failed to create TC Scheduler! System HALT.\n");
+        return;
+    }
+
+    // A missing archive is not fatal: the logger falls back to console output
+    data_logger_init();
+
+    // Deadlines start now, after the slow archive mount
+    watchdog_init();
+
+#define CREATE_TASK(name, entry, prio, core) \
+    if (rtos_task_create(entry, #name, TASK_STACK_##name, prio, core, TASK_STACK(name), TASK_TCB(name)) != pdPASS) { \
+        printf("CRITICAL ERROR: Failed to create task %s! System HALT.\n", #name); \
+        return; \
+    }
+    FSW_TASKS(CREATE_TASK)
+#undef CREATE_TASK
+
+    RtosAllocStats_t alloc;
+    rtos_alloc_get_stats(&alloc);
+    printf("RTOS: %lu tasks, %lu queues, %lu mutexes (%lu static, queue arena %lu/%lu B).\n",
+           (unsigned long)alloc.tasks, (unsigned long)alloc.queues, (unsigned long)alloc.mutexes,
+           (unsigned long)alloc.static_objects, (unsigned long)alloc.arena_used,
+           (unsigned long)alloc.arena_size);
     printf("All tasks and communication channels launched. System running.\n");
 }
\ No newline at end of file
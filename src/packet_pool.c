@@ -0,0 +1,307 @@
+// src/packet_pool.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "packet_pool.h"
+#include "rtos_alloc.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+// --- HELPERS ---
+
+static int slot_belongs_to_pool(const PacketPool_t *pool, const void *slot) {
+    const uint8_t *p = (const uint8_t *)slot;
+    const uint8_t *end = pool->storage + (size_t)pool->slot_count * pool->slot_size;
+
+    return (p >= pool->storage) && (p < end) &&
+           (((size_t)(p - pool->storage) % pool->slot_size) == 0);
+}
+
+static uint16_t slot_index(const PacketPool_t *pool, const void *slot) {
+    return (uint16_t)(((const uint8_t *)slot - pool->storage) / pool->slot_size);
+}
+
+// The slot leaves the free list: flag it as owned again
+static void *take_slot(PacketPool_t *pool, void *slot) {
+    __atomic_store_n(&pool->slot_free[slot_index(pool, slot)], 0, __ATOMIC_RELAXED);
+    return slot;
+}
+
+// Cross-core pools: only the producer writes `stats`, only the consumer
+// writes `releases`; relaxed atomics keep the readers on the other core
+// from seeing torn values
+static void spsc_count(uint32_t *counter) {
+    __atomic_fetch_add(counter, 1u, __ATOMIC_RELAXED);
+}
+
+// Read from the other core the counters may be one event apart; never below 0
+static uint32_t spsc_in_use(PacketPool_t *pool) {
+    uint32_t releases = __atomic_load_n(&pool->releases, __ATOMIC_RELAXED);
+    uint32_t dropped = __atomic_load_n(&pool->stats.dropped_oldest, __ATOMIC_RELAXED);
+    int32_t in_use = (int32_t)(__atomic_load_n(&pool->stats.allocations, __ATOMIC_RELAXED) - dropped - releases);
+    return (in_use > 0) ? (uint32_t)in_use : 0u;
+}
+
+// Releases come from the consumer side of either kind of pool
+static void note_bad_release(PacketPool_t *pool) {
+    __atomic_fetch_add(&pool->stats.bad_releases, 1u, __ATOMIC_RELAXED);
+}
+
+static void note_allocation(PacketPool_t *pool) {
+    portENTER_CRITICAL(&pool->stats_mux);
+    pool->stats.allocations++;
+    pool->stats.in_use++;
+    if (pool->stats.in_use > pool->stats.high_water) {
+        pool->stats.high_water = pool->stats.in_use;
+    }
+    portEXIT_CRITICAL(&pool->stats_mux);
+}
+
+// --- A. POOL CREATION ---
+
+BaseType_t packet_pool_init(PacketPool_t *pool, const char *name,
+                            void *storage, size_t slot_size, uint16_t slot_count,
+                            PoolPolicy_t policy, TickType_t block_timeout) {
+    if (pool == NULL || storage == NULL || slot_size == 0 || slot_count == 0 ||
+        slot_count > PACKET_POOL_MAX_SLOTS) {
+        return pdFAIL;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    pool->name = name;
+    pool->storage = (uint8_t *)storage;
+    pool->slot_size = slot_size;
+    pool->slot_count = slot_count;
+    pool->policy = policy;
+    pool->block_timeout = block_timeout;
+    portMUX_INITIALIZE(&pool->stats_mux);
+
+    // Both queues hold pointers only: the payload never moves. The free
+    // list starts full, so only the ready queue is worth profiling.
+    pool->free_slots = rtos_queue_create(NULL, slot_count, sizeof(void *));
+    pool->ready_slots = rtos_queue_create(name, slot_count, sizeof(void *));
+    if (pool->free_slots == NULL || pool->ready_slots == NULL) {
+        printf("POOL %s: ERROR! Could not create slot queues.\n", name);
+        return pdFAIL;
+    }
+
+    for (uint16_t i = 0; i < slot_count; i++) {
+        void *slot = pool->storage + (size_t)i * slot_size;
+        pool->slot_free[i] = 1;
+        xQueueSend(pool->free_slots, &slot, 0);
+    }
+    return pdPASS;
+}
+
+BaseType_t packet_pool_init_spsc(PacketPool_t *pool, const char *name,
+                                 void *storage, size_t slot_size, uint16_t slot_count,
+                                 PoolPolicy_t policy) {
+    uint32_t ring_size = 1;
+
+    if (pool == NULL || storage == NULL || slot_size == 0 || slot_count == 0 ||
+        slot_count > PACKET_POOL_SPSC_MAX_SLOTS || policy == POOL_BLOCK) {
+        return pdFAIL;
+    }
+    while (ring_size < slot_count) {
+        ring_size <<= 1;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    pool->name = name;
+    pool->storage = (uint8_t *)storage;
+    pool->slot_size = slot_size;
+    pool->slot_count = slot_count;
+    pool->policy = policy;
+    pool->spsc = 1;
+    portMUX_INITIALIZE(&pool->stats_mux);
+
+    // Rings as deep as the pool: a push can never find them full
+    spsc_ring_init(&pool->free_ring, pool->ring_storage[0], ring_size);
+    spsc_ring_init(&pool->ready_ring, pool->ring_storage[1], ring_size);
+    TRACE_NAME(&pool->ready_ring, name);
+
+    for (uint16_t i = 0; i < slot_count; i++) {
+        pool->slot_free[i] = 1;
+        spsc_ring_push(&pool->free_ring, pool->storage + (size_t)i * slot_size);
+    }
+    return pdPASS;
+}
+
+// --- B. PRODUCER SIDE ---
+
+static void *spsc_alloc(PacketPool_t *pool) {
+    void *slot = spsc_ring_pop(&pool->free_ring);
+
+    if (slot == NULL && pool->policy == POOL_DROP_OLDEST &&
+        (slot = spsc_ring_drop_oldest(&pool->ready_ring)) != NULL) {
+        spsc_count(&pool->stats.dropped_oldest);
+    }
+    if (slot == NULL) {
+        spsc_count(&pool->stats.alloc_failures);
+        return NULL;
+    }
+    take_slot(pool, slot);
+
+    spsc_count(&pool->stats.allocations);
+    uint32_t in_use = spsc_in_use(pool);
+    if (in_use > pool->stats.high_water) {
+        __atomic_store_n(&pool->stats.high_water, (uint16_t)in_use, __ATOMIC_RELAXED);
+    }
+    return slot;
+}
+
+void *packet_pool_alloc(PacketPool_t *pool) {
+    void *slot = NULL;
+
+    if (pool->spsc) {
+        return spsc_alloc(pool);
+    }
+
+    // 1. Fast path: a free slot is available
+    if (xQueueReceive(pool->free_slots, &slot, 0) == pdPASS) {
+        note_allocation(pool);
+        return take_slot(pool, slot);
+    }
+
+    // 2. Pool exhausted: apply the backpressure policy
+    switch (pool->policy) {
+        case POOL_DROP_OLDEST:
+            // Steal the oldest packet the consumer has not picked up yet.
+            // The slot changes hands directly, so in_use does not move.
+            if (xQueueReceive(pool->ready_slots, &slot, 0) == pdPASS) {
+                portENTER_CRITICAL(&pool->stats_mux);
+                pool->stats.allocations++;
+                pool->stats.dropped_oldest++;
+                portEXIT_CRITICAL(&pool->stats_mux);
+                return slot;
+            }
+            break;
+
+        case POOL_BLOCK:
+            if (xQueueReceive(pool->free_slots, &slot, pool->block_timeout) == pdPASS) {
+                note_allocation(pool);
+                return take_slot(pool, slot);
+            }
+            break;
+
+        case POOL_DROP_NEWEST:
+        default:
+            break;
+    }
+
+    portENTER_CRITICAL(&pool->stats_mux);
+    pool->stats.alloc_failures++;
+    portEXIT_CRITICAL(&pool->stats_mux);
+    return NULL;
+}
+
+BaseType_t packet_pool_submit(PacketPool_t *pool, void *slot) {
+    if (!slot_belongs_to_pool(pool, slot)) {
+        printf("POOL %s: ERROR! Submit of foreign slot %p rejected.\n", pool->name, slot);
+        return pdFAIL;
+    }
+    if (pool->spsc) {
+        BaseType_t pushed = (spsc_ring_push(&pool->ready_ring, slot) == 0) ? pdPASS : pdFAIL;
+        TRACE_EVENT((pushed == pdPASS) ? TRACE_QUEUE_SEND : TRACE_QUEUE_FULL, &pool->ready_ring,
+                    spsc_ring_count(&pool->ready_ring));
+        if (pushed == pdPASS && pool->consumer != NULL) {
+            xTaskNotifyGive(pool->consumer);
+        }
+        return pushed;
+    }
+
+    // Cannot block: the ready queue is as deep as the pool
+    BaseType_t sent = xQueueSend(pool->ready_slots, &slot, 0);
+    TRACE_EVENT((sent == pdPASS) ? TRACE_QUEUE_SEND : TRACE_QUEUE_FULL, pool->ready_slots,
+                uxQueueMessagesWaiting(pool->ready_slots));
+    if (sent == pdPASS && pool->consumer != NULL) {
+        xTaskNotifyGive(pool->consumer);
+    }
+    return sent;
+}
+
+// --- C. CONSUMER SIDE ---
+
+void packet_pool_set_consumer(PacketPool_t *pool, TaskHandle_t task) {
+    pool->consumer = task;
+}
+
+static void *spsc_receive(PacketPool_t *pool, TickType_t timeout) {
+    void *slot = spsc_ring_pop(&pool->ready_ring);
+
+    // Only the registered consumer is ever notified of a submit
+    if (slot == NULL && timeout != 0 && pool->consumer != NULL &&
+        pool->consumer == xTaskGetCurrentTaskHandle()) {
+        TRACE_EVENT(TRACE_TASK_SLEEP, &pool->ready_ring, 0);
+        ulTaskNotifyTake(pdFALSE, timeout);
+        TRACE_EVENT(TRACE_TASK_WAKE, &pool->ready_ring, 0);
+        slot = spsc_ring_pop(&pool->ready_ring);
+    }
+    if (slot != NULL) {
+        TRACE_EVENT(TRACE_QUEUE_RECEIVE, &pool->ready_ring, spsc_ring_count(&pool->ready_ring));
+    }
+    return slot;
+}
+
+void *packet_pool_receive(PacketPool_t *pool, TickType_t timeout) {
+    void *slot = NULL;
+
+    if (pool->spsc) {
+        return spsc_receive(pool, timeout);
+    }
+
+    TRACE_EVENT(TRACE_TASK_SLEEP, pool->ready_slots, 0);
+    BaseType_t received = xQueueReceive(pool->ready_slots, &slot, timeout);
+    TRACE_EVENT(TRACE_TASK_WAKE, pool->ready_slots, 0);
+    if (received != pdPASS) {
+        return NULL;
+    }
+    TRACE_EVENT(TRACE_QUEUE_RECEIVE, pool->ready_slots, uxQueueMessagesWaiting(pool->ready_slots));
+    return slot;
+}
+
+void packet_pool_release(PacketPool_t *pool, void *slot) {
+    if (!slot_belongs_to_pool(pool, slot)) {
+        printf("POOL %s: ERROR! Release of foreign slot %p ignored.\n", pool->name, slot);
+        note_bad_release(pool);
+        return;
+    }
+    // A slot goes back on the free list once, whoever releases it
+    if (__atomic_exchange_n(&pool->slot_free[slot_index(pool, slot)], 1, __ATOMIC_ACQ_REL)) {
+        printf("POOL %s: ERROR! Double release of slot %p ignored.\n", pool->name, slot);
+        note_bad_release(pool);
+        return;
+    }
+
+    if (pool->spsc) {
+        spsc_ring_push(&pool->free_ring, slot);
+        spsc_count(&pool->releases);
+        return;
+    }
+
+    portENTER_CRITICAL(&pool->stats_mux);
+    if (pool->stats.in_use > 0) {
+        pool->stats.in_use--;
+    }
+    portEXIT_CRITICAL(&pool->stats_mux);
+
+    xQueueSend(pool->free_slots, &slot, 0);
+}
+
+void packet_pool_get_stats(PacketPool_t *pool, PoolStats_t *stats) {
+    if (pool->spsc) {
+        stats->allocations = __atomic_load_n(&pool->stats.allocations, __ATOMIC_RELAXED);
+        stats->alloc_failures = __atomic_load_n(&pool->stats.alloc_failures, __ATOMIC_RELAXED);
+        stats->dropped_oldest = __atomic_load_n(&pool->stats.dropped_oldest, __ATOMIC_RELAXED);
+        stats->bad_releases = __atomic_load_n(&pool->stats.bad_releases, __ATOMIC_RELAXED);
+        stats->high_water = __atomic_load_n(&pool->stats.high_water, __ATOMIC_RELAXED);
+        stats->in_use = (uint16_t)spsc_in_use(pool);
+        return;
+    }
+
+    portENTER_CRITICAL(&pool->stats_mux);
+    *stats = pool->stats;
+    portEXIT_CRITICAL(&pool->stats_mux);
+}
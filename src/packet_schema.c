@@ -0,0 +1,118 @@
+// src/packet_schema.c
+
+#include "packet_schema.h"
+#include "ccsds_packet.h"
+#include "utils.h"
+#include <string.h>
+
+// --- A. FIELD CODECS ---
+// One put/get per wire type. The schema lists expand into a call per field
+// at a constant offset, so each serializer is a straight run of byte stores
+// with no loop and no per-field dispatch.
+
+static inline void put_f32(uint8_t *p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    ccsds_put_be32(p, bits);
+}
+
+static inline float get_f32(const uint8_t *p) {
+    uint32_t bits = ccsds_get_be32(p);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+#define WIRE_PUT_U8(p, v)       ((p)[0] = (uint8_t)(v))
+#define WIRE_PUT_U16(p, v)      ccsds_put_be16((p), (uint16_t)(v))
+#define WIRE_PUT_U32(p, v)      ccsds_put_be32((p), (uint32_t)(v))
+#define WIRE_PUT_F32(p, v)      put_f32((p), (v))
+#define WIRE_PUT_FLAGS(p, v)    ((p)[0] = hk_flags_pack(&(v)))
+#define WIRE_PUT_BYTES8(p, v)   memcpy((p), (v), WIRE_SIZE_BYTES8)
+
+#define WIRE_GET_U8(p, v)       ((v) = (p)[0])
+#define WIRE_GET_U16(p, v)      ((v) = ccsds_get_be16(p))
+#define WIRE_GET_U32(p, v)      ((v) = ccsds_get_be32(p))
+#define WIRE_GET_F32(p, v)      ((v) = get_f32(p))
+#define WIRE_GET_FLAGS(p, v)    hk_flags_unpack(&(v), (p)[0])
+#define WIRE_GET_BYTES8(p, v)   memcpy((v), (p), WIRE_SIZE_BYTES8)
+
+uint8_t hk_flags_pack(const HK_StatusFlags_t *flags) {
+    return (uint8_t)((flags->flg_low_voltage ? HK_FLAG_LOW_VOLTAGE : 0u) |
+                     (flags->flg_antenna_armed ? HK_FLAG_ANTENNA_ARMED : 0u) |
+                     ((flags->system_mode << HK_FLAG_MODE_SHIFT) & HK_FLAG_MODE_MASK) |
+                     (flags->flg_reset_pending ? HK_FLAG_RESET_PENDING : 0u) |
+                     ((flags->reserved << HK_FLAG_RESERVED_SHIFT) & HK_FLAG_RESERVED_MASK));
+}
+
+void hk_flags_unpack(HK_StatusFlags_t *flags, uint8_t byte) {
+    flags->flg_low_voltage = (byte & HK_FLAG_LOW_VOLTAGE) != 0;
+    flags->flg_antenna_armed = (byte & HK_FLAG_ANTENNA_ARMED) != 0;
+    flags->system_mode = (byte & HK_FLAG_MODE_MASK) >> HK_FLAG_MODE_SHIFT;
+    flags->flg_reset_pending = (byte & HK_FLAG_RESET_PENDING) != 0;
+    flags->reserved = (byte & HK_FLAG_RESERVED_MASK) >> HK_FLAG_RESERVED_SHIFT;
+}
+
+// --- B. HOUSEKEEPING TELEMETRY ---
+
+size_t hk_tm_pack(const HK_Telemetry_t *pkt, uint8_t *wire) {
+#define PUT_FIELD(name, type) WIRE_PUT_##type(&wire[HK_TM_OFF_##name], pkt->name);
+    HK_TM_SCHEMA(PUT_FIELD)
+#undef PUT_FIELD
+
+    ccsds_put_be16(&wire[HK_TM_OFF_crc], crc16_ccitt(wire, HK_TM_OFF_crc));
+    return HK_TM_WIRE_LEN;
+}
+
+int hk_tm_unpack(const uint8_t *wire, size_t len, HK_Telemetry_t *pkt) {
+    if (len != HK_TM_WIRE_LEN) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+
+#define GET_FIELD(name, type) WIRE_GET_##type(&wire[HK_TM_OFF_##name], pkt->name);
+    HK_TM_SCHEMA(GET_FIELD)
+#undef GET_FIELD
+
+    pkt->crc_checksum = ccsds_get_be16(&wire[HK_TM_OFF_crc]);
+    return (crc16_ccitt(wire, HK_TM_OFF_crc) == pkt->crc_checksum) ? PKT_SCHEMA_OK : PKT_SCHEMA_BAD_CRC;
+}
+
+// --- C. TELECOMMANDS ---
+
+size_t tc_pack(const TelecommandPacket_t *tc, uint8_t *wire) {
+#define PUT_FIELD(name, type) WIRE_PUT_##type(&wire[TC_OFF_##name], tc->name);
+    TC_SCHEMA(PUT_FIELD)
+#undef PUT_FIELD
+
+    ccsds_put_be16(&wire[TC_OFF_crc], crc16_ccitt(wire, TC_OFF_crc));
+    return TC_WIRE_LEN;
+}
+
+int tc_unpack(const uint8_t *wire, size_t len, TelecommandPacket_t *tc) {
+    if (len != TC_WIRE_LEN) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+
+#define GET_FIELD(name, type) WIRE_GET_##type(&wire[TC_OFF_##name], tc->name);
+    TC_SCHEMA(GET_FIELD)
+#undef GET_FIELD
+
+    tc->crc = ccsds_get_be16(&wire[TC_OFF_crc]);
+    return (crc16_ccitt(wire, TC_OFF_crc) == tc->crc) ? PKT_SCHEMA_OK : PKT_SCHEMA_BAD_CRC;
+}
+
+// --- D. HK RESPONSES ---
+
+size_t hk_response_pack(uint32_t request_timestamp, const HK_Telemetry_t *pkt, uint8_t *wire) {
+    WIRE_PUT_U32(&wire[HK_RESP_OFF_request_timestamp], request_timestamp);
+    return HK_RESP_OFF_record + hk_tm_pack(pkt, &wire[HK_RESP_OFF_record]);
+}
+
+int hk_response_unpack(const uint8_t *wire, size_t len, uint32_t *request_timestamp,
+                       HK_Telemetry_t *pkt) {
+    if (len != HK_RESP_WIRE_LEN) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+    WIRE_GET_U32(&wire[HK_RESP_OFF_request_timestamp], *request_timestamp);
+    return hk_tm_unpack(&wire[HK_RESP_OFF_record], HK_TM_WIRE_LEN, pkt);
+}
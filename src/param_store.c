@@ -0,0 +1,166 @@
+// src/param_store.c
+
+#include "freertos/FreeRTOS.h"
+#include "param_store.h"
+#include <string.h>
+
+// --- A. PARAMETER TABLE ---
+
+typedef enum {
+    TYPE_U8,
+    TYPE_U16,
+    TYPE_I16,
+    TYPE_U32
+} ParamType_t;
+
+typedef struct {
+    const char *name;
+    ParamGroup_t group;
+    ParamType_t type;
+} ParamDef_t;
+
+#define PARAM_DEF(name, group, type) { #name, PARAM_GROUP_##group, TYPE_##type },
+static const ParamDef_t s_params[PARAM_COUNT] = {
+    PARAM_TABLE(PARAM_DEF)
+};
+#undef PARAM_DEF
+
+const char *param_name(ParamId_t id) {
+    return ((uint32_t)id < PARAM_COUNT) ? s_params[id].name : "?";
+}
+
+ParamGroup_t param_group(ParamId_t id) {
+    return ((uint32_t)id < PARAM_COUNT) ? s_params[id].group : PARAM_GROUP_COUNT;
+}
+
+static int32_t clamp_to_type(ParamType_t type, int32_t v) {
+    switch (type) {
+        case TYPE_U8:  return (v < 0) ? 0 : (v > UINT8_MAX) ? UINT8_MAX : v;
+        case TYPE_U16: return (v < 0) ? 0 : (v > UINT16_MAX) ? UINT16_MAX : v;
+        case TYPE_I16: return (v < INT16_MIN) ? INT16_MIN : (v > INT16_MAX) ? INT16_MAX : v;
+        case TYPE_U32:
+        default:       return v;        // Bit pattern of the uint32_t
+    }
+}
+
+// --- B. STORE ---
+// The group version is sequence / 2: even between publishes, odd during one.
+// value[] and changed[] of a group are only touched by its writer, inside
+// the odd window, and only read through the group's seqlock.
+
+typedef struct {
+    uint32_t sequence;
+    uint16_t first;             // Parameter range of the group
+    uint16_t count;
+    portMUX_TYPE mux;           // Keeps the write window short and unpreempted
+} ParamGroupState_t;
+
+static ParamGroupState_t s_groups[PARAM_GROUP_COUNT];
+static int32_t s_value[PARAM_COUNT];
+static uint32_t s_changed[PARAM_COUNT];
+static uint32_t s_write_version[PARAM_GROUP_COUNT];    // Version being published (writer-owned)
+
+int param_store_init(void) {
+    memset(s_value, 0, sizeof(s_value));
+    memset(s_changed, 0, sizeof(s_changed));
+    memset(s_write_version, 0, sizeof(s_write_version));
+
+    // 1. Group ranges from the table
+    for (uint32_t g = 0; g < PARAM_GROUP_COUNT; g++) {
+        s_groups[g].sequence = 0;
+        s_groups[g].count = 0;
+        portMUX_INITIALIZE(&s_groups[g].mux);
+    }
+    for (uint32_t i = 0; i < PARAM_COUNT; i++) {
+        ParamGroupState_t *grp = &s_groups[s_params[i].group];
+        if (grp->count == 0) {
+            grp->first = (uint16_t)i;
+        } else if (grp->first + grp->count != i) {
+            return -1;          // Group split by another group's parameters
+        }
+        grp->count++;
+    }
+    return 0;
+}
+
+// --- C. WRITER SIDE ---
+
+void param_write_begin(ParamGroup_t group) {
+    ParamGroupState_t *grp = &s_groups[group];
+
+    portENTER_CRITICAL(&grp->mux);
+    uint32_t seq = grp->sequence;
+    __atomic_store_n(&grp->sequence, seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    s_write_version[group] = (seq + 2u) / 2u;
+}
+
+void param_write(ParamId_t id, int32_t value) {
+    const ParamDef_t *def = &s_params[id];
+    int32_t v = clamp_to_type(def->type, value);
+
+    // Only this writer stores here: a relaxed read of its own value is current.
+    // The first write always counts as a change, so 0 can mean "never set".
+    if (__atomic_load_n(&s_value[id], __ATOMIC_RELAXED) != v || s_changed[id] == 0) {
+        __atomic_store_n(&s_value[id], v, __ATOMIC_RELAXED);
+        __atomic_store_n(&s_changed[id], s_write_version[def->group], __ATOMIC_RELAXED);
+    }
+}
+
+uint32_t param_write_end(ParamGroup_t group) {
+    ParamGroupState_t *grp = &s_groups[group];
+    uint32_t seq = grp->sequence;
+
+    __atomic_store_n(&grp->sequence, seq + 1u, __ATOMIC_RELEASE);
+    portEXIT_CRITICAL(&grp->mux);
+    return (seq + 1u) / 2u;
+}
+
+// --- D. READER SIDE ---
+
+uint32_t param_read_group(ParamGroup_t group, ParamSnapshot_t *snap) {
+    const ParamGroupState_t *grp = &s_groups[group];
+    uint32_t first = grp->first;
+    uint32_t end = first + grp->count;
+    uint32_t seq_start, seq_end;
+    uint32_t retries = 0;
+
+    for (;;) {
+        seq_start = __atomic_load_n(&grp->sequence, __ATOMIC_ACQUIRE);
+
+        for (uint32_t i = first; i < end; i++) {
+            snap->value[i] = __atomic_load_n(&s_value[i], __ATOMIC_RELAXED);
+            snap->changed[i] = __atomic_load_n(&s_changed[i], __ATOMIC_RELAXED);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        seq_end = __atomic_load_n(&grp->sequence, __ATOMIC_RELAXED);
+        if (!(seq_start & 1u) && seq_start == seq_end) {
+            break;
+        }
+        retries++;
+    }
+    snap->version.group[group] = seq_start / 2u;
+    return retries;
+}
+
+uint32_t param_snapshot(ParamSnapshot_t *snap) {
+    uint32_t retries = 0;
+
+    for (uint32_t g = 0; g < PARAM_GROUP_COUNT; g++) {
+        retries += param_read_group((ParamGroup_t)g, snap);
+    }
+    return retries;
+}
+
+size_t param_changed_since(const ParamSnapshot_t *snap, const ParamVersion_t *since,
+                           ParamId_t *ids, size_t max_ids) {
+    size_t n = 0;
+
+    for (uint32_t i = 0; i < PARAM_COUNT && n < max_ids; i++) {
+        if (snap->changed[i] > since->group[s_params[i].group]) {
+            ids[n++] = (ParamId_t)i;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,268 @@
+// src/rs_fec.c
+
+#include "rs_fec.h"
+#include <stdint.h>
+#include <string.h>
+
+#define RS_A0       RS_N        // Log of zero
+#define RS_FCR      112         // First consecutive root (as a power of alpha^RS_PRIM)
+#define RS_PRIM     11          // Generator roots are alpha^(RS_PRIM * j)
+#define RS_IPRIM    116         // RS_PRIM * RS_IPRIM = 1 mod 255
+
+// --- A. TABLES ---
+// s_gf_exp[i] = alpha^(i mod 255), doubled so that the sum of two logs
+// never needs a reduction; s_gf_log is its inverse (s_gf_log[0] = RS_A0).
+// s_rs_genpoly holds the generator polynomial coefficients as logs,
+// g(x) = prod (x - alpha^(11 j)), j = 112 .. 143; it is palindromic.
+// test/test_rs_fec.c checks all three against a derivation from the field polynomial.
+
+static const uint8_t s_gf_exp[512] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x87, 0x89, 0x95, 0xAD, 0xDD, 0x3D, 0x7A, 0xF4,
+    0x6F, 0xDE, 0x3B, 0x76, 0xEC, 0x5F, 0xBE, 0xFB, 0x71, 0xE2, 0x43, 0x86, 0x8B, 0x91, 0xA5, 0xCD,
+    0x1D, 0x3A, 0x74, 0xE8, 0x57, 0xAE, 0xDB, 0x31, 0x62, 0xC4, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0x67,
+    0xCE, 0x1B, 0x36, 0x6C, 0xD8, 0x37, 0x6E, 0xDC, 0x3F, 0x7E, 0xFC, 0x7F, 0xFE, 0x7B, 0xF6, 0x6B,
+    0xD6, 0x2B, 0x56, 0xAC, 0xDF, 0x39, 0x72, 0xE4, 0x4F, 0x9E, 0xBB, 0xF1, 0x65, 0xCA, 0x13, 0x26,
+    0x4C, 0x98, 0xB7, 0xE9, 0x55, 0xAA, 0xD3, 0x21, 0x42, 0x84, 0x8F, 0x99, 0xB5, 0xED, 0x5D, 0xBA,
+    0xF3, 0x61, 0xC2, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0,
+    0x47, 0x8E, 0x9B, 0xB1, 0xE5, 0x4D, 0x9A, 0xB3, 0xE1, 0x45, 0x8A, 0x93, 0xA1, 0xC5, 0x0D, 0x1A,
+    0x34, 0x68, 0xD0, 0x27, 0x4E, 0x9C, 0xBF, 0xF9, 0x75, 0xEA, 0x53, 0xA6, 0xCB, 0x11, 0x22, 0x44,
+    0x88, 0x97, 0xA9, 0xD5, 0x2D, 0x5A, 0xB4, 0xEF, 0x59, 0xB2, 0xE3, 0x41, 0x82, 0x83, 0x81, 0x85,
+    0x8D, 0x9D, 0xBD, 0xFD, 0x7D, 0xFA, 0x73, 0xE6, 0x4B, 0x96, 0xAB, 0xD1, 0x25, 0x4A, 0x94, 0xAF,
+    0xD9, 0x35, 0x6A, 0xD4, 0x2F, 0x5E, 0xBC, 0xFF, 0x79, 0xF2, 0x63, 0xC6, 0x0B, 0x16, 0x2C, 0x58,
+    0xB0, 0xE7, 0x49, 0x92, 0xA3, 0xC1, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0xC7, 0x09, 0x12, 0x24,
+    0x48, 0x90, 0xA7, 0xC9, 0x15, 0x2A, 0x54, 0xA8, 0xD7, 0x29, 0x52, 0xA4, 0xCF, 0x19, 0x32, 0x64,
+    0xC8, 0x17, 0x2E, 0x5C, 0xB8, 0xF7, 0x69, 0xD2, 0x23, 0x46, 0x8C, 0x9F, 0xB9, 0xF5, 0x6D, 0xDA,
+    0x33, 0x66, 0xCC, 0x1F, 0x3E, 0x7C, 0xF8, 0x77, 0xEE, 0x5B, 0xB6, 0xEB, 0x51, 0xA2, 0xC3, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x87, 0x89, 0x95, 0xAD, 0xDD, 0x3D, 0x7A, 0xF4, 0x6F,
+    0xDE, 0x3B, 0x76, 0xEC, 0x5F, 0xBE, 0xFB, 0x71, 0xE2, 0x43, 0x86, 0x8B, 0x91, 0xA5, 0xCD, 0x1D,
+    0x3A, 0x74, 0xE8, 0x57, 0xAE, 0xDB, 0x31, 0x62, 0xC4, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0x67, 0xCE,
+    0x1B, 0x36, 0x6C, 0xD8, 0x37, 0x6E, 0xDC, 0x3F, 0x7E, 0xFC, 0x7F, 0xFE, 0x7B, 0xF6, 0x6B, 0xD6,
+    0x2B, 0x56, 0xAC, 0xDF, 0x39, 0x72, 0xE4, 0x4F, 0x9E, 0xBB, 0xF1, 0x65, 0xCA, 0x13, 0x26, 0x4C,
+    0x98, 0xB7, 0xE9, 0x55, 0xAA, 0xD3, 0x21, 0x42, 0x84, 0x8F, 0x99, 0xB5, 0xED, 0x5D, 0xBA, 0xF3,
+    0x61, 0xC2, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0x47,
+    0x8E, 0x9B, 0xB1, 0xE5, 0x4D, 0x9A, 0xB3, 0xE1, 0x45, 0x8A, 0x93, 0xA1, 0xC5, 0x0D, 0x1A, 0x34,
+    0x68, 0xD0, 0x27, 0x4E, 0x9C, 0xBF, 0xF9, 0x75, 0xEA, 0x53, 0xA6, 0xCB, 0x11, 0x22, 0x44, 0x88,
+    0x97, 0xA9, 0xD5, 0x2D, 0x5A, 0xB4, 0xEF, 0x59, 0xB2, 0xE3, 0x41, 0x82, 0x83, 0x81, 0x85, 0x8D,
+    0x9D, 0xBD, 0xFD, 0x7D, 0xFA, 0x73, 0xE6, 0x4B, 0x96, 0xAB, 0xD1, 0x25, 0x4A, 0x94, 0xAF, 0xD9,
+    0x35, 0x6A, 0xD4, 0x2F, 0x5E, 0xBC, 0xFF, 0x79, 0xF2, 0x63, 0xC6, 0x0B, 0x16, 0x2C, 0x58, 0xB0,
+    0xE7, 0x49, 0x92, 0xA3, 0xC1, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0xC7, 0x09, 0x12, 0x24, 0x48,
+    0x90, 0xA7, 0xC9, 0x15, 0x2A, 0x54, 0xA8, 0xD7, 0x29, 0x52, 0xA4, 0xCF, 0x19, 0x32, 0x64, 0xC8,
+    0x17, 0x2E, 0x5C, 0xB8, 0xF7, 0x69, 0xD2, 0x23, 0x46, 0x8C, 0x9F, 0xB9, 0xF5, 0x6D, 0xDA, 0x33,
+    0x66, 0xCC, 0x1F, 0x3E, 0x7C, 0xF8, 0x77, 0xEE, 0x5B, 0xB6, 0xEB, 0x51, 0xA2, 0xC3, 0x00, 0x00,
+};
+
+static const uint8_t s_gf_log[256] = {
+    0xFF, 0x00, 0x01, 0x63, 0x02, 0xC6, 0x64, 0x6A, 0x03, 0xCD, 0xC7, 0xBC, 0x65, 0x7E, 0x6B, 0x2A,
+    0x04, 0x8D, 0xCE, 0x4E, 0xC8, 0xD4, 0xBD, 0xE1, 0x66, 0xDD, 0x7F, 0x31, 0x6C, 0x20, 0x2B, 0xF3,
+    0x05, 0x57, 0x8E, 0xE8, 0xCF, 0xAC, 0x4F, 0x83, 0xC9, 0xD9, 0xD5, 0x41, 0xBE, 0x94, 0xE2, 0xB4,
+    0x67, 0x27, 0xDE, 0xF0, 0x80, 0xB1, 0x32, 0x35, 0x6D, 0x45, 0x21, 0x12, 0x2C, 0x0D, 0xF4, 0x38,
+    0x06, 0x9B, 0x58, 0x1A, 0x8F, 0x79, 0xE9, 0x70, 0xD0, 0xC2, 0xAD, 0xA8, 0x50, 0x75, 0x84, 0x48,
+    0xCA, 0xFC, 0xDA, 0x8A, 0xD6, 0x54, 0x42, 0x24, 0xBF, 0x98, 0x95, 0xF9, 0xE3, 0x5E, 0xB5, 0x15,
+    0x68, 0x61, 0x28, 0xBA, 0xDF, 0x4C, 0xF1, 0x2F, 0x81, 0xE6, 0xB2, 0x3F, 0x33, 0xEE, 0x36, 0x10,
+    0x6E, 0x18, 0x46, 0xA6, 0x22, 0x88, 0x13, 0xF7, 0x2D, 0xB8, 0x0E, 0x3D, 0xF5, 0xA4, 0x39, 0x3B,
+    0x07, 0x9E, 0x9C, 0x9D, 0x59, 0x9F, 0x1B, 0x08, 0x90, 0x09, 0x7A, 0x1C, 0xEA, 0xA0, 0x71, 0x5A,
+    0xD1, 0x1D, 0xC3, 0x7B, 0xAE, 0x0A, 0xA9, 0x91, 0x51, 0x5B, 0x76, 0x72, 0x85, 0xA1, 0x49, 0xEB,
+    0xCB, 0x7C, 0xFD, 0xC4, 0xDB, 0x1E, 0x8B, 0xD2, 0xD7, 0x92, 0x55, 0xAA, 0x43, 0x0B, 0x25, 0xAF,
+    0xC0, 0x73, 0x99, 0x77, 0x96, 0x5C, 0xFA, 0x52, 0xE4, 0xEC, 0x5F, 0x4A, 0xB6, 0xA2, 0x16, 0x86,
+    0x69, 0xC5, 0x62, 0xFE, 0x29, 0x7D, 0xBB, 0xCC, 0xE0, 0xD3, 0x4D, 0x8C, 0xF2, 0x1F, 0x30, 0xDC,
+    0x82, 0xAB, 0xE7, 0x56, 0xB3, 0x93, 0x40, 0xD8, 0x34, 0xB0, 0xEF, 0x26, 0x37, 0x0C, 0x11, 0x44,
+    0x6F, 0x78, 0x19, 0x9A, 0x47, 0x74, 0xA7, 0xC1, 0x23, 0x53, 0x89, 0xFB, 0x14, 0x5D, 0xF8, 0x97,
+    0x2E, 0x4B, 0xB9, 0x60, 0x0F, 0xED, 0x3E, 0xE5, 0xF6, 0x87, 0xA5, 0x17, 0x3A, 0xA3, 0x3C, 0xB7,
+};
+
+static const uint8_t s_rs_genpoly[33] = {
+    0x00, 0xF9, 0x3B, 0x42, 0x04, 0x2B, 0x7E, 0xFB, 0x61, 0x1E, 0x03,
+    0xD5, 0x32, 0x42, 0xAA, 0x05, 0x18, 0x05, 0xAA, 0x42, 0x32, 0xD5,
+    0x03, 0x1E, 0x61, 0xFB, 0x7E, 0x2B, 0x04, 0x42, 0x3B, 0xF9, 0x00,
+};
+
+static inline unsigned modnn(unsigned x) {
+    while (x >= RS_N) {
+        x -= RS_N;
+        x = (x >> 8) + (x & RS_N);
+    }
+    return x;
+}
+
+uint8_t rs_gf_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return s_gf_exp[s_gf_log[a] + s_gf_log[b]];
+}
+
+// --- B. ENCODER ---
+// Systematic LFSR division by g(x), one table lookup per parity symbol and
+// data symbol. The shift of the parity register is folded into the update.
+
+void rs_encode(const uint8_t *data, size_t k, size_t stride, uint8_t *parity) {
+    uint8_t reg[RS_PARITY];
+
+    memset(reg, 0, sizeof(reg));
+    for (size_t i = 0; i < k; i++) {
+        unsigned feedback = s_gf_log[data[i * stride] ^ reg[0]];
+
+        if (feedback != RS_A0) {
+            for (unsigned j = 1; j < RS_PARITY; j++) {
+                reg[j - 1] = reg[j] ^ s_gf_exp[feedback + s_rs_genpoly[RS_PARITY - j]];
+            }
+            reg[RS_PARITY - 1] = s_gf_exp[feedback + s_rs_genpoly[0]];
+        } else {
+            memmove(&reg[0], &reg[1], RS_PARITY - 1);
+            reg[RS_PARITY - 1] = 0;
+        }
+    }
+
+    for (unsigned j = 0; j < RS_PARITY; j++) {
+        parity[j * stride] = reg[j];
+    }
+}
+
+// --- C. DECODER ---
+
+int rs_decode(uint8_t *codeword, size_t k, size_t stride) {
+    uint8_t data[RS_N];
+    uint8_t lambda[RS_PARITY + 1], b[RS_PARITY + 1], t[RS_PARITY + 1];
+    uint8_t omega[RS_PARITY + 1], reg[RS_PARITY + 1];
+    uint8_t s[RS_PARITY];
+    unsigned root[RS_PARITY], loc[RS_PARITY];
+    uint8_t fix[RS_PARITY];
+    unsigned syn_error = 0;
+    int deg_lambda = 0, deg_omega, el = 0, count = 0;
+    size_t n = k + RS_PARITY;
+    unsigned pad = (unsigned)(RS_K - k);
+
+    if (k > RS_K) {
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        data[i] = codeword[i * stride];
+    }
+
+    // 1. Syndromes: the codeword evaluated at each generator root
+    for (unsigned i = 0; i < RS_PARITY; i++) {
+        s[i] = data[0];
+    }
+    for (size_t j = 1; j < n; j++) {
+        for (unsigned i = 0; i < RS_PARITY; i++) {
+            s[i] = (s[i] == 0) ? data[j]
+                               : data[j] ^ s_gf_exp[modnn(s_gf_log[s[i]] + (RS_FCR + i) * RS_PRIM)];
+        }
+    }
+    for (unsigned i = 0; i < RS_PARITY; i++) {
+        syn_error |= s[i];
+        s[i] = s_gf_log[s[i]];
+    }
+    if (syn_error == 0) {
+        return 0;
+    }
+
+    // 2. Berlekamp-Massey: error locator polynomial lambda(x)
+    memset(lambda, 0, sizeof(lambda));
+    lambda[0] = 1;
+    for (unsigned i = 0; i <= RS_PARITY; i++) {
+        b[i] = s_gf_log[lambda[i]];
+    }
+    for (int r = 1; r <= RS_PARITY; r++) {
+        unsigned discr = 0;
+        for (int i = 0; i < r; i++) {
+            if (lambda[i] != 0 && s[r - i - 1] != RS_A0) {
+                discr ^= s_gf_exp[s_gf_log[lambda[i]] + s[r - i - 1]];
+            }
+        }
+        discr = s_gf_log[discr];
+
+        if (discr == RS_A0) {
+            memmove(&b[1], b, RS_PARITY);
+            b[0] = RS_A0;
+            continue;
+        }
+        t[0] = lambda[0];
+        for (unsigned i = 0; i < RS_PARITY; i++) {
+            t[i + 1] = (b[i] != RS_A0) ? lambda[i + 1] ^ s_gf_exp[discr + b[i]] : lambda[i + 1];
+        }
+        if (2 * el <= r - 1) {
+            el = r - el;
+            for (unsigned i = 0; i <= RS_PARITY; i++) {
+                b[i] = (lambda[i] == 0) ? RS_A0 : (uint8_t)modnn(s_gf_log[lambda[i]] + RS_N - discr);
+            }
+        } else {
+            memmove(&b[1], b, RS_PARITY);
+            b[0] = RS_A0;
+        }
+        memcpy(lambda, t, sizeof(lambda));
+    }
+
+    for (int i = 0; i <= RS_PARITY; i++) {
+        lambda[i] = s_gf_log[lambda[i]];
+        if (lambda[i] != RS_A0) {
+            deg_lambda = i;
+        }
+    }
+    if (deg_lambda == 0 || deg_lambda > RS_MAX_ERRORS) {
+        return -1;
+    }
+
+    // 3. Chien search: the roots of lambda(x) give the error positions
+    memcpy(&reg[1], &lambda[1], RS_PARITY);
+    for (unsigned i = 1, kk = RS_IPRIM - 1; i <= RS_N; i++, kk = modnn(kk + RS_IPRIM)) {
+        unsigned q = 1;
+        for (int j = deg_lambda; j > 0; j--) {
+            if (reg[j] != RS_A0) {
+                reg[j] = (uint8_t)modnn(reg[j] + (unsigned)j);
+                q ^= s_gf_exp[reg[j]];
+            }
+        }
+        if (q != 0) {
+            continue;
+        }
+        root[count] = i;
+        loc[count] = kk;
+        if (++count == deg_lambda) {
+            break;
+        }
+    }
+    if (count != deg_lambda) {
+        return -1;                          // lambda(x) does not split: too many errors
+    }
+
+    // 4. Error evaluator omega(x) = s(x) lambda(x) mod x^RS_PARITY
+    deg_omega = deg_lambda - 1;
+    for (int i = 0; i <= deg_omega; i++) {
+        unsigned tmp = 0;
+        for (int j = i; j >= 0; j--) {
+            if (s[i - j] != RS_A0 && lambda[j] != RS_A0) {
+                tmp ^= s_gf_exp[s[i - j] + lambda[j]];
+            }
+        }
+        omega[i] = s_gf_log[tmp];
+    }
+
+    // 5. Forney: error values. An error located in the virtual zero fill of
+    //    a shortened code means the codeword is beyond repair.
+    for (int j = count - 1; j >= 0; j--) {
+        unsigned num1 = 0, num2, den = 0;
+
+        for (int i = deg_omega; i >= 0; i--) {
+            if (omega[i] != RS_A0) {
+                num1 ^= s_gf_exp[modnn(omega[i] + (unsigned)i * root[j])];
+            }
+        }
+        num2 = s_gf_exp[modnn(root[j] * (RS_FCR - 1) + RS_N)];
+        for (int i = ((deg_lambda < RS_PARITY - 1) ? deg_lambda : RS_PARITY - 1) & ~1; i >= 0; i -= 2) {
+            if (lambda[i + 1] != RS_A0) {
+                den ^= s_gf_exp[modnn(lambda[i + 1] + (unsigned)i * root[j])];
+            }
+        }
+        if (loc[j] < pad || den == 0) {
+            return -1;
+        }
+        fix[j] = (num1 == 0) ? 0
+                             : s_gf_exp[modnn(s_gf_log[num1] + s_gf_log[num2] + RS_N - s_gf_log[den])];
+    }
+
+    for (int j = 0; j < count; j++) {
+        codeword[(loc[j] - pad) * stride] ^= fix[j];
+    }
+    return count;
+}
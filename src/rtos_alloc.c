@@ -0,0 +1,340 @@
+// src/rtos_alloc.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "rtos_alloc.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef ESP_PLATFORM
+#include "host_runtime.h"       // Exact stack and queue peaks from the POSIX runtime
+#endif
+
+static RtosTaskInfo_t s_tasks[RTOS_MAX_TASKS];
+static RtosQueueInfo_t s_queues[RTOS_MAX_QUEUES];
+static uint32_t s_queue_slots;          // Registry entries claimed (queues and mutexes)
+static RtosAllocStats_t s_alloc_stats;
+static portMUX_TYPE s_alloc_mux = portMUX_INITIALIZER_UNLOCKED;
+
+#define ARENA_ALIGN     8u
+
+#if FSW_STATIC_ALLOC
+static uint8_t s_queue_arena[RTOS_QUEUE_ARENA_BYTES] __attribute__((aligned(ARENA_ALIGN)));
+static StaticQueue_t s_queue_buffers[RTOS_MAX_QUEUES];
+static StaticSemaphore_t s_mutex_buffers[RTOS_MAX_MUTEXES];
+#endif
+
+// Queue storage is handed out front to back and never returned: the FSW
+// creates its queues once at boot. The generated header uses the same rule.
+static uint32_t arena_slice(UBaseType_t length, UBaseType_t item_size) {
+    return ((uint32_t)(length * item_size) + ARENA_ALIGN - 1u) & ~(ARENA_ALIGN - 1u);
+}
+
+static void copy_name(char *dst, const char *name) {
+    if (name == NULL) {
+        dst[0] = '\0';
+        return;
+    }
+    strncpy(dst, name, RTOS_NAME_LEN - 1);
+    dst[RTOS_NAME_LEN - 1] = '\0';
+}
+
+static void note_failure(const char *kind, const char *name) {
+    portENTER_CRITICAL(&s_alloc_mux);
+    s_alloc_stats.failures++;
+    portEXIT_CRITICAL(&s_alloc_mux);
+    printf("RTOS ALLOC: ERROR! Could not create %s %s.\n", kind, name ? name : "(unnamed)");
+}
+
+// --- A. TASKS ---
+
+BaseType_t rtos_task_create(TaskFunction_t entry, const char *name, uint32_t stack_bytes,
+                            UBaseType_t priority, int core, StackType_t *stack, StaticTask_t *tcb) {
+    TaskHandle_t handle = NULL;
+    RtosTaskInfo_t *info;
+
+    if (!FSW_CORE_PLAN || core < 0 || core >= portNUM_PROCESSORS) {
+        core = RTOS_CORE_ANY;
+    }
+    BaseType_t affinity = (core == RTOS_CORE_ANY) ? (BaseType_t)tskNO_AFFINITY : (BaseType_t)core;
+
+    // 1. Claim the registry slot first; the new task may run immediately
+    portENTER_CRITICAL(&s_alloc_mux);
+    if (s_alloc_stats.tasks >= RTOS_MAX_TASKS) {
+        portEXIT_CRITICAL(&s_alloc_mux);
+        note_failure("task", name);
+        return pdFAIL;
+    }
+    info = &s_tasks[s_alloc_stats.tasks];
+    portEXIT_CRITICAL(&s_alloc_mux);
+
+    memset(info, 0, sizeof(*info));
+    copy_name(info->name, name);
+    info->stack_bytes = stack_bytes;
+    info->core = (int8_t)core;
+
+    // 2. Create from the caller's buffers or the heap, on its core
+#if FSW_STATIC_ALLOC
+    if (stack != NULL && tcb != NULL) {
+        handle = xTaskCreateStaticPinnedToCore(entry, name, stack_bytes, NULL, priority, stack, tcb,
+                                               affinity);
+        info->is_static = 1;
+    }
+#else
+    if (stack == NULL && tcb == NULL &&
+        xTaskCreatePinnedToCore(entry, name, stack_bytes, NULL, priority, &handle, affinity) != pdPASS) {
+        handle = NULL;
+    }
+#endif
+    if (handle == NULL) {
+        note_failure("task", name);
+        return pdFAIL;
+    }
+    info->handle = handle;
+
+    portENTER_CRITICAL(&s_alloc_mux);
+    s_alloc_stats.tasks++;
+    s_alloc_stats.static_objects += info->is_static;
+    portEXIT_CRITICAL(&s_alloc_mux);
+    return pdPASS;
+}
+
+static uint32_t stack_used(const RtosTaskInfo_t *info) {
+#ifdef ESP_PLATFORM
+    uint32_t free_bytes = (uint32_t)uxTaskGetStackHighWaterMark(info->handle);
+    return (free_bytes < info->stack_bytes) ? info->stack_bytes - free_bytes : 0u;
+#else
+    return host_runtime_stack_used(info->handle);
+#endif
+}
+
+void rtos_task_delete_self(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    for (uint32_t i = 0; i < s_alloc_stats.tasks; i++) {
+        RtosTaskInfo_t *info = &s_tasks[i];
+        if (info->handle == self && !info->deleted) {
+            uint32_t used = stack_used(info);
+            if (used > info->stack_peak) {
+                info->stack_peak = used;
+            }
+            info->deleted = 1;
+            break;
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+// --- B. QUEUES AND MUTEXES ---
+
+static RtosQueueInfo_t *claim_queue_slot(const char *name, UBaseType_t length, UBaseType_t item_size) {
+    RtosQueueInfo_t *info = NULL;
+
+    portENTER_CRITICAL(&s_alloc_mux);
+    if (s_queue_slots < RTOS_MAX_QUEUES) {
+        info = &s_queues[s_queue_slots++];
+        memset(info, 0, sizeof(*info));
+        copy_name(info->name, name);
+        info->length = length;
+        info->item_size = item_size;
+    }
+    portEXIT_CRITICAL(&s_alloc_mux);
+    return info;
+}
+
+QueueHandle_t rtos_queue_create(const char *name, UBaseType_t length, UBaseType_t item_size) {
+    QueueHandle_t queue = NULL;
+    RtosQueueInfo_t *info = claim_queue_slot(name, length, item_size);
+
+    if (info != NULL) {
+#if FSW_STATIC_ALLOC
+        uint32_t bytes = arena_slice(length, item_size);
+        uint8_t *storage = NULL;
+
+        // 1. Carve the storage; running out is a sizing error, not bad luck
+        portENTER_CRITICAL(&s_alloc_mux);
+        if (s_alloc_stats.arena_used + bytes <= RTOS_QUEUE_ARENA_BYTES) {
+            storage = &s_queue_arena[s_alloc_stats.arena_used];
+            s_alloc_stats.arena_used += bytes;
+        }
+        portEXIT_CRITICAL(&s_alloc_mux);
+        if (storage != NULL) {
+            queue = xQueueCreateStatic(length, item_size, storage, &s_queue_buffers[info - s_queues]);
+            info->is_static = 1;
+        } else {
+            printf("RTOS ALLOC: Queue arena exhausted (%lu B total, this queue needs %lu B).\n",
+                   (unsigned long)RTOS_QUEUE_ARENA_BYTES, (unsigned long)bytes);
+        }
+#else
+        queue = xQueueCreate(length, item_size);
+#endif
+    }
+    if (queue == NULL) {
+        note_failure("queue", name);
+        return NULL;
+    }
+
+    // 2. Publish the slot
+    info->handle = queue;
+    portENTER_CRITICAL(&s_alloc_mux);
+    s_alloc_stats.queues++;
+    s_alloc_stats.static_objects += info->is_static;
+    portEXIT_CRITICAL(&s_alloc_mux);
+    if (name != NULL) {
+        TRACE_NAME(queue, name);
+    }
+    return queue;
+}
+
+SemaphoreHandle_t rtos_mutex_create(const char *name) {
+    SemaphoreHandle_t mutex = NULL;
+    RtosQueueInfo_t *info = claim_queue_slot(name, 1, 0);
+
+    if (info != NULL) {
+#if FSW_STATIC_ALLOC
+        if (s_alloc_stats.mutexes < RTOS_MAX_MUTEXES) {
+            mutex = xSemaphoreCreateMutexStatic(&s_mutex_buffers[s_alloc_stats.mutexes]);
+            info->is_static = 1;
+        }
+#else
+        mutex = xSemaphoreCreateMutex();
+#endif
+    }
+    if (mutex == NULL) {
+        note_failure("mutex", name);
+        return NULL;
+    }
+
+    info->handle = mutex;
+    portENTER_CRITICAL(&s_alloc_mux);
+    s_alloc_stats.mutexes++;
+    s_alloc_stats.static_objects += info->is_static;
+    portEXIT_CRITICAL(&s_alloc_mux);
+    TRACE_NAME(mutex, name);
+    return mutex;
+}
+
+void rtos_alloc_get_stats(RtosAllocStats_t *stats) {
+    portENTER_CRITICAL(&s_alloc_mux);
+    *stats = s_alloc_stats;
+    portEXIT_CRITICAL(&s_alloc_mux);
+#if FSW_STATIC_ALLOC
+    stats->arena_size = RTOS_QUEUE_ARENA_BYTES;
+#else
+    stats->arena_size = 0;
+#endif
+}
+
+// --- C. PROFILE ---
+
+void rtos_profile_sample(void) {
+    uint32_t tasks = s_alloc_stats.tasks;
+    uint32_t slots = s_queue_slots;
+
+    for (uint32_t i = 0; i < tasks; i++) {
+        RtosTaskInfo_t *info = &s_tasks[i];
+        if (!info->deleted) {
+            uint32_t used = stack_used(info);
+            if (used > info->stack_peak) {
+                info->stack_peak = used;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < slots; i++) {
+        RtosQueueInfo_t *info = &s_queues[i];
+        // Mutexes share the registry, but their depth means nothing
+        if (info->handle == NULL || info->item_size == 0) {
+            continue;
+        }
+#ifdef ESP_PLATFORM
+        UBaseType_t depth = uxQueueMessagesWaiting(info->handle);
+#else
+        UBaseType_t depth = host_runtime_queue_peak(info->handle);
+#endif
+        if (depth > info->peak) {
+            info->peak = depth;
+        }
+    }
+}
+
+int rtos_profile_get_task(uint32_t index, RtosTaskInfo_t *info) {
+    if (index >= s_alloc_stats.tasks) {
+        return -1;
+    }
+    *info = s_tasks[index];
+    return 0;
+}
+
+int rtos_profile_get_queue(uint32_t index, RtosQueueInfo_t *info) {
+    if (index >= s_queue_slots) {
+        return -1;
+    }
+    *info = s_queues[index];
+    return 0;
+}
+
+uint32_t rtos_profile_recommend_stack(uint32_t peak_bytes) {
+    uint32_t bytes = peak_bytes + peak_bytes * RTOS_STACK_MARGIN_PCT / 100u + RTOS_STACK_MARGIN_BYTES;
+
+    bytes = (bytes + RTOS_STACK_ROUND - 1u) / RTOS_STACK_ROUND * RTOS_STACK_ROUND;
+    return (bytes < RTOS_STACK_MIN) ? RTOS_STACK_MIN : bytes;
+}
+
+void rtos_profile_write_header(FILE *out, uint32_t seconds_profiled) {
+    uint32_t arena = 0;
+
+    rtos_profile_sample();
+
+    // 1. Stacks
+    fprintf(out, "// include/task_sizing.h\n"
+                 "// Generated by rtos_profile_write_header() after %lu s on the %s.\n"
+                 "// Stacks: peak + %u%% + %u B, rounded up to %u B (minimum %u B).\n",
+            (unsigned long)seconds_profiled,
+#ifdef ESP_PLATFORM
+            "target",
+#else
+            "host (x86 stack use is an estimate; re-profile on the target)",
+#endif
+            RTOS_STACK_MARGIN_PCT, RTOS_STACK_MARGIN_BYTES, RTOS_STACK_ROUND, RTOS_STACK_MIN);
+    fprintf(out, "\n#ifndef TASK_SIZING_H\n#define TASK_SIZING_H\n\n");
+    for (uint32_t i = 0; i < s_alloc_stats.tasks; i++) {
+        const RtosTaskInfo_t *info = &s_tasks[i];
+        fprintf(out, "#define TASK_STACK_%-16s %5lu    // peak %lu of %lu B\n", info->name,
+                (unsigned long)rtos_profile_recommend_stack(info->stack_peak),
+                (unsigned long)info->stack_peak, (unsigned long)info->stack_bytes);
+    }
+
+    // 2. Queues: lengths stay with their owners, the peaks are for review
+    fprintf(out, "\n");
+    for (uint32_t i = 0; i < s_queue_slots; i++) {
+        const RtosQueueInfo_t *info = &s_queues[i];
+        if (info->item_size == 0) {
+            continue;
+        }
+        arena += arena_slice(info->length, info->item_size);
+        if (info->handle != NULL && info->name[0] != '\0') {
+            fprintf(out, "// queue %-12s length %3lu, peak %3lu (%lu B items)\n", info->name,
+                    (unsigned long)info->length, (unsigned long)info->peak,
+                    (unsigned long)info->item_size);
+        }
+    }
+    fprintf(out, "#define RTOS_QUEUE_ARENA_BYTES  %lu\n\n#endif // TASK_SIZING_H\n",
+            (unsigned long)arena);
+}
+
+#if FSW_PROFILE_SECONDS
+void vRtosProfileTask(void *pvParameters) {
+    TickType_t start = xTaskGetTickCount();
+
+    // Queue depths are only visible while this task runs, hence every tick
+    while ((TickType_t)(xTaskGetTickCount() - start) < pdMS_TO_TICKS(FSW_PROFILE_SECONDS * 1000u)) {
+        rtos_profile_sample();
+        vTaskDelay(1);
+    }
+    rtos_profile_write_header(stdout, FSW_PROFILE_SECONDS);
+    rtos_task_delete_self();
+}
+#endif
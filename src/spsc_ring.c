@@ -0,0 +1,58 @@
+// src/spsc_ring.c
+
+#include "spsc_ring.h"
+
+int spsc_ring_init(SpscRing_t *ring, void **storage, uint32_t size) {
+    if (storage == NULL || size == 0 || (size & (size - 1u)) != 0) {
+        return -1;
+    }
+    ring->slots = storage;
+    ring->mask = size - 1u;
+    ring->head = 0;
+    ring->tail = 0;
+    return 0;
+}
+
+int spsc_ring_push(SpscRing_t *ring, void *item) {
+    uint32_t head = ring->head;
+
+    // 1. Room? The acquire pairs with the consumer's release of the entry
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+        return -1;
+    }
+
+    // 2. Fill the entry, then publish it
+    __atomic_store_n(&ring->slots[head & ring->mask], item, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 1u, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Both takers read the entry first and claim it with the CAS; a taker that
+// loses the race throws its copy away, since the slot may since be reused
+static void *take_oldest(SpscRing_t *ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    for (;;) {
+        if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+            return NULL;
+        }
+        void *item = __atomic_load_n(&ring->slots[tail & ring->mask], __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&ring->tail, &tail, tail + 1u, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return item;
+        }
+    }
+}
+
+void *spsc_ring_drop_oldest(SpscRing_t *ring) {
+    return take_oldest(ring);
+}
+
+void *spsc_ring_pop(SpscRing_t *ring) {
+    return take_oldest(ring);
+}
+
+uint32_t spsc_ring_count(const SpscRing_t *ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+}
@@ -0,0 +1,59 @@
+// src/subsystem_hub.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "subsystem_hub.h"
+#include "cdhs_router.h"
+#include "ccsds_packet.h"
+#include "eps_control.h"
+#include "trace.h"
+#include <stdio.h>
+
+#define HUB_INBOX_COUNT 3
+
+void vSubsystemHubTask(void *pvParameters) {
+    QueueSetHandle_t xInboxSet;
+    QueueSetMemberHandle_t xReady;
+    CCSDS_Frame_t *frame;
+
+    // Each inbox is independent: a busy subsystem cannot hold back the others
+    xInboxSet = xQueueCreateSet(HUB_INBOX_COUNT * SUBSYSTEM_INBOX_DEPTH);
+    xQueueAddToSet(xAdcsQueue, xInboxSet);
+    xQueueAddToSet(xEpsQueue, xInboxSet);
+    xQueueAddToSet(xHkQueue, xInboxSet);
+    TRACE_NAME(xInboxSet, "HUB_SET");
+
+    printf("SUBSYSTEM HUB: Task initialized, serving ADCS/EPS/HK inboxes.\n");
+    TRACE_TASK_START();
+
+    for (;;) {
+        TRACE_EVENT(TRACE_TASK_SLEEP, xInboxSet, 0);
+        xReady = xQueueSelectFromSet(xInboxSet, portMAX_DELAY);
+        TRACE_EVENT(TRACE_TASK_WAKE, xInboxSet, 0);
+        if (xReady == NULL || xQueueReceive(xReady, &frame, 0) != pdPASS) {
+            continue;
+        }
+        TRACE_EVENT(TRACE_QUEUE_RECEIVE, xReady, uxQueueMessagesWaiting(xReady));
+
+        CCSDS_PrimaryHeader_t hdr = {0};
+        size_t user_len = 0;
+        const uint8_t *user = NULL;
+        if (ccsds_decode_primary(frame->data, frame->length, &hdr) == 0) {
+            user = ccsds_user_data(frame->data, &hdr, &user_len);
+        }
+
+        if (xReady == xAdcsQueue) {
+            printf("[ADCS] Command received (%u bytes of user data).\n", (unsigned)user_len);
+        } else if (xReady == xEpsQueue) {
+            // First user-data byte selects the power mode
+            if (user != NULL && user_len > 0) {
+                vEPS_SetSafeModePower(user[0]);
+            }
+        } else {
+            printf("[HK] Housekeeping request received (seq %u).\n", (unsigned)hdr.seq_count);
+        }
+
+        cdhs_router_release(frame);
+    }
+}
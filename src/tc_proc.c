@@ -8,71 +8,253 @@
 #include "watchdog.h"
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include "tc_proc.h"
 #include "utils.h"
+#include "ccsds_packet.h"
+#include "packet_schema.h"
+#include "cdhs_router.h"
+#include "fsw_log.h"
 #include "esp_log.h"
+#include "trace.h"
+#include "task_defs.h"
+#include "param_store.h"
 
 
-void process_telecommand(TelecommandPacket_t *tc_packet);
-
-extern QueueHandle_t xTelemetryQueue;
 extern QueueHandle_t xCommandQueue;
 
+typedef struct {
+    const char *name;
+    TcValidateFn_t validate;
+    TcHandlerFn_t execute;
+} TcHandlerEntry_t;
+
+static TcProcStats_t s_proc_stats;
+static TcCommandStats_t s_cmd_stats[TC_ID_COUNT];
+static portMUX_TYPE s_tc_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- A. BUILT-IN HANDLERS ---
+
+static int validate_set_mode(const TelecommandPacket_t *tc) {
+    return (tc->payload[0] <= MODE_CRITICAL) ? 0 : -1;
+}
+
+static void handle_set_mode(const TelecommandPacket_t *tc) {
+    // The new mode is expected to be in the first byte of the payload
+    set_system_mode((SystemMode_t)tc->payload[0]);
+}
+
+static void handle_request_hk(const TelecommandPacket_t *tc) {
+    // The TM Generator answers on the priority lane, echoing tc->timestamp
+    if (tm_gen_request_hk(tc->timestamp) != pdPASS) {
+        FSW_LOGW(LOG_MOD_TC, "TC PROC: HK request T: %lu refused, generator backlog full.\n",
+                 (unsigned long)tc->timestamp);
+    } else {
+        FSW_LOGI(LOG_MOD_TC, "TC PROC: Requesting immediate Telemetry burst.\n");
+    }
+}
+
+static void handle_no_op(const TelecommandPacket_t *tc) {
+    FSW_LOGI(LOG_MOD_TC, "TC PROC: NO-OP command received. Link OK.\n");
+}
+
+// Other modules add theirs with tc_proc_register_handler()
+static TcHandlerEntry_t s_handlers[TC_ID_COUNT] = {
+    [TC_NO_OP]      = { "NO_OP",      NULL,              handle_no_op },
+    [TC_SET_MODE]   = { "SET_MODE",   validate_set_mode, handle_set_mode },
+    [TC_REQUEST_HK] = { "REQUEST_HK", NULL,              handle_request_hk },
+};
+
+BaseType_t tc_proc_register_handler(TelecommandID_t id, const char *name,
+                                    TcValidateFn_t validate, TcHandlerFn_t execute) {
+    if ((uint32_t)id >= TC_ID_COUNT || execute == NULL) {
+        return pdFAIL;
+    }
+    s_handlers[id].name = name;
+    s_handlers[id].validate = validate;
+    s_handlers[id].execute = execute;
+    return pdPASS;
+}
+
+// --- B. EXECUTION ---
+
+// Wire decode and CRC check, table lookup, validation, execution. submit_us
+// starts the wait interval (the router submit time, or now for commands
+// raised on board).
+static void execute_telecommand(const uint8_t *wire, size_t len, uint32_t submit_us) {
+    TelecommandPacket_t tc;
+
+    // 1. Length and CRC over the wire bytes
+    int status = tc_unpack(wire, len, &tc);
+    uint32_t checked_us = util_get_time_us();
+
+    if (status == PKT_SCHEMA_BAD_LENGTH) {
+        portENTER_CRITICAL(&s_tc_mux);
+        s_proc_stats.malformed++;
+        portEXIT_CRITICAL(&s_tc_mux);
+        FSW_LOGE(LOG_MOD_TC, "TC PROC: ERROR! Unexpected TC length %u. Packet discarded.\n", (unsigned)len);
+        return;
+    }
+    if (status == PKT_SCHEMA_BAD_CRC) {
+        portENTER_CRITICAL(&s_tc_mux);
+        s_proc_stats.crc_failures++;
+        portEXIT_CRITICAL(&s_tc_mux);
+        FSW_LOGE(LOG_MOD_TC, "TC PROC: ERROR! CRC FAILURE! Packet discarded.\n");
+        FSW_LOGE(LOG_MOD_TC, "           Expected CRC: 0x%X, Calculated CRC: 0x%X\n",
+                 tc.crc, crc16_ccitt(wire, TC_OFF_crc));
+        return;
+    }
+    uint32_t id = (uint32_t)tc.command_id;
+
+    // 2. O(1) lookup
+    if (id >= TC_ID_COUNT || s_handlers[id].execute == NULL) {
+        portENTER_CRITICAL(&s_tc_mux);
+        s_proc_stats.unknown_id++;
+        portEXIT_CRITICAL(&s_tc_mux);
+        FSW_LOGE(LOG_MOD_TC, "TC PROC: ERROR! Unknown command ID: %lu\n", (unsigned long)id);
+        return;
+    }
+    const TcHandlerEntry_t *handler = &s_handlers[id];
+    TcCommandStats_t *stats = &s_cmd_stats[id];
+    uint32_t wait_us = checked_us - submit_us;
+
+    // 3. Parameters
+    if (handler->validate != NULL && handler->validate(&tc) != 0) {
+        portENTER_CRITICAL(&s_tc_mux);
+        stats->invalid_params++;
+        stats->wait_sum_us += wait_us;
+        if (wait_us > stats->wait_max_us) {
+            stats->wait_max_us = wait_us;
+        }
+        portEXIT_CRITICAL(&s_tc_mux);
+        FSW_LOGE(LOG_MOD_TC, "TC PROC: ERROR! Invalid parameters for %s. Command rejected.\n", handler->name);
+        return;
+    }
+
+    // 4. Execute
+    FSW_LOGI(LOG_MOD_TC, "TC PROC: CRC OK. Executing %s.\n", handler->name);
+    handler->execute(&tc);
+    uint32_t exec_us = util_get_time_us() - checked_us;
+
+    portENTER_CRITICAL(&s_tc_mux);
+    stats->executed++;
+    stats->wait_sum_us += wait_us;
+    stats->exec_sum_us += exec_us;
+    if (wait_us > stats->wait_max_us) {
+        stats->wait_max_us = wait_us;
+    }
+    if (exec_us > stats->exec_max_us) {
+        stats->exec_max_us = exec_us;
+    }
+    portEXIT_CRITICAL(&s_tc_mux);
+}
+
+void process_telecommand(const TelecommandPacket_t *tc_packet) {
+    uint8_t wire[TC_WIRE_LEN];
+
+    execute_telecommand(wire, tc_pack(tc_packet, wire), util_get_time_us());
+}
+
+// Unwraps one routed space packet and releases it
+static void handle_frame(CCSDS_Frame_t *rx_frame) {
+    CCSDS_PrimaryHeader_t hdr;
+    const uint8_t *user = NULL;
+    size_t user_len = 0;
+
+    if (ccsds_decode_primary(rx_frame->data, rx_frame->length, &hdr) == 0) {
+        user = ccsds_user_data(rx_frame->data, &hdr, &user_len);
+    }
+
+    portENTER_CRITICAL(&s_tc_mux);
+    s_proc_stats.received++;
+    portEXIT_CRITICAL(&s_tc_mux);
+
+    // A missing user data field counts as a wrong length
+    execute_telecommand(user, (user != NULL) ? user_len : 0, rx_frame->submit_time_us);
+    cdhs_router_release(rx_frame);
+}
+
+// TC group of the parameter store. Only this task publishes it, once per
+// burst; commands raised on board land in the next burst's publish.
+static void publish_tc_params(void) {
+    uint32_t received, rejected;
+
+    portENTER_CRITICAL(&s_tc_mux);
+    received = s_proc_stats.received;
+    rejected = s_proc_stats.malformed + s_proc_stats.crc_failures + s_proc_stats.unknown_id;
+    portEXIT_CRITICAL(&s_tc_mux);
+
+    param_write_begin(PARAM_GROUP_TC);
+    param_write(PARAM_tc_received, (int32_t)received);
+    param_write(PARAM_tc_rejected, (int32_t)rejected);
+    param_write_end(PARAM_GROUP_TC);
+}
+
+// --- C. PROCESSOR TASK ---
+
 void vCommandProcessorTask(void *pvParameters){
-    HK_Telemetry_t rx_packet;
-    TelecommandPacket_t rx_command;
+    CCSDS_Frame_t *rx_frame;
     printf("TC Processor Task initialized and waiting for commands.\n");
+    TRACE_TASK_START();
     for(;;) {
-        if(xQueueReceive(xCommandQueue, &rx_command, pdMS_TO_TICKS(100)) == pdPASS) {
-            process_telecommand(&rx_command);
+        // 1. Sleep until the router hands over a packet (timeout only feeds the watchdog)
+        TRACE_EVENT(TRACE_TASK_SLEEP, xCommandQueue, 0);
+        BaseType_t woke = xQueueReceive(xCommandQueue, &rx_frame, pdMS_TO_TICKS(TC_PROC_IDLE_WAKE_MS));
+        TRACE_EVENT(TRACE_TASK_WAKE, xCommandQueue, 0);
+        if(woke == pdPASS) {
+            uint32_t depth = (uint32_t)uxQueueMessagesWaiting(xCommandQueue) + 1;
+            uint32_t drained = 0;
+
+            // 2. Drain the burst without going back to the scheduler between TCs
+            do {
+                TRACE_EVENT(TRACE_QUEUE_RECEIVE, xCommandQueue, uxQueueMessagesWaiting(xCommandQueue));
+                handle_frame(rx_frame);
+                drained++;
+            } while (drained < TC_PROC_BATCH_MAX &&
+                     xQueueReceive(xCommandQueue, &rx_frame, 0) == pdPASS);
+
+            portENTER_CRITICAL(&s_tc_mux);
+            s_proc_stats.batches++;
+            if (drained > s_proc_stats.batch_max) {
+                s_proc_stats.batch_max = drained;
+            }
+            if (depth > s_proc_stats.queue_peak) {
+                s_proc_stats.queue_peak = depth;
+            }
+            portEXIT_CRITICAL(&s_tc_mux);
+            publish_tc_params();
         }
-        
-        
-        //if(xQueueReceive(xTelemetryQueue, &rx_packet, 0) == pdPASS) {
-            //printf("Received Telemetry Packet - Timestamp: %lu, Bus Voltage: %.2f V\n",
-            //    rx_packet.timestamp, (double)rx_packet.bus_voltage);
-        //}
-        //if (xTaskGetTickCount() > pdMS_TO_TICKS(10000) && get_system_mode() == MODE_SAFE) {
-        //    set_system_mode(MODE_NOMINAL); // This calls the protected function!
-        //}
+
         watchdog_pet(WDT_TASK_CMD_PROC);
     }
 }
 
+// --- D. TELEMETRY SURFACE ---
 
-void process_telecommand(TelecommandPacket_t *tc_packet) {
-    size_t crc_data_length = sizeof(TelecommandPacket_t) - sizeof(uint16_t);
+void tc_proc_get_stats(TcProcStats_t *stats) {
+    CdhsApidStats_t route;
 
-    uint16_t calculated_crc = crc16_ccitt((const uint8_t *)tc_packet, crc_data_length);
+    portENTER_CRITICAL(&s_tc_mux);
+    *stats = s_proc_stats;
+    portEXIT_CRITICAL(&s_tc_mux);
 
-    if(calculated_crc != tc_packet->crc) {
-        printf("TC PROC: ERROR! CRC FAILURE! Packet discarded.\n");
-        printf("           Expected CRC: 0x%X, Calculated CRC: 0x%X\n", tc_packet->crc, calculated_crc);
-        return;
+    // The router owns the drop count for a full xCommandQueue
+    stats->queue_overflows = 0;
+    if (cdhs_router_get_apid_stats(APID_CDHS, &route) == pdPASS) {
+        stats->queue_overflows = route.drops;
     }
-    printf("TC PROC: CRC OK. Executing Command ID: %d\n", tc_packet->command_id);
-
-    switch (tc_packet->command_id) {
-        case TC_SET_MODE:
-            // The new mode is expected to be in the first byte of the payload
-            SystemMode_t new_mode = (SystemMode_t)tc_packet->payload[0];
-            set_system_mode(new_mode);
-            break;
-
-        case TC_REQUEST_HK:
-            printf("TC PROC: Requesting immediate Telemetry burst.\n");
-            break;
-            
-        case TC_NO_OP:
-            printf("TC PROC: NO-OP command received. Link OK.\n");
-            break;
-
-        default:
-            printf("TC PROC: ERROR! Unknown command ID: %d\n", tc_packet->command_id);
-            break;
+}
+
+BaseType_t tc_proc_get_command_stats(TelecommandID_t id, TcCommandStats_t *stats) {
+    if ((uint32_t)id >= TC_ID_COUNT) {
+        return pdFAIL;
     }
+    portENTER_CRITICAL(&s_tc_mux);
+    *stats = s_cmd_stats[id];
+    portEXIT_CRITICAL(&s_tc_mux);
+    return pdPASS;
 }
 
 void vTC_SetSystemMode(int new_mode){
     printf("STUB CALLED: Setting system mode to %d.\n", new_mode);
-}
\ No newline at end of file
+}
@@ -0,0 +1,341 @@
+// src/tc_scheduler.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "tc_scheduler.h"
+#include "tc_timeline.h"
+#include "tc_proc.h"
+#include "satellite_types.h"
+#include "ccsds_packet.h"   // Big-endian helpers
+#include "watchdog.h"
+#include "utils.h"
+#include "rtos_alloc.h"
+#include "trace.h"
+#include "checkpoint.h"
+#include "fsw_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static TcTimeline_t s_timeline;
+static TcSchedulerStats_t s_sched_stats;
+static SemaphoreHandle_t xSchedMutex;
+static TaskHandle_t s_sched_task;
+
+#define COMMAND_CRC_LEN (sizeof(Command_t) - sizeof(uint16_t))
+
+// Wakes the scheduler so it recomputes its sleep after the head may have moved
+static void wake_scheduler(void) {
+    if (s_sched_task != NULL) {
+        xTaskNotifyGive(s_sched_task);
+    }
+}
+
+// Only commands with a handler can be stored; an insert cannot be nested
+// because its own payload would not fit in the 3 stored parameter bytes.
+static int validate_insert(const TelecommandPacket_t *tc) {
+    uint8_t cmd_id = tc->payload[0];
+    return (cmd_id < TC_ID_COUNT && cmd_id != TC_SCHED_INSERT) ? 0 : -1;
+}
+
+static int validate_list(const TelecommandPacket_t *tc) {
+    uint32_t from = ccsds_get_be32(&tc->payload[0]);
+    uint32_t to = ccsds_get_be32(&tc->payload[4]);
+    return ((int32_t)(to - from) >= 0) ? 0 : -1;
+}
+
+// --- WARM RESTART ---
+// The earliest TC_SCHED_CHECKPOINT_MAX pending commands are checkpointed
+// after every insert, delete and dispatch, under xSchedMutex; picking them
+// walks only the top of the heap (tc_timeline_earliest()). Ticks start
+// from zero again after a reset, so restored commands keep the time they
+// still had to wait, counted from the last moment the previous boot is known
+// to have been alive. A command is saved as gone before it runs: a reset
+// while it executes loses it rather than running it twice.
+typedef struct {
+    uint16_t count;
+    uint16_t reserved;
+    Command_t cmd[TC_SCHED_CHECKPOINT_MAX];
+} TimelineCheckpoint_t;
+
+static TimelineCheckpoint_t s_checkpoint;
+
+// Called with xSchedMutex held (or before the scheduler runs)
+static void save_timeline(TickType_t now) {
+    TcTimelineEntry_t entries[TC_SCHED_CHECKPOINT_MAX];
+    size_t n = tc_timeline_earliest(&s_timeline, entries, TC_SCHED_CHECKPOINT_MAX);
+
+    memset(&s_checkpoint, 0, sizeof(s_checkpoint));
+    s_checkpoint.count = (uint16_t)n;
+    for (size_t i = 0; i < n; i++) {
+        s_checkpoint.cmd[i] = entries[i].cmd;
+    }
+    checkpoint_write(CHECKPOINT_TIMELINE, &s_checkpoint, sizeof(s_checkpoint), (uint32_t)now);
+}
+
+// Re-queues the commands of the previous boot on this boot's tick count
+static void restore_timeline(void) {
+    CheckpointInfo_t info;
+    CheckpointStats_t cp;
+    TickType_t now = xTaskGetTickCount();
+    uint32_t restored = 0, dropped = 0;
+
+    if (checkpoint_get(CHECKPOINT_TIMELINE, &s_checkpoint, sizeof(s_checkpoint), &info) != 0) {
+        return;
+    }
+
+    // 1. Time base: the previous boot's last sign of life, else when the record was written
+    checkpoint_get_stats(&cp);
+    uint32_t base = (cp.last_alive_valid && info.boot + 1u == cp.boot) ? cp.last_alive_tick : info.tick;
+
+    // 2. Re-insert; commands due during the outage run at once
+    for (uint16_t i = 0; i < s_checkpoint.count && i < TC_SCHED_CHECKPOINT_MAX; i++) {
+        Command_t cmd = s_checkpoint.cmd[i];
+        uint16_t id;
+
+        if (crc16_ccitt((const uint8_t *)&cmd, COMMAND_CRC_LEN) != cmd.checksum) {
+            dropped++;
+            continue;
+        }
+        int32_t remaining = (int32_t)(cmd.execution_time - base);
+        cmd.execution_time = (uint32_t)now + (uint32_t)((remaining > 0) ? remaining : 0);
+        cmd.checksum = crc16_ccitt((const uint8_t *)&cmd, COMMAND_CRC_LEN);
+        if (tc_timeline_insert(&s_timeline, &cmd, &id) == 0) {
+            restored++;
+        } else {
+            dropped++;
+        }
+    }
+    s_sched_stats.restored = restored;
+    printf("TC SCHED: %lu command(s) restored from checkpoint, %lu dropped.\n",
+           (unsigned long)restored, (unsigned long)dropped);
+}
+
+// --- A. TIMELINE ACCESS ---
+
+BaseType_t tc_scheduler_init(void) {
+    xSchedMutex = rtos_mutex_create("SCHED_MUTEX");
+    if (xSchedMutex == NULL) {
+        return pdFAIL;
+    }
+    tc_timeline_init(&s_timeline);
+    memset(&s_sched_stats, 0, sizeof(s_sched_stats));
+
+    // The rebased times replace the old record at once
+    restore_timeline();
+    save_timeline(xTaskGetTickCount());
+
+    if (tc_proc_register_handler(TC_SCHED_INSERT, "SCHED_INSERT", validate_insert,
+                                 tc_scheduler_handle_telecommand) != pdPASS ||
+        tc_proc_register_handler(TC_SCHED_DELETE, "SCHED_DELETE", NULL,
+                                 tc_scheduler_handle_telecommand) != pdPASS ||
+        tc_proc_register_handler(TC_SCHED_LIST, "SCHED_LIST", validate_list,
+                                 tc_scheduler_handle_telecommand) != pdPASS) {
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+BaseType_t tc_scheduler_insert(const Command_t *cmd, uint16_t *id) {
+    Command_t stored = *cmd;
+    uint32_t head_before = 0, head_after = 0;
+    int had_head, result;
+
+    // Guards the command while it waits in RAM, possibly for days
+    stored.checksum = crc16_ccitt((const uint8_t *)&stored, COMMAND_CRC_LEN);
+
+    xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+    had_head = (tc_timeline_next_time(&s_timeline, &head_before) == 0);
+    result = tc_timeline_insert(&s_timeline, &stored, id);
+    tc_timeline_next_time(&s_timeline, &head_after);
+    if (result == 0) {
+        s_sched_stats.inserted++;
+        save_timeline(xTaskGetTickCount());
+    } else {
+        s_sched_stats.rejected_full++;
+    }
+    xSemaphoreGive(xSchedMutex);
+
+    if (result != 0) {
+        return pdFAIL;
+    }
+    if (!had_head || head_after != head_before) {
+        wake_scheduler();
+    }
+    return pdPASS;
+}
+
+BaseType_t tc_scheduler_delete(uint16_t id) {
+    int result;
+
+    xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+    result = tc_timeline_delete(&s_timeline, id);
+    if (result == 0) {
+        s_sched_stats.deleted++;
+        save_timeline(xTaskGetTickCount());
+    }
+    xSemaphoreGive(xSchedMutex);
+
+    // A later deadline may now be the head; the scheduler just re-evaluates
+    if (result == 0) {
+        wake_scheduler();
+    }
+    return (result == 0) ? pdPASS : pdFAIL;
+}
+
+size_t tc_scheduler_list(uint32_t from, uint32_t to, TcTimelineEntry_t *entries, size_t max_entries) {
+    size_t n;
+
+    xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+    n = tc_timeline_list(&s_timeline, from, to, entries, max_entries);
+    xSemaphoreGive(xSchedMutex);
+    return n;
+}
+
+void tc_scheduler_get_stats(TcSchedulerStats_t *stats) {
+    xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+    *stats = s_sched_stats;
+    stats->pending = tc_timeline_count(&s_timeline);
+    xSemaphoreGive(xSchedMutex);
+}
+
+// --- B. GROUND INTERFACE ---
+
+void tc_scheduler_handle_telecommand(const TelecommandPacket_t *tc) {
+    const uint8_t *p = tc->payload;
+
+    switch (tc->command_id) {
+        case TC_SCHED_INSERT: {
+            Command_t cmd;
+            uint16_t id;
+
+            memset(&cmd, 0, sizeof(cmd));
+            cmd.command_id = p[0];
+            cmd.execution_time = ccsds_get_be32(&p[1]);
+            cmd.parameter_length = 3;
+            memcpy(cmd.data, &p[5], 3);
+
+            if (tc_scheduler_insert(&cmd, &id) == pdPASS) {
+                FSW_LOGI(LOG_MOD_SCHED, "TC SCHED: Command %u queued for T=%lu (id 0x%04X).\n",
+                         cmd.command_id, (unsigned long)cmd.execution_time, id);
+            } else {
+                FSW_LOGE(LOG_MOD_SCHED, "TC SCHED: ERROR! Timeline full, command %u rejected.\n", cmd.command_id);
+            }
+            break;
+        }
+
+        case TC_SCHED_DELETE: {
+            uint16_t id = ccsds_get_be16(&p[0]);
+            if (tc_scheduler_delete(id) == pdPASS) {
+                FSW_LOGI(LOG_MOD_SCHED, "TC SCHED: Command id 0x%04X deleted.\n", id);
+            } else {
+                FSW_LOGE(LOG_MOD_SCHED, "TC SCHED: ERROR! No pending command with id 0x%04X.\n", id);
+            }
+            break;
+        }
+
+        case TC_SCHED_LIST: {
+            TcTimelineEntry_t entries[TC_SCHED_LIST_MAX];
+            uint32_t from = ccsds_get_be32(&p[0]);
+            uint32_t to = ccsds_get_be32(&p[4]);
+            size_t n = tc_scheduler_list(from, to, entries, TC_SCHED_LIST_MAX);
+
+            FSW_LOGI(LOG_MOD_SCHED, "TC SCHED: %u command(s) between T=%lu and T=%lu:\n",
+                     (unsigned)n, (unsigned long)from, (unsigned long)to);
+            for (size_t i = 0; i < n; i++) {
+                FSW_LOGI(LOG_MOD_SCHED, "           id 0x%04X  T=%lu  cmd %u\n", entries[i].id,
+                         (unsigned long)entries[i].cmd.execution_time, entries[i].cmd.command_id);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// --- C. SCHEDULER TASK ---
+
+static void dispatch(const TcTimelineEntry_t *entry, TickType_t now) {
+    TelecommandPacket_t tc;
+    uint32_t jitter = (uint32_t)(now - entry->cmd.execution_time);
+
+    // 1. A stored command that no longer matches its checksum is never run
+    if (crc16_ccitt((const uint8_t *)&entry->cmd, COMMAND_CRC_LEN) != entry->cmd.checksum) {
+        xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+        s_sched_stats.corrupt++;
+        xSemaphoreGive(xSchedMutex);
+        FSW_LOGE(LOG_MOD_SCHED, "TC SCHED: ERROR! Command id 0x%04X corrupted in storage. Discarded.\n", entry->id);
+        return;
+    }
+
+    xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+    s_sched_stats.fired++;
+    s_sched_stats.jitter_sum_ticks += jitter;
+    if (jitter > s_sched_stats.jitter_max_ticks) {
+        s_sched_stats.jitter_max_ticks = jitter;
+    }
+    if (jitter > 0) {
+        s_sched_stats.fired_late++;
+    }
+    xSemaphoreGive(xSchedMutex);
+
+    // 2. Same path as an immediate TC
+    memset(&tc, 0, sizeof(tc));
+    tc.timestamp = now;
+    tc.command_id = (TelecommandID_t)entry->cmd.command_id;
+    memcpy(tc.payload, entry->cmd.data, sizeof(tc.payload));
+
+    FSW_LOGI(LOG_MOD_SCHED, "TC SCHED: Dispatching id 0x%04X (cmd %u) at T=%lu, jitter %lu ticks.\n",
+             entry->id, entry->cmd.command_id, (unsigned long)now, (unsigned long)jitter);
+    process_telecommand(&tc);
+}
+
+void vTcSchedulerTask(void *pvParameters) {
+    const TickType_t xMaxSleep = pdMS_TO_TICKS(TC_SCHED_MAX_SLEEP_MS);
+    TcTimelineEntry_t entry;
+
+    s_sched_task = xTaskGetCurrentTaskHandle();
+    printf("TC Scheduler Task initialized, %u command slots.\n", (unsigned)TC_TIMELINE_CAPACITY);
+    TRACE_TASK_START();
+
+    for (;;) {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = xMaxSleep;
+        uint32_t next;
+        int due;
+
+        // 1. Run everything that is due (mutex released while a command executes)
+        do {
+            xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+            due = tc_timeline_pop_due(&s_timeline, now, &entry);
+            if (due) {
+                save_timeline(now);
+            }
+            xSemaphoreGive(xSchedMutex);
+            if (due) {
+                dispatch(&entry, now);
+                now = xTaskGetTickCount();
+            }
+        } while (due);
+
+        // 2. Sleep until the next deadline; inserts and deletes cut the sleep short
+        xSemaphoreTake(xSchedMutex, portMAX_DELAY);
+        if (tc_timeline_next_time(&s_timeline, &next) == 0) {
+            int32_t until = (int32_t)(next - now);
+            if (until <= 0) {
+                wait = 0;
+            } else if ((TickType_t)until < xMaxSleep) {
+                wait = (TickType_t)until;
+            }
+        }
+        xSemaphoreGive(xSchedMutex);
+
+        watchdog_pet(WDT_TASK_TC_SCHED);
+        if (wait > 0) {
+            TRACE_EVENT(TRACE_TASK_SLEEP, NULL, 0);
+            ulTaskNotifyTake(pdTRUE, wait);
+            TRACE_EVENT(TRACE_TASK_WAKE, NULL, 0);
+        }
+    }
+}
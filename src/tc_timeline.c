@@ -0,0 +1,263 @@
+// src/tc_timeline.c
+
+#include "tc_timeline.h"
+#include <string.h>
+
+// --- HELPERS ---
+
+// Wrap-safe "a runs before b"
+static int earlier(const TcTimeline_t *tl, uint16_t a, uint16_t b) {
+    int32_t dt = (int32_t)(tl->cmd[a].execution_time - tl->cmd[b].execution_time);
+    if (dt != 0) {
+        return dt < 0;
+    }
+    return (int32_t)(tl->order[a] - tl->order[b]) < 0;
+}
+
+static void place(TcTimeline_t *tl, uint16_t index, uint16_t slot) {
+    tl->heap[index] = slot;
+    tl->pos[slot] = index;
+}
+
+static void sift_up(TcTimeline_t *tl, uint16_t index) {
+    uint16_t slot = tl->heap[index];
+
+    while (index > 0) {
+        uint16_t parent = (uint16_t)((index - 1) / 2);
+        if (!earlier(tl, slot, tl->heap[parent])) {
+            break;
+        }
+        place(tl, index, tl->heap[parent]);
+        index = parent;
+    }
+    place(tl, index, slot);
+}
+
+static void sift_down(TcTimeline_t *tl, uint16_t index) {
+    uint16_t slot = tl->heap[index];
+
+    for (;;) {
+        uint16_t child = (uint16_t)(2 * index + 1);
+        if (child >= tl->count) {
+            break;
+        }
+        if (child + 1 < tl->count && earlier(tl, tl->heap[child + 1], tl->heap[child])) {
+            child++;
+        }
+        if (!earlier(tl, tl->heap[child], slot)) {
+            break;
+        }
+        place(tl, index, tl->heap[child]);
+        index = child;
+    }
+    place(tl, index, slot);
+}
+
+static uint16_t make_id(const TcTimeline_t *tl, uint16_t slot) {
+    return (uint16_t)((tl->generation[slot] << 8) | slot);
+}
+
+// Takes the entry at heap position `index` out and returns its slot to the pool
+static void remove_at(TcTimeline_t *tl, uint16_t index) {
+    uint16_t slot = tl->heap[index];
+
+    tl->count--;
+    if (index < tl->count) {
+        place(tl, index, tl->heap[tl->count]);
+        // The moved entry may belong above or below its new position
+        if (index > 0 && earlier(tl, tl->heap[index], tl->heap[(index - 1) / 2])) {
+            sift_up(tl, index);
+        } else {
+            sift_down(tl, index);
+        }
+    }
+
+    tl->pos[slot] = TC_TIMELINE_INVALID_ID;
+    tl->generation[slot]++;
+    if (make_id(tl, slot) == TC_TIMELINE_INVALID_ID) {
+        tl->generation[slot]++;             // Slot 255 skips generation 255
+    }
+    tl->free_slots[tl->free_count++] = slot;
+}
+
+typedef char tc_timeline_slot_fits_id[(TC_TIMELINE_CAPACITY <= 256) ? 1 : -1];
+
+// --- A. UPDATE ---
+
+void tc_timeline_init(TcTimeline_t *tl) {
+    memset(tl, 0, sizeof(*tl));
+    for (uint16_t s = 0; s < TC_TIMELINE_CAPACITY; s++) {
+        tl->free_slots[s] = (uint16_t)(TC_TIMELINE_CAPACITY - 1 - s);   // Slot 0 handed out first
+        tl->pos[s] = TC_TIMELINE_INVALID_ID;
+    }
+    tl->free_count = TC_TIMELINE_CAPACITY;
+}
+
+int tc_timeline_insert(TcTimeline_t *tl, const Command_t *cmd, uint16_t *id) {
+    if (tl->free_count == 0) {
+        return -1;
+    }
+
+    uint16_t slot = tl->free_slots[--tl->free_count];
+    tl->cmd[slot] = *cmd;
+    tl->order[slot] = tl->next_order++;
+
+    place(tl, tl->count, slot);
+    tl->count++;
+    sift_up(tl, (uint16_t)(tl->count - 1));
+
+    if (id != NULL) {
+        *id = make_id(tl, slot);
+    }
+    return 0;
+}
+
+int tc_timeline_delete(TcTimeline_t *tl, uint16_t id) {
+    uint16_t slot = id & 0xFFu;
+
+    if (slot >= TC_TIMELINE_CAPACITY || tl->pos[slot] == TC_TIMELINE_INVALID_ID ||
+        make_id(tl, slot) != id) {
+        return -1;
+    }
+    remove_at(tl, tl->pos[slot]);
+    return 0;
+}
+
+// --- B. QUERIES ---
+
+int tc_timeline_next_time(const TcTimeline_t *tl, uint32_t *execution_time) {
+    if (tl->count == 0) {
+        return -1;
+    }
+    *execution_time = tl->cmd[tl->heap[0]].execution_time;
+    return 0;
+}
+
+int tc_timeline_pop_due(TcTimeline_t *tl, uint32_t now, TcTimelineEntry_t *entry) {
+    if (tl->count == 0) {
+        return 0;
+    }
+
+    uint16_t slot = tl->heap[0];
+    if ((int32_t)(now - tl->cmd[slot].execution_time) < 0) {
+        return 0;
+    }
+
+    entry->id = make_id(tl, slot);
+    entry->cmd = tl->cmd[slot];
+    remove_at(tl, 0);
+    return 1;
+}
+
+size_t tc_timeline_list(const TcTimeline_t *tl, uint32_t from, uint32_t to,
+                        TcTimelineEntry_t *entries, size_t max_entries) {
+    uint16_t stack[TC_TIMELINE_CAPACITY];
+    uint16_t match[TC_TIMELINE_CAPACITY];
+    size_t depth = 0, found = 0;
+
+    // 1. Walk the heap, pruning subtrees that start after `to`
+    if (tl->count > 0) {
+        stack[depth++] = 0;
+    }
+    while (depth > 0) {
+        uint16_t index = stack[--depth];
+        uint16_t slot = tl->heap[index];
+        uint32_t t = tl->cmd[slot].execution_time;
+
+        if ((int32_t)(t - to) > 0) {
+            continue;
+        }
+        if ((int32_t)(t - from) >= 0) {
+            match[found++] = slot;
+        }
+        if (2u * index + 1 < tl->count) {
+            stack[depth++] = (uint16_t)(2 * index + 1);
+        }
+        if (2u * index + 2 < tl->count) {
+            stack[depth++] = (uint16_t)(2 * index + 2);
+        }
+    }
+
+    // 2. Time order (insertion sort: a range listing is short and rare)
+    for (size_t i = 1; i < found; i++) {
+        uint16_t slot = match[i];
+        size_t j = i;
+        while (j > 0 && earlier(tl, slot, match[j - 1])) {
+            match[j] = match[j - 1];
+            j--;
+        }
+        match[j] = slot;
+    }
+
+    if (found > max_entries) {
+        found = max_entries;
+    }
+    for (size_t i = 0; i < found; i++) {
+        entries[i].id = make_id(tl, match[i]);
+        entries[i].cmd = tl->cmd[match[i]];
+    }
+    return found;
+}
+
+// The earliest entry of the heap is its root and the next one is always a
+// child of an entry already taken, so a best-first walk only ever looks at
+// the taken entries and their children: O(k log k) for k entries.
+static void frontier_push(const TcTimeline_t *tl, uint16_t *frontier, size_t *n, uint16_t index) {
+    size_t i = (*n)++;
+
+    while (i > 0 && earlier(tl, tl->heap[index], tl->heap[frontier[(i - 1) / 2]])) {
+        frontier[i] = frontier[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    frontier[i] = index;
+}
+
+static uint16_t frontier_pop(const TcTimeline_t *tl, uint16_t *frontier, size_t *n) {
+    uint16_t top = frontier[0];
+    uint16_t last = frontier[--(*n)];
+    size_t i = 0;
+
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= *n) {
+            break;
+        }
+        if (child + 1 < *n && earlier(tl, tl->heap[frontier[child + 1]], tl->heap[frontier[child]])) {
+            child++;
+        }
+        if (!earlier(tl, tl->heap[frontier[child]], tl->heap[last])) {
+            break;
+        }
+        frontier[i] = frontier[child];
+        i = child;
+    }
+    if (*n > 0) {
+        frontier[i] = last;
+    }
+    return top;
+}
+
+size_t tc_timeline_earliest(const TcTimeline_t *tl, TcTimelineEntry_t *entries, size_t max_entries) {
+    uint16_t frontier[TC_TIMELINE_CAPACITY];     // Heap positions, itself a min-heap
+    size_t n = 0, found = 0;
+
+    if (tl->count > 0) {
+        frontier[n++] = 0;
+    }
+    while (n > 0 && found < max_entries) {
+        uint16_t index = frontier_pop(tl, frontier, &n);
+        uint16_t slot = tl->heap[index];
+
+        entries[found].id = make_id(tl, slot);
+        entries[found].cmd = tl->cmd[slot];
+        found++;
+
+        if (2u * index + 1 < tl->count) {
+            frontier_push(tl, frontier, &n, (uint16_t)(2 * index + 1));
+        }
+        if (2u * index + 2 < tl->count) {
+            frontier_push(tl, frontier, &n, (uint16_t)(2 * index + 2));
+        }
+    }
+    return found;
+}
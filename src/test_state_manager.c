@@ -1,47 +1,254 @@
 // src/state_manager.c
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "state_manager.h"
+#include "param_store.h"
 #include "satellite_types.h"
+#include "trace.h"
+#include "fsw_log.h"
+#include "utils.h"
+#include "checkpoint.h"
 #include <stdio.h>
+#include <string.h>
 
 
-extern SystemMode_t g_current_mode;
 extern SemaphoreHandle_t xModeMutex;
 
-// --- A. SAFELY READ THE CURRENT MODE (Mutex Take/Give) ---
+// --- MODE STATE BLOCK ---
+// Readers never block: get_system_mode() is one atomic load of mode_word and
+// get_system_mode_snapshot() is a seqlock read (retry while `sequence` is odd
+// or changed). Writers are serialized by xModeMutex; the seqlock write itself
+// runs inside a short critical section so a reader can never preempt a
+// half-finished update and spin on it.
+static struct {
+    uint32_t sequence;              // Odd while a write is in progress
+    uint32_t mode_word;             // SystemMode_t, published for the wait-free path
+    uint32_t generation;
+    uint32_t last_transition_tick;
+} s_mode_state;
+
+static portMUX_TYPE s_mode_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Subscriber mailboxes. Filled by the writer inside the seqlock critical
+// section, so they see transitions in generation order; emptied by their
+// task under the same lock.
+typedef struct {
+    TaskHandle_t task;
+    int pending;
+    ModeChangeEvent_t event;
+    ModeSubscriberStats_t stats;
+} ModeSubscriber_t;
+
+static ModeSubscriber_t s_subscribers[MODE_MAX_SUBSCRIBERS];
+static uint32_t s_subscriber_count;
+
+// Copy of the state block for the parameter store's MODE group. Called with
+// writers serialized (xModeMutex, or init before the scheduler runs).
+static void publish_mode_params(SystemMode_t mode, uint32_t generation, uint32_t tick) {
+    param_write_begin(PARAM_GROUP_MODE);
+    param_write(PARAM_mode, (int32_t)mode);
+    param_write(PARAM_mode_generation, (int32_t)generation);
+    param_write(PARAM_mode_since_tick, (int32_t)tick);
+    param_write_end(PARAM_GROUP_MODE);
+}
+
+static const char *mode_name(SystemMode_t mode) {
+    return (mode == MODE_NOMINAL) ? "NOMINAL" :
+           (mode == MODE_SAFE) ? "SAFE" : "CRITICAL";
+}
+
+// Checkpoint record of the state block; written under xModeMutex
+typedef struct {
+    uint32_t mode;
+    uint32_t generation;
+} ModeCheckpoint_t;
+
+void state_manager_init(void) {
+    ModeCheckpoint_t saved;
+    SystemMode_t mode = MODE_SAFE;
+    uint32_t generation = 0;
+
+    // A warm restart resumes the mode the satellite was in; the generation
+    // carries on so subscribers and ground see one continuous history
+    if (checkpoint_get(CHECKPOINT_MODE, &saved, sizeof(saved), NULL) == 0 &&
+        saved.mode <= (uint32_t)MODE_CRITICAL) {
+        mode = (SystemMode_t)saved.mode;
+        generation = saved.generation;
+        printf("STATE: Restored mode %s (gen %lu) from checkpoint.\n",
+               mode_name(mode), (unsigned long)generation);
+    }
+
+    portENTER_CRITICAL(&s_mode_mux);
+    __atomic_store_n(&s_mode_state.sequence, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mode_state.mode_word, (uint32_t)mode, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mode_state.generation, generation, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mode_state.last_transition_tick, 0, __ATOMIC_RELAXED);
+    memset(s_subscribers, 0, sizeof(s_subscribers));
+    s_subscriber_count = 0;
+    portEXIT_CRITICAL(&s_mode_mux);
+    publish_mode_params(mode, generation, 0);
+}
+
+// --- A. READ THE CURRENT MODE (wait-free) ---
 SystemMode_t get_system_mode(void) {
-    SystemMode_t mode_copy = MODE_SAFE;
-    
-    // Attempt to acquire the Mutex (Wait indefinitely: portMAX_DELAY)
-    if (xSemaphoreTake(xModeMutex, portMAX_DELAY) == pdTRUE) {
-        
-        // Mutex acquired! Copy the state variable for safe reading
-        mode_copy = g_current_mode;
-        
-        // Release the Mutex immediately so other tasks can access it
-        xSemaphoreGive(xModeMutex);
+    return (SystemMode_t)__atomic_load_n(&s_mode_state.mode_word, __ATOMIC_ACQUIRE);
+}
+
+// --- B. READ THE FULL STATE BLOCK (seqlock) ---
+void get_system_mode_snapshot(SystemModeSnapshot_t *snapshot) {
+    uint32_t seq_start, seq_end;
+
+    do {
+        seq_start = __atomic_load_n(&s_mode_state.sequence, __ATOMIC_ACQUIRE);
+
+        snapshot->mode = (SystemMode_t)__atomic_load_n(&s_mode_state.mode_word, __ATOMIC_RELAXED);
+        snapshot->generation = __atomic_load_n(&s_mode_state.generation, __ATOMIC_RELAXED);
+        snapshot->last_transition_tick = __atomic_load_n(&s_mode_state.last_transition_tick, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        seq_end = __atomic_load_n(&s_mode_state.sequence, __ATOMIC_RELAXED);
+    } while ((seq_start & 1u) || seq_start != seq_end);
+}
+
+// --- C. SAFELY CHANGE THE MODE (Mutex Take/Give) ---
+BaseType_t set_system_mode(SystemMode_t new_mode) {
+    SystemMode_t old_mode;
+    uint32_t generation, subscribers;
+    uint32_t now_us = util_get_time_us();
+
+    // 1. Validate before touching the lock
+    if ((uint32_t)new_mode > (uint32_t)MODE_CRITICAL) {
+        FSW_LOGW(LOG_MOD_MODE, "WARNING: Rejected mode change to invalid mode %d.\n", new_mode);
+        return pdFAIL;
+    }
+
+    // 2. Serialize writers (Wait for 10 ticks, then give up)
+    if (xSemaphoreTake(xModeMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        TRACE_EVENT(TRACE_MUTEX_TIMEOUT, xModeMutex, 0);
+        FSW_LOGW(LOG_MOD_MODE, "WARNING: Could not change mode to %d; Mutex busy.\n", new_mode);
+        return pdFAIL;
     }
-    return mode_copy;
-}
-
-// --- B. SAFELY CHANGE THE MODE (Mutex Take/Give) ---
-void set_system_mode(SystemMode_t new_mode) {
-    
-    // Attempt to acquire the Mutex (Wait for 10 ticks, then give up)
-    if (xSemaphoreTake(xModeMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        
-        // Mutex acquired! Change the global state variable
-        g_current_mode = new_mode;
-        
-        printf("Mode Change SUCCESS! New Mode: %s\n", 
-               (new_mode == MODE_NOMINAL) ? "NOMINAL" : 
-               (new_mode == MODE_SAFE) ? "SAFE" : "CRITICAL");
-        
-        // Release the Mutex
+
+    TRACE_EVENT(TRACE_MUTEX_TAKE, xModeMutex, 0);
+
+    old_mode = get_system_mode();
+    if (old_mode == new_mode) {
+        TRACE_EVENT(TRACE_MUTEX_GIVE, xModeMutex, 0);
         xSemaphoreGive(xModeMutex);
-    } else {
-        printf("WARNING: Could not change mode to %d; Mutex busy.\n", new_mode);
+        return pdPASS; // Already there: no transition, no new generation
     }
-}
\ No newline at end of file
+
+    // 3. Publish the new state block (seqlock write)
+    TickType_t now = xTaskGetTickCount();
+
+    portENTER_CRITICAL(&s_mode_mux);
+    uint32_t seq = s_mode_state.sequence;
+    __atomic_store_n(&s_mode_state.sequence, seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    generation = s_mode_state.generation + 1u;
+    __atomic_store_n(&s_mode_state.generation, generation, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mode_state.last_transition_tick, (uint32_t)now, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mode_state.mode_word, (uint32_t)new_mode, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&s_mode_state.sequence, seq + 2u, __ATOMIC_RELEASE);
+
+    // 4. Post to every mailbox while transitions are still ordered
+    subscribers = s_subscriber_count;
+    for (uint32_t i = 0; i < subscribers; i++) {
+        ModeChangeEvent_t *event = &s_subscribers[i].event;
+        if (s_subscribers[i].pending) {
+            event->coalesced++;         // Keep the old_mode the task last saw
+        } else {
+            event->old_mode = old_mode;
+            event->coalesced = 0;
+        }
+        event->new_mode = new_mode;
+        event->generation = generation;
+        event->tick = (uint32_t)now;
+        event->time_us = now_us;
+        s_subscribers[i].pending = 1;
+    }
+    portEXIT_CRITICAL(&s_mode_mux);
+    publish_mode_params(new_mode, generation, (uint32_t)now);
+
+    // Still under xModeMutex: records land in generation order
+    ModeCheckpoint_t record = { (uint32_t)new_mode, generation };
+    checkpoint_write(CHECKPOINT_MODE, &record, sizeof(record), (uint32_t)now);
+
+    TRACE_EVENT(TRACE_MUTEX_GIVE, xModeMutex, 0);
+    xSemaphoreGive(xModeMutex);
+    TRACE_EVENT(TRACE_MODE_CHANGE, NULL, new_mode);
+
+    // 5. Wake the subscribers; a higher-priority one runs right here
+    for (uint32_t i = 0; i < subscribers; i++) {
+        xTaskNotifyGive(s_subscribers[i].task);
+    }
+
+    // 6. Report outside the lock; the record is formatted later by LOG_DRAIN
+    FSW_LOGI(LOG_MOD_MODE, "Mode Change SUCCESS! New Mode: %s (from %s, gen %lu)\n",
+             mode_name(new_mode), mode_name(old_mode), (unsigned long)generation);
+    return pdPASS;
+}
+
+// --- D. MODE-CHANGE SUBSCRIPTIONS ---
+int mode_subscribe(TaskHandle_t task, SystemMode_t *current) {
+    int id = -1;
+
+    portENTER_CRITICAL(&s_mode_mux);
+    if (s_subscriber_count < MODE_MAX_SUBSCRIBERS) {
+        id = (int)s_subscriber_count++;
+        memset(&s_subscribers[id], 0, sizeof(s_subscribers[id]));
+        s_subscribers[id].task = task;
+    }
+    if (current != NULL) {
+        *current = get_system_mode();
+    }
+    portEXIT_CRITICAL(&s_mode_mux);
+    return id;
+}
+
+int mode_take_event(int subscriber, ModeChangeEvent_t *event) {
+    ModeSubscriber_t *sub;
+    int taken = 0;
+
+    if (subscriber < 0 || (uint32_t)subscriber >= MODE_MAX_SUBSCRIBERS) {
+        return 0;
+    }
+    sub = &s_subscribers[subscriber];
+
+    uint32_t now_us = util_get_time_us();
+    TickType_t now = xTaskGetTickCount();
+
+    portENTER_CRITICAL(&s_mode_mux);
+    if (sub->pending) {
+        uint32_t latency_ticks = (uint32_t)now - sub->event.tick;
+        uint32_t latency_us = now_us - sub->event.time_us;
+
+        *event = sub->event;
+        sub->pending = 0;
+        sub->stats.events++;
+        sub->stats.coalesced += sub->event.coalesced;
+        if (latency_ticks > sub->stats.max_latency_ticks) {
+            sub->stats.max_latency_ticks = latency_ticks;
+        }
+        if (latency_us > sub->stats.max_latency_us) {
+            sub->stats.max_latency_us = latency_us;
+        }
+        taken = 1;
+    }
+    portEXIT_CRITICAL(&s_mode_mux);
+    return taken;
+}
+
+void mode_get_subscriber_stats(int subscriber, ModeSubscriberStats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (subscriber < 0 || (uint32_t)subscriber >= MODE_MAX_SUBSCRIBERS) {
+        return;
+    }
+    portENTER_CRITICAL(&s_mode_mux);
+    *stats = s_subscribers[subscriber].stats;
+    portEXIT_CRITICAL(&s_mode_mux);
+}
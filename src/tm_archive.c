@@ -0,0 +1,496 @@
+// src/tm_archive.c
+
+#include "tm_archive.h"
+#include "flash_backend.h"
+#include "crc16.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define PAGE_HDR_LEN     ((uint16_t)sizeof(TmArchivePageHeader_t))
+#define PAGE_DATA_LEN    (TM_ARCHIVE_PAGE_SIZE - PAGE_HDR_LEN)
+#define HEADER_CRC_LEN   offsetof(TmArchivePageHeader_t, header_crc)
+
+typedef char tm_archive_header_is_24_bytes[(sizeof(TmArchivePageHeader_t) == 24) ? 1 : -1];
+
+typedef enum {
+    HDR_VALID,
+    HDR_ERASED,
+    HDR_CORRUPT
+} HeaderState_t;
+
+// --- HELPERS ---
+
+static uint32_t total_pages(const TmArchive_t *ar) {
+    return ar->sector_count * ar->pages_per_sector;
+}
+
+static uint32_t page_addr(uint32_t page) {
+    return page * TM_ARCHIVE_PAGE_SIZE;
+}
+
+static uint16_t crc_of(const void *data, size_t len) {
+    return crc16_final(crc16_update(crc16_init(), (const uint8_t *)data, len));
+}
+
+static HeaderState_t read_header(const TmArchive_t *ar, uint32_t page, TmArchivePageHeader_t *hdr) {
+    static const uint8_t blank[sizeof(TmArchivePageHeader_t)] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+
+    if (ar->flash->read(ar->flash->ctx, page_addr(page), hdr, sizeof(*hdr)) != 0) {
+        return HDR_CORRUPT;
+    }
+    if (memcmp(hdr, blank, sizeof(*hdr)) == 0) {
+        return HDR_ERASED;
+    }
+    if (hdr->magic != TM_ARCHIVE_PAGE_MAGIC ||
+        hdr->header_crc != crc_of(hdr, HEADER_CRC_LEN) ||
+        hdr->used_bytes > PAGE_DATA_LEN) {
+        return HDR_CORRUPT;
+    }
+    return HDR_VALID;
+}
+
+static int check_geometry(TmArchive_t *ar, const FlashBackend_t *flash) {
+    if (flash == NULL || flash->sector_size < TM_ARCHIVE_PAGE_SIZE ||
+        (flash->sector_size % TM_ARCHIVE_PAGE_SIZE) != 0 ||
+        flash->sector_count < 2 || flash->sector_count > TM_ARCHIVE_MAX_SECTORS) {
+        return -1;
+    }
+
+    memset(ar, 0, sizeof(*ar));
+    ar->flash = flash;
+    ar->sector_count = flash->sector_count;
+    ar->pages_per_sector = flash->sector_size / TM_ARCHIVE_PAGE_SIZE;
+    ar->next_sequence = 1;
+    return 0;
+}
+
+// --- A. FORMAT / MOUNT ---
+
+int tm_archive_format(TmArchive_t *ar, const FlashBackend_t *flash) {
+    if (check_geometry(ar, flash) != 0) {
+        return -1;
+    }
+
+    for (uint32_t s = 0; s < ar->sector_count; s++) {
+        if (flash->erase_sector(flash->ctx, s) != 0) {
+            return -1;
+        }
+        ar->erased[s] = 1;
+    }
+    ar->stats.sector_erases = ar->sector_count;
+    return 0;
+}
+
+int tm_archive_mount(TmArchive_t *ar, const FlashBackend_t *flash) {
+    TmArchivePageHeader_t hdr;
+    uint32_t max_seq = 0;
+    uint32_t max_page = 0;
+    uint32_t max_last_ts = 0;
+
+    if (check_geometry(ar, flash) != 0) {
+        return -1;
+    }
+
+    // 1. One pass over every page header: sector index + newest page. The
+    //    index entry comes from the first valid page of the sector, so a
+    //    torn page 0 does not hide the pages written after it.
+    for (uint32_t page = 0; page < total_pages(ar); page++) {
+        switch (read_header(ar, page, &hdr)) {
+            case HDR_VALID: {
+                uint32_t sector = page / ar->pages_per_sector;
+                ar->stats.pages_recovered++;
+                if (ar->index[sector].first_seq == 0 || hdr.sequence < ar->index[sector].first_seq) {
+                    ar->index[sector].first_seq = hdr.sequence;
+                    ar->index[sector].first_ts = hdr.first_ts;
+                }
+                if (hdr.sequence > max_seq) {
+                    max_seq = hdr.sequence;
+                    max_page = page;
+                    max_last_ts = hdr.last_ts;
+                }
+                break;
+            }
+            case HDR_CORRUPT:
+                ar->stats.pages_corrupt++;
+                break;
+            case HDR_ERASED:
+            default:
+                break;
+        }
+    }
+
+    if (max_seq == 0) {
+        return 0; // Empty log: start at sector 0 (erased on first write)
+    }
+
+    // 2. Write position: first erased page after the newest one in its sector.
+    //    Torn pages in between are skipped, never reprogrammed.
+    ar->head_sector = max_page / ar->pages_per_sector;
+    ar->head_page = ar->pages_per_sector;
+    for (uint32_t p = (max_page % ar->pages_per_sector) + 1; p < ar->pages_per_sector; p++) {
+        if (read_header(ar, ar->head_sector * ar->pages_per_sector + p, &hdr) == HDR_ERASED) {
+            ar->head_page = p;
+            break;
+        }
+    }
+    ar->next_sequence = max_seq + 1;
+    ar->last_ts = max_last_ts;
+    ar->has_records = 1;
+    return 0;
+}
+
+// --- B. WRITE PATH ---
+
+int tm_archive_flush(TmArchive_t *ar) {
+    TmArchivePageHeader_t hdr;
+    int result = 0;
+
+    if (ar->page_records == 0) {
+        return 0;
+    }
+
+    // 1. Move to the next sector round-robin once the current one is full
+    if (ar->head_page >= ar->pages_per_sector) {
+        ar->head_sector = (ar->head_sector + 1) % ar->sector_count;
+        ar->head_page = 0;
+    }
+
+    // 2. Entering a sector: it holds the oldest data, so erase it first
+    if (ar->head_page == 0) {
+        ar->index[ar->head_sector].first_seq = 0;
+        if (!ar->erased[ar->head_sector]) {
+            if (ar->flash->erase_sector(ar->flash->ctx, ar->head_sector) != 0) {
+                ar->stats.write_errors++;
+                result = -1;
+            }
+            ar->stats.sector_erases++;
+        }
+        ar->erased[ar->head_sector] = 0;
+    }
+
+    // 3. The owner's trailer sits at the end of the page, erased bytes before
+    //    it. Filled even if the page is lost, so the owner starts a new page too.
+    uint16_t program_len = (uint16_t)(PAGE_HDR_LEN + ar->page_used);
+    if (ar->trailer_len > 0) {
+        uint16_t trailer_off = TM_ARCHIVE_PAGE_SIZE - ar->trailer_len;
+        memset(&ar->page_buf[program_len], 0xFF, trailer_off - program_len);
+        ar->trailer_fn(ar->trailer_ctx, &ar->page_buf[trailer_off], ar->trailer_len);
+        program_len = TM_ARCHIVE_PAGE_SIZE;
+    }
+
+    // 4. Header goes first in the page, so a torn write always breaks its CRC
+    if (result == 0) {
+        hdr.magic = TM_ARCHIVE_PAGE_MAGIC;
+        hdr.sequence = ar->next_sequence++;
+        hdr.first_ts = ar->page_first_ts;
+        hdr.last_ts = ar->page_last_ts;
+        hdr.record_count = ar->page_records;
+        hdr.used_bytes = ar->page_used;
+        hdr.data_crc = crc_of(&ar->page_buf[PAGE_HDR_LEN], ar->page_used);
+        hdr.header_crc = crc_of(&hdr, HEADER_CRC_LEN);
+        memcpy(ar->page_buf, &hdr, sizeof(hdr));
+
+        uint32_t page = ar->head_sector * ar->pages_per_sector + ar->head_page;
+        if (ar->flash->program(ar->flash->ctx, page_addr(page), ar->page_buf, program_len) != 0) {
+            ar->stats.write_errors++;
+            result = -1;
+            // A page left blank would read as the end of the log: program
+            // the next one there. A half-written one is skipped like a torn page.
+            if (read_header(ar, page, &hdr) != HDR_ERASED) {
+                ar->head_page++;
+            }
+        } else {
+            ar->stats.pages_written++;
+            if (ar->index[ar->head_sector].first_seq == 0) {  // First page that made it
+                ar->index[ar->head_sector].first_seq = hdr.sequence;
+                ar->index[ar->head_sector].first_ts = hdr.first_ts;
+            }
+            ar->head_page++;
+        }
+    }
+
+    // 5. The RAM page is consumed either way: a failing flash must not wedge the logger
+    ar->page_used = 0;
+    ar->page_records = 0;
+    return result;
+}
+
+int tm_archive_set_trailer(TmArchive_t *ar, uint16_t len, TmArchiveTrailerFn_t fill, void *ctx) {
+    if (len > PAGE_DATA_LEN / 2 || (len > 0 && fill == NULL) || ar->page_used + len > PAGE_DATA_LEN) {
+        return -1;
+    }
+    ar->trailer_len = len;
+    ar->trailer_fn = fill;
+    ar->trailer_ctx = ctx;
+    return 0;
+}
+
+int tm_archive_append(TmArchive_t *ar, uint32_t timestamp, const void *data, uint16_t length) {
+    return tm_archive_append_kind(ar, 0, timestamp, data, length);
+}
+
+int tm_archive_append_kind(TmArchive_t *ar, uint8_t kind, uint32_t timestamp,
+                           const void *data, uint16_t length) {
+    if (length > TM_ARCHIVE_MAX_RECORD - ar->trailer_len || kind > TM_ARCHIVE_MAX_KIND ||
+        (length > 0 && data == NULL)) {
+        return -1;
+    }
+
+    uint16_t kind_length = (uint16_t)((kind << TM_ARCHIVE_KIND_SHIFT) | length);
+
+    // A page that fails to program is counted in write_errors and dropped;
+    // this record still goes into the fresh RAM page
+    if ((size_t)ar->page_used + TM_ARCHIVE_RECORD_HDR_LEN + length > (size_t)(PAGE_DATA_LEN - ar->trailer_len)) {
+        (void)tm_archive_flush(ar);
+    }
+
+    uint8_t *rec = &ar->page_buf[PAGE_HDR_LEN + ar->page_used];
+    memcpy(&rec[0], &timestamp, sizeof(timestamp));
+    memcpy(&rec[4], &kind_length, sizeof(kind_length));
+    if (length > 0) {
+        memcpy(&rec[TM_ARCHIVE_RECORD_HDR_LEN], data, length);
+    }
+
+    if (ar->page_records == 0) {
+        ar->page_first_ts = timestamp;
+    }
+    ar->page_last_ts = timestamp;
+    ar->last_ts = timestamp;
+    ar->has_records = 1;
+    ar->page_used += (uint16_t)(TM_ARCHIVE_RECORD_HDR_LEN + length);
+    ar->page_records++;
+
+    ar->stats.records_appended++;
+    ar->stats.bytes_appended += length;
+    return 0;
+}
+
+// --- C. READ PATH ---
+
+static int load_page(TmArchive_t *ar, const TmArchiveCursor_t *cursor) {
+    const TmArchivePageHeader_t *hdr = (const TmArchivePageHeader_t *)ar->read_buf;
+
+    if (ar->read_valid && ar->read_page == cursor->page && ar->read_seq == cursor->sequence) {
+        return 0;
+    }
+
+    ar->read_valid = 0;
+    if (ar->flash->read(ar->flash->ctx, page_addr(cursor->page), ar->read_buf, TM_ARCHIVE_PAGE_SIZE) != 0 ||
+        hdr->magic != TM_ARCHIVE_PAGE_MAGIC ||
+        hdr->header_crc != crc_of(hdr, HEADER_CRC_LEN) ||
+        hdr->sequence != cursor->sequence ||
+        hdr->used_bytes > PAGE_DATA_LEN) {
+        return -1;
+    }
+
+    ar->read_data_ok = (hdr->data_crc == crc_of(&ar->read_buf[PAGE_HDR_LEN], hdr->used_bytes));
+    ar->read_valid = 1;
+    ar->read_page = cursor->page;
+    ar->read_seq = cursor->sequence;
+    return 0;
+}
+
+// Moves the cursor to the next page in log order. Returns 0 if there is one.
+static int next_page(const TmArchive_t *ar, TmArchiveCursor_t *cursor) {
+    TmArchivePageHeader_t hdr;
+    uint32_t page = cursor->page;
+
+    for (uint32_t step = 0; step < total_pages(ar); step++) {
+        page = (page + 1) % total_pages(ar);
+
+        switch (read_header(ar, page, &hdr)) {
+            case HDR_VALID:
+                // An older sequence means we wrapped onto the oldest data: end of log
+                if (hdr.sequence <= cursor->sequence) {
+                    return -1;
+                }
+                cursor->page = page;
+                cursor->sequence = hdr.sequence;
+                cursor->offset = PAGE_HDR_LEN;
+                cursor->record = 0;
+                return 0;
+            case HDR_CORRUPT:
+                continue; // Torn page: step over it
+            case HDR_ERASED:
+            default:
+                return -1;
+        }
+    }
+    return -1;
+}
+
+int tm_archive_read_next(TmArchive_t *ar, TmArchiveCursor_t *cursor,
+                         uint32_t *timestamp, void *buf, uint16_t buf_size, uint16_t *length) {
+    for (;;) {
+        // 1. Was the sector under the cursor erased and reused since?
+        uint32_t sector = cursor->page / ar->pages_per_sector;
+        if (ar->index[sector].first_seq == 0 || ar->index[sector].first_seq > cursor->sequence) {
+            return -1;
+        }
+
+        if (load_page(ar, cursor) != 0) {
+            return -1;
+        }
+        const TmArchivePageHeader_t *hdr = (const TmArchivePageHeader_t *)ar->read_buf;
+
+        // 2. Serve the next record of this page
+        if (ar->read_data_ok && cursor->record < hdr->record_count) {
+            const uint8_t *rec = &ar->read_buf[cursor->offset];
+            uint32_t ts;
+            uint16_t len;
+
+            memcpy(&ts, &rec[0], sizeof(ts));
+            memcpy(&len, &rec[4], sizeof(len));
+            cursor->kind = (uint8_t)(len >> TM_ARCHIVE_KIND_SHIFT);
+            len &= TM_ARCHIVE_LENGTH_MASK;
+            if ((size_t)cursor->offset + TM_ARCHIVE_RECORD_HDR_LEN + len > (size_t)PAGE_HDR_LEN + hdr->used_bytes) {
+                return -1;
+            }
+
+            if (timestamp != NULL) {
+                *timestamp = ts;
+            }
+            if (length != NULL) {
+                *length = len;
+            }
+            if (buf != NULL) {
+                memcpy(buf, &rec[TM_ARCHIVE_RECORD_HDR_LEN], (len < buf_size) ? len : buf_size);
+            }
+
+            cursor->offset += (uint16_t)(TM_ARCHIVE_RECORD_HDR_LEN + len);
+            cursor->record++;
+            return 1;
+        }
+
+        // 3. Page exhausted (or its data failed CRC): continue in the next one
+        if (next_page(ar, cursor) != 0) {
+            return 0;
+        }
+    }
+}
+
+int tm_archive_last_timestamp(const TmArchive_t *ar, uint32_t *timestamp) {
+    if (!ar->has_records) {
+        return -1;
+    }
+    *timestamp = ar->last_ts;
+    return 0;
+}
+
+int tm_archive_seek(TmArchive_t *ar, uint32_t timestamp, TmArchiveCursor_t *cursor) {
+    TmArchivePageHeader_t hdr;
+    uint32_t n = ar->sector_count;
+    int32_t first = -1, last = -1;
+
+    // 1. Sectors in log order start right after the head. Unused ones can
+    //    only sit at either end, so the used ones form one sorted run.
+    for (uint32_t i = 0; i < n; i++) {
+        if (ar->index[(ar->head_sector + 1 + i) % n].first_seq != 0) {
+            if (first < 0) {
+                first = (int32_t)i;
+            }
+            last = (int32_t)i;
+        }
+    }
+    if (first < 0) {
+        return -1;
+    }
+
+    // 2. Binary search: last sector whose first record is not after `timestamp`
+    int32_t lo = first, hi = last, found = first;
+    while (lo <= hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (ar->index[(ar->head_sector + 1 + (uint32_t)mid) % n].first_ts <= timestamp) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    uint32_t sector = (ar->head_sector + 1 + (uint32_t)found) % n;
+
+    // 3. Within that sector: last page starting at or before `timestamp`,
+    //    else its first valid page (torn pages in front of it are skipped)
+    uint32_t base = sector * ar->pages_per_sector;
+    int placed = 0;
+    cursor->page = base;
+    cursor->sequence = ar->index[sector].first_seq;
+    for (uint32_t p = 0; p < ar->pages_per_sector; p++) {
+        HeaderState_t state = read_header(ar, base + p, &hdr);
+        if (state == HDR_ERASED || (state == HDR_VALID && placed && hdr.first_ts > timestamp)) {
+            break;
+        }
+        if (state == HDR_VALID && hdr.sequence >= ar->index[sector].first_seq) {
+            cursor->page = base + p;
+            cursor->sequence = hdr.sequence;
+            placed = 1;
+        }
+    }
+    cursor->offset = PAGE_HDR_LEN;
+    cursor->record = 0;
+
+    // 4. Walk records to the first one at or after `timestamp`
+    for (;;) {
+        TmArchiveCursor_t here = *cursor;
+        uint32_t ts;
+        if (tm_archive_read_next(ar, cursor, &ts, NULL, 0, NULL) != 1) {
+            return -1;
+        }
+        if (ts >= timestamp) {
+            *cursor = here;
+            return 0;
+        }
+    }
+}
+
+void tm_archive_get_stats(const TmArchive_t *ar, TmArchiveStats_t *stats) {
+    *stats = ar->stats;
+}
+
+// --- D. PAGE-LEVEL ACCESS ---
+
+uint32_t tm_archive_page_count(const TmArchive_t *ar) {
+    return total_pages(ar);
+}
+
+uint32_t tm_archive_write_page(const TmArchive_t *ar) {
+    return (ar->head_sector * ar->pages_per_sector + ar->head_page) % total_pages(ar);
+}
+
+int tm_archive_open_page(TmArchive_t *ar, uint32_t page,
+                         TmArchivePageHeader_t *hdr, TmArchiveCursor_t *cursor) {
+    if (page >= total_pages(ar)) {
+        return -1;
+    }
+
+    // A sector with no index entry was erased (or never written)
+    uint32_t sector = page / ar->pages_per_sector;
+    if (ar->index[sector].first_seq == 0 || read_header(ar, page, hdr) != HDR_VALID ||
+        hdr->sequence < ar->index[sector].first_seq) {
+        return -1;
+    }
+
+    cursor->page = page;
+    cursor->sequence = hdr->sequence;
+    cursor->offset = PAGE_HDR_LEN;
+    cursor->record = 0;
+    return 0;
+}
+
+int tm_archive_read_trailer(TmArchive_t *ar, uint32_t page,
+                            TmArchivePageHeader_t *hdr, void *trailer) {
+    TmArchiveCursor_t cursor;
+
+    if (ar->trailer_len == 0 || tm_archive_open_page(ar, page, hdr, &cursor) != 0) {
+        return -1;
+    }
+    if (ar->flash->read(ar->flash->ctx, page_addr(page) + TM_ARCHIVE_PAGE_SIZE - ar->trailer_len,
+                        trailer, ar->trailer_len) != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -1,44 +1,237 @@
 // src/tm_gen.c
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
 #include "satellite_types.h"
 #include "task_defs.h"
 #include "state_manager.h"
 #include "watchdog.h"
+#include "packet_pool.h"
+#include "packet_schema.h"
+#include "hk_sched.h"
+#include "param_store.h"
+#include "trace.h"
+#include "fsw_log.h"
+#include "utils.h"
+#include "checkpoint.h"
 #include <stdio.h>
+#include <string.h>
 
-extern QueueHandle_t xTelemetryQueue;
+extern PacketPool_t g_telemetry_pool;
+extern PacketPool_t g_hk_response_pool;
 
+// The HK scheduler (hk_sched.h) is stepped every HK_SCHED_TICK_MS with a
+// fresh sample of every parameter. A mode change wakes the task at once and
+// switches the rate table; an HK request is answered without a step.
+static HkSched_t s_hk_sched;         // Owned by the TM Generator task
+static HkSchedStats_t s_hk_stats;    // Copy published after every step
+static portMUX_TYPE s_hk_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+typedef struct {
+    uint32_t request_timestamp;
+    uint32_t request_us;
+    uint32_t request_tick;
+} HkRequest_t;
+
+// sequence_count of the next HK packet. Checkpointed with every step, which
+// doubles as the FSW's 1 Hz sign of life for the warm-restart logic.
+static uint16_t s_hk_sequence;
+
+typedef struct {
+    uint32_t hk_sequence;
+} TmGenCheckpoint_t;
+
+static void save_checkpoint(TickType_t now) {
+    TmGenCheckpoint_t record = { s_hk_sequence };
+    checkpoint_write(CHECKPOINT_TM_GEN, &record, sizeof(record), (uint32_t)now);
+}
+
+uint16_t tm_gen_get_hk_sequence(void) {
+    return __atomic_load_n(&s_hk_sequence, __ATOMIC_RELAXED);
+}
+
+static TaskHandle_t s_tm_gen_task;
+static HkRequest_t s_requests[TM_GEN_REQUEST_DEPTH];
+static uint32_t s_request_head;     // Written by the requester
+static uint32_t s_request_tail;     // Written by the generator
+static portMUX_TYPE s_request_mux = portMUX_INITIALIZER_UNLOCKED;
+
+BaseType_t tm_gen_request_hk(uint32_t request_timestamp) {
+    BaseType_t queued = pdFAIL;
+
+    portENTER_CRITICAL(&s_request_mux);
+    if (s_request_head - s_request_tail < TM_GEN_REQUEST_DEPTH) {
+        HkRequest_t *req = &s_requests[s_request_head % TM_GEN_REQUEST_DEPTH];
+        req->request_timestamp = request_timestamp;
+        req->request_us = util_get_time_us();
+        req->request_tick = (uint32_t)xTaskGetTickCount();
+        s_request_head++;
+        queued = pdPASS;
+    }
+    portEXIT_CRITICAL(&s_request_mux);
+
+    if (queued == pdPASS && s_tm_gen_task != NULL) {
+        xTaskNotifyGive(s_tm_gen_task);
+    }
+    return queued;
+}
+
+void tm_gen_get_hk_stats(HkSchedStats_t *stats) {
+    portENTER_CRITICAL(&s_hk_stats_mux);
+    *stats = s_hk_stats;
+    portEXIT_CRITICAL(&s_hk_stats_mux);
+}
+
+// One value per HK_PARAM_TABLE entry, in the parameter's wire units, from a
+// single lock-free snapshot of the parameter store
+static void sample_params(SystemMode_t mode, int32_t value[HK_PARAM_COUNT]) {
+    ParamSnapshot_t snap;
+    HK_StatusFlags_t flags;
+
+    param_snapshot(&snap);
+    memset(&flags, 0, sizeof(flags));
+    flags.system_mode = mode;
+    flags.flg_low_voltage = (snap.value[PARAM_eps_fault_code] != EPS_FAULT_NONE);
+
+    value[HK_PARAM_bus_mv] = snap.value[PARAM_eps_bus_mv];
+    value[HK_PARAM_bus_min_mv] = snap.value[PARAM_eps_batch_min_mv];
+    value[HK_PARAM_status_flags] = hk_flags_pack(&flags);
+    value[HK_PARAM_ext_temp_cc] = 0;                // No TCS on the bus yet
+    value[HK_PARAM_eps_trips] = snap.value[PARAM_eps_trips];
+    value[HK_PARAM_tc_received] = snap.value[PARAM_tc_received];
+}
+
+// Full HK record from the same sample the scheduler sees
+static void fill_snapshot(HK_Telemetry_t *pkt, const int32_t value[HK_PARAM_COUNT]) {
+    memset(pkt, 0, sizeof(*pkt));
+    pkt->timestamp = xTaskGetTickCount();
+    pkt->sequence_count = s_hk_sequence;
+    __atomic_store_n(&s_hk_sequence, (uint16_t)(s_hk_sequence + 1u), __ATOMIC_RELAXED);
+    pkt->bus_voltage = (float)value[HK_PARAM_bus_mv] / 1000.0f;
+    pkt->ext_temp_c = (float)value[HK_PARAM_ext_temp_cc] / 100.0f;
+    hk_flags_unpack(&pkt->status_flags, (uint8_t)value[HK_PARAM_status_flags]);
+}
+
+// Answers every pending TC_REQUEST_HK with a snapshot taken now
+static void serve_hk_requests(const int32_t value[HK_PARAM_COUNT]) {
+    HkRequest_t req;
+    HK_Response_t *rsp;
+
+    for (;;) {
+        // 1. Oldest pending request
+        portENTER_CRITICAL(&s_request_mux);
+        if (s_request_tail == s_request_head) {
+            portEXIT_CRITICAL(&s_request_mux);
+            return;
+        }
+        req = s_requests[s_request_tail % TM_GEN_REQUEST_DEPTH];
+        s_request_tail++;
+        portEXIT_CRITICAL(&s_request_mux);
+
+        // 2. Fresh snapshot straight into the response slot
+        rsp = (HK_Response_t *)packet_pool_alloc(&g_hk_response_pool);
+        if (rsp == NULL) {
+            FSW_LOGW(LOG_MOD_TM, "TM GEN: WARNING: HK response pool full, request T: %lu dropped.\n",
+                     (unsigned long)req.request_timestamp);
+            continue;
+        }
+        rsp->request_timestamp = req.request_timestamp;
+        rsp->request_us = req.request_us;
+        rsp->request_tick = req.request_tick;
+        fill_snapshot(&rsp->hk, value);
+        packet_pool_submit(&g_hk_response_pool, rsp);
+        FSW_LOGI(LOG_MOD_TM, "TM GEN: HK response for request T: %lu sent to priority lane.\n",
+                 (unsigned long)req.request_timestamp);
+    }
+}
+
+// Steps the scheduler and hands a sample set, if any, to the logger
+static void run_hk_step(TickType_t now, const int32_t value[HK_PARAM_COUNT]) {
+    uint8_t frame[HK_SAMPLES_MAX_LEN];
+    HkSampleFrame_t *slot;
+
+    size_t len = hk_sched_step(&s_hk_sched, (uint32_t)(now * portTICK_PERIOD_MS), (uint32_t)now,
+                               value, frame);
+
+    portENTER_CRITICAL(&s_hk_stats_mux);
+    s_hk_stats = s_hk_sched.stats;
+    portEXIT_CRITICAL(&s_hk_stats_mux);
+    if (len == 0) {
+        return;
+    }
+
+    // The logger gets the slot pointer
+    slot = (HkSampleFrame_t *)packet_pool_alloc(&g_telemetry_pool);
+    if (slot == NULL) {
+        FSW_LOGW(LOG_MOD_TM, "WARNING: Telemetry Pool exhausted, packet lost.\n");
+        return;
+    }
+    slot->timestamp = (uint32_t)now;
+    slot->length = (uint16_t)len;
+    memcpy(slot->wire, frame, len);
+    packet_pool_submit(&g_telemetry_pool, slot);
+    FSW_LOGD(LOG_MOD_TM, "TM GEN: HK sample set T: %lu, %u B\n", (unsigned long)now, (unsigned)len);
+}
 
 void vTelemetryGeneratorTask(void *pvParameters) {
-    
-    HK_Telemetry_t tx_packet;
-    float simulated_voltage = 3.3f;      // Initial simulated voltage value
-    float FSW_MIN_BUS_VOLTAGE = 2.8f;    // Critical safety threshold
+    int32_t value[HK_PARAM_COUNT];
+    ModeChangeEvent_t mode_event;
+    SystemMode_t mode;
+    int mode_sub;
+    int run_step = 0;
+    TickType_t now = xTaskGetTickCount();
+    // First set one base tick after boot, once the EPS has published a batch
+    TickType_t next_step = now + pdMS_TO_TICKS(HK_SCHED_TICK_MS);
+
+    // Requests and mode changes both arrive as task notifications
+    s_tm_gen_task = xTaskGetCurrentTaskHandle();
+
+    // Ground sees the packet count carry on across a warm restart
+    TmGenCheckpoint_t saved;
+    if (checkpoint_get(CHECKPOINT_TM_GEN, &saved, sizeof(saved), NULL) == 0) {
+        s_hk_sequence = (uint16_t)saved.hk_sequence;
+    }
+    mode_sub = mode_subscribe(s_tm_gen_task, &mode);
+    hk_sched_init(&s_hk_sched, mode, (uint32_t)(next_step * portTICK_PERIOD_MS));
+    s_hk_stats = s_hk_sched.stats;
 
     printf("TM Generator Task initialized and running.\n");
+    TRACE_TASK_START();
     for(;;) {
-        if(get_system_mode() == MODE_NOMINAL){
-            printf("TM GEN: -- Running NOMINAL Mission Cycle --\n");
-            tx_packet.timestamp = xTaskGetTickCount();
-            tx_packet.bus_voltage = simulated_voltage;
-        
-            if(tx_packet.bus_voltage < FSW_MIN_BUS_VOLTAGE) {
-                printf("TM GEN: !!! Bus voltage below threshold (%.2f V). Packet discarded. !!!\n", tx_packet.bus_voltage);
-            }
-            else {
-                if(xQueueSend(xTelemetryQueue, &tx_packet, 0) != pdPASS) {
-                    printf("WARNING: Telemetry Queue Full, packet lost.\n");
-                }
-            }
-            
-        }else{
-            printf("TM GEN: Waiting for MODE_NOMINAL. Current mode: %d\n", get_system_mode());
+        // 1. One sample feeds both the requests and the scheduler
+        uint16_t sequence = s_hk_sequence;
+        sample_params(mode, value);
+        serve_hk_requests(value);
+
+        // 2. Scheduler step at the base rate, or at once after a mode change
+        now = xTaskGetTickCount();
+        if ((int32_t)(now - next_step) >= 0) {
+            run_step = 1;
+        }
+        if (run_step) {
+            run_hk_step(now, value);
+            watchdog_pet(WDT_TASK_TM_GEN);
+            next_step = now + pdMS_TO_TICKS(HK_SCHED_TICK_MS);
         }
+        if (run_step || sequence != s_hk_sequence) {
+            save_checkpoint(now);
+        }
+        run_step = 0;
+
+        TRACE_EVENT(TRACE_TASK_SLEEP, NULL, 0);
+        ulTaskNotifyTake(pdTRUE, next_step - now);
+        TRACE_EVENT(TRACE_TASK_WAKE, NULL, 0);
 
-        watchdog_pet(WDT_TASK_TM_GEN);
-        
-        vTaskDelay(pdMS_TO_TICKS(5000)); 
+        // The bus delivers the new mode; poll only if the subscription failed
+        if (mode_take_event(mode_sub, &mode_event)) {
+            mode = mode_event.new_mode;
+            run_step = 1;
+        } else if (mode_sub < 0 && get_system_mode() != mode) {
+            mode = get_system_mode();
+            run_step = 1;
+        }
+        if (run_step) {
+            hk_sched_set_mode(&s_hk_sched, mode, (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+            FSW_LOGI(LOG_MOD_TM, "TM GEN: HK rates switched to mode %d\n", mode);
+        }
     }
-}
\ No newline at end of file
+}
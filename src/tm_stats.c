@@ -0,0 +1,329 @@
+// src/tm_stats.c
+
+#include "tm_stats.h"
+#include "ccsds_packet.h"
+#include "utils.h"
+#include "packet_schema.h"
+#include <math.h>
+#include <string.h>
+
+// --- A. STATISTICS TABLE ---
+
+typedef struct {
+    const char *name;
+    HkParamId_t source;
+    int32_t low;
+    int32_t high;
+    int32_t hist_base;
+    int32_t hist_width;
+} TmStatDef_t;
+
+#define TM_STATS_DEF(name, hk, low, high, base, width) { #name, HK_PARAM_##hk, low, high, base, width },
+static const TmStatDef_t s_stats[TM_STATS_COUNT] = {
+    TM_STATS_TABLE(TM_STATS_DEF)
+};
+#undef TM_STATS_DEF
+
+const char *tm_stats_name(TmStatId_t id) {
+    return ((uint32_t)id < TM_STATS_COUNT) ? s_stats[id].name : "?";
+}
+
+// --- B. AGGREGATES ---
+
+static void agg_reset(TmStatsAgg_t *agg) {
+    memset(agg, 0, sizeof(*agg));
+    agg->min = INT32_MAX;
+    agg->max = INT32_MIN;
+}
+
+static void agg_add(TmStatsAgg_t *agg, const TmStatDef_t *def, int32_t v) {
+    int32_t bin = (v - def->hist_base) / def->hist_width;
+
+    if (v < def->hist_base) {
+        bin = 0;        // Division truncates toward zero
+    }
+    agg->count++;
+    agg->sum += v;
+    agg->sum_sq += (uint64_t)((int64_t)v * v);
+    if (v < agg->min) {
+        agg->min = v;
+    }
+    if (v > agg->max) {
+        agg->max = v;
+    }
+    agg->below += (v < def->low);
+    agg->above += (v > def->high);
+    agg->hist[(bin >= TM_STATS_HIST_BINS) ? TM_STATS_HIST_BINS - 1 : bin]++;
+}
+
+void tm_stats_merge(TmStatsAgg_t *into, const TmStatsAgg_t *from) {
+    if (from->count == 0) {
+        return;
+    }
+    into->count += from->count;
+    into->sum += from->sum;
+    into->sum_sq += from->sum_sq;
+    if (from->min < into->min) {
+        into->min = from->min;
+    }
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+    into->below += from->below;
+    into->above += from->above;
+    for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+        into->hist[b] += from->hist[b];
+    }
+}
+
+double tm_stats_mean(const TmStatsAgg_t *agg) {
+    return (agg->count > 0) ? (double)agg->sum / (double)agg->count : 0.0;
+}
+
+// Sums are exact integers, so E[x^2] - E[x]^2 only loses what a double
+// loses; it is clamped at 0 against rounding.
+double tm_stats_stddev(const TmStatsAgg_t *agg) {
+    double mean, var;
+
+    if (agg->count == 0) {
+        return 0.0;
+    }
+    mean = tm_stats_mean(agg);
+    var = (double)agg->sum_sq / (double)agg->count - mean * mean;
+    return (var > 0.0) ? sqrt(var) : 0.0;
+}
+
+// --- C. LIVE PAGE ---
+
+void tm_stats_init(TmStats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        agg_reset(&stats->page[i]);
+    }
+}
+
+void tm_stats_add(TmStats_t *stats, const HkSampleSet_t *set) {
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        if (set->present & (1u << s_stats[i].source)) {
+            agg_add(&stats->page[i], &s_stats[i], set->value[s_stats[i].source]);
+        }
+    }
+    if (stats->page_sets == 0) {
+        stats->page_first_ts = set->timestamp;
+    }
+    stats->page_last_ts = set->timestamp;
+    stats->page_sets++;
+    stats->sets++;
+}
+
+// --- D. PAGE TRAILER ---
+
+static uint8_t sat8(uint32_t v) {
+    return (v > UINT8_MAX) ? UINT8_MAX : (uint8_t)v;
+}
+
+static uint16_t sat16(uint32_t v) {
+    return (v > UINT16_MAX) ? UINT16_MAX : (uint16_t)v;
+}
+
+void tm_stats_fill_trailer(void *ctx, uint8_t *trailer, uint16_t len) {
+    TmStats_t *stats = (TmStats_t *)ctx;
+    uint8_t *p = trailer;
+
+    if (len < TM_STATS_TRAILER_LEN) {
+        return;
+    }
+
+    // 1. Aggregates of the page being programmed (empty stats keep min > max)
+    *p++ = TM_STATS_COUNT;
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        const TmStatsAgg_t *agg = &stats->page[i];
+        int32_t min = (agg->count > 0) ? agg->min : 0;
+        int32_t max = (agg->count > 0) ? agg->max : 0;
+
+        ccsds_put_be16(p, sat16(agg->count));                   p += 2;
+        ccsds_put_be16(p, (uint16_t)(int16_t)min);              p += 2;
+        ccsds_put_be16(p, (uint16_t)(int16_t)max);              p += 2;
+        ccsds_put_be32(p, (uint32_t)(int32_t)agg->sum);         p += 4;
+        ccsds_put_be32(p, (uint32_t)(agg->sum_sq >> 32));       p += 4;
+        ccsds_put_be32(p, (uint32_t)agg->sum_sq);               p += 4;
+        *p++ = sat8(agg->below);
+        *p++ = sat8(agg->above);
+        for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+            *p++ = sat8(agg->hist[b]);
+        }
+    }
+    ccsds_put_be16(p, crc16_ccitt(trailer, (size_t)(p - trailer)));
+
+    // 2. The next page starts empty
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        agg_reset(&stats->page[i]);
+    }
+    stats->page_sets = 0;
+    stats->trailers++;
+}
+
+int tm_stats_unpack_trailer(const uint8_t *trailer, size_t len, TmStatsAgg_t stat[TM_STATS_COUNT]) {
+    const uint8_t *p = trailer;
+
+    if (len < TM_STATS_TRAILER_LEN || trailer[0] != TM_STATS_COUNT) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+    if (crc16_ccitt(trailer, TM_STATS_TRAILER_LEN - WIRE_CRC_LEN) !=
+        ccsds_get_be16(&trailer[TM_STATS_TRAILER_LEN - WIRE_CRC_LEN])) {
+        return PKT_SCHEMA_BAD_CRC;
+    }
+
+    p++;
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        TmStatsAgg_t *agg = &stat[i];
+
+        agg_reset(agg);
+        agg->count = ccsds_get_be16(p);                         p += 2;
+        if (agg->count > 0) {
+            agg->min = (int16_t)ccsds_get_be16(p);
+            agg->max = (int16_t)ccsds_get_be16(p + 2);
+        }
+        p += 4;
+        agg->sum = (int32_t)ccsds_get_be32(p);                  p += 4;
+        agg->sum_sq = ((uint64_t)ccsds_get_be32(p) << 32) | ccsds_get_be32(p + 4);
+        p += 8;
+        agg->below = *p++;
+        agg->above = *p++;
+        for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+            agg->hist[b] = *p++;
+        }
+    }
+    return PKT_SCHEMA_OK;
+}
+
+// --- E. WINDOW QUERY ---
+
+static void cover(TmStatsSummary_t *summary, uint32_t first_ts, uint32_t last_ts) {
+    if (summary->pages == 0 || first_ts < summary->first_ts) {
+        summary->first_ts = first_ts;
+    }
+    if (summary->pages == 0 || last_ts > summary->last_ts) {
+        summary->last_ts = last_ts;
+    }
+    summary->pages++;
+}
+
+int tm_stats_query(TmStats_t *stats, TmArchive_t *archive, uint32_t from, uint32_t to,
+                   TmStatsSummary_t *summary) {
+    uint8_t trailer[TM_STATS_TRAILER_LEN];
+    TmStatsAgg_t page_stat[TM_STATS_COUNT];
+    TmArchivePageHeader_t hdr;
+    TmArchiveCursor_t cursor;
+
+    memset(summary, 0, sizeof(*summary));
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        agg_reset(&summary->stat[i]);
+    }
+
+    // 1. Flushed pages in log order, from the one holding the first record
+    //    at or after `from` up to the write position
+    if (archive->trailer_len == TM_STATS_TRAILER_LEN && tm_archive_seek(archive, from, &cursor) == 0) {
+        uint32_t page = cursor.page;
+        uint32_t last_seq = 0;
+        uint32_t end = tm_archive_write_page(archive);
+
+        for (uint32_t step = 0; step < tm_archive_page_count(archive) && page != end; step++) {
+            if (tm_archive_read_trailer(archive, page, &hdr, trailer) == 0) {
+                if (hdr.sequence < last_seq || hdr.first_ts > to) {
+                    break;      // Wrapped onto older data, or past the window
+                }
+                last_seq = hdr.sequence;
+                if (tm_stats_unpack_trailer(trailer, sizeof(trailer), page_stat) == PKT_SCHEMA_OK) {
+                    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+                        tm_stats_merge(&summary->stat[i], &page_stat[i]);
+                    }
+                    cover(summary, hdr.first_ts, hdr.last_ts);
+                } else {
+                    summary->pages_missing++;
+                }
+            }
+            page = (page + 1) % tm_archive_page_count(archive);
+        }
+    }
+
+    // 2. The page still in RAM
+    if (stats->page_sets > 0 && stats->page_last_ts >= from && stats->page_first_ts <= to) {
+        for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+            tm_stats_merge(&summary->stat[i], &stats->page[i]);
+        }
+        cover(summary, stats->page_first_ts, stats->page_last_ts);
+    }
+    return (summary->pages > 0 || summary->pages_missing > 0) ? 0 : -1;
+}
+
+// --- F. SUMMARY FRAME ---
+
+static int16_t round_i16(double v) {
+    v = (v < 0.0) ? v - 0.5 : v + 0.5;
+    return (v <= INT16_MIN) ? INT16_MIN : (v >= INT16_MAX) ? INT16_MAX : (int16_t)v;
+}
+
+static uint8_t hist_share(uint32_t bin, uint32_t count) {
+    return (count > 0) ? (uint8_t)(((uint64_t)bin * UINT8_MAX + count / 2) / count) : 0;
+}
+
+size_t tm_summary_pack(uint32_t request_ts, const TmStatsSummary_t *summary, uint8_t *wire) {
+    uint8_t *p = wire;
+
+    ccsds_put_be32(p, request_ts);                              p += 4;
+    ccsds_put_be32(p, summary->first_ts);                       p += 4;
+    ccsds_put_be32(p, summary->last_ts);                        p += 4;
+    ccsds_put_be16(p, sat16(summary->pages));                   p += 2;
+    ccsds_put_be16(p, sat16(summary->pages_missing));           p += 2;
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        const TmStatsAgg_t *agg = &summary->stat[i];
+        int32_t min = (agg->count > 0) ? agg->min : 0;
+        int32_t max = (agg->count > 0) ? agg->max : 0;
+
+        ccsds_put_be32(p, agg->count);                          p += 4;
+        ccsds_put_be16(p, (uint16_t)(int16_t)min);              p += 2;
+        ccsds_put_be16(p, (uint16_t)(int16_t)max);              p += 2;
+        ccsds_put_be16(p, (uint16_t)round_i16(tm_stats_mean(agg)));     p += 2;
+        ccsds_put_be16(p, (uint16_t)round_i16(tm_stats_stddev(agg)));   p += 2;
+        ccsds_put_be16(p, sat16(agg->below));                   p += 2;
+        ccsds_put_be16(p, sat16(agg->above));                   p += 2;
+        for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+            *p++ = hist_share(agg->hist[b], agg->count);
+        }
+    }
+    ccsds_put_be16(p, crc16_ccitt(wire, (size_t)(p - wire)));
+    return TM_SUMMARY_WIRE_LEN;
+}
+
+int tm_summary_unpack(const uint8_t *wire, size_t len, TmSummaryFrame_t *frame) {
+    const uint8_t *p = wire;
+
+    if (len != TM_SUMMARY_WIRE_LEN) {
+        return PKT_SCHEMA_BAD_LENGTH;
+    }
+    if (crc16_ccitt(wire, len - WIRE_CRC_LEN) != ccsds_get_be16(&wire[len - WIRE_CRC_LEN])) {
+        return PKT_SCHEMA_BAD_CRC;
+    }
+
+    frame->request_ts = ccsds_get_be32(p);                      p += 4;
+    frame->first_ts = ccsds_get_be32(p);                        p += 4;
+    frame->last_ts = ccsds_get_be32(p);                         p += 4;
+    frame->pages = ccsds_get_be16(p);                           p += 2;
+    frame->pages_missing = ccsds_get_be16(p);                   p += 2;
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        TmSummaryStat_t *st = &frame->stat[i];
+
+        st->count = ccsds_get_be32(p);                          p += 4;
+        st->min = (int16_t)ccsds_get_be16(p);                   p += 2;
+        st->max = (int16_t)ccsds_get_be16(p);                   p += 2;
+        st->mean = (int16_t)ccsds_get_be16(p);                  p += 2;
+        st->stddev = ccsds_get_be16(p);                         p += 2;
+        st->below = ccsds_get_be16(p);                          p += 2;
+        st->above = ccsds_get_be16(p);                          p += 2;
+        for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+            st->hist[b] = *p++;
+        }
+    }
+    return PKT_SCHEMA_OK;
+}
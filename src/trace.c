@@ -0,0 +1,124 @@
+// src/trace.c
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "trace.h"
+#include "utils.h"
+#include <string.h>
+
+#if FSW_TRACE
+
+// One ring per core; the host runtime simulates the target's two
+#define TRACE_CORES         portNUM_PROCESSORS
+#define TRACE_CORE_ID()     ((uint8_t)xPortGetCoreID())
+
+#define TRACE_RING_MASK     (TRACE_RING_EVENTS - 1u)
+
+typedef char trace_ring_is_power_of_two[((TRACE_RING_EVENTS & TRACE_RING_MASK) == 0) ? 1 : -1];
+typedef char trace_event_is_16_bytes[(sizeof(TraceEvent_t) == 16) ? 1 : -1];
+
+typedef struct {
+    uint32_t head;          // Events ever claimed on this core
+    TraceEvent_t events[TRACE_RING_EVENTS];
+} TraceRing_t;
+
+static TraceRing_t s_rings[TRACE_CORES];
+static TraceName_t s_names[TRACE_MAX_NAMES];
+static uint32_t s_name_count;
+static uint32_t s_cycles_per_us;
+static volatile int s_trace_enabled;
+static portMUX_TYPE s_names_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- A. SETUP ---
+
+void trace_init(void) {
+    memset(s_rings, 0, sizeof(s_rings));
+    s_name_count = 0;
+
+    // The decoder needs cycles per microsecond; measure it instead of
+    // depending on the CPU clock setting (and the host's TSC rate)
+    uint32_t t0 = util_get_time_us();
+    uint32_t c0 = util_get_cycle_count();
+    while ((uint32_t)(util_get_time_us() - t0) < 2000u) {
+    }
+    uint32_t dt = util_get_time_us() - t0;
+    s_cycles_per_us = (util_get_cycle_count() - c0) / (dt ? dt : 1u);
+
+    s_trace_enabled = 1;
+}
+
+void trace_name(const void *handle, const char *name) {
+    portENTER_CRITICAL(&s_names_mux);
+    if (s_name_count < TRACE_MAX_NAMES) {
+        TraceName_t *entry = &s_names[s_name_count++];
+        entry->id = (uint32_t)(uintptr_t)handle;
+        strncpy(entry->name, name, TRACE_NAME_LEN - 1);
+        entry->name[TRACE_NAME_LEN - 1] = '\0';
+    }
+    portEXIT_CRITICAL(&s_names_mux);
+}
+
+void trace_task_start(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    trace_name(self, pcTaskGetName(self));
+    trace_record(TRACE_TASK_START, NULL, 0);
+}
+
+void trace_set_enabled(int enabled) {
+    s_trace_enabled = enabled;
+}
+
+// --- B. RECORDING (any task, either core) ---
+
+void trace_record(TraceEventType_t type, const void *object, uint16_t arg) {
+    if (!s_trace_enabled) {
+        return;
+    }
+
+    uint8_t core = TRACE_CORE_ID();
+    TraceRing_t *ring = &s_rings[core];
+
+    // Claiming the slot is the only shared step. An ISR on this core that
+    // records in between simply takes the next slot.
+    uint32_t index = __atomic_fetch_add(&ring->head, 1u, __ATOMIC_RELAXED);
+    TraceEvent_t *e = &ring->events[index & TRACE_RING_MASK];
+
+    e->cycles = util_get_cycle_count();
+    e->task = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+    e->object = (uint32_t)(uintptr_t)object;
+    e->type = (uint8_t)type;
+    e->core = core;
+    e->arg = arg;
+}
+
+// --- C. DUMP ---
+
+int trace_dump(TraceWriteFn_t write, void *ctx) {
+    TraceDumpHeader_t header;
+    int was_enabled = s_trace_enabled;
+
+    s_trace_enabled = 0;
+
+    header.magic = TRACE_DUMP_MAGIC;
+    header.version = TRACE_DUMP_VERSION;
+    header.cores = TRACE_CORES;
+    header.name_count = (uint8_t)s_name_count;
+    header.ring_events = TRACE_RING_EVENTS;
+    header.cycles_per_us = s_cycles_per_us;
+
+    int result = write(ctx, &header, sizeof(header));
+    if (result == 0) {
+        result = write(ctx, s_names, s_name_count * sizeof(TraceName_t));
+    }
+    for (int core = 0; core < TRACE_CORES && result == 0; core++) {
+        result = write(ctx, &s_rings[core].head, sizeof(uint32_t));
+        if (result == 0) {
+            result = write(ctx, s_rings[core].events, sizeof(s_rings[core].events));
+        }
+    }
+
+    s_trace_enabled = was_enabled;
+    return result;
+}
+
+#endif // FSW_TRACE
@@ -0,0 +1,386 @@
+// src/uplink_deframer.c
+
+#include "uplink_deframer.h"
+#include "ccsds_packet.h"
+#include "crc16.h"
+#include <string.h>
+
+// Bytes fed to the CRC per realignment chunk (packets off byte alignment)
+#define DEFRAMER_CHUNK 32
+
+// --- A. BIT HELPERS ---
+
+static inline unsigned popcount32(uint32_t x) {
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (x * 0x01010101u) >> 24;
+}
+
+// Bit-sliced marker search over the 32 candidates ending in the low word of
+// the window: bit k of each mask stands for the candidate window >> k. Marker
+// bits are compared one at a time for all candidates at once, mismatches
+// counted in saturating bit planes (pN: more than N wrong bits). On noise
+// every candidate is out after a dozen or so marker bits. Returns the
+// candidates within max_errors.
+static uint32_t match_candidates(uint64_t window, unsigned max_errors) {
+    uint32_t p0 = 0, p1 = 0, p2 = 0, p3 = 0;
+    const uint32_t s0 = 0u - (uint32_t)(max_errors == 0), s1 = 0u - (uint32_t)(max_errors == 1);
+    const uint32_t s2 = 0u - (uint32_t)(max_errors == 2), s3 = 0u - (uint32_t)(max_errors == 3);
+    uint32_t out = 0;
+
+    for (unsigned i = 0; i < 32u; i += 4u) {
+        uint64_t w = window >> i;
+        uint32_t asm_bits = UPLINK_ASM >> i;
+        for (unsigned n = 0; n < 4u; n++) {
+            uint32_t miss = (uint32_t)(w >> n) ^ (0u - ((asm_bits >> n) & 1u));
+            p3 |= p2 & miss;
+            p2 |= p1 & miss;
+            p1 |= p0 & miss;
+            p0 |= miss;
+        }
+        out = (p0 & s0) | (p1 & s1) | (p2 & s2) | (p3 & s3);
+        if (out == 0xFFFFFFFFu) {
+            return 0;
+        }
+    }
+    return ~out;
+}
+
+static inline uint8_t ring_byte(const UplinkDeframer_t *d, uint32_t i) {
+    return d->ring[i & d->mask];
+}
+
+static inline uint32_t ring_be32(const UplinkDeframer_t *d, uint32_t i) {
+    uint32_t idx = i & d->mask;
+    if (idx + 4u <= d->mask + 1u) {
+        return ccsds_get_be32(&d->ring[idx]);
+    }
+    return ((uint32_t)ring_byte(d, i) << 24) | ((uint32_t)ring_byte(d, i + 1) << 16) |
+           ((uint32_t)ring_byte(d, i + 2) << 8) | (uint32_t)ring_byte(d, i + 3);
+}
+
+// Byte j of the current packet, as it would be with byte alignment
+static inline uint8_t packet_byte(const UplinkDeframer_t *d, uint32_t j) {
+    uint32_t i = d->start + j;
+    if (d->bit == 0) {
+        return ring_byte(d, i);
+    }
+    return (uint8_t)((ring_byte(d, i) << d->bit) | (ring_byte(d, i + 1) >> (8 - d->bit)));
+}
+
+static inline uint32_t load_head(const UplinkDeframer_t *d) {
+    return __atomic_load_n(&d->head, __ATOMIC_ACQUIRE);
+}
+
+// --- B. STATE CHANGES ---
+
+// The tail only moves forward: bytes behind it may already be overwritten
+static void advance_tail(UplinkDeframer_t *d, uint32_t tail) {
+    if ((int32_t)(tail - d->tail) > 0) {
+        __atomic_store_n(&d->tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+// A marker was accepted: the packet starts at (byte, bit)
+static void lock_on(UplinkDeframer_t *d, uint32_t byte, uint8_t bit, unsigned errors) {
+    d->state = DEFRAMER_PACKET;
+    d->start = byte;
+    d->bit = bit;
+    d->asm_errors = (uint8_t)errors;
+    d->length = 0;
+    d->crc_done = 0;
+    d->crc = crc16_init();
+    d->skip_active = 0;
+    // The marker stays in the ring in case the packet is rejected. After a
+    // negative slip it starts in the last byte of the packet already
+    // released, which is not ours any more.
+    advance_tail(d, byte - UPLINK_ASM_LEN);
+    if (errors != 0) {
+        d->stats.asm_corrected++;
+    }
+}
+
+static void hunt_from(UplinkDeframer_t *d, uint32_t byte) {
+    d->state = DEFRAMER_HUNT;
+    d->pos = byte;
+    d->window = 0;
+    d->window_bits = 0;
+}
+
+// Header or CRC failure: the marker may have been a false match inside
+// noise, or a real packet may start inside the rejected one. Search again
+// from the marker (or the tail, if the marker began before it), past the
+// packet that was just rejected.
+static void reject_packet(UplinkDeframer_t *d) {
+    hunt_from(d, d->tail);
+    d->skip_byte = d->start;
+    d->skip_bit = d->bit;
+    d->skip_active = 1;
+}
+
+// --- C. HUNT ---
+
+// Loads the stream one 32-bit word at a time into a 64-bit window and tests
+// the 32 bit alignments ending in the new word together. Returns 1 once
+// locked.
+static int hunt(UplinkDeframer_t *d, uint32_t head) {
+    // Locals: the ring is bytes, so the compiler would reload d-> after every load
+    uint32_t pos = d->pos;
+    uint64_t window = d->window;
+    uint32_t window_bits = d->window_bits;
+    const unsigned max_errors = d->cfg.max_asm_errors;
+    int locked = 0;
+
+    while (!locked && head - pos >= 4u) {
+        window = (window << 32) | ring_be32(d, pos);
+        window_bits = (window_bits >= 32u) ? 64u : window_bits + 32u;
+        pos += 4u;
+
+        uint32_t found = match_candidates(window, max_errors);
+        if (window_bits < 64u) {
+            found &= 1u;                        // Only the candidate fully loaded
+        }
+        while (found != 0) {
+            int k = 31 - __builtin_clz(found);  // Earliest first
+            found &= ~(1u << k);
+
+            uint32_t byte = pos - (uint32_t)((k + 7) >> 3);
+            uint8_t bit = (uint8_t)((8 - (k & 7)) & 7);
+            if (d->skip_active && ((int32_t)(byte - d->skip_byte) < 0 ||
+                                   (byte == d->skip_byte && bit <= d->skip_bit))) {
+                continue;
+            }
+            d->stats.acquisitions++;
+            lock_on(d, byte, bit, popcount32((uint32_t)(window >> k) ^ UPLINK_ASM));
+            locked = 1;
+            break;
+        }
+    }
+
+    d->pos = pos;
+    d->window = window;
+    d->window_bits = window_bits;
+    // A marker ending in the next word can start up to 8 bytes back
+    if (!locked) {
+        advance_tail(d, pos - 8u);
+    }
+    return locked;
+}
+
+// --- D. PACKET ---
+
+// Feeds the CRC with the packet bytes that arrived, validates the header as
+// soon as it is in and delivers the packet once the CRC matches. Returns 1
+// when the state changed.
+static int follow_packet(UplinkDeframer_t *d, uint32_t head) {
+    uint32_t raw = head - d->start;
+    // Off alignment, byte j also needs raw byte j + 1
+    uint32_t avail = (d->bit == 0) ? raw : (raw > 0u ? raw - 1u : 0u);
+
+    // 1. Primary header: version and announced length must be plausible
+    if (d->length == 0) {
+        uint8_t hdr_bytes[CCSDS_PRIMARY_HEADER_LEN];
+        CCSDS_PrimaryHeader_t hdr;
+        size_t total;
+
+        if (avail < CCSDS_PRIMARY_HEADER_LEN) {
+            return 0;
+        }
+        for (uint32_t j = 0; j < CCSDS_PRIMARY_HEADER_LEN; j++) {
+            hdr_bytes[j] = packet_byte(d, j);
+        }
+        if (ccsds_decode_primary(hdr_bytes, sizeof(hdr_bytes), &hdr) != 0 ||
+            (total = ccsds_packet_length(&hdr)) < CCSDS_PRIMARY_HEADER_LEN + CCSDS_CRC_LEN ||
+            total > d->cfg.max_packet_len) {
+            d->stats.header_errors++;
+            reject_packet(d);
+            return 1;
+        }
+        d->length = (uint16_t)total;
+    }
+
+    // 2. Incremental CRC over what has arrived, trailing CRC excluded
+    uint32_t body = d->length - CCSDS_CRC_LEN;
+    uint32_t target = (avail < body) ? avail : body;
+    while (d->crc_done < target) {
+        uint32_t idx = (d->start + d->crc_done) & d->mask;
+        uint32_t run = target - d->crc_done;
+
+        if (d->bit == 0) {
+            if (run > d->mask + 1u - idx) {
+                run = d->mask + 1u - idx;       // Up to the end of the ring
+            }
+            d->crc = crc16_update(d->crc, &d->ring[idx], run);
+        } else {
+            uint8_t chunk[DEFRAMER_CHUNK];
+            if (run > DEFRAMER_CHUNK) {
+                run = DEFRAMER_CHUNK;
+            }
+            for (uint32_t j = 0; j < run; j++) {
+                chunk[j] = packet_byte(d, d->crc_done + j);
+            }
+            d->crc = crc16_update(d->crc, chunk, run);
+        }
+        d->crc_done = (uint16_t)(d->crc_done + run);
+    }
+
+    if (avail < d->length) {
+        return 0;
+    }
+
+    // 3. Packet Error Control
+    uint16_t received = (uint16_t)((packet_byte(d, body) << 8) | packet_byte(d, body + 1u));
+    if (crc16_final(d->crc) != received) {
+        d->stats.crc_failures++;
+        reject_packet(d);
+        return 1;
+    }
+
+    // 4. Hand off in place. An unaligned packet is shifted into byte
+    //    alignment first; the raw byte shared with the next marker is kept.
+    uint32_t end = d->start + d->length;
+    d->last_raw = ring_byte(d, end - 1u);
+    if (d->bit != 0) {
+        for (uint32_t j = 0; j < d->length; j++) {
+            d->ring[(d->start + j) & d->mask] = packet_byte(d, j);
+        }
+    }
+
+    UplinkPacketView_t view;
+    uint32_t idx = d->start & d->mask;
+    uint32_t first = d->mask + 1u - idx;
+    if (first > d->length) {
+        first = d->length;
+    }
+    view.seg[0] = &d->ring[idx];
+    view.seg_len[0] = (uint16_t)first;
+    view.seg[1] = (first < d->length) ? d->ring : NULL;
+    view.seg_len[1] = (uint16_t)(d->length - first);
+    view.length = d->length;
+    view.bit_offset = d->bit;
+    view.asm_errors = d->asm_errors;
+    d->stats.packets++;
+    d->on_packet(d->ctx, &view);
+
+    // 5. The next marker is due right behind this packet
+    d->state = DEFRAMER_CHECK;
+    __atomic_store_n(&d->tail, end, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// --- E. FLYWHEEL ---
+
+// Tests the expected marker position first, then +/-1 .. slip_window_bits.
+// Returns 1 when the state changed.
+static int check_marker(UplinkDeframer_t *d, uint32_t head) {
+    uint32_t expected = d->start + d->length;   // Byte holding the marker's first bit
+
+    // Window of 8 bytes from the byte before the marker (kept as received)
+    if (head - expected < 7u) {
+        return 0;
+    }
+    uint64_t window = (uint64_t)d->last_raw << 56;
+    for (uint32_t j = 0; j < 7u; j++) {
+        window |= (uint64_t)ring_byte(d, expected + j) << (48 - 8 * j);
+    }
+
+    int base = 8 + d->bit;      // Marker start in window bits, from the MSB
+    for (int n = 0; n <= 2 * d->cfg.slip_window_bits; n++) {
+        int offset = (n & 1) ? (n + 1) / 2 : -(n / 2);
+        int s = base + offset;
+        unsigned errors = popcount32((uint32_t)(window >> (32 - s)) ^ UPLINK_ASM);
+        if (errors <= d->cfg.max_asm_errors) {
+            if (offset != 0) {
+                d->stats.bit_slips++;
+            }
+            lock_on(d, expected - 1u + (uint32_t)((s + 32) >> 3), (uint8_t)((s + 32) & 7), errors);
+            return 1;
+        }
+    }
+
+    d->stats.sync_losses++;
+    hunt_from(d, expected);
+    d->skip_active = 0;
+    return 1;
+}
+
+// --- F. PUBLIC API ---
+
+int uplink_deframer_init(UplinkDeframer_t *d, uint8_t *ring, uint32_t ring_size,
+                         const UplinkDeframerConfig_t *cfg,
+                         UplinkPacketFn_t on_packet, void *ctx) {
+    if (d == NULL || ring == NULL || cfg == NULL || on_packet == NULL ||
+        ring_size == 0 || (ring_size & (ring_size - 1u)) != 0 ||
+        cfg->max_packet_len < CCSDS_PRIMARY_HEADER_LEN + CCSDS_CRC_LEN ||
+        ring_size < 2u * cfg->max_packet_len ||
+        cfg->slip_window_bits > UPLINK_MAX_SLIP_BITS || cfg->max_asm_errors > UPLINK_MAX_ASM_ERRORS) {
+        return -1;
+    }
+
+    memset(d, 0, sizeof(*d));
+    d->ring = ring;
+    d->mask = ring_size - 1u;
+    d->cfg = *cfg;
+    d->on_packet = on_packet;
+    d->ctx = ctx;
+    d->state = DEFRAMER_HUNT;
+    return 0;
+}
+
+uint8_t *uplink_deframer_rx_reserve(UplinkDeframer_t *d, size_t *len) {
+    uint32_t head = d->head;
+    uint32_t free_bytes = d->mask + 1u - (head - __atomic_load_n(&d->tail, __ATOMIC_ACQUIRE));
+    uint32_t idx = head & d->mask;
+    uint32_t contiguous = d->mask + 1u - idx;
+
+    *len = (free_bytes < contiguous) ? free_bytes : contiguous;
+    return &d->ring[idx];
+}
+
+void uplink_deframer_rx_commit(UplinkDeframer_t *d, size_t len) {
+    d->stats.bytes_in += (uint32_t)len;
+    __atomic_store_n(&d->head, d->head + (uint32_t)len, __ATOMIC_RELEASE);
+}
+
+size_t uplink_deframer_rx_write(UplinkDeframer_t *d, const uint8_t *data, size_t len) {
+    size_t written = 0;
+
+    // At most two spans: up to the end of the ring, then from its start
+    while (written < len) {
+        size_t span;
+        uint8_t *dst = uplink_deframer_rx_reserve(d, &span);
+        if (span == 0) {
+            break;
+        }
+        if (span > len - written) {
+            span = len - written;
+        }
+        memcpy(dst, data + written, span);
+        uplink_deframer_rx_commit(d, span);
+        written += span;
+    }
+
+    d->stats.overrun_bytes += (uint32_t)(len - written);
+    return written;
+}
+
+uint32_t uplink_deframer_poll(UplinkDeframer_t *d) {
+    uint32_t head = load_head(d);
+    uint32_t delivered = d->stats.packets;
+    int progress = 1;
+
+    while (progress) {
+        switch (d->state) {
+            case DEFRAMER_HUNT:   progress = hunt(d, head);          break;
+            case DEFRAMER_PACKET: progress = follow_packet(d, head); break;
+            case DEFRAMER_CHECK:  progress = check_marker(d, head);  break;
+            default:              progress = 0;                      break;
+        }
+    }
+    return d->stats.packets - delivered;
+}
+
+void uplink_deframer_get_stats(const UplinkDeframer_t *d, UplinkDeframerStats_t *stats) {
+    *stats = d->stats;
+}
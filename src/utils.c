@@ -4,24 +4,44 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#if defined(ESP_PLATFORM)
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#else
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
 
-uint16_t crc16_ccitt(const uint8_t *data, size_t length) {
-    uint16_t crc = CRC16_INITIAL;
-    size_t i, j;
 
+uint16_t crc16_ccitt(const uint8_t *data, size_t length) {
     if (data == NULL) {
         return 0; // Handle null pointer case
     }
-    
-    for (i = 0; i < length; i++) {
-        crc ^= ((uint16_t)data[i] << 8);
-        for (j = 0; j < 8; j++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ CRC16_POLY;
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    return crc;
-}
\ No newline at end of file
+
+    return crc16_final(crc16_update(crc16_init(), data, length));
+}
+
+uint32_t util_get_cycle_count(void) {
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_cpu_get_ccount();
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    // No portable cycle counter: fall back to nanoseconds
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+uint32_t util_get_time_us(void) {
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000u);
+#endif
+}
@@ -3,45 +3,275 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "satellite_types.h"
+#include "state_manager.h"
 #include "watchdog.h"
+#include "param_store.h"
+#include "trace.h"
+#include "checkpoint.h"
+#include "fsw_log.h"
 #include <stdio.h>
+#include <string.h>
 
-// Array to store the last time (in ticks) each critical task checked in.
-TickType_t g_watchdog_last_pet[WDT_TASK_COUNT] = {0};
+typedef struct {
+    TickType_t last_pet;
+    uint8_t expired;            // Escalated; waits for the next pet
+    WatchdogTaskStats_t stats;
+} WatchdogSlot_t;
+
+// Deadlines leave room for one missed period plus scheduling delays.
+// DATA_LOG only logs: a stalled archive loses telemetry, not the spacecraft.
+static WatchdogConfig_t s_wdt_config[WDT_TASK_COUNT] = {
+    [WDT_TASK_TM_GEN]    = { 5000,  12000, WDT_ACTION_CRITICAL },
+    [WDT_TASK_CMD_PROC]  = { 1000,  3000,  WDT_ACTION_CRITICAL },   // TC_PROC_IDLE_WAKE_MS
+    [WDT_TASK_EPS_MON]   = { 100,   1000,  WDT_ACTION_CRITICAL },   // EPS_BATCH_PERIOD_MS
+    [WDT_TASK_DATA_LOG]  = { 100,   5000,  WDT_ACTION_LOG },
+    [WDT_TASK_ROUTER]    = { 1000,  3000,  WDT_ACTION_CRITICAL },
+    [WDT_TASK_TC_SCHED]  = { 5000,  12000, WDT_ACTION_CRITICAL },   // TC_SCHED_MAX_SLEEP_MS
+};
+
+static const char *s_wdt_names[WDT_TASK_COUNT] = {
+    [WDT_TASK_TM_GEN]   = "TM_GEN",
+    [WDT_TASK_CMD_PROC] = "CMD_PROC",
+    [WDT_TASK_EPS_MON]  = "EPS_MON",
+    [WDT_TASK_DATA_LOG] = "DATA_LOG",
+    [WDT_TASK_ROUTER]   = "CDHS_ROUTER",
+    [WDT_TASK_TC_SCHED] = "TC_SCHED",
+};
+
+static WatchdogSlot_t s_wdt[WDT_TASK_COUNT];
+static WatchdogResetLog_t s_reset_log;     // Written by init, then by the monitor only
+static WatchdogRestartHook_t s_restart_hook;
+static TaskHandle_t s_wdt_task;
+static portMUX_TYPE s_wdt_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Re-evaluates the sleep after a deadline may have moved earlier
+static void wake_monitor(void) {
+    if (s_wdt_task != NULL) {
+        xTaskNotifyGive(s_wdt_task);
+    }
+}
+
+// --- A. CONFIGURATION ---
+
+void watchdog_init(void) {
+    TickType_t now = xTaskGetTickCount();
+
+    portENTER_CRITICAL(&s_wdt_mux);
+    memset(s_wdt, 0, sizeof(s_wdt));
+    for (int i = 0; i < WDT_TASK_COUNT; i++) {
+        s_wdt[i].last_pet = now;
+        s_wdt[i].stats.interval_min_ticks = UINT32_MAX;
+        s_wdt[i].stats.slack_min_ticks = UINT32_MAX;
+    }
+    portEXIT_CRITICAL(&s_wdt_mux);
+
+    // The previous boot's last expiry is the prime suspect for a warm reset
+    CheckpointStats_t cp;
+    checkpoint_get_stats(&cp);
+    if (checkpoint_get(CHECKPOINT_RESETS, &s_reset_log, sizeof(s_reset_log), NULL) != 0) {
+        memset(&s_reset_log, 0, sizeof(s_reset_log));
+    }
+    if (cp.reset != CHECKPOINT_RESET_POWER_ON && cp.boot > 0) {
+        WatchdogResetEntry_t entry;
+
+        memset(&entry, 0, sizeof(entry));
+        entry.reason = (uint8_t)cp.reset;
+        entry.last_expired = (uint8_t)s_reset_log.last_expired;
+        entry.boot = cp.boot - 1u;
+        entry.alive_tick = cp.last_alive_tick;
+        memmove(&s_reset_log.history[1], &s_reset_log.history[0],
+                sizeof(entry) * (WATCHDOG_RESET_HISTORY - 1));
+        s_reset_log.history[0] = entry;
+        if (s_reset_log.count < WATCHDOG_RESET_HISTORY) {
+            s_reset_log.count++;
+        }
+        s_reset_log.warm_resets++;
+        printf("WATCHDOG: Warm restart #%lu (%s) after boot %lu, last expired task: %s.\n",
+               (unsigned long)s_reset_log.warm_resets, checkpoint_reset_name(cp.reset),
+               (unsigned long)entry.boot,
+               (entry.last_expired > 0) ? s_wdt_names[entry.last_expired - 1] : "none");
+    }
+    s_reset_log.last_expired = 0;
+    checkpoint_write(CHECKPOINT_RESETS, &s_reset_log, sizeof(s_reset_log), (uint32_t)now);
+}
+
+void watchdog_get_reset_log(WatchdogResetLog_t *log) {
+    portENTER_CRITICAL(&s_wdt_mux);
+    *log = s_reset_log;
+    portEXIT_CRITICAL(&s_wdt_mux);
+}
+
+BaseType_t watchdog_configure(WatchdogTaskID_t task_id, const WatchdogConfig_t *config) {
+    if (task_id >= WDT_TASK_COUNT || config->deadline_ms == 0) {
+        return pdFAIL;
+    }
+    portENTER_CRITICAL(&s_wdt_mux);
+    s_wdt_config[task_id] = *config;
+    portEXIT_CRITICAL(&s_wdt_mux);
+
+    wake_monitor();
+    return pdPASS;
+}
+
+void watchdog_set_restart_hook(WatchdogRestartHook_t hook) {
+    s_restart_hook = hook;
+}
+
+// --- B. PET (called by the supervised tasks) ---
 
-// Function called by critical tasks to signal they are alive
 void watchdog_pet(WatchdogTaskID_t task_id) {
-    if (task_id < WDT_TASK_COUNT) {
-        g_watchdog_last_pet[task_id] = xTaskGetTickCount();
+    if (task_id >= WDT_TASK_COUNT) {
+        return;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    WatchdogSlot_t *slot = &s_wdt[task_id];
+    WatchdogTaskStats_t *stats = &slot->stats;
+    uint8_t was_expired;
+
+    TRACE_EVENT(TRACE_WDT_PET, NULL, task_id);
+
+    portENTER_CRITICAL(&s_wdt_mux);
+    uint32_t interval = (uint32_t)(now - slot->last_pet);
+    uint32_t period = pdMS_TO_TICKS(s_wdt_config[task_id].period_ms);
+    uint32_t deadline = pdMS_TO_TICKS(s_wdt_config[task_id].deadline_ms);
+
+    if (stats->pets > 0) {
+        uint32_t jitter = (interval > period) ? interval - period : period - interval;
+        uint32_t slack = (interval < deadline) ? deadline - interval : 0;
+
+        stats->interval_sum_ticks += interval;
+        stats->jitter_sum_ticks += jitter;
+        if (interval < stats->interval_min_ticks) {
+            stats->interval_min_ticks = interval;
+        }
+        if (interval > stats->interval_max_ticks) {
+            stats->interval_max_ticks = interval;
+        }
+        if (jitter > stats->jitter_max_ticks) {
+            stats->jitter_max_ticks = jitter;
+        }
+        if (slack < stats->slack_min_ticks) {
+            stats->slack_min_ticks = slack;
+        }
+    }
+    stats->pets++;
+    slot->last_pet = now;
+    was_expired = slot->expired;
+    slot->expired = 0;
+    portEXIT_CRITICAL(&s_wdt_mux);
+
+    // The monitor may be sleeping past this task's new deadline
+    if (was_expired) {
+        FSW_LOGW(LOG_MOD_WDT, "WATCHDOG: Task %s is alive again.\n", s_wdt_names[task_id]);
+        wake_monitor();
     }
 }
 
-// WATCHDOG MONITOR TASK
-void vSoftwareWatchdogTask(void *pvParameters) {
-    // Timeout is 15 seconds (15000 milliseconds)
-    const TickType_t xWatchdogTimeout = pdMS_TO_TICKS(15000); 
-    
-    // Initialize array at boot time so the system doesn't immediately reset
+BaseType_t watchdog_get_stats(WatchdogTaskID_t task_id, WatchdogTaskStats_t *stats) {
+    if (task_id >= WDT_TASK_COUNT) {
+        return pdFAIL;
+    }
+    portENTER_CRITICAL(&s_wdt_mux);
+    *stats = s_wdt[task_id].stats;
+    portEXIT_CRITICAL(&s_wdt_mux);
+    return pdPASS;
+}
+
+// --- C. SUPERVISION ---
+
+static void escalate(WatchdogTaskID_t task_id, WatchdogAction_t action, uint32_t silent_ticks) {
+    // On record before the action: a restart may follow right away
+    portENTER_CRITICAL(&s_wdt_mux);
+    s_reset_log.last_expired = (uint16_t)(task_id + 1);
+    WatchdogResetLog_t record = s_reset_log;
+    portEXIT_CRITICAL(&s_wdt_mux);
+    checkpoint_write(CHECKPOINT_RESETS, &record, sizeof(record), (uint32_t)xTaskGetTickCount());
+
+    FSW_LOGE(LOG_MOD_WDT, "WATCHDOG: !!! CRITICAL FAILURE: Task %s silent for %lu ms (deadline %lu ms) !!!\n",
+             s_wdt_names[task_id], (unsigned long)(silent_ticks * portTICK_PERIOD_MS),
+             (unsigned long)s_wdt_config[task_id].deadline_ms);
+
+    switch (action) {
+        case WDT_ACTION_LOG:
+            break;
+
+        case WDT_ACTION_RESTART:
+            if (s_restart_hook != NULL) {
+                s_restart_hook(task_id);
+                break;
+            }
+            FSW_LOGW(LOG_MOD_WDT, "WATCHDOG: No restart hook installed, forcing MODE_CRITICAL.\n");
+            set_system_mode(MODE_CRITICAL);
+            break;
+
+        case WDT_ACTION_CRITICAL:
+        default:
+            set_system_mode(MODE_CRITICAL);
+            break;
+    }
+}
+
+// WDT group of the parameter store; only the monitor calls this
+static void publish_expiries(WatchdogTaskID_t last_expired) {
+    uint32_t expiries = 0;
+
+    portENTER_CRITICAL(&s_wdt_mux);
     for (int i = 0; i < WDT_TASK_COUNT; i++) {
-        g_watchdog_last_pet[i] = xTaskGetTickCount();
+        expiries += s_wdt[i].stats.expiries;
     }
-    
-    printf("WATCHDOG: Software Watchdog initialized.\n");
+    portEXIT_CRITICAL(&s_wdt_mux);
 
-    for (;;) {
-        vTaskDelay(pdMS_TO_TICKS(5000)); // Check every 5 seconds (1/3 of timeout)
-
-        TickType_t xCurrentTime = xTaskGetTickCount();
-        
-        // Loop through all critical tasks to check their status
-        for (int i = 0; i < WDT_TASK_COUNT; i++) {
-            if (xCurrentTime - g_watchdog_last_pet[i] > xWatchdogTimeout) {
-                // FAILURE DETECTED: Task has not pet the watchdog in 15 seconds
-                printf("WATCHDOG: !!! CRITICAL FAILURE: Task %d timed out !!!\n", i);
-                
-                // IMPORTANT: This is where a real FSW would call esp_restart() or 
-                // transition to MODE_CRITICAL to save the system. For simulation, I just log the event.
+    param_write_begin(PARAM_GROUP_WDT);
+    param_write(PARAM_wdt_expiries, (int32_t)expiries);
+    param_write(PARAM_wdt_last_expired, (int32_t)last_expired + 1);
+    param_write_end(PARAM_GROUP_WDT);
+}
+
+TickType_t watchdog_check(TickType_t now) {
+    TickType_t next = portMAX_DELAY;
+
+    for (int i = 0; i < WDT_TASK_COUNT; i++) {
+        WatchdogAction_t action;
+        uint32_t silent;
+        int fire = 0;
+
+        // 1. Deadline of this task (wrap-safe)
+        portENTER_CRITICAL(&s_wdt_mux);
+        silent = (uint32_t)(now - s_wdt[i].last_pet);
+        int32_t remaining = (int32_t)(pdMS_TO_TICKS(s_wdt_config[i].deadline_ms) - silent);
+        action = s_wdt_config[i].action;
+        if (!s_wdt[i].expired) {
+            if (remaining <= 0) {
+                s_wdt[i].expired = 1;
+                s_wdt[i].stats.expiries++;
+                fire = 1;
+            } else if ((TickType_t)remaining < next) {
+                next = (TickType_t)remaining;
             }
         }
+        portEXIT_CRITICAL(&s_wdt_mux);
+
+        // 2. Escalate outside the critical section (it may take the mode mutex)
+        if (fire) {
+            publish_expiries((WatchdogTaskID_t)i);
+            escalate((WatchdogTaskID_t)i, action, silent);
+        }
     }
-}
\ No newline at end of file
+    return next;
+}
+
+// WATCHDOG MONITOR TASK
+void vSoftwareWatchdogTask(void *pvParameters) {
+    s_wdt_task = xTaskGetCurrentTaskHandle();
+    printf("WATCHDOG: Software Watchdog initialized.\n");
+    TRACE_TASK_START();
+
+    for (;;) {
+        // Sleeps exactly until the earliest deadline; pets only move deadlines
+        // later, so only a reconfiguration or a recovered task cuts it short.
+        TRACE_EVENT(TRACE_TASK_SLEEP, NULL, 0);
+        ulTaskNotifyTake(pdTRUE, watchdog_check(xTaskGetTickCount()));
+        TRACE_EVENT(TRACE_TASK_WAKE, NULL, 0);
+    }
+}
@@ -0,0 +1,126 @@
+// test/test_ccsds_packet.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdint.h>
+#include <string.h>
+#include "ccsds_packet.h"        // Functions to test: build/decode primary + secondary, user data
+#include "utils.h"               // crc16_ccitt
+
+// Links against src/ccsds_packet.c, src/utils.c and src/crc16.c
+
+// --- TEST FUNCTIONS ---
+
+void test_build_and_decode_round_trip() {
+    uint8_t user[20], packet[CCSDS_MAX_PACKET_LEN];
+    CCSDS_PrimaryHeader_t hdr;
+    CCSDS_SecondaryHeader_t sec;
+    size_t user_len;
+
+    for (size_t i = 0; i < sizeof(user); i++) {
+        user[i] = (uint8_t)(0x40 + i);
+    }
+    size_t len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TC, APID_EPS, 1234,
+                                    0x0123456789ABCDEFull, user, sizeof(user));
+    TEST_ASSERT_EQUAL(CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + sizeof(user) + CCSDS_CRC_LEN, len);
+
+    // Every header field comes back, and the announced length is the built one
+    TEST_ASSERT_EQUAL(0, ccsds_decode_primary(packet, len, &hdr));
+    TEST_ASSERT_EQUAL(0, hdr.version);
+    TEST_ASSERT_EQUAL(CCSDS_TYPE_TC, hdr.type);
+    TEST_ASSERT_EQUAL(1, hdr.sec_hdr_flag);
+    TEST_ASSERT_EQUAL_HEX16(APID_EPS, hdr.apid);
+    TEST_ASSERT_EQUAL(CCSDS_SEQ_UNSEGMENTED, hdr.seq_flags);
+    TEST_ASSERT_EQUAL_UINT16(1234, hdr.seq_count);
+    TEST_ASSERT_EQUAL(len, ccsds_packet_length(&hdr));
+    TEST_ASSERT_EQUAL_HEX16(APID_EPS, ccsds_get_apid(packet));
+
+    TEST_ASSERT_EQUAL(0, ccsds_decode_secondary(packet, len, &sec));
+    TEST_ASSERT_TRUE(sec.met == 0x0123456789ABCDEFull);
+
+    const uint8_t *data = ccsds_user_data(packet, &hdr, &user_len);
+    TEST_ASSERT_EQUAL(sizeof(user), user_len);
+    TEST_ASSERT_EQUAL_MEMORY(user, data, sizeof(user));
+
+    // Packet Error Control covers everything before it
+    TEST_ASSERT_EQUAL_HEX16(crc16_ccitt(packet, len - CCSDS_CRC_LEN), ccsds_get_be16(&packet[len - CCSDS_CRC_LEN]));
+}
+
+void test_build_masks_apid_and_sequence_count() {
+    uint8_t packet[CCSDS_MAX_PACKET_LEN];
+    CCSDS_PrimaryHeader_t hdr;
+
+    size_t len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TM, 0xF810, 0xC005, 0, NULL, 0);
+    TEST_ASSERT_EQUAL(CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + CCSDS_CRC_LEN, len);
+    TEST_ASSERT_EQUAL(0, ccsds_decode_primary(packet, len, &hdr));
+    TEST_ASSERT_EQUAL(CCSDS_TYPE_TM, hdr.type);
+    TEST_ASSERT_EQUAL_HEX16(0x010, hdr.apid);
+    TEST_ASSERT_EQUAL_UINT16(0x0005, hdr.seq_count);
+}
+
+void test_build_refuses_what_does_not_fit() {
+    uint8_t user[8] = { 0 }, packet[CCSDS_MAX_PACKET_LEN];
+    size_t exact = CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + sizeof(user) + CCSDS_CRC_LEN;
+
+    TEST_ASSERT_EQUAL(exact, ccsds_build_packet(packet, exact, CCSDS_TYPE_TM, APID_CDHS, 0, 0, user, sizeof(user)));
+    TEST_ASSERT_EQUAL(0, ccsds_build_packet(packet, exact - 1, CCSDS_TYPE_TM, APID_CDHS, 0, 0, user, sizeof(user)));
+    TEST_ASSERT_EQUAL(0, ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TM, APID_CDHS, 0, 0, NULL, 4));
+    TEST_ASSERT_EQUAL(0, ccsds_build_packet(NULL, sizeof(packet), CCSDS_TYPE_TM, APID_CDHS, 0, 0, user, 4));
+}
+
+void test_decode_rejects_bad_version_and_short_buffers() {
+    uint8_t packet[CCSDS_MAX_PACKET_LEN];
+    CCSDS_PrimaryHeader_t hdr;
+    CCSDS_SecondaryHeader_t sec;
+
+    size_t len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TC, APID_ADCS, 7, 99, NULL, 0);
+
+    // Only version 1 (field value 0) is accepted
+    for (uint8_t version = 1; version < 8; version++) {
+        packet[0] = (uint8_t)((packet[0] & 0x1F) | (version << 5));
+        TEST_ASSERT_EQUAL(-1, ccsds_decode_primary(packet, len, &hdr));
+        TEST_ASSERT_EQUAL(version, hdr.version);
+    }
+
+    TEST_ASSERT_EQUAL(-1, ccsds_decode_primary(packet, CCSDS_PRIMARY_HEADER_LEN - 1, &hdr));
+    TEST_ASSERT_EQUAL(-1, ccsds_decode_primary(NULL, len, &hdr));
+    TEST_ASSERT_EQUAL(-1, ccsds_decode_secondary(packet, CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN - 1, &sec));
+}
+
+void test_bad_length_field_yields_no_user_data() {
+    uint8_t packet[CCSDS_MAX_PACKET_LEN];
+    CCSDS_PrimaryHeader_t hdr;
+    size_t user_len = 99;
+
+    size_t len = ccsds_build_packet(packet, sizeof(packet), CCSDS_TYPE_TC, APID_CDHS, 0, 0, NULL, 0);
+
+    // A data length shorter than secondary header + CRC leaves no user data field
+    ccsds_put_be16(&packet[4], (uint16_t)(CCSDS_SECONDARY_HEADER_LEN - 1));
+    TEST_ASSERT_EQUAL(0, ccsds_decode_primary(packet, len, &hdr));
+    TEST_ASSERT_TRUE(ccsds_packet_length(&hdr) != len);
+    TEST_ASSERT_NULL(ccsds_user_data(packet, &hdr, &user_len));
+    TEST_ASSERT_EQUAL(0, user_len);
+
+    // The largest field value announces 65536 bytes after the header
+    ccsds_put_be16(&packet[4], 0xFFFF);
+    TEST_ASSERT_EQUAL(0, ccsds_decode_primary(packet, len, &hdr));
+    TEST_ASSERT_EQUAL(CCSDS_PRIMARY_HEADER_LEN + 65536u, ccsds_packet_length(&hdr));
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_build_and_decode_round_trip);
+    RUN_TEST(test_build_masks_apid_and_sequence_count);
+    RUN_TEST(test_build_refuses_what_does_not_fit);
+    RUN_TEST(test_decode_rejects_bad_version_and_short_buffers);
+    RUN_TEST(test_bad_length_field_yields_no_user_data);
+
+    return UNITY_END();
+}
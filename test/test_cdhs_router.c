@@ -0,0 +1,224 @@
+// test/test_cdhs_router.c
+
+#include <unity.h>               // Unity Test Framework
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "cdhs_router.h"         // Functions to test: init/register/route/get_*_stats
+#include "ccsds_packet.h"
+#include "packet_pool.h"
+#include "watchdog.h"
+#include <stdio.h>
+#include <string.h>
+
+// Links against src/cdhs_router.c, src/ccsds_packet.c, src/packet_pool.c,
+// src/spsc_ring.c, src/uplink_deframer.c, src/rtos_alloc.c, src/trace.c,
+// src/utils.c, src/crc16.c, src/fsw_log.c and the host runtime
+// (host/freertos_posix.c).
+// Frames are routed directly with cdhs_router_route(), as the router task does.
+
+#define TEST_POOL_SLOTS     8
+#define TEST_QUEUE_DEPTH    2
+#define TEST_USER_LEN       4
+#define TEST_PACKET_LEN     (CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + TEST_USER_LEN + CCSDS_CRC_LEN)
+
+// The router task pets the watchdog; nothing here runs it
+void watchdog_pet(WatchdogTaskID_t task_id) {
+    (void)task_id;
+}
+
+static CCSDS_Frame_t s_frames[TEST_POOL_SLOTS];
+static PacketPool_t s_pool;
+static QueueHandle_t s_queue[CDHS_DEST_COUNT];
+
+// Allocates a frame holding a valid TC for `apid`
+static CCSDS_Frame_t *make_frame(uint16_t apid, uint16_t seq) {
+    uint8_t user[TEST_USER_LEN] = { 0xC0, 0xFF, 0xEE, (uint8_t)seq };
+    CCSDS_Frame_t *frame = cdhs_router_alloc_frame();
+
+    TEST_ASSERT_NOT_NULL(frame);
+    frame->length = (uint16_t)ccsds_build_packet(frame->data, sizeof(frame->data), CCSDS_TYPE_TC, apid, seq,
+                                                 0, user, sizeof(user));
+    TEST_ASSERT_EQUAL(TEST_PACKET_LEN, frame->length);
+    return frame;
+}
+
+// Takes the next frame off a destination queue and checks where it was meant to go
+static void expect_delivered(CdhsDestination_t dest, uint16_t apid) {
+    CCSDS_Frame_t *frame = NULL;
+
+    TEST_ASSERT_EQUAL(pdPASS, xQueueReceive(s_queue[dest], &frame, 0));
+    TEST_ASSERT_EQUAL_HEX16(apid, ccsds_get_apid(frame->data));
+    cdhs_router_release(frame);
+}
+
+static uint16_t pool_in_use(void) {
+    PoolStats_t stats;
+    packet_pool_get_stats(&s_pool, &stats);
+    return stats.in_use;
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_default_and_registered_routes_use_the_apid_table() {
+    CdhsApidStats_t stats;
+
+    // Default routes
+    cdhs_router_route(make_frame(APID_ADCS, 1));
+    cdhs_router_route(make_frame(APID_EPS, 2));
+    cdhs_router_route(make_frame(APID_CDHS, 3));
+    cdhs_router_route(make_frame(APID_HOUSEKEEPING, 4));
+    expect_delivered(CDHS_DEST_ADCS, APID_ADCS);
+    expect_delivered(CDHS_DEST_EPS, APID_EPS);
+    expect_delivered(CDHS_DEST_CDHS, APID_CDHS);
+    expect_delivered(CDHS_DEST_HK, APID_HOUSEKEEPING);
+
+    // A new APID, the highest one, and a moved route
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_register_apid(0x123, CDHS_DEST_HK));
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_register_apid(CCSDS_APID_MASK, CDHS_DEST_CDHS));
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_register_apid(APID_ADCS, CDHS_DEST_EPS));
+    cdhs_router_route(make_frame(0x123, 5));
+    cdhs_router_route(make_frame(CCSDS_APID_MASK, 6));
+    cdhs_router_route(make_frame(APID_ADCS, 7));
+    expect_delivered(CDHS_DEST_HK, 0x123);
+    expect_delivered(CDHS_DEST_CDHS, CCSDS_APID_MASK);
+    expect_delivered(CDHS_DEST_EPS, APID_ADCS);
+    TEST_ASSERT_EQUAL(0, uxQueueMessagesWaiting(s_queue[CDHS_DEST_ADCS]));
+
+    // Counters are per APID; a moved route keeps its own
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_get_apid_stats(APID_ADCS, &stats));
+    TEST_ASSERT_EQUAL_HEX16(APID_ADCS, stats.apid);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.packets);
+    TEST_ASSERT_EQUAL_UINT32(2 * TEST_PACKET_LEN, stats.bytes);
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_get_apid_stats(0x123, &stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.packets);
+    TEST_ASSERT_EQUAL(pdFAIL, cdhs_router_get_apid_stats(0x124, &stats));
+    TEST_ASSERT_EQUAL(pdFAIL, cdhs_router_get_apid_stats(CCSDS_APID_MASK + 1, &stats));
+
+    // The table holds CDHS_MAX_ROUTED_APIDS routes; moving one still works when full
+    uint16_t apid = 0x200;
+    while (cdhs_router_register_apid(apid, CDHS_DEST_HK) == pdPASS) {
+        apid++;
+    }
+    TEST_ASSERT_EQUAL(CDHS_MAX_ROUTED_APIDS - 6, apid - 0x200);
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_register_apid(0x200, CDHS_DEST_ADCS));
+    TEST_ASSERT_EQUAL(pdFAIL, cdhs_router_register_apid(CCSDS_APID_MASK + 1, CDHS_DEST_HK));
+    TEST_ASSERT_EQUAL(pdFAIL, cdhs_router_register_apid(0x300, CDHS_DEST_COUNT));
+    TEST_ASSERT_EQUAL(0, pool_in_use());
+}
+
+void test_malformed_crc_failures_and_unrouted_are_counted_and_released() {
+    CdhsRouterStats_t router;
+    CdhsApidStats_t stats;
+    CCSDS_Frame_t *frame;
+
+    // 1. Malformed: bad version, length field off by one, too short, too long
+    frame = make_frame(APID_EPS, 1);
+    frame->data[0] |= 0x20;
+    cdhs_router_route(frame);
+    frame = make_frame(APID_EPS, 2);
+    frame->length--;
+    cdhs_router_route(frame);
+    frame = make_frame(APID_EPS, 3);
+    frame->length = CCSDS_PRIMARY_HEADER_LEN - 1;
+    cdhs_router_route(frame);
+    frame = make_frame(APID_EPS, 4);
+    frame->length = CCSDS_MAX_PACKET_LEN + 1;
+    cdhs_router_route(frame);
+
+    // 2. CRC failure on a routed APID
+    frame = make_frame(APID_EPS, 5);
+    frame->data[CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN] ^= 0x01;
+    cdhs_router_route(frame);
+
+    // 3. Valid packets for an APID nobody registered
+    cdhs_router_route(make_frame(0x3AB, 6));
+    cdhs_router_route(make_frame(0x3AC, 7));
+
+    cdhs_router_get_stats(&router);
+    TEST_ASSERT_EQUAL_UINT32(7, router.received);
+    TEST_ASSERT_EQUAL_UINT32(4, router.malformed);
+    TEST_ASSERT_EQUAL_UINT32(2, router.unrouted);
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_get_apid_stats(APID_EPS, &stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.crc_failures);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.packets);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.drops);
+    TEST_ASSERT_EQUAL(pdFAIL, cdhs_router_get_apid_stats(0x3AB, &stats));     // Catch-all counters
+    TEST_ASSERT_EQUAL_UINT32(2, stats.drops);
+
+    // Nothing was delivered and every frame went back to the pool
+    TEST_ASSERT_EQUAL(0, uxQueueMessagesWaiting(s_queue[CDHS_DEST_EPS]));
+    TEST_ASSERT_EQUAL(0, pool_in_use());
+}
+
+void test_full_queue_does_not_stall_the_other_subsystems() {
+    CdhsApidStats_t stats;
+
+    // ADCS stops draining: its queue fills and the overflow is dropped
+    for (uint16_t i = 0; i < TEST_QUEUE_DEPTH + 2; i++) {
+        cdhs_router_route(make_frame(APID_ADCS, i));
+    }
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_get_apid_stats(APID_ADCS, &stats));
+    TEST_ASSERT_EQUAL_UINT32(TEST_QUEUE_DEPTH, stats.packets);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.drops);
+    TEST_ASSERT_EQUAL(TEST_QUEUE_DEPTH, pool_in_use());
+
+    // Everyone else still gets their packets at once
+    cdhs_router_route(make_frame(APID_EPS, 10));
+    cdhs_router_route(make_frame(APID_CDHS, 11));
+    cdhs_router_route(make_frame(APID_HOUSEKEEPING, 12));
+    expect_delivered(CDHS_DEST_EPS, APID_EPS);
+    expect_delivered(CDHS_DEST_CDHS, APID_CDHS);
+    expect_delivered(CDHS_DEST_HK, APID_HOUSEKEEPING);
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_get_apid_stats(APID_EPS, &stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.packets);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.drops);
+
+    // ADCS resumes once it drains
+    expect_delivered(CDHS_DEST_ADCS, APID_ADCS);
+    expect_delivered(CDHS_DEST_ADCS, APID_ADCS);
+    cdhs_router_route(make_frame(APID_ADCS, 13));
+    expect_delivered(CDHS_DEST_ADCS, APID_ADCS);
+    TEST_ASSERT_EQUAL(0, pool_in_use());
+}
+
+void test_destination_without_a_queue_drops() {
+    CdhsApidStats_t stats;
+    CdhsRouterStats_t router;
+
+    TEST_ASSERT_EQUAL(pdFAIL, cdhs_router_set_destination(CDHS_DEST_NONE, s_queue[CDHS_DEST_HK]));
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_set_destination(CDHS_DEST_HK, NULL));
+    cdhs_router_route(make_frame(APID_HOUSEKEEPING, 1));
+
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_get_apid_stats(APID_HOUSEKEEPING, &stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.drops);
+    cdhs_router_get_stats(&router);
+    TEST_ASSERT_EQUAL_UINT32(0, router.unrouted);       // Routed, just not deliverable
+    TEST_ASSERT_EQUAL(0, pool_in_use());
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(pdPASS, packet_pool_init(&s_pool, "UPLINK", s_frames, sizeof(CCSDS_Frame_t),
+                                               TEST_POOL_SLOTS, POOL_DROP_NEWEST, 0));
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_init(&s_pool));
+    for (int dest = CDHS_DEST_NONE + 1; dest < CDHS_DEST_COUNT; dest++) {
+        s_queue[dest] = xQueueCreate(TEST_QUEUE_DEPTH, sizeof(CCSDS_Frame_t *));
+        TEST_ASSERT_NOT_NULL(s_queue[dest]);
+        TEST_ASSERT_EQUAL(pdPASS, cdhs_router_set_destination((CdhsDestination_t)dest, s_queue[dest]));
+    }
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_default_and_registered_routes_use_the_apid_table);
+    RUN_TEST(test_malformed_crc_failures_and_unrouted_are_counted_and_released);
+    RUN_TEST(test_full_queue_does_not_stall_the_other_subsystems);
+    RUN_TEST(test_destination_without_a_queue_drops);
+
+    return UNITY_END();
+}
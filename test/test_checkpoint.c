@@ -0,0 +1,269 @@
+// test/test_checkpoint.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "checkpoint.h"          // Functions to test: init/get/write
+#include "utils.h"               // CRC-16 and cycle counter
+
+static uint8_t s_region[CHECKPOINT_REGION_BYTES];
+
+// The MODE section comes first: slot 0 at offset 0, slot 1 right after it
+#define MODE_BYTES      16
+#define MODE_SLOT_1     CHECKPOINT_SLOT_BYTES(MODE_BYTES)
+
+typedef struct {
+    uint32_t value;
+    uint32_t filler[3];
+} Record_t;
+
+// --- SYNC STUB: remembers the last range it was asked to persist ---
+static uint32_t s_syncs;
+static uint32_t s_sync_offset;
+static size_t s_sync_len;
+
+static int sync_stub(void *ctx, uint32_t offset, const void *data, size_t len) {
+    (void)ctx;
+    TEST_ASSERT_TRUE(data == s_region + offset);
+    s_syncs++;
+    s_sync_offset = offset;
+    s_sync_len = len;
+    return 0;
+}
+
+static void write_mode(uint32_t value, uint32_t tick) {
+    Record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.value = value;
+    TEST_ASSERT_EQUAL(0, checkpoint_write(CHECKPOINT_MODE, &rec, sizeof(rec), tick));
+}
+
+static int read_mode(uint32_t *value, CheckpointInfo_t *info) {
+    Record_t rec;
+    int result = checkpoint_get(CHECKPOINT_MODE, &rec, sizeof(rec), info);
+    *value = rec.value;
+    return result;
+}
+
+// Rewrites a slot header as the firmware would have, CRC included
+static void forge_generation(uint32_t slot_offset, uint32_t generation) {
+    CheckpointHeader_t hdr;
+    uint16_t crc;
+
+    memcpy(&hdr, s_region + slot_offset, sizeof(hdr));
+    hdr.generation = generation;
+    crc = crc16_update(crc16_init(), (const uint8_t *)&hdr, offsetof(CheckpointHeader_t, crc));
+    hdr.crc = crc16_final(crc16_update(crc, s_region + slot_offset + sizeof(hdr), hdr.len));
+    memcpy(s_region + slot_offset, &hdr, sizeof(hdr));
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_warm_boot_restores_newest_record() {
+    CheckpointInfo_t info;
+    CheckpointStats_t stats;
+    uint32_t value;
+
+    for (uint32_t i = 1; i <= 5; i++) {
+        write_mode(100 + i, 10 * i);
+    }
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_WATCHDOG, NULL, NULL));
+
+    TEST_ASSERT_EQUAL(0, read_mode(&value, &info));
+    TEST_ASSERT_EQUAL_UINT32(105, value);
+    TEST_ASSERT_EQUAL_UINT32(5, info.generation);
+    TEST_ASSERT_EQUAL_UINT32(0, info.boot);
+    TEST_ASSERT_EQUAL_UINT32(50, info.tick);
+
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.boot);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.restored);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.corrupt_slots);
+    TEST_ASSERT_EQUAL(CHECKPOINT_RESET_WATCHDOG, stats.reset);
+
+    // Sections nobody wrote stay empty
+    uint8_t buf[8];
+    TEST_ASSERT_EQUAL(-1, checkpoint_get(CHECKPOINT_TM_GEN, buf, sizeof(buf), NULL));
+}
+
+void test_torn_write_falls_back_to_previous_copy() {
+    CheckpointInfo_t info;
+    CheckpointStats_t stats;
+    uint32_t value;
+
+    write_mode(1, 10);          // Slot 0
+    write_mode(2, 20);          // Slot 1
+
+    // Reset halfway through the payload of the newest copy
+    s_region[MODE_SLOT_1 + sizeof(CheckpointHeader_t)] ^= 0xFF;
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_BROWNOUT, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, read_mode(&value, &info));
+    TEST_ASSERT_EQUAL_UINT32(1, value);
+    TEST_ASSERT_EQUAL_UINT32(1, info.generation);
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.corrupt_slots);
+
+    // The next write replaces the torn slot, never the good one
+    write_mode(3, 5);
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_SOFTWARE, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, read_mode(&value, &info));
+    TEST_ASSERT_EQUAL_UINT32(3, value);
+    TEST_ASSERT_EQUAL_UINT32(2, info.generation);
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.corrupt_slots);
+}
+
+void test_generation_order_survives_wrap() {
+    CheckpointInfo_t info;
+    uint32_t value;
+
+    write_mode(1, 10);          // Slot 0
+    write_mode(2, 20);          // Slot 1
+    forge_generation(0, 0xFFFFFFFFu);
+    forge_generation(MODE_SLOT_1, 0);
+
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_WATCHDOG, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, read_mode(&value, &info));
+    TEST_ASSERT_EQUAL_UINT32(2, value);
+    TEST_ASSERT_EQUAL_UINT32(0, info.generation);
+
+    write_mode(3, 30);
+    TEST_ASSERT_EQUAL(0, read_mode(&value, &info));
+    TEST_ASSERT_EQUAL_UINT32(3, value);
+    TEST_ASSERT_EQUAL_UINT32(1, info.generation);
+}
+
+void test_length_mismatch_and_oversize_rejected() {
+    CheckpointStats_t stats;
+    uint8_t small[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t big[MODE_BYTES + 1];
+    Record_t rec;
+
+    // A record from a firmware with another layout is ignored, not misread
+    TEST_ASSERT_EQUAL(0, checkpoint_write(CHECKPOINT_MODE, small, sizeof(small), 1));
+    TEST_ASSERT_EQUAL(-1, checkpoint_get(CHECKPOINT_MODE, &rec, sizeof(rec), NULL));
+    TEST_ASSERT_EQUAL(0, checkpoint_get(CHECKPOINT_MODE, small, sizeof(small), NULL));
+
+    memset(big, 0, sizeof(big));
+    TEST_ASSERT_EQUAL(-1, checkpoint_write(CHECKPOINT_MODE, big, sizeof(big), 1));
+    TEST_ASSERT_EQUAL(-1, checkpoint_write(CHECKPOINT_SECTION_COUNT, small, sizeof(small), 1));
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.write_errors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.writes);
+}
+
+void test_power_on_wipes_region() {
+    static const uint8_t zero[CHECKPOINT_REGION_BYTES];
+    CheckpointStats_t stats;
+    uint32_t value;
+
+    write_mode(7, 10);
+    s_syncs = 0;
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_POWER_ON, sync_stub, NULL));
+    TEST_ASSERT_EQUAL(-1, read_mode(&value, NULL));
+    TEST_ASSERT_EQUAL_MEMORY(zero, s_region, CHECKPOINT_REGION_BYTES);
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.boot);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.restored);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.last_alive_valid);
+
+    // The wiped region is persisted in one go, each write as its own slot
+    TEST_ASSERT_EQUAL_UINT32(1, s_syncs);
+    TEST_ASSERT_EQUAL_UINT32(CHECKPOINT_REGION_BYTES, s_sync_len);
+    write_mode(8, 20);
+    write_mode(9, 30);
+    TEST_ASSERT_EQUAL_UINT32(3, s_syncs);
+    TEST_ASSERT_EQUAL_UINT32(MODE_SLOT_1, s_sync_offset);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(CheckpointHeader_t) + sizeof(Record_t), s_sync_len);
+}
+
+void test_boot_count_and_last_sign_of_life() {
+    CheckpointInfo_t info;
+    CheckpointStats_t stats;
+    uint32_t value, heartbeat = 1;
+
+    // Boot 0 goes down at tick 700
+    TEST_ASSERT_EQUAL(0, checkpoint_write(CHECKPOINT_TM_GEN, &heartbeat, sizeof(heartbeat), 500));
+    write_mode(1, 700);
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_WATCHDOG, NULL, NULL));
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.boot);
+    TEST_ASSERT_EQUAL_UINT8(1, stats.last_alive_valid);
+    TEST_ASSERT_EQUAL_UINT32(700, stats.last_alive_tick);
+
+    // Boot 1 only beats once, at tick 50: older records do not count
+    heartbeat = 2;
+    TEST_ASSERT_EQUAL(0, checkpoint_write(CHECKPOINT_TM_GEN, &heartbeat, sizeof(heartbeat), 50));
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_PANIC, NULL, NULL));
+    checkpoint_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.boot);
+    TEST_ASSERT_EQUAL_UINT32(50, stats.last_alive_tick);
+
+    // The MODE record is still boot 0's
+    TEST_ASSERT_EQUAL(0, read_mode(&value, &info));
+    TEST_ASSERT_EQUAL_UINT32(0, info.boot);
+    TEST_ASSERT_EQUAL_UINT32(700, info.tick);
+}
+
+void test_benchmark_restore_and_write() {
+    static const uint16_t bytes[CHECKPOINT_SECTION_COUNT] = {
+#define SECTION_BYTES(name, reserved) reserved,
+        CHECKPOINT_TABLE(SECTION_BYTES)
+#undef SECTION_BYTES
+    };
+    static uint8_t payload[1024];
+    CheckpointStats_t stats;
+    uint32_t restore_min = UINT32_MAX, write_min = UINT32_MAX;
+
+    // Every section full, both slots written
+    memset(payload, 0xA5, sizeof(payload));
+    for (int pass = 0; pass < 2; pass++) {
+        for (int s = 0; s < CHECKPOINT_SECTION_COUNT; s++) {
+            TEST_ASSERT_EQUAL(0, checkpoint_write((CheckpointSection_t)s, payload, bytes[s], 100));
+        }
+    }
+
+    for (int i = 0; i < 200; i++) {
+        uint32_t c0 = util_get_cycle_count();
+        checkpoint_init(s_region, CHECKPOINT_RESET_WATCHDOG, NULL, NULL);
+        uint32_t c1 = util_get_cycle_count();
+        checkpoint_write(CHECKPOINT_MODE, payload, MODE_BYTES, 200);
+        uint32_t c2 = util_get_cycle_count();
+        if (c1 - c0 < restore_min) restore_min = c1 - c0;
+        if (c2 - c1 < write_min) write_min = c2 - c1;
+    }
+
+    checkpoint_get_stats(&stats);
+    printf("CHECKPOINT: restore of %d sections (%u B region) %lu cycles, %lu us | MODE write %lu cycles\n",
+           CHECKPOINT_SECTION_COUNT, (unsigned)CHECKPOINT_REGION_BYTES, (unsigned long)restore_min,
+           (unsigned long)stats.restore_us, (unsigned long)write_min);
+    TEST_ASSERT_EQUAL_UINT32(CHECKPOINT_SECTION_COUNT, stats.restored);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.corrupt_slots);
+    TEST_ASSERT_TRUE(write_min < restore_min);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    memset(s_region, 0xEE, sizeof(s_region));       // RTC memory after power-up
+    TEST_ASSERT_EQUAL(0, checkpoint_init(s_region, CHECKPOINT_RESET_POWER_ON, NULL, NULL));
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_warm_boot_restores_newest_record);
+    RUN_TEST(test_torn_write_falls_back_to_previous_copy);
+    RUN_TEST(test_generation_order_survives_wrap);
+    RUN_TEST(test_length_mismatch_and_oversize_rejected);
+    RUN_TEST(test_power_on_wipes_region);
+    RUN_TEST(test_boot_count_and_last_sign_of_life);
+    RUN_TEST(test_benchmark_restore_and_write);
+
+    return UNITY_END();
+}
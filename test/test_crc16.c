@@ -0,0 +1,130 @@
+// test/test_crc16.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "crc16.h"               // Functions to test: crc16_init/update/final and back-ends
+#include "utils.h"               // crc16_ccitt, util_get_cycle_count
+
+typedef uint16_t (*crc16_backend_fn)(uint16_t crc, const uint8_t *data, size_t length);
+
+static const struct {
+    const char *name;
+    crc16_backend_fn fn;
+} backends[] = {
+    { "bitwise", crc16_update_bitwise },
+    { "table",   crc16_update_table },
+    { "slice4",  crc16_update_slice4 },
+    { "slice8",  crc16_update_slice8 },
+};
+#define BACKEND_COUNT (sizeof(backends) / sizeof(backends[0]))
+
+#define BENCH_FRAME_SIZE 1024
+#define BENCH_ROUNDS     200
+
+static uint8_t test_buffer[BENCH_FRAME_SIZE];
+
+// Simple LCG so the data is repeatable across runs
+static void fill_pseudo_random(uint8_t *buf, size_t len, uint32_t seed) {
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_all_backends_match_check_value() {
+    const uint8_t check[] = "123456789";
+
+    for (size_t b = 0; b < BACKEND_COUNT; b++) {
+        uint16_t crc = backends[b].fn(CRC16_INITIAL, check, 9);
+        TEST_ASSERT_EQUAL_HEX16(0x29B1, crc);
+    }
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16_ccitt(check, 9));
+}
+
+void test_backends_agree_on_every_length_and_alignment() {
+    fill_pseudo_random(test_buffer, sizeof(test_buffer), 0xC0FFEE);
+
+    // Odd offsets and lengths exercise the slice tails and unaligned starts
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len < 64; len++) {
+            uint16_t ref = crc16_update_bitwise(CRC16_INITIAL, &test_buffer[offset], len);
+            for (size_t b = 1; b < BACKEND_COUNT; b++) {
+                TEST_ASSERT_EQUAL_HEX16(ref, backends[b].fn(CRC16_INITIAL, &test_buffer[offset], len));
+            }
+        }
+    }
+}
+
+void test_streaming_split_matches_one_shot() {
+    fill_pseudo_random(test_buffer, 300, 42);
+    uint16_t one_shot = crc16_ccitt(test_buffer, 300);
+
+    // Split the frame at every possible point, as if it arrived in two DMA buffers
+    for (size_t split = 0; split <= 300; split++) {
+        uint16_t crc = crc16_init();
+        crc = crc16_update(crc, test_buffer, split);
+        crc = crc16_update(crc, &test_buffer[split], 300 - split);
+        TEST_ASSERT_EQUAL_HEX16(one_shot, crc16_final(crc));
+    }
+}
+
+void test_telecommand_crc_unchanged() {
+    // Same computation as process_telecommand(): the wire CRC must not change
+    uint8_t packet[14] = { 0x88, 0x13, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01 };
+    TEST_ASSERT_EQUAL_HEX16(crc16_update_bitwise(CRC16_INITIAL, packet, sizeof(packet)),
+                            crc16_ccitt(packet, sizeof(packet)));
+}
+
+void test_benchmark_bytes_per_cycle() {
+    fill_pseudo_random(test_buffer, sizeof(test_buffer), 7);
+    uint32_t baseline_cycles = 0;
+    volatile uint16_t sink = 0;
+
+    printf("CRC16 BENCH: %d bytes x %d rounds (CRC16_BACKEND=%d)\n",
+           BENCH_FRAME_SIZE, BENCH_ROUNDS, CRC16_BACKEND);
+
+    for (size_t b = 0; b < BACKEND_COUNT; b++) {
+        uint32_t start = util_get_cycle_count();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            sink ^= backends[b].fn(CRC16_INITIAL, test_buffer, sizeof(test_buffer));
+        }
+        uint32_t cycles = util_get_cycle_count() - start;
+        if (b == 0) {
+            baseline_cycles = cycles;
+        }
+
+        double bytes = (double)BENCH_FRAME_SIZE * BENCH_ROUNDS;
+        printf("CRC16 BENCH: %-8s %8.3f bytes/cycle  %6.2f cycles/byte  speedup x%.1f\n",
+               backends[b].name,
+               bytes / (double)cycles,
+               (double)cycles / bytes,
+               (double)baseline_cycles / (double)cycles);
+    }
+    (void)sink;
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    memset(test_buffer, 0, sizeof(test_buffer));
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_all_backends_match_check_value);
+    RUN_TEST(test_backends_agree_on_every_length_and_alignment);
+    RUN_TEST(test_streaming_split_matches_one_shot);
+    RUN_TEST(test_telecommand_crc_unchanged);
+    RUN_TEST(test_benchmark_bytes_per_cycle);
+
+    return UNITY_END();
+}
@@ -0,0 +1,313 @@
+// test/test_downlink.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "downlink.h"            // Functions to test: pass_begin/service/pass_end
+#include "tm_archive.h"
+#include "flash_backend.h"
+#include "ccsds_packet.h"
+#include "hk_compress.h"
+#include "packet_schema.h"
+#include "satellite_types.h"
+
+#define TEST_IMAGE        "test_downlink.bin"
+#define TEST_SECTOR_SIZE  4096
+#define TEST_SECTORS      16
+#define TEST_RECORDS      1000
+#define LINK_RATE_BPS     9600
+#define SERVICE_MS        10     // One FreeRTOS tick at 100 Hz
+
+static FlashBackend_t s_flash;
+static TmArchive_t s_archive;
+static Downlink_t s_downlink;
+
+// --- RADIO STUB: records the timestamp of every packet it is given ---
+static uint32_t s_sent_ts[TEST_RECORDS * 2];
+static uint32_t s_sent_count;
+static uint8_t s_seen[TEST_RECORDS];
+static uint32_t s_duplicates;
+static uint32_t s_sample_sets;
+
+static void record_sent(uint32_t ts) {
+    s_sent_ts[s_sent_count++] = ts;
+    if (ts < TEST_RECORDS) {
+        s_duplicates += s_seen[ts];
+        s_seen[ts] = 1;
+    }
+}
+
+static int radio_stub(void *ctx, const uint8_t *frame, size_t len) {
+    CCSDS_PrimaryHeader_t hdr;
+    HK_Telemetry_t unpacked[CCSDS_MAX_PACKET_LEN];
+    size_t user_len = 0, count = 0;
+    (void)ctx;
+
+    TEST_ASSERT_EQUAL(0, ccsds_decode_primary(frame, len, &hdr));
+    const uint8_t *user = ccsds_user_data(frame, &hdr, &user_len);
+
+    if (hdr.apid == APID_HK_COMPRESSED) {
+        TEST_ASSERT_EQUAL(0, hk_decode_frame(user, user_len, unpacked, CCSDS_MAX_PACKET_LEN, &count));
+        for (size_t i = 0; i < count; i++) {
+            record_sent(unpacked[i].timestamp);
+        }
+    } else if (hdr.apid == APID_HK_SAMPLES) {
+        s_sample_sets++;
+        record_sent((uint32_t)ccsds_get_be64(&frame[CCSDS_PRIMARY_HEADER_LEN]));
+    } else {
+        TEST_ASSERT_EQUAL(APID_HOUSEKEEPING, hdr.apid);
+        record_sent((uint32_t)ccsds_get_be64(&frame[CCSDS_PRIMARY_HEADER_LEN]));
+    }
+    return 0;
+}
+
+static void fill_archive(uint32_t from, uint32_t to) {
+    HK_Telemetry_t pkt;
+    uint8_t wire[HK_TM_WIRE_LEN];
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.bus_voltage = 3.3f;
+    for (uint32_t ts = from; ts < to; ts++) {
+        pkt.timestamp = ts;
+        pkt.sequence_count = (uint16_t)ts;
+        tm_archive_append(&s_archive, ts, wire, (uint16_t)hk_tm_pack(&pkt, wire));
+    }
+    tm_archive_flush(&s_archive);
+}
+
+// Runs one pass the way vDataLoggerTask does: a service call every tick
+static void run_pass(uint32_t *clock_ms, uint32_t duration_ms) {
+    TEST_ASSERT_EQUAL(0, downlink_pass_begin(&s_downlink, *clock_ms, duration_ms));
+    while (downlink_is_active(&s_downlink)) {
+        *clock_ms += SERVICE_MS;
+        downlink_service(&s_downlink, *clock_ms);
+    }
+}
+
+static uint32_t frame_len(void) {
+    return DOWNLINK_FRAME_OVERHEAD + HK_TM_WIRE_LEN;
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_oldest_first_paces_to_link_rate() {
+    DownlinkPassStats_t pass;
+    uint32_t clock_ms = 0;
+
+    fill_archive(0, TEST_RECORDS);
+    run_pass(&clock_ms, 10000);
+    downlink_get_last_pass(&s_downlink, &pass);
+
+    printf("DOWNLINK PASS: %u frames, %u/%u B (%u%%), backlog %u records / %u B\n",
+           pass.frames_sent, pass.bytes_sent, pass.budget_bytes, pass.utilization_pct,
+           pass.backlog_records, pass.backlog_bytes);
+
+    // Never above the budget, and the token bucket wastes almost none of it
+    TEST_ASSERT_LESS_OR_EQUAL(pass.budget_bytes + DOWNLINK_BURST_BYTES, pass.bytes_sent);
+    TEST_ASSERT_GREATER_OR_EQUAL(95, pass.utilization_pct);
+    TEST_ASSERT_EQUAL_UINT32(pass.bytes_sent, pass.frames_sent * frame_len());
+
+    // Chronological, and the backlog accounts for exactly the rest
+    for (uint32_t i = 0; i < s_sent_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, s_sent_ts[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS - pass.frames_sent, pass.backlog_records);
+    TEST_ASSERT_EQUAL_UINT32(pass.backlog_records * frame_len(), pass.backlog_bytes);
+}
+
+void test_next_pass_resumes_without_resending() {
+    DownlinkPassStats_t pass;
+    uint32_t clock_ms = 0;
+
+    fill_archive(0, TEST_RECORDS);
+
+    // Short passes end mid-page; keep going until the backlog is empty
+    for (int i = 0; i < 20; i++) {
+        run_pass(&clock_ms, 3000);
+        clock_ms += 90 * 60 * 1000;     // One orbit to the next pass
+        downlink_get_last_pass(&s_downlink, &pass);
+        if (pass.backlog_records == 0) {
+            break;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, pass.backlog_records);
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS, s_sent_count);
+    TEST_ASSERT_EQUAL_UINT32(0, s_duplicates);
+    for (uint32_t i = 0; i < s_sent_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, s_sent_ts[i]);
+    }
+    printf("DOWNLINK RESUME: %u records over %u passes, 0 resent\n", s_sent_count, pass.pass_number);
+}
+
+void test_newest_first_sends_latest_data_first() {
+    DownlinkPassStats_t pass;
+    uint32_t clock_ms = 0;
+
+    downlink_set_policy(&s_downlink, DOWNLINK_NEWEST_FIRST);
+    fill_archive(0, TEST_RECORDS);
+    run_pass(&clock_ms, 2000);
+
+    // First frame comes from the newest page; records ascend within a page and
+    // every step back in time lands on the page just before
+    uint32_t per_page = (TM_ARCHIVE_PAGE_SIZE - sizeof(TmArchivePageHeader_t)) /
+                        (TM_ARCHIVE_RECORD_HDR_LEN + HK_TM_WIRE_LEN);
+    TEST_ASSERT_GREATER_OR_EQUAL(TEST_RECORDS - per_page, s_sent_ts[0]);
+    for (uint32_t i = 1; i < s_sent_count; i++) {
+        if (s_sent_ts[i] < s_sent_ts[i - 1]) {
+            TEST_ASSERT_LESS_OR_EQUAL(2 * per_page, s_sent_ts[i - 1] - s_sent_ts[i]);
+        }
+    }
+
+    // New HK arrives between passes: it goes out before the older backlog
+    fill_archive(TEST_RECORDS, TEST_RECORDS + 10);
+    uint32_t before = s_sent_count;
+    run_pass(&clock_ms, 100000);
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS, s_sent_ts[before]);
+
+    downlink_get_last_pass(&s_downlink, &pass);
+    TEST_ASSERT_EQUAL_UINT32(0, pass.backlog_records);
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS + 10, s_sent_count);
+    TEST_ASSERT_EQUAL_UINT32(0, s_duplicates);
+}
+
+void test_sector_reuse_clears_sent_marks() {
+    DownlinkPassStats_t pass;
+    uint32_t clock_ms = 0;
+    uint32_t capacity_records;
+
+    fill_archive(0, 200);
+    run_pass(&clock_ms, 100000);
+    TEST_ASSERT_EQUAL_UINT32(200, s_sent_count);
+
+    // Wrap the whole log: every page sent before now holds new data
+    capacity_records = TEST_SECTORS * (TEST_SECTOR_SIZE / TM_ARCHIVE_PAGE_SIZE) * 18;
+    fill_archive(100000, 100000 + capacity_records);
+    run_pass(&clock_ms, 1000);
+    downlink_get_last_pass(&s_downlink, &pass);
+
+    TEST_ASSERT_GREATER_OR_EQUAL(100000, s_sent_ts[200]);
+    TEST_ASSERT_GREATER_THAN(0, pass.backlog_records);
+}
+
+void test_compressed_frames_multiply_records_per_pass() {
+    DownlinkPassStats_t plain, packed;
+    uint32_t clock_ms = 0;
+
+    fill_archive(0, TEST_RECORDS);
+    run_pass(&clock_ms, 2000);
+    downlink_get_last_pass(&s_downlink, &plain);
+
+    downlink_set_compression(&s_downlink, 1);
+    run_pass(&clock_ms, 2000);
+    downlink_get_last_pass(&s_downlink, &packed);
+
+    printf("DOWNLINK COMPRESSION: 2 s pass, plain %u records in %u B, compressed %u records in %u B\n",
+           plain.records_sent, plain.bytes_sent, packed.records_sent, packed.bytes_sent);
+    TEST_ASSERT_GREATER_OR_EQUAL(3 * plain.records_sent, packed.records_sent);
+
+    // Still in order, still no resends, and the rest drains in compressed frames
+    run_pass(&clock_ms, 100000);
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS, s_sent_count);
+    TEST_ASSERT_EQUAL_UINT32(0, s_duplicates);
+    for (uint32_t i = 0; i < s_sent_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, s_sent_ts[i]);
+    }
+}
+
+void test_record_kind_selects_apid() {
+    uint8_t set[12] = { 0 };
+    uint32_t clock_ms = 0;
+
+    // HK records around a run of multi-rate sample sets, compression on
+    fill_archive(0, 400);
+    for (uint32_t ts = 400; ts < 600; ts++) {
+        TEST_ASSERT_EQUAL(0, tm_archive_append_kind(&s_archive, TM_RECORD_HK_SAMPLES, ts, set, sizeof(set)));
+    }
+    fill_archive(600, TEST_RECORDS);
+    downlink_set_compression(&s_downlink, 1);
+    run_pass(&clock_ms, 100000);
+
+    // Sample sets go down one per packet on their own APID, never into an HK frame
+    TEST_ASSERT_EQUAL_UINT32(200, s_sample_sets);
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS, s_sent_count);
+    TEST_ASSERT_EQUAL_UINT32(0, s_duplicates);
+    for (uint32_t i = 0; i < s_sent_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, s_sent_ts[i]);
+    }
+}
+
+void test_resume_state_survives_a_reset() {
+    DownlinkResume_t saved;
+    DownlinkPassStats_t pass;
+    uint32_t clock_ms = 0;
+
+    fill_archive(0, TEST_RECORDS);
+    run_pass(&clock_ms, 3000);
+
+    // Reset in the middle of the second pass: only the snapshot and the flash survive
+    TEST_ASSERT_EQUAL(0, downlink_pass_begin(&s_downlink, clock_ms, 100000));
+    for (int i = 0; i < 150; i++) {
+        clock_ms += SERVICE_MS;
+        downlink_service(&s_downlink, clock_ms);
+    }
+    downlink_save_resume(&s_downlink, &saved);
+    uint16_t tm_sequence = s_downlink.tm_sequence;
+    uint32_t sent_before = s_sent_count;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_mount(&s_archive, &s_flash));
+    TEST_ASSERT_EQUAL(0, downlink_init(&s_downlink, &s_archive, LINK_RATE_BPS,
+                                       DOWNLINK_OLDEST_FIRST, radio_stub, NULL));
+    TEST_ASSERT_GREATER_THAN(0, downlink_restore_resume(&s_downlink, &saved));
+    TEST_ASSERT_EQUAL_UINT16(tm_sequence, s_downlink.tm_sequence);
+
+    // The next pass is number 3 and picks up at the record the reset cut off
+    run_pass(&clock_ms, 100000);
+    downlink_get_last_pass(&s_downlink, &pass);
+    TEST_ASSERT_EQUAL_UINT32(3, pass.pass_number);
+    TEST_ASSERT_EQUAL_UINT32(0, pass.backlog_records);
+    TEST_ASSERT_EQUAL_UINT32(TEST_RECORDS, s_sent_count);
+    TEST_ASSERT_EQUAL_UINT32(0, s_duplicates);
+    TEST_ASSERT_EQUAL_UINT32(sent_before, s_sent_ts[sent_before]);
+
+    // A reformatted archive is behind the snapshot: none of its marks apply
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    fill_archive(0, 100);
+    TEST_ASSERT_EQUAL(0, downlink_init(&s_downlink, &s_archive, LINK_RATE_BPS,
+                                       DOWNLINK_OLDEST_FIRST, radio_stub, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, downlink_restore_resume(&s_downlink, &saved));
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    remove(TEST_IMAGE);
+    TEST_ASSERT_EQUAL(0, flash_file_open(&s_flash, TEST_IMAGE, TEST_SECTOR_SIZE, TEST_SECTORS));
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    TEST_ASSERT_EQUAL(0, downlink_init(&s_downlink, &s_archive, LINK_RATE_BPS,
+                                       DOWNLINK_OLDEST_FIRST, radio_stub, NULL));
+    memset(s_seen, 0, sizeof(s_seen));
+    s_sent_count = 0;
+    s_duplicates = 0;
+    s_sample_sets = 0;
+}
+
+void tearDown(void) {
+    flash_file_close(&s_flash);
+    remove(TEST_IMAGE);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_oldest_first_paces_to_link_rate);
+    RUN_TEST(test_next_pass_resumes_without_resending);
+    RUN_TEST(test_newest_first_sends_latest_data_first);
+    RUN_TEST(test_sector_reuse_clears_sent_marks);
+    RUN_TEST(test_compressed_frames_multiply_records_per_pass);
+    RUN_TEST(test_record_kind_selects_apid);
+    RUN_TEST(test_resume_state_survives_a_reset);
+
+    return UNITY_END();
+}
@@ -0,0 +1,227 @@
+// test/test_eps_filter.c
+
+#include <unity.h>
+#include "eps_filter.h"
+#include "eps_source.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Links against src/eps_filter.c, src/eps_source_synth.c and src/utils.c.
+// Mirrors the flight settings in eps_control.h.
+#define RATE_HZ         1000
+#define BATCH           100
+#define EWMA_SHIFT      6
+
+static const EpsFdirConfig_t s_fdir_config = { 2500, 2700, 2, 10 };
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// Records `seconds` of a synthetic bus into a heap buffer
+static uint16_t *record_trace(EpsSynthConfig_t *cfg, uint32_t seconds, size_t *count) {
+    EpsSampleSource_t source;
+    *count = (size_t)seconds * RATE_HZ;
+    uint16_t *trace = malloc(*count * sizeof(uint16_t));
+
+    eps_source_synth_open(&source, cfg, RATE_HZ);
+    source.read(source.ctx, trace, *count);
+    return trace;
+}
+
+// Runs the flight pipeline over a trace. Returns the sample index of the
+// batch that tripped first (-1 if none) and counts the state changes.
+static long run_pipeline(const uint16_t *trace, size_t count, uint32_t *transitions) {
+    EpsFilter_t filter;
+    EpsFdir_t fdir;
+    EpsBatchResult_t result;
+    EpsHealth_t state = EPS_HEALTH_NOMINAL;
+    long first_trip = -1;
+
+    eps_filter_init(&filter, trace[0], EWMA_SHIFT);
+    TEST_ASSERT_EQUAL(0, eps_fdir_init(&fdir, &s_fdir_config));
+    *transitions = 0;
+
+    for (size_t at = 0; at + BATCH <= count; at += BATCH) {
+        eps_filter_run(&filter, &trace[at], BATCH, &result);
+        EpsHealth_t next = eps_fdir_update(&fdir, result.mean_min_mv);
+        if (next != state) {
+            (*transitions)++;
+            if (next == EPS_HEALTH_UNDERVOLTAGE && first_trip < 0) {
+                first_trip = (long)(at + BATCH);
+            }
+        }
+        state = next;
+    }
+    return first_trip;
+}
+
+// --- Float reference: same kernels and thresholds in single precision ---
+
+typedef struct {
+    float window[EPS_FILTER_MA_WINDOW];
+    float sum;
+    float ewma;
+    uint32_t index;
+    int below, above, tripped;
+} FloatPipeline_t;
+
+static long run_float_pipeline(const uint16_t *trace, size_t count) {
+    FloatPipeline_t p;
+    long first_trip = -1;
+
+    memset(&p, 0, sizeof(p));
+    for (int i = 0; i < EPS_FILTER_MA_WINDOW; i++) {
+        p.window[i] = trace[0] / 1000.0f;
+    }
+    p.sum = p.window[0] * EPS_FILTER_MA_WINDOW;
+    p.ewma = p.window[0];
+
+    for (size_t at = 0; at + BATCH <= count; at += BATCH) {
+        float mean_min = 1e9f;
+        for (size_t i = at; i < at + BATCH; i++) {
+            float v = trace[i] / 1000.0f;
+            uint32_t slot = p.index++ % EPS_FILTER_MA_WINDOW;
+            p.sum += v - p.window[slot];
+            p.window[slot] = v;
+            float mean = p.sum / EPS_FILTER_MA_WINDOW;
+            if (mean < mean_min) mean_min = mean;
+            p.ewma += (v - p.ewma) * (1.0f / 64.0f);
+        }
+        if (!p.tripped) {
+            p.below = (mean_min < 2.5f) ? p.below + 1 : 0;
+            if (p.below >= 2) {
+                p.tripped = 1;
+                p.above = 0;
+                if (first_trip < 0) first_trip = (long)(at + BATCH);
+            }
+        } else {
+            p.above = (mean_min >= 2.7f) ? p.above + 1 : 0;
+            if (p.above >= 10) {
+                p.tripped = 0;
+                p.below = 0;
+            }
+        }
+    }
+    return first_trip;
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_kernels_track_the_input(void) {
+    EpsFilter_t filter;
+    EpsBatchResult_t result;
+    uint16_t samples[64];
+
+    eps_filter_init(&filter, 3300, EWMA_SHIFT);
+    for (int i = 0; i < 64; i++) {
+        samples[i] = (uint16_t)(3000 + (i % 16) * 10);  // Window mean 3075
+    }
+    eps_filter_run(&filter, samples, 64, &result);
+
+    TEST_ASSERT_EQUAL_UINT16(3075, result.mean_mv);
+    TEST_ASSERT_EQUAL_UINT16(3000, result.min_mv);
+    TEST_ASSERT_EQUAL_UINT16(3150, result.max_mv);
+    TEST_ASSERT_EQUAL_UINT16(3075, result.mean_min_mv);     // Fell monotonically from 3300
+
+    // EWMA converges on a step without overshoot, both directions
+    for (int i = 0; i < 64; i++) samples[i] = 2400;
+    for (int i = 0; i < 20; i++) eps_filter_run(&filter, samples, 64, &result);
+    TEST_ASSERT_UINT_WITHIN(1, 2400, result.ewma_mv);
+    for (int i = 0; i < 64; i++) samples[i] = 3300;
+    for (int i = 0; i < 20; i++) eps_filter_run(&filter, samples, 64, &result);
+    TEST_ASSERT_UINT_WITHIN(1, 3300, result.ewma_mv);
+}
+
+void test_sag_is_detected_within_a_second(void) {
+    EpsSynthConfig_t bus = { .nominal_mv = 3300, .fault_mv = 2400, .noise_mv = 30,
+                             .fault_onset_ms = 10000, .rng = 1 };
+    uint32_t transitions;
+    size_t count;
+    uint16_t *trace = record_trace(&bus, 20, &count);
+
+    long trip = run_pipeline(trace, count, &transitions);
+    long latency_ms = (trip - 10 * RATE_HZ) * 1000 / RATE_HZ;
+    printf("EPS FILTER: sag detected %ld ms after onset\n", latency_ms);
+
+    TEST_ASSERT_TRUE(trip > 0);
+    TEST_ASSERT_TRUE(latency_ms > 0 && latency_ms <= 300);
+    TEST_ASSERT_EQUAL_UINT32(1, transitions);
+    free(trace);
+}
+
+void test_glitches_do_not_trip(void) {
+    // A 1.5 V single-sample dip every 50 ms for a minute
+    EpsSynthConfig_t bus = { .nominal_mv = 3300, .noise_mv = 30, .glitch_mv = 1500,
+                             .glitch_every = 50, .rng = 2 };
+    uint32_t transitions;
+    size_t count;
+    uint16_t *trace = record_trace(&bus, 60, &count);
+
+    TEST_ASSERT_EQUAL(-1, run_pipeline(trace, count, &transitions));
+    TEST_ASSERT_EQUAL_UINT32(0, transitions);
+    free(trace);
+}
+
+void test_hysteresis_does_not_chatter(void) {
+    // Bus hovering on the trip point: one trip, no recovery below clear_mv
+    EpsSynthConfig_t bus = { .nominal_mv = 2510, .noise_mv = 80, .rng = 3 };
+    uint32_t transitions;
+    size_t count;
+    uint16_t *trace = record_trace(&bus, 60, &count);
+
+    TEST_ASSERT_TRUE(run_pipeline(trace, count, &transitions) > 0);
+    TEST_ASSERT_EQUAL_UINT32(1, transitions);
+    free(trace);
+
+    // Recovery needs clear_batches in a row at clear_mv
+    EpsFdir_t fdir;
+    eps_fdir_init(&fdir, &s_fdir_config);
+    eps_fdir_update(&fdir, 2000);
+    TEST_ASSERT_EQUAL(EPS_HEALTH_UNDERVOLTAGE, eps_fdir_update(&fdir, 2000));
+    for (int i = 0; i < 9; i++) {
+        TEST_ASSERT_EQUAL(EPS_HEALTH_UNDERVOLTAGE, eps_fdir_update(&fdir, 2800));
+    }
+    TEST_ASSERT_EQUAL(EPS_HEALTH_NOMINAL, eps_fdir_update(&fdir, 2800));
+
+    EpsFdirConfig_t bad = { 2500, 2500, 2, 10 };
+    TEST_ASSERT_EQUAL(-1, eps_fdir_init(&fdir, &bad));
+}
+
+// Fixed point against the float reference over an hour of noisy, glitchy
+// bus with a sag at the end: same decision, and the cost per sample.
+void test_fixed_point_against_float_benchmark(void) {
+    EpsSynthConfig_t bus = { .nominal_mv = 3300, .fault_mv = 2400, .noise_mv = 40,
+                             .glitch_mv = 900, .glitch_every = 7919,
+                             .fault_onset_ms = 3590000, .rng = 4 };
+    uint32_t transitions;
+    size_t count;
+    uint16_t *trace = record_trace(&bus, 3600, &count);
+
+    uint32_t c0 = util_get_cycle_count();
+    long fixed_trip = run_pipeline(trace, count, &transitions);
+    uint32_t c1 = util_get_cycle_count();
+    long float_trip = run_float_pipeline(trace, count);
+    uint32_t c2 = util_get_cycle_count();
+
+    printf("EPS FILTER: %lu samples, fixed %.2f cycles/sample, float %.2f cycles/sample (trip at %ld / %ld)\n",
+           (unsigned long)count, (double)(c1 - c0) / count, (double)(c2 - c1) / count,
+           fixed_trip, float_trip);
+    TEST_ASSERT_EQUAL(float_trip, fixed_trip);
+    TEST_ASSERT_EQUAL_UINT32(1, transitions);
+    free(trace);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_kernels_track_the_input);
+    RUN_TEST(test_sag_is_detected_within_a_second);
+    RUN_TEST(test_glitches_do_not_trip);
+    RUN_TEST(test_hysteresis_does_not_chatter);
+    RUN_TEST(test_fixed_point_against_float_benchmark);
+    return UNITY_END();
+}
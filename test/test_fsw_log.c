@@ -0,0 +1,153 @@
+// test/test_fsw_log.c
+
+#include <unity.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "fsw_log.h"
+#include "state_manager.h"
+#include "satellite_types.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+// Links against src/fsw_log.c, src/test_state_manager.c and src/utils.c
+SemaphoreHandle_t xModeMutex;
+
+TickType_t xTaskGetTickCount(void) {
+    return 0;
+}
+
+void setUp(void) {
+    fsw_log_init();
+}
+
+void tearDown(void) {
+}
+
+static void pop_line(char *line, size_t len) {
+    FswLogRecord_t record;
+    TEST_ASSERT_EQUAL(0, fsw_log_pop(&record));
+    fsw_log_format(&record, line, len);
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_record_formats_like_printf(void) {
+    char line[FSW_LOG_LINE_MAX], expected[FSW_LOG_LINE_MAX];
+    const char *mode = "NOMINAL";
+
+    FSW_LOGI(LOG_MOD_TM, "TM GEN: %s at %.2f V, T: %lu, 100%% 0x%04X\n",
+             mode, (double)3.3f, (unsigned long)4000000000u, 0xBEEFu);
+    FSW_LOGI(LOG_MOD_TM, "TM GEN: no arguments\n");
+    FSW_LOGI(LOG_MOD_TM, "TM GEN: %d\n", -7);
+
+    snprintf(expected, sizeof(expected), "TM GEN: %s at %.2f V, T: %lu, 100%% 0x%04X\n",
+             mode, (double)3.3f, (unsigned long)4000000000u, 0xBEEFu);
+    pop_line(line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING(expected, line);
+    pop_line(line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("TM GEN: no arguments\n", line);
+    pop_line(line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("TM GEN: -7\n", line);
+
+    // Truncation keeps the string terminated
+    FSW_LOGI(LOG_MOD_TM, "TM GEN: %s\n", "a long tail that does not fit");
+    pop_line(line, 12);
+    TEST_ASSERT_EQUAL_STRING("TM GEN: a l", line);
+}
+
+void test_levels_and_module_filter(void) {
+    FswLogRecord_t record;
+    FswLogStats_t stats;
+
+    FSW_LOGD(LOG_MOD_EPS, "EPS MON: debug is off by default\n");
+    TEST_ASSERT_EQUAL(-1, fsw_log_pop(&record));
+
+    fsw_log_set_level(LOG_MOD_EPS, LOG_LEVEL_DEBUG);
+    fsw_log_set_level(LOG_MOD_TC, LOG_LEVEL_ERROR);
+    FSW_LOGD(LOG_MOD_EPS, "EPS MON: now on\n");
+    FSW_LOGW(LOG_MOD_TC, "TC PROC: filtered\n");
+    FSW_LOGE(LOG_MOD_TC, "TC PROC: kept\n");
+
+    TEST_ASSERT_EQUAL(0, fsw_log_pop(&record));
+    TEST_ASSERT_EQUAL(LOG_MOD_EPS, record.site->module);
+    TEST_ASSERT_EQUAL(0, fsw_log_pop(&record));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, record.site->level);
+    TEST_ASSERT_EQUAL(-1, fsw_log_pop(&record));
+
+    fsw_log_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.written);
+}
+
+void test_full_ring_drops_newest_and_counts(void) {
+    FswLogRecord_t record;
+    FswLogStats_t stats;
+
+    for (int i = 0; i < FSW_LOG_RING_DEPTH + 5; i++) {
+        FSW_LOGI(LOG_MOD_LOGGER, "DATA LOGGER: record %d\n", i);
+    }
+    fsw_log_get_stats(&stats);
+    TEST_ASSERT_EQUAL(FSW_LOG_RING_DEPTH, stats.written);
+    TEST_ASSERT_EQUAL(5, stats.dropped);
+    TEST_ASSERT_EQUAL(FSW_LOG_RING_DEPTH, stats.high_water);
+
+    // The oldest records survive
+    TEST_ASSERT_EQUAL(0, fsw_log_pop(&record));
+    TEST_ASSERT_EQUAL(0, record.args[0].i);
+
+    // One drain reports the loss once and empties the ring
+    TEST_ASSERT_EQUAL(FSW_LOG_RING_DEPTH - 1, fsw_log_drain(UINT32_MAX));
+    fsw_log_get_stats(&stats);
+    TEST_ASSERT_EQUAL(FSW_LOG_RING_DEPTH - 1, stats.drained);
+    TEST_ASSERT_EQUAL(-1, fsw_log_pop(&record));
+}
+
+// The mode-change report used to be formatted and written by the caller.
+// Compares that cost with the deferred record on this machine; unbuffered
+// /dev/null stands in for the UART (which is far slower still: ~5 ms for
+// this line at 115200 baud).
+void test_deferred_cost_against_printf(void) {
+    enum { RUNS = 2000 };
+    FILE *sink = fopen("/dev/null", "w");
+    uint32_t printf_min = UINT32_MAX, deferred_min = UINT32_MAX, mode_min = UINT32_MAX;
+
+    TEST_ASSERT_NOT_NULL(sink);
+    setvbuf(sink, NULL, _IONBF, 0);
+
+    for (int i = 0; i < RUNS; i++) {
+        uint32_t c0 = util_get_cycle_count();
+        fprintf(sink, "Mode Change SUCCESS! New Mode: %s (from %s, gen %lu)\n",
+                "NOMINAL", "SAFE", (unsigned long)i);
+        uint32_t c1 = util_get_cycle_count();
+        FSW_LOGI(LOG_MOD_MODE, "Mode Change SUCCESS! New Mode: %s (from %s, gen %lu)\n",
+                 "NOMINAL", "SAFE", (unsigned long)i);
+        uint32_t c2 = util_get_cycle_count();
+        FswLogRecord_t record;
+        fsw_log_pop(&record);   // Keep the ring from filling, outside the timed part
+
+        // A full transition with its deferred report
+        state_manager_init();
+        uint32_t c3 = util_get_cycle_count();
+        set_system_mode(MODE_NOMINAL);
+        uint32_t c4 = util_get_cycle_count();
+        fsw_log_pop(&record);
+
+        if (c1 - c0 < printf_min) printf_min = c1 - c0;
+        if (c2 - c1 < deferred_min) deferred_min = c2 - c1;
+        if (c4 - c3 < mode_min) mode_min = c4 - c3;
+    }
+    fclose(sink);
+
+    printf("FSW LOG: mode report printf %lu cycles | deferred %lu cycles | set_system_mode() %lu cycles\n",
+           (unsigned long)printf_min, (unsigned long)deferred_min, (unsigned long)mode_min);
+    TEST_ASSERT_TRUE(deferred_min < printf_min);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_record_formats_like_printf);
+    RUN_TEST(test_levels_and_module_filter);
+    RUN_TEST(test_full_ring_drops_newest_and_counts);
+    RUN_TEST(test_deferred_cost_against_printf);
+    return UNITY_END();
+}
@@ -0,0 +1,240 @@
+// test/test_hk_compress.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "hk_compress.h"         // Functions to test: encoder + ground decoder
+#include "satellite_types.h"
+#include "utils.h"               // util_get_cycle_count
+
+#define STREAM_LEN      2000
+#define TM_USER_BYTES   112      // User data room in one 128 B CCSDS TM packet
+#define LARGE_FRAME     4096
+
+static HK_Telemetry_t s_stream[STREAM_LEN];
+static HK_Telemetry_t s_decoded[STREAM_LEN];
+static uint8_t s_frame[LARGE_FRAME];
+
+// --- STREAM GENERATORS ---
+
+static uint32_t s_seed;
+static int32_t noise(int32_t amplitude) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return (int32_t)((s_seed >> 16) % (uint32_t)(2 * amplitude + 1)) - amplitude;
+}
+
+// Bhaskara-style sine over one period [0, 1): no libm needed
+static float wave(float phase) {
+    float x = phase - (float)(int)phase;
+    float sign = (x < 0.5f) ? 1.0f : -1.0f;
+    float u = (x < 0.5f) ? x * 2.0f : (x - 0.5f) * 2.0f;
+    return sign * 4.0f * u * (1.0f - u);
+}
+
+// What vTelemetryGeneratorTask produces today: one packet every 5 s (500
+// ticks), a steady bus, a mode change and an EPS fault part way through.
+static void make_fsw_stream(void) {
+    memset(s_stream, 0, sizeof(s_stream));
+    for (uint32_t i = 0; i < STREAM_LEN; i++) {
+        HK_Telemetry_t *p = &s_stream[i];
+        p->timestamp = 500 + i * 500 + ((i % 17 == 0) ? 1 : 0);   // Scheduling jitter
+        p->sequence_count = (uint16_t)i;
+        p->status_flags.system_mode = (i < 4) ? MODE_SAFE : MODE_NOMINAL;
+        p->bus_voltage = (i < 1500) ? 3.3f : 2.4f;
+        p->status_flags.flg_low_voltage = (i >= 1500);
+        p->ext_temp_c = 0.0f;
+    }
+}
+
+// A busier orbit: eclipse temperature swing, charge/discharge and ADC noise
+static void make_orbit_stream(void) {
+    s_seed = 0xB0B;
+    memset(s_stream, 0, sizeof(s_stream));
+    for (uint32_t i = 0; i < STREAM_LEN; i++) {
+        HK_Telemetry_t *p = &s_stream[i];
+        float orbit = (float)i / 1080.0f;                          // 90 min at 5 s
+        p->timestamp = 1000000u + i * 500u;
+        p->sequence_count = (uint16_t)(60000u + i);                // Wraps mid-stream
+        p->status_flags.system_mode = MODE_NOMINAL;
+        p->status_flags.flg_antenna_armed = (i / 400) & 1u;
+        p->bus_voltage = 3.85f + 0.25f * wave(orbit) + (float)noise(3) * 0.001f;
+        p->ext_temp_c = 20.0f * wave(orbit + 0.1f) + (float)noise(5) * 0.01f;
+    }
+}
+
+static void assert_packets_match(const HK_Telemetry_t *a, const HK_Telemetry_t *b) {
+    TEST_ASSERT_EQUAL_UINT32(a->timestamp, b->timestamp);
+    TEST_ASSERT_EQUAL_UINT16(a->sequence_count, b->sequence_count);
+    TEST_ASSERT_EQUAL(a->status_flags.system_mode, b->status_flags.system_mode);
+    TEST_ASSERT_EQUAL(a->status_flags.flg_low_voltage, b->status_flags.flg_low_voltage);
+    TEST_ASSERT_EQUAL(a->status_flags.flg_antenna_armed, b->status_flags.flg_antenna_armed);
+    TEST_ASSERT_EQUAL(a->status_flags.flg_reset_pending, b->status_flags.flg_reset_pending);
+    TEST_ASSERT_FLOAT_WITHIN(HK_VOLT_LSB * 0.51f, a->bus_voltage, b->bus_voltage);
+    TEST_ASSERT_FLOAT_WITHIN(HK_TEMP_LSB * 0.51f, a->ext_temp_c, b->ext_temp_c);
+}
+
+// Splits the stream into frames of at most `cap` bytes; returns total frame bytes
+static size_t encode_stream(size_t cap, uint32_t *frames, uint32_t *cycles) {
+    HkEncoder_t enc;
+    size_t total = 0, i = 0;
+    uint32_t start = util_get_cycle_count();
+
+    *frames = 0;
+    while (i < STREAM_LEN) {
+        TEST_ASSERT_EQUAL(0, hk_encoder_begin(&enc, s_frame, cap));
+        while (i < STREAM_LEN && hk_encoder_add(&enc, &s_stream[i]) == 0) {
+            i++;
+        }
+        total += hk_encoder_finish(&enc);
+        (*frames)++;
+    }
+    *cycles = util_get_cycle_count() - start;
+    return total;
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_round_trip_within_quantization() {
+    HkEncoder_t enc;
+    size_t count = 0;
+
+    make_orbit_stream();
+    TEST_ASSERT_EQUAL(0, hk_encoder_begin(&enc, s_frame, sizeof(s_frame)));
+    for (size_t i = 0; i < 500; i++) {
+        TEST_ASSERT_EQUAL(0, hk_encoder_add(&enc, &s_stream[i]));
+    }
+    size_t len = hk_encoder_finish(&enc);
+
+    TEST_ASSERT_EQUAL(0, hk_decode_frame(s_frame, len, s_decoded, STREAM_LEN, &count));
+    TEST_ASSERT_EQUAL(500, count);
+    for (size_t i = 0; i < count; i++) {
+        assert_packets_match(&s_stream[i], &s_decoded[i]);
+    }
+}
+
+void test_full_frame_rolls_back_and_next_frame_continues() {
+    size_t decoded = 0;
+    size_t i = 0;
+
+    make_orbit_stream();
+
+    // Every frame fits one TM packet and the stream survives the splits
+    while (i < STREAM_LEN) {
+        HkEncoder_t enc;
+        size_t count = 0;
+
+        TEST_ASSERT_EQUAL(0, hk_encoder_begin(&enc, s_frame, TM_USER_BYTES));
+        while (i < STREAM_LEN && hk_encoder_add(&enc, &s_stream[i]) == 0) {
+            i++;
+        }
+        size_t len = hk_encoder_finish(&enc);
+        TEST_ASSERT_LESS_OR_EQUAL(TM_USER_BYTES, len);
+        TEST_ASSERT_EQUAL(0, hk_decode_frame(s_frame, len, &s_decoded[decoded], STREAM_LEN - decoded, &count));
+        decoded += count;
+    }
+
+    TEST_ASSERT_EQUAL(STREAM_LEN, decoded);
+    for (size_t k = 0; k < STREAM_LEN; k++) {
+        assert_packets_match(&s_stream[k], &s_decoded[k]);
+    }
+}
+
+void test_escapes_for_gaps_wraps_and_invalid_values() {
+    HK_Telemetry_t pkts[6];
+    HkEncoder_t enc;
+    size_t count = 0;
+
+    memset(pkts, 0, sizeof(pkts));
+    pkts[0].timestamp = 0xFFFFFF00u; pkts[0].sequence_count = 7;  pkts[0].bus_voltage = 3.3f;
+    pkts[1].timestamp = 0x00000010u; pkts[1].sequence_count = 8;  pkts[1].bus_voltage = 3.3f;  // Tick wrap
+    pkts[2].timestamp = 0x00100000u; pkts[2].sequence_count = 42; pkts[2].bus_voltage = -1.0f; // Gap, seq jump
+    pkts[3].timestamp = 0x00100001u; pkts[3].sequence_count = 43; pkts[3].bus_voltage = NAN;   // Sensor dropout
+    pkts[4].timestamp = 0x00100002u; pkts[4].sequence_count = 44; pkts[4].bus_voltage = 4.2f;
+    pkts[5] = pkts[4];
+    pkts[5].timestamp = 0x00100003u; pkts[5].sequence_count = 45;
+    pkts[5].status_flags.flg_reset_pending = 1;
+    pkts[5].ext_temp_c = -40.0f;
+
+    TEST_ASSERT_EQUAL(0, hk_encoder_begin(&enc, s_frame, sizeof(s_frame)));
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL(0, hk_encoder_add(&enc, &pkts[i]));
+    }
+    size_t len = hk_encoder_finish(&enc);
+    TEST_ASSERT_EQUAL(0, hk_decode_frame(s_frame, len, s_decoded, 6, &count));
+    TEST_ASSERT_EQUAL(6, count);
+
+    for (int i = 0; i < 6; i++) {
+        if (i == 3) {
+            TEST_ASSERT_TRUE(s_decoded[i].bus_voltage != s_decoded[i].bus_voltage);  // NaN
+            TEST_ASSERT_EQUAL_UINT32(pkts[i].timestamp, s_decoded[i].timestamp);
+            continue;
+        }
+        assert_packets_match(&pkts[i], &s_decoded[i]);
+    }
+}
+
+void test_corrupt_or_truncated_frame_is_rejected() {
+    HkEncoder_t enc;
+    size_t count = 0;
+
+    make_fsw_stream();
+    hk_encoder_begin(&enc, s_frame, TM_USER_BYTES);
+    for (int i = 0; i < 20; i++) {
+        hk_encoder_add(&enc, &s_stream[i]);
+    }
+    size_t len = hk_encoder_finish(&enc);
+
+    TEST_ASSERT_EQUAL(-1, hk_decode_frame(s_frame, len - 1, s_decoded, STREAM_LEN, &count));
+    s_frame[5] ^= 0x10;
+    TEST_ASSERT_EQUAL(-1, hk_decode_frame(s_frame, len, s_decoded, STREAM_LEN, &count));
+    s_frame[5] ^= 0x10;
+    TEST_ASSERT_EQUAL(-1, hk_decode_frame(s_frame, len, s_decoded, 5, &count));   // Caller buffer too small
+    TEST_ASSERT_EQUAL(0, hk_decode_frame(s_frame, len, s_decoded, STREAM_LEN, &count));
+}
+
+void test_benchmark_compression_ratio_and_encode_cost() {
+    static const struct {
+        const char *name;
+        void (*make)(void);
+        float min_ratio;
+    } streams[] = {
+        { "fsw",   make_fsw_stream,   15.0f },
+        { "orbit", make_orbit_stream, 6.0f },
+    };
+    const size_t caps[] = { TM_USER_BYTES, LARGE_FRAME };
+    const size_t raw = STREAM_LEN * sizeof(HK_Telemetry_t);
+
+    for (size_t s = 0; s < sizeof(streams) / sizeof(streams[0]); s++) {
+        streams[s].make();
+        for (size_t c = 0; c < 2; c++) {
+            uint32_t frames, cycles;
+            size_t packed = encode_stream(caps[c], &frames, &cycles);
+            float ratio = (float)raw / (float)packed;
+
+            printf("HK COMPRESS: %-5s frame<=%4u B: %u -> %u B in %u frames, ratio %.2fx, %.2f bits/sample, %u cycles/sample\n",
+                   streams[s].name, (unsigned)caps[c], (unsigned)raw, (unsigned)packed, frames,
+                   (double)ratio, (double)packed * 8.0 / STREAM_LEN, cycles / STREAM_LEN);
+            TEST_ASSERT_TRUE(ratio >= streams[s].min_ratio);
+        }
+    }
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_round_trip_within_quantization);
+    RUN_TEST(test_full_frame_rolls_back_and_next_frame_continues);
+    RUN_TEST(test_escapes_for_gaps_wraps_and_invalid_values);
+    RUN_TEST(test_corrupt_or_truncated_frame_is_rejected);
+    RUN_TEST(test_benchmark_compression_ratio_and_encode_cost);
+
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+// test/test_hk_sched.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "hk_sched.h"            // Functions to test: init/set_mode/step + ground decoder
+#include "packet_schema.h"       // HK_TM_WIRE_LEN for the fixed-rate comparison
+#include "ccsds_packet.h"        // ccsds_get_be16
+#include "tm_archive.h"          // TM_ARCHIVE_RECORD_HDR_LEN
+#include "utils.h"               // util_get_cycle_count
+
+#define TICK_MS         HK_SCHED_TICK_MS
+#define DAY_STEPS       86400u          // One day at the 1 s base rate
+#define FIXED_PERIOD_S  5               // What the TM Generator used to do
+
+static HkSched_t s_sched;
+static uint8_t s_frame[HK_SAMPLES_MAX_LEN];
+static int32_t s_value[HK_PARAM_COUNT];
+
+static uint32_t s_seed;
+static int32_t noise(int32_t amplitude) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return (int32_t)((s_seed >> 16) % (uint32_t)(2 * amplitude + 1)) - amplitude;
+}
+
+static void steady_bus(void) {
+    memset(s_value, 0, sizeof(s_value));
+    s_value[HK_PARAM_bus_mv] = 3300;
+    s_value[HK_PARAM_bus_min_mv] = 3280;
+    s_value[HK_PARAM_status_flags] = MODE_NOMINAL << HK_FLAG_MODE_SHIFT;
+}
+
+// Steps once at second `t`; returns the decoded set's present mask (0: no frame)
+static uint16_t step_at(uint32_t t) {
+    HkSampleSet_t set;
+    size_t len = hk_sched_step(&s_sched, t * TICK_MS, t * 100u, s_value, s_frame);
+
+    if (len == 0) {
+        return 0;
+    }
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_samples_unpack(s_frame, len, &set));
+    TEST_ASSERT_EQUAL_UINT32(t * 100u, set.timestamp);
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        if (set.present & (1u << i)) {
+            TEST_ASSERT_EQUAL_INT(s_value[i], set.value[i]);
+        }
+    }
+    return set.present;
+}
+
+#define BIT(name)   ((uint16_t)(1u << HK_PARAM_##name))
+#define ALL_PARAMS  ((uint16_t)((1u << HK_PARAM_COUNT) - 1u))
+
+// --- TEST FUNCTIONS ---
+
+void test_periods_follow_the_mode_table() {
+    uint32_t sent[HK_PARAM_COUNT] = { 0 };
+    uint32_t frames = 0;
+
+    // Nothing changes: only the periods produce frames, and they line up
+    steady_bus();
+    hk_sched_init(&s_sched, MODE_NOMINAL, 0);
+    for (uint32_t t = 0; t <= 600; t++) {
+        uint16_t present = step_at(t);
+        frames += (present != 0);
+        for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+            sent[i] += (present >> i) & 1u;
+        }
+    }
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(600000u / hk_sched_period_ms((HkParamId_t)i, MODE_NOMINAL) + 1u, sent[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(600000u / hk_sched_period_ms(HK_PARAM_bus_mv, MODE_NOMINAL) + 1u, frames);
+    TEST_ASSERT_EQUAL_UINT32(0, s_sched.stats.sent_changed);
+
+    // SAFE is sparser: the same 10 minutes in far fewer frames
+    hk_sched_init(&s_sched, MODE_SAFE, 0);
+    frames = 0;
+    for (uint32_t t = 0; t <= 600; t++) {
+        frames += (step_at(t) != 0);
+    }
+    TEST_ASSERT_EQUAL_UINT32(600000u / hk_sched_period_ms(HK_PARAM_bus_mv, MODE_SAFE) + 1u, frames);
+}
+
+void test_deadband_sends_changes_between_periods() {
+    steady_bus();
+    hk_sched_init(&s_sched, MODE_NOMINAL, 0);
+    TEST_ASSERT_EQUAL_HEX16(ALL_PARAMS, step_at(0));
+
+    // Inside the deadband: nothing until the period is up
+    s_value[HK_PARAM_bus_mv] += 15;
+    TEST_ASSERT_EQUAL_HEX16(0, step_at(1));
+
+    // Outside it: sent at the next step, alone
+    s_value[HK_PARAM_bus_mv] += 10;
+    TEST_ASSERT_EQUAL_HEX16(BIT(bus_mv), step_at(2));
+    TEST_ASSERT_EQUAL_HEX16(0, step_at(3));
+
+    // A counter with deadband 0 goes on any change
+    s_value[HK_PARAM_tc_received] = 1;
+    TEST_ASSERT_EQUAL_HEX16(BIT(tc_received), step_at(4));
+
+    // The change did not move the grid: bus_mv is still due at 30 s
+    for (uint32_t t = 5; t < 30; t++) {
+        TEST_ASSERT_EQUAL_HEX16(0, step_at(t));
+    }
+    TEST_ASSERT_EQUAL_HEX16(BIT(bus_mv) | BIT(bus_min_mv), step_at(30));
+    TEST_ASSERT_EQUAL_UINT32(2, s_sched.stats.sent_changed);
+}
+
+void test_changes_near_a_slot_carry_the_due_parameters() {
+    steady_bus();
+    hk_sched_init(&s_sched, MODE_NOMINAL, 0);
+    step_at(0);
+    for (uint32_t t = 1; t < 25; t++) {
+        step_at(t);
+    }
+
+    // A sag at 25 s: 5 s before the 30 s slot, inside the 25 % window, so
+    // bus_mv rides along and the slot itself produces nothing
+    s_value[HK_PARAM_bus_min_mv] = 2400;
+    TEST_ASSERT_EQUAL_HEX16(BIT(bus_mv) | BIT(bus_min_mv), step_at(25));
+    for (uint32_t t = 26; t < 60; t++) {
+        TEST_ASSERT_EQUAL_HEX16(0, step_at(t));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, s_sched.stats.sent_merged);
+
+    // Back on the grid at 60 s
+    TEST_ASSERT_EQUAL_HEX16(BIT(bus_mv) | BIT(bus_min_mv) | BIT(status_flags), step_at(60));
+}
+
+void test_mode_change_sends_a_full_set_at_the_new_rates() {
+    steady_bus();
+    hk_sched_init(&s_sched, MODE_NOMINAL, 0);
+    for (uint32_t t = 0; t < 47; t++) {
+        step_at(t);
+    }
+
+    s_value[HK_PARAM_status_flags] = MODE_CRITICAL << HK_FLAG_MODE_SHIFT;
+    hk_sched_set_mode(&s_sched, MODE_CRITICAL, 47 * TICK_MS);
+    TEST_ASSERT_EQUAL_HEX16(ALL_PARAMS, step_at(47));
+
+    // CRITICAL rate for the bus, from the mode change on
+    uint32_t period_s = hk_sched_period_ms(HK_PARAM_bus_mv, MODE_CRITICAL) / 1000u;
+    for (uint32_t t = 48; t < 47 + period_s; t++) {
+        TEST_ASSERT_EQUAL_HEX16(0, step_at(t));
+    }
+    TEST_ASSERT_TRUE(step_at(47 + period_s) & BIT(bus_mv));
+}
+
+void test_wire_round_trip_and_rejects() {
+    HkSampleSet_t set;
+    size_t len;
+
+    steady_bus();
+    s_value[HK_PARAM_ext_temp_cc] = -1250;      // Signed
+    s_value[HK_PARAM_bus_mv] = 70000;           // Clamped to U16
+    hk_sched_init(&s_sched, MODE_NOMINAL, 0);
+    len = hk_sched_step(&s_sched, 0, 0x01020304, s_value, s_frame);
+    TEST_ASSERT_EQUAL(HK_SAMPLES_MAX_LEN, len);
+    TEST_ASSERT_EQUAL_HEX8(0x01, s_frame[0]);
+    TEST_ASSERT_EQUAL_HEX16(ALL_PARAMS, ccsds_get_be16(&s_frame[HK_SAMPLES_OFF_present]));
+
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_samples_unpack(s_frame, len, &set));
+    TEST_ASSERT_EQUAL_INT(-1250, set.value[HK_PARAM_ext_temp_cc]);
+    TEST_ASSERT_EQUAL_INT(65535, set.value[HK_PARAM_bus_mv]);
+
+    // Length must match the present mask; every bit is covered by the CRC
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, hk_samples_unpack(s_frame, len - 1, &set));
+    for (size_t bit = HK_SAMPLES_OFF_values * 8; bit < len * 8; bit++) {
+        s_frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_CRC, hk_samples_unpack(s_frame, len, &set));
+        s_frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    s_frame[HK_SAMPLES_OFF_present] |= 0x80;    // Unknown parameter
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, hk_samples_unpack(s_frame, len, &set));
+}
+
+void test_day_volume_against_fixed_rate() {
+    uint64_t bytes = 0, records = 0, cycles = 0;
+
+    // A NOMINAL day: bus noise, a 2-minute sag every orbit, a few TCs
+    s_seed = 0x5EED;
+    steady_bus();
+    hk_sched_init(&s_sched, MODE_NOMINAL, 0);
+    for (uint32_t t = 0; t < DAY_STEPS; t++) {
+        int sag = (t % 5400u) < 120u;
+        s_value[HK_PARAM_bus_mv] = (sag ? 3050 : 3300) + noise(8);
+        s_value[HK_PARAM_bus_min_mv] = s_value[HK_PARAM_bus_mv] - 20 + noise(15);
+        s_value[HK_PARAM_ext_temp_cc] = (int32_t)((t / 60u) % 90u) * 10 - 450;
+        s_value[HK_PARAM_tc_received] = (int32_t)(t / 3600u);
+
+        uint32_t start = util_get_cycle_count();
+        size_t len = hk_sched_step(&s_sched, t * TICK_MS, t * 100u, s_value, s_frame);
+        cycles += util_get_cycle_count() - start;
+        if (len > 0) {
+            bytes += len + TM_ARCHIVE_RECORD_HDR_LEN;
+            records++;
+        }
+    }
+
+    uint64_t fixed = (uint64_t)(DAY_STEPS / FIXED_PERIOD_S) * (HK_TM_WIRE_LEN + TM_ARCHIVE_RECORD_HDR_LEN);
+    printf("HK SCHED: day in %lu sets, %lu B archived vs %lu B at 17 B / 5 s (%.1fx less); "
+           "%lu due, %lu changed, %lu merged; %.0f cycles/step\n",
+           (unsigned long)records, (unsigned long)bytes, (unsigned long)fixed, (double)fixed / (double)bytes,
+           (unsigned long)s_sched.stats.sent_due, (unsigned long)s_sched.stats.sent_changed,
+           (unsigned long)s_sched.stats.sent_merged, (double)cycles / DAY_STEPS);
+    TEST_ASSERT_LESS_THAN(fixed / 2, bytes);
+    TEST_ASSERT_GREATER_THAN(0, s_sched.stats.sent_changed);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_periods_follow_the_mode_table);
+    RUN_TEST(test_deadband_sends_changes_between_periods);
+    RUN_TEST(test_changes_near_a_slot_carry_the_due_parameters);
+    RUN_TEST(test_mode_change_sends_a_full_set_at_the_new_rates);
+    RUN_TEST(test_wire_round_trip_and_rejects);
+    RUN_TEST(test_day_volume_against_fixed_rate);
+
+    return UNITY_END();
+}
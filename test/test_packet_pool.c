@@ -0,0 +1,265 @@
+// test/test_packet_pool.c
+
+#include <unity.h>               // Unity Test Framework
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "packet_pool.h"         // Functions to test: alloc/submit/receive/release, both pool kinds
+#include "host_runtime.h"        // Simulated scheduler for the POOL_BLOCK cases
+#include <stdio.h>
+#include <string.h>
+
+// Links against src/packet_pool.c, src/spsc_ring.c, src/rtos_alloc.c,
+// src/trace.c and the host runtime (host/freertos_posix.c)
+
+#define TEST_SLOTS          4
+#define TEST_BLOCK_TICKS    50
+
+typedef struct {
+    uint32_t id;
+    uint8_t body[28];
+} TestPacket_t;
+
+static TestPacket_t s_slots[TEST_SLOTS];
+static PacketPool_t s_pool;
+
+static void open_pool(int spsc, PoolPolicy_t policy) {
+    if (spsc) {
+        TEST_ASSERT_EQUAL(pdPASS, packet_pool_init_spsc(&s_pool, "TEST", s_slots, sizeof(TestPacket_t),
+                                                        TEST_SLOTS, policy));
+    } else {
+        TEST_ASSERT_EQUAL(pdPASS, packet_pool_init(&s_pool, "TEST", s_slots, sizeof(TestPacket_t),
+                                                   TEST_SLOTS, policy, TEST_BLOCK_TICKS));
+    }
+}
+
+// Fills the pool with ready packets 0..TEST_SLOTS-1
+static void fill_ready(void) {
+    for (uint32_t i = 0; i < TEST_SLOTS; i++) {
+        TestPacket_t *pkt = packet_pool_alloc(&s_pool);
+        TEST_ASSERT_NOT_NULL(pkt);
+        pkt->id = i;
+        TEST_ASSERT_EQUAL(pdPASS, packet_pool_submit(&s_pool, pkt));
+    }
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_drop_newest_fails_the_allocation_and_keeps_the_queue() {
+    PoolStats_t stats;
+
+    for (int spsc = 0; spsc <= 1; spsc++) {
+        open_pool(spsc, POOL_DROP_NEWEST);
+        fill_ready();
+
+        TEST_ASSERT_NULL(packet_pool_alloc(&s_pool));
+        packet_pool_get_stats(&s_pool, &stats);
+        TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS, stats.allocations);
+        TEST_ASSERT_EQUAL_UINT32(1, stats.alloc_failures);
+        TEST_ASSERT_EQUAL_UINT32(0, stats.dropped_oldest);
+        TEST_ASSERT_EQUAL(TEST_SLOTS, stats.in_use);
+        TEST_ASSERT_EQUAL(TEST_SLOTS, stats.high_water);
+
+        // Everything submitted is still delivered, oldest first
+        for (uint32_t i = 0; i < TEST_SLOTS; i++) {
+            TestPacket_t *pkt = packet_pool_receive(&s_pool, 0);
+            TEST_ASSERT_NOT_NULL(pkt);
+            TEST_ASSERT_EQUAL_UINT32(i, pkt->id);
+            packet_pool_release(&s_pool, pkt);
+        }
+        TEST_ASSERT_NULL(packet_pool_receive(&s_pool, 0));
+        packet_pool_get_stats(&s_pool, &stats);
+        TEST_ASSERT_EQUAL(0, stats.in_use);
+        TEST_ASSERT_EQUAL(TEST_SLOTS, stats.high_water);
+    }
+}
+
+void test_drop_oldest_reclaims_the_oldest_ready_packet() {
+    PoolStats_t stats;
+
+    for (int spsc = 0; spsc <= 1; spsc++) {
+        open_pool(spsc, POOL_DROP_OLDEST);
+        fill_ready();
+
+        // Two more packets take the slots of packets 0 and 1
+        for (uint32_t i = TEST_SLOTS; i < TEST_SLOTS + 2; i++) {
+            TestPacket_t *pkt = packet_pool_alloc(&s_pool);
+            TEST_ASSERT_NOT_NULL(pkt);
+            TEST_ASSERT_EQUAL_UINT32(i - TEST_SLOTS, pkt->id);
+            pkt->id = i;
+            TEST_ASSERT_EQUAL(pdPASS, packet_pool_submit(&s_pool, pkt));
+        }
+        packet_pool_get_stats(&s_pool, &stats);
+        TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS + 2, stats.allocations);
+        TEST_ASSERT_EQUAL_UINT32(2, stats.dropped_oldest);
+        TEST_ASSERT_EQUAL_UINT32(0, stats.alloc_failures);
+        TEST_ASSERT_EQUAL(TEST_SLOTS, stats.in_use);
+        TEST_ASSERT_EQUAL(TEST_SLOTS, stats.high_water);
+
+        // The consumer sees the newest TEST_SLOTS packets, in order
+        for (uint32_t i = 2; i < TEST_SLOTS + 2; i++) {
+            TestPacket_t *pkt = packet_pool_receive(&s_pool, 0);
+            TEST_ASSERT_NOT_NULL(pkt);
+            TEST_ASSERT_EQUAL_UINT32(i, pkt->id);
+            packet_pool_release(&s_pool, pkt);
+        }
+        TEST_ASSERT_NULL(packet_pool_receive(&s_pool, 0));
+    }
+}
+
+void test_drop_oldest_fails_when_nothing_is_ready() {
+    PoolStats_t stats;
+    void *held[TEST_SLOTS];
+
+    for (int spsc = 0; spsc <= 1; spsc++) {
+        open_pool(spsc, POOL_DROP_OLDEST);
+
+        // Every slot is still with the producer: nothing to reclaim
+        for (int i = 0; i < TEST_SLOTS; i++) {
+            held[i] = packet_pool_alloc(&s_pool);
+            TEST_ASSERT_NOT_NULL(held[i]);
+        }
+        TEST_ASSERT_NULL(packet_pool_alloc(&s_pool));
+        packet_pool_get_stats(&s_pool, &stats);
+        TEST_ASSERT_EQUAL_UINT32(1, stats.alloc_failures);
+        TEST_ASSERT_EQUAL_UINT32(0, stats.dropped_oldest);
+        for (int i = 0; i < TEST_SLOTS; i++) {
+            packet_pool_release(&s_pool, held[i]);
+        }
+    }
+}
+
+// --- POOL_BLOCK: a producer task against a consumer task on the simulated clock ---
+static TickType_t s_release_at;     // 0: the consumer never releases
+static TickType_t s_alloc_done;
+static void *s_alloc_result;
+static void *s_held[TEST_SLOTS];
+
+static void producer_task(void *arg) {
+    for (int i = 0; i < TEST_SLOTS; i++) {
+        s_held[i] = packet_pool_alloc(&s_pool);
+    }
+    s_alloc_result = packet_pool_alloc(&s_pool);    // Blocks: the pool is exhausted
+    s_alloc_done = xTaskGetTickCount();
+    vTaskDelete(NULL);
+}
+
+static void consumer_task(void *arg) {
+    if (s_release_at > 0) {
+        vTaskDelay(s_release_at);
+        packet_pool_release(&s_pool, s_held[2]);
+    }
+    vTaskDelete(NULL);
+}
+
+static void run_block_case(TickType_t release_at) {
+    s_release_at = release_at;
+    s_alloc_result = NULL;
+    s_alloc_done = 0;
+    open_pool(0, POOL_BLOCK);
+
+    TickType_t start = xTaskGetTickCount();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(producer_task, "PRODUCER", 4096, NULL, 2, NULL));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(consumer_task, "CONSUMER", 4096, NULL, 1, NULL));
+    host_runtime_run(start + 2 * TEST_BLOCK_TICKS);
+    s_alloc_done -= start;
+}
+
+void test_block_waits_for_a_release_then_times_out() {
+    PoolStats_t stats;
+
+    // 1. A slot released 20 ticks in is handed to the waiting producer at once
+    run_block_case(20);
+    TEST_ASSERT_EQUAL_PTR(s_held[2], s_alloc_result);
+    TEST_ASSERT_EQUAL_UINT32(20, s_alloc_done);
+    packet_pool_get_stats(&s_pool, &stats);
+    TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS + 1, stats.allocations);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.alloc_failures);
+    TEST_ASSERT_EQUAL(TEST_SLOTS, stats.in_use);
+
+    // 2. Without one the producer gives up after block_timeout
+    run_block_case(0);
+    TEST_ASSERT_NULL(s_alloc_result);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BLOCK_TICKS, s_alloc_done);
+    packet_pool_get_stats(&s_pool, &stats);
+    TEST_ASSERT_EQUAL_UINT32(TEST_SLOTS, stats.allocations);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.alloc_failures);
+    TEST_ASSERT_EQUAL(TEST_SLOTS, stats.high_water);
+}
+
+void test_release_rejects_foreign_and_double_freed_slots() {
+    PoolStats_t stats;
+    TestPacket_t outside;
+
+    for (int spsc = 0; spsc <= 1; spsc++) {
+        open_pool(spsc, POOL_DROP_NEWEST);
+        TestPacket_t *a = packet_pool_alloc(&s_pool);
+        TestPacket_t *b = packet_pool_alloc(&s_pool);
+        TEST_ASSERT_NOT_NULL(a);
+        TEST_ASSERT_NOT_NULL(b);
+
+        // Not a slot of this pool: outside its storage, or inside a slot
+        packet_pool_release(&s_pool, &outside);
+        packet_pool_release(&s_pool, (uint8_t *)a + 1);
+        TEST_ASSERT_EQUAL(pdFAIL, packet_pool_submit(&s_pool, &outside));
+
+        // A slot goes back once; never-allocated slots are already free
+        packet_pool_release(&s_pool, a);
+        packet_pool_release(&s_pool, a);
+        packet_pool_release(&s_pool, &s_slots[TEST_SLOTS - 1]);
+
+        packet_pool_get_stats(&s_pool, &stats);
+        TEST_ASSERT_EQUAL_UINT32(4, stats.bad_releases);
+        TEST_ASSERT_EQUAL(1, stats.in_use);
+
+        // The free list holds every slot exactly once: three more, then none
+        void *seen[TEST_SLOTS] = { b };
+        for (int i = 1; i < TEST_SLOTS; i++) {
+            seen[i] = packet_pool_alloc(&s_pool);
+            TEST_ASSERT_NOT_NULL(seen[i]);
+            for (int j = 0; j < i; j++) {
+                TEST_ASSERT_TRUE(seen[i] != seen[j]);
+            }
+        }
+        TEST_ASSERT_NULL(packet_pool_alloc(&s_pool));
+        for (int i = 0; i < TEST_SLOTS; i++) {
+            packet_pool_release(&s_pool, seen[i]);
+        }
+        packet_pool_get_stats(&s_pool, &stats);
+        TEST_ASSERT_EQUAL_UINT32(4, stats.bad_releases);
+        TEST_ASSERT_EQUAL(0, stats.in_use);
+    }
+}
+
+void test_init_rejects_bad_geometry() {
+    static uint8_t big[(PACKET_POOL_MAX_SLOTS + 1) * 4];
+
+    TEST_ASSERT_EQUAL(pdFAIL, packet_pool_init(&s_pool, "BIG", big, 4, PACKET_POOL_MAX_SLOTS + 1,
+                                               POOL_DROP_NEWEST, 0));
+    TEST_ASSERT_EQUAL(pdFAIL, packet_pool_init_spsc(&s_pool, "SPSC", big, 4, PACKET_POOL_SPSC_MAX_SLOTS + 1,
+                                                    POOL_DROP_NEWEST));
+    TEST_ASSERT_EQUAL(pdFAIL, packet_pool_init_spsc(&s_pool, "SPSC", s_slots, sizeof(TestPacket_t), TEST_SLOTS,
+                                                    POOL_BLOCK));
+    TEST_ASSERT_EQUAL(pdFAIL, packet_pool_init(&s_pool, "ZERO", s_slots, 0, TEST_SLOTS, POOL_DROP_NEWEST, 0));
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    memset(s_slots, 0, sizeof(s_slots));
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_drop_newest_fails_the_allocation_and_keeps_the_queue);
+    RUN_TEST(test_drop_oldest_reclaims_the_oldest_ready_packet);
+    RUN_TEST(test_drop_oldest_fails_when_nothing_is_ready);
+    RUN_TEST(test_block_waits_for_a_release_then_times_out);
+    RUN_TEST(test_release_rejects_foreign_and_double_freed_slots);
+    RUN_TEST(test_init_rejects_bad_geometry);
+
+    return UNITY_END();
+}
@@ -0,0 +1,240 @@
+// test/test_packet_schema.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "ccsds_packet.h"        // ccsds_get_be16
+#include "packet_schema.h"       // Functions to test: hk_tm_* / tc_* pack and unpack
+#include "satellite_types.h"
+#include "utils.h"               // crc16_ccitt, util_get_cycle_count
+
+#define ROUND_TRIPS     10000
+#define BENCH_ROUNDS    100000
+
+static uint32_t s_seed;
+static uint32_t next_random(void) {
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return s_seed;
+}
+
+static void make_hk(HK_Telemetry_t *pkt) {
+    memset(pkt, 0, sizeof(*pkt));
+    pkt->timestamp = 0x01020304;
+    pkt->sequence_count = 0x0506;
+    pkt->status_flags.flg_low_voltage = 1;
+    pkt->status_flags.system_mode = MODE_CRITICAL;
+    pkt->status_flags.flg_reset_pending = 1;
+    pkt->bus_voltage = 3.3f;            // 0x40533333
+    pkt->ext_temp_c = -12.5f;           // 0xC1480000
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_layout_offsets() {
+    // Field order and widths from the schema, nothing from the compiler
+    TEST_ASSERT_EQUAL(0, HK_TM_OFF_timestamp);
+    TEST_ASSERT_EQUAL(4, HK_TM_OFF_sequence_count);
+    TEST_ASSERT_EQUAL(6, HK_TM_OFF_status_flags);
+    TEST_ASSERT_EQUAL(7, HK_TM_OFF_bus_voltage);
+    TEST_ASSERT_EQUAL(11, HK_TM_OFF_ext_temp_c);
+    TEST_ASSERT_EQUAL(15, HK_TM_OFF_crc);
+    TEST_ASSERT_EQUAL(17, HK_TM_WIRE_LEN);
+
+    TEST_ASSERT_EQUAL(0, TC_OFF_timestamp);
+    TEST_ASSERT_EQUAL(4, TC_OFF_command_id);
+    TEST_ASSERT_EQUAL(5, TC_OFF_payload);
+    TEST_ASSERT_EQUAL(13, TC_OFF_crc);
+    TEST_ASSERT_EQUAL(15, TC_WIRE_LEN);
+}
+
+void test_hk_wire_bytes_are_exact() {
+    const uint8_t expected[HK_TM_OFF_crc] = {
+        0x01, 0x02, 0x03, 0x04,         // timestamp
+        0x05, 0x06,                     // sequence_count
+        0x29,                           // flags: low voltage | CRITICAL << 2 | reset pending
+        0x40, 0x53, 0x33, 0x33,         // bus_voltage 3.3f
+        0xC1, 0x48, 0x00, 0x00,         // ext_temp_c -12.5f
+    };
+    uint16_t crc = crc16_ccitt(expected, sizeof(expected));
+    HK_Telemetry_t pkt, out;
+    uint8_t wire[HK_TM_WIRE_LEN + 1];
+
+    make_hk(&pkt);
+    pkt.crc_checksum = 0xDEAD;          // Ignored: the CRC is computed over the wire bytes
+    memset(wire, 0xEE, sizeof(wire));
+
+    TEST_ASSERT_EQUAL(HK_TM_WIRE_LEN, hk_tm_pack(&pkt, wire));
+    TEST_ASSERT_EQUAL_MEMORY(expected, wire, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX8(crc >> 8, wire[HK_TM_OFF_crc]);
+    TEST_ASSERT_EQUAL_HEX8(crc & 0xFF, wire[HK_TM_OFF_crc + 1]);
+    TEST_ASSERT_EQUAL_HEX8(0xEE, wire[HK_TM_WIRE_LEN]);     // Nothing written past the end
+
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_tm_unpack(wire, HK_TM_WIRE_LEN, &out));
+    TEST_ASSERT_EQUAL_UINT32(0x01020304, out.timestamp);
+    TEST_ASSERT_EQUAL_UINT16(0x0506, out.sequence_count);
+    TEST_ASSERT_EQUAL(1, out.status_flags.flg_low_voltage);
+    TEST_ASSERT_EQUAL(0, out.status_flags.flg_antenna_armed);
+    TEST_ASSERT_EQUAL(MODE_CRITICAL, out.status_flags.system_mode);
+    TEST_ASSERT_EQUAL(1, out.status_flags.flg_reset_pending);
+    TEST_ASSERT_TRUE(out.bus_voltage == 3.3f);
+    TEST_ASSERT_TRUE(out.ext_temp_c == -12.5f);
+    TEST_ASSERT_EQUAL_HEX16(crc, out.crc_checksum);
+}
+
+void test_tc_wire_bytes_are_exact() {
+    const uint8_t expected[TC_OFF_crc] = {
+        0x00, 0x00, 0x01, 0xF4,         // timestamp 500
+        TC_SET_MODE,                    // command_id, one byte whatever sizeof(enum)
+        MODE_NOMINAL, 0xAA, 0, 0, 0, 0, 0, 0x55,
+    };
+    TelecommandPacket_t tc, out;
+    uint8_t wire[TC_WIRE_LEN];
+
+    memset(&tc, 0, sizeof(tc));
+    tc.timestamp = 500;
+    tc.command_id = TC_SET_MODE;
+    tc.payload[0] = MODE_NOMINAL;
+    tc.payload[1] = 0xAA;
+    tc.payload[7] = 0x55;
+
+    TEST_ASSERT_EQUAL(TC_WIRE_LEN, tc_pack(&tc, wire));
+    TEST_ASSERT_EQUAL_MEMORY(expected, wire, sizeof(expected));
+    TEST_ASSERT_EQUAL_HEX16(crc16_ccitt(expected, sizeof(expected)), ccsds_get_be16(&wire[TC_OFF_crc]));
+
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, tc_unpack(wire, sizeof(wire), &out));
+    TEST_ASSERT_EQUAL_UINT32(500, out.timestamp);
+    TEST_ASSERT_EQUAL(TC_SET_MODE, out.command_id);
+    TEST_ASSERT_EQUAL_MEMORY(tc.payload, out.payload, sizeof(tc.payload));
+}
+
+void test_round_trip_is_byte_exact() {
+    HK_Telemetry_t pkt, out;
+    TelecommandPacket_t tc, tc_out;
+    uint8_t wire[HK_TM_WIRE_LEN], again[HK_TM_WIRE_LEN];
+    uint8_t tc_wire[TC_WIRE_LEN], tc_again[TC_WIRE_LEN];
+
+    s_seed = 0x5C4E3A;
+    for (int i = 0; i < ROUND_TRIPS; i++) {
+        uint32_t bits;
+
+        // 1. Random fields, floats from raw bit patterns (NaN, -0, denormals too)
+        memset(&pkt, 0, sizeof(pkt));
+        pkt.timestamp = next_random();
+        pkt.sequence_count = (uint16_t)next_random();
+        hk_flags_unpack(&pkt.status_flags, (uint8_t)(next_random() >> 24));
+        bits = next_random();
+        memcpy(&pkt.bus_voltage, &bits, sizeof(bits));
+        bits = next_random();
+        memcpy(&pkt.ext_temp_c, &bits, sizeof(bits));
+
+        // 2. pack -> unpack -> pack gives the same bytes
+        hk_tm_pack(&pkt, wire);
+        TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_tm_unpack(wire, sizeof(wire), &out));
+        hk_tm_pack(&out, again);
+        TEST_ASSERT_EQUAL_MEMORY(wire, again, sizeof(wire));
+        TEST_ASSERT_EQUAL_HEX8(hk_flags_pack(&pkt.status_flags), wire[HK_TM_OFF_status_flags]);
+
+        memset(&tc, 0, sizeof(tc));
+        tc.timestamp = next_random();
+        tc.command_id = (TelecommandID_t)(next_random() % TC_ID_COUNT);
+        for (size_t b = 0; b < sizeof(tc.payload); b++) {
+            tc.payload[b] = (uint8_t)(next_random() >> 24);
+        }
+        tc_pack(&tc, tc_wire);
+        TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, tc_unpack(tc_wire, sizeof(tc_wire), &tc_out));
+        tc_pack(&tc_out, tc_again);
+        TEST_ASSERT_EQUAL_MEMORY(tc_wire, tc_again, sizeof(tc_wire));
+    }
+}
+
+void test_unpack_rejects_bad_length_and_any_bit_flip() {
+    HK_Telemetry_t pkt, out;
+    uint8_t wire[HK_TM_WIRE_LEN];
+
+    make_hk(&pkt);
+    hk_tm_pack(&pkt, wire);
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, hk_tm_unpack(wire, HK_TM_WIRE_LEN - 1, &out));
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, hk_tm_unpack(wire, HK_TM_WIRE_LEN + 1, &out));
+
+    for (size_t bit = 0; bit < HK_TM_WIRE_LEN * 8; bit++) {
+        wire[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_CRC, hk_tm_unpack(wire, HK_TM_WIRE_LEN, &out));
+        wire[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+
+    // The old packed TC (4-byte enum, 18 bytes) is no longer accepted
+    uint8_t old_tc[18] = { 0 };
+    TelecommandPacket_t tc;
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, tc_unpack(old_tc, sizeof(old_tc), &tc));
+}
+
+void test_hk_response_carries_request_timestamp() {
+    HK_Telemetry_t pkt, out;
+    uint8_t record[HK_TM_WIRE_LEN];
+    uint8_t wire[HK_RESP_WIRE_LEN];
+    uint32_t request_timestamp = 0;
+
+    // Request timestamp first, then the HK record exactly as hk_tm_pack() writes it
+    make_hk(&pkt);
+    hk_tm_pack(&pkt, record);
+    TEST_ASSERT_EQUAL(21, HK_RESP_WIRE_LEN);
+    TEST_ASSERT_EQUAL(HK_RESP_WIRE_LEN, hk_response_pack(0xA1B2C3D4, &pkt, wire));
+    TEST_ASSERT_EQUAL_HEX8(0xA1, wire[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xD4, wire[3]);
+    TEST_ASSERT_EQUAL_MEMORY(record, &wire[HK_RESP_OFF_record], HK_TM_WIRE_LEN);
+
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_response_unpack(wire, sizeof(wire), &request_timestamp, &out));
+    TEST_ASSERT_EQUAL_HEX32(0xA1B2C3D4, request_timestamp);
+    TEST_ASSERT_EQUAL_UINT32(pkt.timestamp, out.timestamp);
+    TEST_ASSERT_EQUAL_FLOAT(pkt.bus_voltage, out.bus_voltage);
+
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, hk_response_unpack(wire, HK_TM_WIRE_LEN, &request_timestamp, &out));
+    wire[HK_RESP_OFF_record] ^= 0x01;
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_CRC, hk_response_unpack(wire, sizeof(wire), &request_timestamp, &out));
+}
+
+void test_benchmark_pack_unpack() {
+    HK_Telemetry_t pkt, out;
+    uint8_t wire[HK_TM_WIRE_LEN];
+    volatile uint32_t sink = 0;
+
+    make_hk(&pkt);
+    uint32_t c0 = util_get_cycle_count();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        pkt.timestamp = (uint32_t)i;
+        hk_tm_pack(&pkt, wire);
+        sink += wire[HK_TM_OFF_crc];
+    }
+    uint32_t c1 = util_get_cycle_count();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        wire[HK_TM_OFF_timestamp + 3] = (uint8_t)i;
+        sink += (uint32_t)hk_tm_unpack(wire, sizeof(wire), &out);
+    }
+    uint32_t c2 = util_get_cycle_count();
+
+    printf("PACKET SCHEMA: HK pack %.1f cycles, unpack %.1f cycles (CRC included)\n",
+           (double)(c1 - c0) / BENCH_ROUNDS, (double)(c2 - c1) / BENCH_ROUNDS);
+    (void)sink;
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_layout_offsets);
+    RUN_TEST(test_hk_wire_bytes_are_exact);
+    RUN_TEST(test_tc_wire_bytes_are_exact);
+    RUN_TEST(test_round_trip_is_byte_exact);
+    RUN_TEST(test_unpack_rejects_bad_length_and_any_bit_flip);
+    RUN_TEST(test_hk_response_carries_request_timestamp);
+    RUN_TEST(test_benchmark_pack_unpack);
+
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+// test/test_param_store.c
+
+#include <unity.h>               // Unity Test Framework
+#include "param_store.h"         // Functions to test: writer/reader sides, changed-since
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void publish_tc(int32_t received, int32_t rejected) {
+    param_write_begin(PARAM_GROUP_TC);
+    param_write(PARAM_tc_received, received);
+    param_write(PARAM_tc_rejected, rejected);
+    param_write_end(PARAM_GROUP_TC);
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_group_publish_round_trip() {
+    ParamSnapshot_t snap;
+
+    TEST_ASSERT_EQUAL(0, param_store_init());
+    param_snapshot(&snap);
+    for (uint32_t g = 0; g < PARAM_GROUP_COUNT; g++) {
+        TEST_ASSERT_EQUAL_UINT32(0, snap.version.group[g]);
+    }
+
+    param_write_begin(PARAM_GROUP_EPS);
+    param_write(PARAM_eps_bus_mv, 3300);
+    param_write(PARAM_eps_fault_code, 0x101);          // Clamped to U8
+    param_write(PARAM_eps_samples, (int32_t)0xF0000000u);   // U32 keeps its bit pattern
+    TEST_ASSERT_EQUAL_UINT32(1, param_write_end(PARAM_GROUP_EPS));
+
+    TEST_ASSERT_EQUAL_UINT32(0, param_read_group(PARAM_GROUP_EPS, &snap));
+    TEST_ASSERT_EQUAL_UINT32(1, snap.version.group[PARAM_GROUP_EPS]);
+    TEST_ASSERT_EQUAL_INT(3300, snap.value[PARAM_eps_bus_mv]);
+    TEST_ASSERT_EQUAL_INT(255, snap.value[PARAM_eps_fault_code]);
+    TEST_ASSERT_EQUAL_HEX32(0xF0000000u, (uint32_t)snap.value[PARAM_eps_samples]);
+
+    // Other groups are untouched
+    param_snapshot(&snap);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.version.group[PARAM_GROUP_TC]);
+    TEST_ASSERT_EQUAL(PARAM_GROUP_MODE, param_group(PARAM_mode_generation));
+    TEST_ASSERT_EQUAL_STRING("eps_bus_mv", param_name(PARAM_eps_bus_mv));
+}
+
+void test_changed_since_lists_only_new_values() {
+    ParamSnapshot_t first, snap;
+    ParamId_t ids[PARAM_COUNT];
+    ParamVersion_t boot;
+
+    TEST_ASSERT_EQUAL(0, param_store_init());
+    memset(&boot, 0, sizeof(boot));
+
+    // First publish sets both, zero included
+    publish_tc(0, 0);
+    param_snapshot(&first);
+    TEST_ASSERT_EQUAL(2, param_changed_since(&first, &boot, ids, PARAM_COUNT));
+    TEST_ASSERT_EQUAL(PARAM_tc_received, ids[0]);
+    TEST_ASSERT_EQUAL(PARAM_tc_rejected, ids[1]);
+
+    // Same values: a new version, nothing changed
+    publish_tc(0, 0);
+    param_snapshot(&snap);
+    TEST_ASSERT_EQUAL_UINT32(2, snap.version.group[PARAM_GROUP_TC]);
+    TEST_ASSERT_EQUAL(0, param_changed_since(&snap, &first.version, ids, PARAM_COUNT));
+
+    // One counter moves, in another group's publish too
+    publish_tc(5, 0);
+    param_write_begin(PARAM_GROUP_MODE);
+    param_write(PARAM_mode, 2);
+    param_write_end(PARAM_GROUP_MODE);
+    param_snapshot(&snap);
+    TEST_ASSERT_EQUAL(2, param_changed_since(&snap, &first.version, ids, PARAM_COUNT));
+    TEST_ASSERT_EQUAL(PARAM_mode, ids[0]);
+    TEST_ASSERT_EQUAL(PARAM_tc_received, ids[1]);
+
+    // The list is bounded by the caller
+    TEST_ASSERT_EQUAL(1, param_changed_since(&snap, &first.version, ids, 1));
+    TEST_ASSERT_EQUAL(0, param_changed_since(&snap, &snap.version, ids, PARAM_COUNT));
+}
+
+// --- BENCHMARK: snapshot cost with many readers against live writers ---
+// Every EPS publish k sets all EPS parameters to k % 200, so a reader can
+// check a copy is one publish: equal values, all changed at its version.
+// The writers publish every BENCH_WRITE_PERIOD_US, thousands of times the
+// real rate (EPS: 10 Hz). Back to back they would also measure the host
+// scheduler: with the test's no-op critical section a reader can preempt a
+// writer inside its window and spin out a whole time slice, which the
+// flight critical section rules out.
+
+#define BENCH_MAX_READERS       8
+#define BENCH_READS             100000
+#define BENCH_WRITE_PERIOD_US   20
+
+static uint32_t s_latency_ns[BENCH_MAX_READERS][BENCH_READS];
+static volatile int s_stop_writers;
+static volatile int s_torn_reads;
+static uint32_t s_retries;
+
+static void pace_writer(void) {
+    struct timespec ts = { 0, BENCH_WRITE_PERIOD_US * 1000L };
+    nanosleep(&ts, NULL);
+}
+
+static void *eps_writer(void *arg) {
+    uint32_t k = 0;
+
+    (void)arg;
+    while (!__atomic_load_n(&s_stop_writers, __ATOMIC_RELAXED)) {
+        k++;
+        param_write_begin(PARAM_GROUP_EPS);
+        for (uint32_t i = PARAM_eps_fault_code; i <= PARAM_eps_filter_cycles_max; i++) {
+            param_write((ParamId_t)i, (int32_t)(k % 200u));
+        }
+        param_write_end(PARAM_GROUP_EPS);
+        pace_writer();
+    }
+    return NULL;
+}
+
+static void *tc_writer(void *arg) {
+    int32_t k = 0;
+
+    (void)arg;
+    while (!__atomic_load_n(&s_stop_writers, __ATOMIC_RELAXED)) {
+        k++;
+        publish_tc(k, k);
+        pace_writer();
+    }
+    return NULL;
+}
+
+static void *snapshot_reader(void *arg) {
+    uint32_t *samples = (uint32_t *)arg;
+    uint32_t last_version = 0, retries = 0;
+    ParamSnapshot_t snap;
+
+    for (int n = 0; n < BENCH_READS; n++) {
+        uint64_t t0 = now_ns();
+        retries += param_snapshot(&snap);
+        samples[n] = (uint32_t)(now_ns() - t0);
+
+        uint32_t version = snap.version.group[PARAM_GROUP_EPS];
+        int torn = (version < last_version) ||
+                   (snap.value[PARAM_tc_received] != snap.value[PARAM_tc_rejected]);
+        for (uint32_t i = PARAM_eps_fault_code; i <= PARAM_eps_filter_cycles_max && version > 0; i++) {
+            torn |= (snap.value[i] != (int32_t)(version % 200u)) || (snap.changed[i] != version);
+        }
+        if (torn) {
+            __atomic_add_fetch(&s_torn_reads, 1, __ATOMIC_RELAXED);
+        }
+        last_version = version;
+    }
+    __atomic_add_fetch(&s_retries, retries, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void run_bench(int readers, int writers) {
+    static uint32_t all[BENCH_MAX_READERS * BENCH_READS];
+    pthread_t reader[BENCH_MAX_READERS], writer[2];
+    ParamSnapshot_t snap;
+
+    TEST_ASSERT_EQUAL(0, param_store_init());
+    s_stop_writers = 0;
+    s_torn_reads = 0;
+    s_retries = 0;
+
+    if (writers) {
+        pthread_create(&writer[0], NULL, eps_writer, NULL);
+        pthread_create(&writer[1], NULL, tc_writer, NULL);
+    }
+    for (int r = 0; r < readers; r++) {
+        pthread_create(&reader[r], NULL, snapshot_reader, s_latency_ns[r]);
+    }
+    for (int r = 0; r < readers; r++) {
+        pthread_join(reader[r], NULL);
+    }
+    s_stop_writers = 1;
+    if (writers) {
+        pthread_join(writer[0], NULL);
+        pthread_join(writer[1], NULL);
+    }
+
+    size_t n = 0;
+    for (int r = 0; r < readers; r++) {
+        for (int i = 0; i < BENCH_READS; i++) {
+            all[n++] = s_latency_ns[r][i];
+        }
+    }
+    qsort(all, n, sizeof(all[0]), cmp_u32);
+    param_snapshot(&snap);
+
+    printf("PARAM STORE: %d readers, %s: snapshot p50 %u ns | p99 %u ns | max %u ns, "
+           "%.3f retries/snapshot, %lu EPS publishes\n",
+           readers, writers ? "2 writers" : "no writer", all[n / 2], all[(n * 99) / 100], all[n - 1],
+           (double)s_retries / (double)n, (unsigned long)snap.version.group[PARAM_GROUP_EPS]);
+    TEST_ASSERT_EQUAL(0, s_torn_reads);
+}
+
+void test_snapshot_cost_with_concurrent_readers() {
+    run_bench(1, 0);
+    for (int readers = 1; readers <= BENCH_MAX_READERS; readers *= 2) {
+        run_bench(readers, 1);
+    }
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_group_publish_round_trip);
+    RUN_TEST(test_changed_since_lists_only_new_values);
+    RUN_TEST(test_snapshot_cost_with_concurrent_readers);
+
+    return UNITY_END();
+}
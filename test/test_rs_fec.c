@@ -0,0 +1,525 @@
+// test/test_rs_fec.c
+
+#include <unity.h>               // Unity Test Framework
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "rs_fec.h"              // Functions to test: rs_encode, rs_decode, rs_gf_mul
+#include "downlink_fec.h"        // Functions to test: codeblock packing and decoding
+#include "ccsds_packet.h"        // Space packets to pack
+#include "utils.h"               // util_get_cycle_count, crc16_ccitt
+
+#define GF_POLY             0x187u  // x^8 + x^7 + x^2 + x + 1
+#define RS_ROOT_FIRST       112u
+#define RS_ROOT_STEP        11u
+#define TEST_MAX_BLOCKS     64
+#define TEST_MAX_PACKETS    512
+#define SIM_AIR_BYTES       (576u * 1024u)  // One 8 minute pass at 9600 bps
+#define BENCH_BLOCKS        8192u
+#define FLIGHT_CPU_HZ       240000000.0
+#define FLIGHT_LINK_BPS     9600.0
+
+static uint32_t s_seed;
+static uint32_t prng(void) {
+    s_seed ^= s_seed << 13;
+    s_seed ^= s_seed >> 17;
+    s_seed ^= s_seed << 5;
+    return s_seed;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// --- Reference field and code, bit-serial straight from the definitions ---
+static uint8_t ref_mul(uint8_t a, uint8_t b) {
+    unsigned acc = 0, x = a;
+    while (b != 0) {
+        if (b & 1u) {
+            acc ^= x;
+        }
+        x <<= 1;
+        if (x & 0x100u) {
+            x ^= GF_POLY;
+        }
+        b >>= 1;
+    }
+    return (uint8_t)acc;
+}
+
+static uint8_t ref_pow_alpha(unsigned e) {
+    uint8_t v = 1;
+    for (unsigned i = 0; i < e % RS_N; i++) {
+        v = ref_mul(v, 0x02);
+    }
+    return v;
+}
+
+// g(x) = prod (x - alpha^(11 j)), j = 112 .. 143; gen[0] is the x^32 coefficient
+static uint8_t s_ref_gen[RS_PARITY + 1];
+
+static void ref_build_generator(void) {
+    memset(s_ref_gen, 0, sizeof(s_ref_gen));
+    s_ref_gen[0] = 1;
+    for (unsigned j = 0; j < RS_PARITY; j++) {
+        uint8_t root = ref_pow_alpha((RS_ROOT_FIRST + j) * RS_ROOT_STEP);
+        for (unsigned i = j + 1; i > 0; i--) {
+            s_ref_gen[i] ^= ref_mul(s_ref_gen[i - 1], root);
+        }
+    }
+}
+
+// Remainder of d(x) x^32 / g(x), long division one symbol at a time
+static void ref_encode(const uint8_t *data, size_t k, uint8_t *parity) {
+    uint8_t rem[RS_PARITY + 1];
+    memset(rem, 0, sizeof(rem));
+    for (size_t i = 0; i < k; i++) {
+        uint8_t lead = data[i] ^ rem[0];
+        for (unsigned j = 0; j < RS_PARITY; j++) {
+            rem[j] = rem[j + 1] ^ ref_mul(lead, s_ref_gen[j + 1]);
+        }
+    }
+    memcpy(parity, rem, RS_PARITY);
+}
+
+// A codeword is a multiple of g(x): zero at every root
+static int ref_is_codeword(const uint8_t *cw, size_t n, size_t stride) {
+    for (unsigned j = 0; j < RS_PARITY; j++) {
+        uint8_t root = ref_pow_alpha((RS_ROOT_FIRST + j) * RS_ROOT_STEP);
+        uint8_t acc = 0;
+        for (size_t i = 0; i < n; i++) {
+            acc = ref_mul(acc, root) ^ cw[i * stride];
+        }
+        if (acc != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void random_bytes(uint8_t *buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)prng();
+    }
+}
+
+// Puts `count` symbol errors at distinct positions of a k + 32 symbol codeword
+static void corrupt_symbols(uint8_t *cw, size_t n, size_t stride, unsigned count) {
+    uint8_t hit[RS_N];
+    memset(hit, 0, sizeof(hit));
+    while (count > 0) {
+        size_t pos = prng() % n;
+        uint8_t flip = (uint8_t)(1u + prng() % 255u);
+        if (!hit[pos]) {
+            hit[pos] = 1;
+            cw[pos * stride] ^= flip;
+            count--;
+        }
+    }
+}
+
+// --- Codeblock capture (the radio) ---
+static uint8_t s_blocks[TEST_MAX_BLOCKS][DOWNLINK_FEC_BLOCK_LEN(DOWNLINK_FEC_MAX_DEPTH)];
+static size_t s_block_len[TEST_MAX_BLOCKS];
+static uint32_t s_block_count;
+
+static int capture_block(void *ctx, const uint8_t *frame, size_t len) {
+    (void)ctx;
+    if (s_block_count < TEST_MAX_BLOCKS) {
+        memcpy(s_blocks[s_block_count], frame, len);
+        s_block_len[s_block_count] = len;
+    }
+    s_block_count++;
+    return 0;
+}
+
+// --- Packet capture (the ground) ---
+static uint8_t s_got[TEST_MAX_PACKETS][CCSDS_MAX_PACKET_LEN];
+static uint16_t s_got_len[TEST_MAX_PACKETS];
+static uint32_t s_got_count;
+
+static void capture_packet(void *ctx, const uint8_t *packet, size_t len) {
+    (void)ctx;
+    if (s_got_count < TEST_MAX_PACKETS) {
+        memcpy(s_got[s_got_count], packet, len);
+        s_got_len[s_got_count] = (uint16_t)len;
+    }
+    s_got_count++;
+}
+
+// Builds a housekeeping-like packet with `user_len` random bytes; returns its length
+static size_t make_packet(uint8_t *pkt, uint16_t seq, size_t user_len) {
+    uint8_t user[CCSDS_MAX_PACKET_LEN];
+    random_bytes(user, user_len);
+    return ccsds_build_packet(pkt, CCSDS_MAX_PACKET_LEN, CCSDS_TYPE_TM, APID_HOUSEKEEPING, seq,
+                              seq * 100u, user, user_len);
+}
+
+// --- TESTS ---
+
+void test_gf_multiply_matches_field_polynomial() {
+    for (unsigned a = 0; a < 256; a++) {
+        for (unsigned b = 0; b < 256; b++) {
+            if (rs_gf_mul((uint8_t)a, (uint8_t)b) != ref_mul((uint8_t)a, (uint8_t)b)) {
+                TEST_FAIL_MESSAGE("rs_gf_mul disagrees with the field polynomial");
+            }
+        }
+    }
+    // alpha = 0x02 generates the whole multiplicative group
+    TEST_ASSERT_EQUAL_HEX8(1, ref_pow_alpha(RS_N));
+    for (unsigned e = 1; e < RS_N; e++) {
+        TEST_ASSERT_NOT_EQUAL(1, ref_pow_alpha(e));
+    }
+}
+
+void test_encoder_matches_reference_division() {
+    uint8_t cw[RS_N], parity[RS_PARITY];
+    static const size_t ks[] = { RS_K, 200, 64, 1 };
+
+    for (size_t t = 0; t < sizeof(ks) / sizeof(ks[0]); t++) {
+        for (int trial = 0; trial < 20; trial++) {
+            size_t k = ks[t];
+            random_bytes(cw, k);
+            rs_encode(cw, k, 1, &cw[k]);
+            ref_encode(cw, k, parity);
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(parity, &cw[k], RS_PARITY);
+            TEST_ASSERT_TRUE(ref_is_codeword(cw, k + RS_PARITY, 1));
+        }
+    }
+}
+
+void test_decoder_corrects_up_to_16_errors() {
+    uint8_t cw[RS_N], sent[RS_N];
+
+    for (unsigned errors = 0; errors <= RS_MAX_ERRORS; errors++) {
+        for (int trial = 0; trial < 50; trial++) {
+            random_bytes(sent, RS_K);
+            rs_encode(sent, RS_K, 1, &sent[RS_K]);
+            memcpy(cw, sent, RS_N);
+            corrupt_symbols(cw, RS_N, 1, errors);
+
+            TEST_ASSERT_EQUAL_INT((int)errors, rs_decode(cw, RS_K, 1));
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(sent, cw, RS_N);
+        }
+    }
+}
+
+void test_decoder_reports_more_than_16_errors_untouched() {
+    uint8_t cw[RS_N], bad[RS_N];
+
+    for (unsigned errors = RS_MAX_ERRORS + 1; errors <= RS_PARITY; errors++) {
+        for (int trial = 0; trial < 20; trial++) {
+            random_bytes(cw, RS_K);
+            rs_encode(cw, RS_K, 1, &cw[RS_K]);
+            corrupt_symbols(cw, RS_N, 1, errors);
+            memcpy(bad, cw, RS_N);
+
+            TEST_ASSERT_EQUAL_INT(-1, rs_decode(cw, RS_K, 1));
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(bad, cw, RS_N);
+        }
+    }
+}
+
+void test_shortened_interleaved_codewords_stay_in_their_lane() {
+    enum { DEPTH = 3, K = 50, N = K + RS_PARITY };
+    uint8_t block[DEPTH * N], sent[DEPTH * N];
+
+    // 1. Three shortened codewords coded where they lie
+    random_bytes(block, DEPTH * K);
+    for (unsigned lane = 0; lane < DEPTH; lane++) {
+        rs_encode(&block[lane], K, DEPTH, &block[DEPTH * K + lane]);
+        TEST_ASSERT_TRUE(ref_is_codeword(&block[lane], N, DEPTH));
+    }
+    memcpy(sent, block, sizeof(block));
+
+    // 2. 16 errors in lane 1 only; the other lanes are never written
+    corrupt_symbols(&block[1], N, DEPTH, RS_MAX_ERRORS);
+    TEST_ASSERT_EQUAL_INT(0, rs_decode(&block[0], K, DEPTH));
+    TEST_ASSERT_EQUAL_INT(RS_MAX_ERRORS, rs_decode(&block[1], K, DEPTH));
+    TEST_ASSERT_EQUAL_INT(0, rs_decode(&block[2], K, DEPTH));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(sent, block, sizeof(block));
+
+    // 3. The missing symbols are zeros: an "error" there would be a miscorrection
+    TEST_ASSERT_EQUAL_INT(-1, rs_decode(&block[0], RS_K + 1, DEPTH));
+}
+
+void test_codeblocks_round_trip_at_depth_1_and_4() {
+    static const unsigned depths[] = { 1, 4 };
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    static uint8_t sent[TEST_MAX_PACKETS][CCSDS_MAX_PACKET_LEN];
+    static size_t sent_len[TEST_MAX_PACKETS];
+    DownlinkFec_t fec;
+
+    for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+        unsigned depth = depths[d];
+        size_t bytes = 0, sent_count = 0;
+        DownlinkFecRxStats_t rx = { 0 };
+
+        s_block_count = 0;
+        s_got_count = 0;
+        TEST_ASSERT_EQUAL_INT(0, downlink_fec_init(&fec, depth, capture_block, NULL));
+
+        // 1. Enough packets of every size for several blocks, then a flush
+        while (sent_count < 100) {
+            size_t len = make_packet(pkt, (uint16_t)sent_count, prng() % 112u);
+            memcpy(sent[sent_count], pkt, len);
+            sent_len[sent_count++] = len;
+            bytes += len;
+            TEST_ASSERT_EQUAL_INT(0, downlink_fec_send(&fec, pkt, len));
+        }
+        TEST_ASSERT_EQUAL_INT(0, downlink_fec_flush(&fec));
+        TEST_ASSERT_EQUAL_INT(0, downlink_fec_flush(&fec));     // Empty: nothing goes out
+
+        TEST_ASSERT_EQUAL_UINT32(sent_count, fec.stats.packets);
+        TEST_ASSERT_EQUAL_UINT32(bytes, fec.stats.packet_bytes);
+        TEST_ASSERT_EQUAL_UINT32(s_block_count, fec.stats.blocks);
+        TEST_ASSERT_EQUAL_UINT32(s_block_count * DOWNLINK_FEC_DATA_LEN(depth), bytes + fec.stats.fill_bytes);
+
+        // 2. Every block is an ASM and `depth` valid codewords
+        for (uint32_t b = 0; b < s_block_count; b++) {
+            TEST_ASSERT_EQUAL_UINT32(DOWNLINK_FEC_BLOCK_LEN(depth), s_block_len[b]);
+            TEST_ASSERT_EQUAL_HEX32(CCSDS_ASM, ccsds_get_be32(s_blocks[b]));
+            for (unsigned lane = 0; lane < depth; lane++) {
+                TEST_ASSERT_TRUE(ref_is_codeword(&s_blocks[b][CCSDS_ASM_LEN + lane], RS_N, depth));
+            }
+            TEST_ASSERT_EQUAL_INT(0, downlink_fec_decode_block(s_blocks[b], depth, capture_packet, NULL, &rx));
+        }
+
+        // 3. Same packets, same order
+        TEST_ASSERT_EQUAL_UINT32(sent_count, s_got_count);
+        TEST_ASSERT_EQUAL_UINT32(sent_count, rx.packets);
+        TEST_ASSERT_EQUAL_UINT32(0, rx.bad_packets);
+        for (size_t i = 0; i < sent_count; i++) {
+            TEST_ASSERT_EQUAL_UINT32(sent_len[i], s_got_len[i]);
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(sent[i], s_got[i], sent_len[i]);
+        }
+    }
+}
+
+void test_depth_0_and_configuration() {
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    DownlinkFec_t fec;
+    size_t len = make_packet(pkt, 7, 20);
+
+    TEST_ASSERT_EQUAL_INT(-1, downlink_fec_init(&fec, DOWNLINK_FEC_MAX_DEPTH + 1, capture_block, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, downlink_fec_init(&fec, 1, NULL, NULL));
+
+    // Uncoded: every packet goes straight to the radio
+    TEST_ASSERT_EQUAL_INT(0, downlink_fec_init(&fec, 0, capture_block, NULL));
+    TEST_ASSERT_EQUAL_INT(0, downlink_fec_send(&fec, pkt, len));
+    TEST_ASSERT_EQUAL_INT(0, downlink_fec_flush(&fec));
+    TEST_ASSERT_EQUAL_UINT32(1, s_block_count);
+    TEST_ASSERT_EQUAL_UINT32(len, s_block_len[0]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pkt, s_blocks[0], len);
+
+    TEST_ASSERT_EQUAL_UINT32(9600, downlink_fec_info_rate(9600, 0));
+    TEST_ASSERT_EQUAL_UINT32(9600u * 223u / 259u, downlink_fec_info_rate(9600, 1));
+    TEST_ASSERT_EQUAL_UINT32(9600u * 892u / 1024u, downlink_fec_info_rate(9600, 4));
+}
+
+void test_interleaving_corrects_longer_bursts() {
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    static const unsigned depths[] = { 1, 4 };
+    int decoded[2];
+
+    // The same 48 byte burst (3 x 16 symbols) in the middle of each data field
+    for (size_t d = 0; d < 2; d++) {
+        unsigned depth = depths[d];
+        DownlinkFec_t fec;
+        DownlinkFecRxStats_t rx = { 0 };
+
+        s_block_count = 0;
+        s_got_count = 0;
+        downlink_fec_init(&fec, depth, capture_block, NULL);
+        for (uint16_t i = 0; i < 3 * depth; i++) {
+            downlink_fec_send(&fec, pkt, make_packet(pkt, i, 40));
+        }
+        downlink_fec_flush(&fec);
+        TEST_ASSERT_EQUAL_UINT32(1, s_block_count);
+
+        for (unsigned i = 0; i < 48; i++) {
+            s_blocks[0][CCSDS_ASM_LEN + 100 + i] ^= (uint8_t)(1u + prng() % 255u);
+        }
+        decoded[d] = downlink_fec_decode_block(s_blocks[0], depth, capture_packet, NULL, &rx);
+        if (depth == 4) {
+            TEST_ASSERT_EQUAL_UINT32(3 * depth, s_got_count);
+            TEST_ASSERT_EQUAL_UINT32(48, rx.corrected);
+        } else {
+            TEST_ASSERT_EQUAL_UINT32(1, rx.uncorrectable);
+            TEST_ASSERT_TRUE(rx.bad_packets > 0);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(-1, decoded[0]);
+    TEST_ASSERT_EQUAL_INT(0, decoded[1]);
+}
+
+// --- Pass simulation ---
+// Packets sized like the HK traffic go through one pass worth of on-air
+// bytes with independent bit errors. Uncoded, each packet costs its ASM
+// (uplink_deframer.h style framing) and survives only without a single
+// error; coded, a block costs DOWNLINK_FEC_BLOCK_LEN and its packets survive
+// while every codeword is within 16 symbol errors.
+
+static uint64_t s_error_gap;
+
+static void channel(uint8_t *buf, size_t len, double ber) {
+    uint64_t bits = (uint64_t)len * 8u;
+    uint64_t bit = s_error_gap;
+    for (; bit < bits; bit += 1u + (uint64_t)(-log((prng() + 1.0) / 4294967297.0) / ber)) {
+        buf[bit / 8u] ^= (uint8_t)(0x80u >> (bit % 8u));
+    }
+    s_error_gap = bit - bits;
+}
+
+static uint32_t simulate_uncoded(double ber, uint32_t *sent) {
+    uint8_t frame[CCSDS_ASM_LEN + CCSDS_MAX_PACKET_LEN];
+    uint32_t air = 0, ok = 0;
+
+    *sent = 0;
+    for (;;) {
+        size_t len = make_packet(&frame[CCSDS_ASM_LEN], (uint16_t)*sent, 20u + prng() % 40u);
+        if (air + CCSDS_ASM_LEN + len > SIM_AIR_BYTES) {
+            break;
+        }
+        air += (uint32_t)(CCSDS_ASM_LEN + len);
+        (*sent)++;
+        ccsds_put_be32(frame, CCSDS_ASM);
+        channel(frame, CCSDS_ASM_LEN + len, ber);
+        const uint8_t *pkt = &frame[CCSDS_ASM_LEN];
+        ok += (ccsds_get_be32(frame) == CCSDS_ASM &&
+               crc16_ccitt(pkt, len - CCSDS_CRC_LEN) == ccsds_get_be16(&pkt[len - CCSDS_CRC_LEN]));
+    }
+    return ok;
+}
+
+static uint32_t simulate_coded(unsigned depth, double ber, uint32_t *sent) {
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    uint32_t blocks = SIM_AIR_BYTES / DOWNLINK_FEC_BLOCK_LEN(depth);
+    uint32_t ok = 0, pending = 0;
+    DownlinkFec_t fec;
+    DownlinkFecRxStats_t rx = { 0 };
+
+    downlink_fec_init(&fec, depth, capture_block, NULL);
+    while (fec.stats.blocks < blocks) {
+        s_block_count = 0;
+        downlink_fec_send(&fec, pkt, make_packet(pkt, (uint16_t)fec.stats.packets, 20u + prng() % 40u));
+        // Packets still waiting in the block being filled
+        pending = (s_block_count == 0) ? pending + 1u : (fec.used > 0);
+        if (s_block_count > 0) {
+            channel(s_blocks[0], s_block_len[0], ber);
+            s_got_count = 0;
+            downlink_fec_decode_block(s_blocks[0], depth, capture_packet, NULL, &rx);
+            ok += s_got_count;
+        }
+    }
+    *sent = fec.stats.packets - pending;
+    return ok;
+}
+
+void test_pass_simulation_coded_vs_uncoded() {
+    static const double bers[] = { 1e-5, 1e-4, 5e-4, 1e-3 };
+
+    printf("RS FEC: one pass of %u KB on air, HK-sized packets delivered intact:\n", SIM_AIR_BYTES / 1024u);
+    for (size_t i = 0; i < sizeof(bers) / sizeof(bers[0]); i++) {
+        uint32_t sent0, sent1, sent4;
+        uint32_t ok0 = simulate_uncoded(bers[i], &sent0);
+        uint32_t ok1 = simulate_coded(1, bers[i], &sent1);
+        uint32_t ok4 = simulate_coded(4, bers[i], &sent4);
+
+        printf("RS FEC:   BER %.0e | uncoded %lu/%lu (%.1f%%) | depth 1 %lu/%lu (%.1f%%) | depth 4 %lu/%lu (%.1f%%)\n",
+               bers[i], (unsigned long)ok0, (unsigned long)sent0, 100.0 * ok0 / sent0,
+               (unsigned long)ok1, (unsigned long)sent1, 100.0 * ok1 / sent1,
+               (unsigned long)ok4, (unsigned long)sent4, 100.0 * ok4 / sent4);
+
+        // The code pays ~14 % of the link and loses nothing up to 1e-3
+        TEST_ASSERT_EQUAL_UINT32(sent1, ok1);
+        TEST_ASSERT_EQUAL_UINT32(sent4, ok4);
+        if (bers[i] >= 5e-4) {
+            TEST_ASSERT_TRUE(ok1 > ok0);
+            TEST_ASSERT_TRUE(ok4 > ok0);
+        }
+    }
+}
+
+void test_benchmark_encode() {
+    static uint8_t block[DOWNLINK_FEC_BLOCK_LEN(1)];
+    uint8_t *data = &block[CCSDS_ASM_LEN];
+    uint32_t clean = 0, repaired = 0;
+
+    random_bytes(data, RS_K);
+
+    // 1. Encode: the only RS work the flight CPU does
+    double t0 = now_s();
+    uint32_t c0 = util_get_cycle_count();
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        data[i % RS_K] ^= (uint8_t)i;
+        rs_encode(data, RS_K, 1, &data[RS_K]);
+    }
+    uint32_t cycles = util_get_cycle_count() - c0;
+    double encode_s = now_s() - t0;
+    double encode_mbps = (double)BENCH_BLOCKS * RS_K / encode_s / 1e6;
+    double cycles_per_byte = (double)cycles / ((double)BENCH_BLOCKS * RS_K);
+
+    // 2. Ground side: clean codewords and codewords at the correction limit
+    uint8_t cw[RS_N];
+    t0 = now_s();
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        clean += (rs_decode(data, RS_K, 1) == 0);
+    }
+    double clean_mbps = (double)BENCH_BLOCKS * RS_N / (now_s() - t0) / 1e6;
+    t0 = now_s();
+    for (uint32_t i = 0; i < BENCH_BLOCKS / 8u; i++) {
+        memcpy(cw, data, RS_N);
+        corrupt_symbols(cw, RS_N, 1, RS_MAX_ERRORS);
+        repaired += (rs_decode(cw, RS_K, 1) == RS_MAX_ERRORS);
+    }
+    double worst_mbps = (double)(BENCH_BLOCKS / 8u) * RS_N / (now_s() - t0) / 1e6;
+
+    // Share of one 240 MHz core the encoder needs to keep a 9600 bps link
+    // busy, if the flight CPU takes as many cycles per byte as this one
+    double link_bytes = FLIGHT_LINK_BPS / 8.0 * RS_K / DOWNLINK_FEC_BLOCK_LEN(1);
+    double cpu_share = 100.0 * cycles_per_byte * link_bytes / FLIGHT_CPU_HZ;
+
+    printf("RS FEC: encode %.1f MB/s (%.1f cycles/B, %.3f %% of a 240 MHz core at 9600 bps) | "
+           "decode clean %.1f MB/s, 16 errors %.1f MB/s\n",
+           encode_mbps, cycles_per_byte, cpu_share, clean_mbps, worst_mbps);
+
+    TEST_ASSERT_EQUAL_UINT32(BENCH_BLOCKS, clean);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_BLOCKS / 8u, repaired);
+    TEST_ASSERT_TRUE(cpu_share < 1.0);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    s_seed = 0x2545F491u;
+    s_block_count = 0;
+    s_got_count = 0;
+    s_error_gap = 0;
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    ref_build_generator();
+    RUN_TEST(test_gf_multiply_matches_field_polynomial);
+    RUN_TEST(test_encoder_matches_reference_division);
+    RUN_TEST(test_decoder_corrects_up_to_16_errors);
+    RUN_TEST(test_decoder_reports_more_than_16_errors_untouched);
+    RUN_TEST(test_shortened_interleaved_codewords_stay_in_their_lane);
+    RUN_TEST(test_codeblocks_round_trip_at_depth_1_and_4);
+    RUN_TEST(test_depth_0_and_configuration);
+    RUN_TEST(test_interleaving_corrects_longer_bursts);
+    RUN_TEST(test_pass_simulation_coded_vs_uncoded);
+    RUN_TEST(test_benchmark_encode);
+
+    return UNITY_END();
+}
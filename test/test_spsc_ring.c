@@ -0,0 +1,356 @@
+// test/test_spsc_ring.c
+
+#include <unity.h>               // Unity Test Framework
+#include "spsc_ring.h"           // Functions to test: push, pop, drop_oldest, count
+#include "utils.h"               // crc16_ccitt for the synthetic archive load
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_RING_SIZE      16
+#define STRESS_ITEMS        2000000u
+#define BENCH_COMMANDS      2000
+#define BENCH_PERIOD_NS     200000L     // One command every 200 us
+#define BENCH_MAX_LOAD      8           // Archive threads at most
+#define ARCHIVE_PAGE_LEN    512
+
+static void *s_storage[TEST_RING_SIZE];
+static SpscRing_t s_ring;
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// --- Host CPUs (the test may run in a container limited to a few) ---
+static int s_cpu[CPU_SETSIZE];
+static int s_cpu_count;
+
+static void find_cpus(void) {
+    cpu_set_t set;
+
+    s_cpu_count = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return;
+    }
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &set)) {
+            s_cpu[s_cpu_count++] = c;
+        }
+    }
+}
+
+// index < 0 leaves the thread to the scheduler
+static void pin_self(int index) {
+    cpu_set_t set;
+
+    if (index < 0 || s_cpu_count == 0) {
+        return;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(s_cpu[index % s_cpu_count], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void *item(uintptr_t n) {
+    return (void *)(n + 1u);               // Never NULL
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_rejects_bad_sizes() {
+    TEST_ASSERT_EQUAL(-1, spsc_ring_init(&s_ring, s_storage, 0));
+    TEST_ASSERT_EQUAL(-1, spsc_ring_init(&s_ring, s_storage, 12));
+    TEST_ASSERT_EQUAL(-1, spsc_ring_init(&s_ring, NULL, 16));
+    TEST_ASSERT_EQUAL(0, spsc_ring_init(&s_ring, s_storage, 1));
+    TEST_ASSERT_EQUAL(0, spsc_ring_init(&s_ring, s_storage, TEST_RING_SIZE));
+}
+
+void test_fifo_order_full_ring_and_wraparound() {
+    TEST_ASSERT_EQUAL(0, spsc_ring_init(&s_ring, s_storage, TEST_RING_SIZE));
+    TEST_ASSERT_NULL(spsc_ring_pop(&s_ring));
+
+    // Several laps, so both indices wrap around the storage
+    uintptr_t next_in = 0, next_out = 0;
+    for (int lap = 0; lap < 5; lap++) {
+        while (spsc_ring_push(&s_ring, item(next_in)) == 0) {
+            next_in++;
+        }
+        TEST_ASSERT_EQUAL_UINT32(TEST_RING_SIZE, spsc_ring_count(&s_ring));
+
+        for (int i = 0; i < TEST_RING_SIZE - 3; i++) {
+            TEST_ASSERT_EQUAL_PTR(item(next_out), spsc_ring_pop(&s_ring));
+            next_out++;
+        }
+        TEST_ASSERT_EQUAL_UINT32(3, spsc_ring_count(&s_ring));
+    }
+    while (next_out < next_in) {
+        TEST_ASSERT_EQUAL_PTR(item(next_out), spsc_ring_pop(&s_ring));
+        next_out++;
+    }
+    TEST_ASSERT_NULL(spsc_ring_pop(&s_ring));
+    TEST_ASSERT_EQUAL_UINT32(0, spsc_ring_count(&s_ring));
+}
+
+void test_drop_oldest_makes_room_for_the_newest() {
+    TEST_ASSERT_EQUAL(0, spsc_ring_init(&s_ring, s_storage, 4));
+    TEST_ASSERT_NULL(spsc_ring_drop_oldest(&s_ring));
+
+    for (uintptr_t n = 0; n < 4; n++) {
+        TEST_ASSERT_EQUAL(0, spsc_ring_push(&s_ring, item(n)));
+    }
+    TEST_ASSERT_EQUAL(-1, spsc_ring_push(&s_ring, item(4)));
+    TEST_ASSERT_EQUAL_PTR(item(0), spsc_ring_drop_oldest(&s_ring));
+    TEST_ASSERT_EQUAL(0, spsc_ring_push(&s_ring, item(4)));
+
+    // The consumer carries on with what is left, in order
+    for (uintptr_t n = 1; n <= 4; n++) {
+        TEST_ASSERT_EQUAL_PTR(item(n), spsc_ring_pop(&s_ring));
+    }
+    TEST_ASSERT_NULL(spsc_ring_pop(&s_ring));
+}
+
+// --- Two threads: every item arrives once, in order ---
+static uint32_t s_out_of_order;
+static uint32_t s_popped;
+static uint32_t s_dropped;
+static volatile int s_producer_done;
+
+static void *stress_producer(void *arg) {
+    int drop = *(const int *)arg;
+
+    pin_self(0);
+    for (uintptr_t n = 0; n < STRESS_ITEMS; n++) {
+        while (spsc_ring_push(&s_ring, item(n)) != 0) {
+            if (!drop) {
+                sched_yield();
+            } else if (spsc_ring_drop_oldest(&s_ring) != NULL) {
+                s_dropped++;
+            }
+        }
+        if (drop && (n % 64u) == 0) {
+            sched_yield();                  // Let a consumer on the same CPU race the drops too
+        }
+    }
+    __atomic_store_n(&s_producer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *stress_consumer(void *arg) {
+    uintptr_t last = 0;
+
+    pin_self(1);
+    for (;;) {
+        void *p = spsc_ring_pop(&s_ring);
+        if (p == NULL) {
+            if (__atomic_load_n(&s_producer_done, __ATOMIC_ACQUIRE) && spsc_ring_count(&s_ring) == 0) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        // Dropping only ever skips items, it never reorders or repeats one
+        if ((uintptr_t)p <= last) {
+            s_out_of_order++;
+        }
+        last = (uintptr_t)p;
+        s_popped++;
+    }
+    return NULL;
+}
+
+static void run_stress(int drop) {
+    pthread_t producer, consumer;
+
+    TEST_ASSERT_EQUAL(0, spsc_ring_init(&s_ring, s_storage, TEST_RING_SIZE));
+    s_out_of_order = 0;
+    s_popped = 0;
+    s_dropped = 0;
+    s_producer_done = 0;
+
+    uint64_t t0 = now_ns();
+    pthread_create(&consumer, NULL, stress_consumer, NULL);
+    pthread_create(&producer, NULL, stress_producer, &drop);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    double ns_per_item = (double)(now_ns() - t0) / STRESS_ITEMS;
+
+    printf("SPSC: %u items across 2 threads (%s), %.1f ns/item, %u dropped\n", STRESS_ITEMS,
+           drop ? "drop oldest when full" : "producer waits when full", ns_per_item, s_dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, s_out_of_order);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_ITEMS, s_popped + s_dropped);
+    if (!drop) {
+        TEST_ASSERT_EQUAL_UINT32(0, s_dropped);
+    }
+}
+
+void test_two_threads_transfer_everything_in_order() {
+    run_stress(0);
+}
+
+void test_two_threads_with_drops_lose_nothing_twice() {
+    run_stress(1);
+}
+
+// --- Command latency under archive load ---
+// A router thread sends one command every 200 us to a command thread while
+// archive threads checksum flash pages flat out. The plan pins the router
+// and the command thread to one CPU and the archive to the others, and the
+// command goes over an SPSC ring. The baseline leaves placement to the
+// scheduler and hands the command over through a mutex and condition
+// variable, the way a kernel queue does.
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    uint64_t stamp[TEST_RING_SIZE];
+    uint32_t head, tail;
+} LockedQueue_t;
+
+static LockedQueue_t s_locked = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, {0}, 0, 0 };
+static uint64_t s_stamp[TEST_RING_SIZE];
+static uint32_t s_latency_ns[BENCH_COMMANDS];
+static int s_use_plan;
+static volatile int s_stop_load;
+static uint32_t s_pages_checked;
+
+static void *archive_load(void *arg) {
+    uint8_t page[ARCHIVE_PAGE_LEN];
+    uint32_t pages = 0;
+
+    pin_self(s_use_plan ? (int)(intptr_t)arg : -1);
+    for (size_t i = 0; i < sizeof(page); i++) {
+        page[i] = (uint8_t)(i * 7u);
+    }
+    while (!__atomic_load_n(&s_stop_load, __ATOMIC_RELAXED)) {
+        page[pages % sizeof(page)] ^= (uint8_t)crc16_ccitt(page, sizeof(page));
+        pages++;
+    }
+    __atomic_add_fetch(&s_pages_checked, pages, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void *command_thread(void *arg) {
+    pin_self(s_use_plan ? 0 : -1);
+    for (int n = 0; n < BENCH_COMMANDS; n++) {
+        uint64_t sent;
+
+        if (s_use_plan) {
+            void *p;
+            while ((p = spsc_ring_pop(&s_ring)) == NULL) {
+                sched_yield();
+            }
+            sent = *(const uint64_t *)p;
+        } else {
+            pthread_mutex_lock(&s_locked.lock);
+            while (s_locked.head == s_locked.tail) {
+                pthread_cond_wait(&s_locked.ready, &s_locked.lock);
+            }
+            sent = s_locked.stamp[s_locked.tail++ % TEST_RING_SIZE];
+            pthread_mutex_unlock(&s_locked.lock);
+        }
+        s_latency_ns[n] = (uint32_t)(now_ns() - sent);
+    }
+    return NULL;
+}
+
+static void *router_thread(void *arg) {
+    struct timespec period = { 0, BENCH_PERIOD_NS };
+
+    pin_self(s_use_plan ? 0 : -1);
+    for (int n = 0; n < BENCH_COMMANDS; n++) {
+        nanosleep(&period, NULL);
+        if (s_use_plan) {
+            uint64_t *stamp = &s_stamp[n % TEST_RING_SIZE];
+            *stamp = now_ns();
+            while (spsc_ring_push(&s_ring, stamp) != 0) {
+                sched_yield();
+            }
+        } else {
+            pthread_mutex_lock(&s_locked.lock);
+            s_locked.stamp[s_locked.head++ % TEST_RING_SIZE] = now_ns();
+            pthread_cond_signal(&s_locked.ready);
+            pthread_mutex_unlock(&s_locked.lock);
+        }
+    }
+    return NULL;
+}
+
+static uint32_t run_latency(int use_plan, int load_threads) {
+    pthread_t load[BENCH_MAX_LOAD], router, command;
+
+    TEST_ASSERT_EQUAL(0, spsc_ring_init(&s_ring, s_storage, TEST_RING_SIZE));
+    s_locked.head = s_locked.tail = 0;
+    s_use_plan = use_plan;
+    s_stop_load = 0;
+    s_pages_checked = 0;
+
+    // Under the plan the archive threads get every CPU but the command one
+    int data_cpus = (s_cpu_count > 1) ? s_cpu_count - 1 : 1;
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < load_threads; i++) {
+        pthread_create(&load[i], NULL, archive_load, (void *)(intptr_t)(1 + i % data_cpus));
+    }
+    pthread_create(&command, NULL, command_thread, NULL);
+    pthread_create(&router, NULL, router_thread, NULL);
+    pthread_join(router, NULL);
+    pthread_join(command, NULL);
+    __atomic_store_n(&s_stop_load, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < load_threads; i++) {
+        pthread_join(load[i], NULL);
+    }
+    double seconds = (double)(now_ns() - t0) * 1e-9;
+
+    qsort(s_latency_ns, BENCH_COMMANDS, sizeof(s_latency_ns[0]), cmp_u32);
+    uint32_t p99 = s_latency_ns[(BENCH_COMMANDS * 99) / 100];
+    printf("SPSC: %-34s command latency p50 %6u ns | p99 %8u ns | max %8u ns, archive %.0f pages/s\n",
+           use_plan ? "plan (pinned, SPSC ring):" : "baseline (unpinned, locked queue):",
+           s_latency_ns[BENCH_COMMANDS / 2], p99, s_latency_ns[BENCH_COMMANDS - 1],
+           (double)s_pages_checked / seconds);
+    return p99;
+}
+
+void test_command_latency_under_archive_load() {
+    // One archive thread per CPU keeps the whole host busy in both runs
+    int load_threads = (s_cpu_count > 1) ? s_cpu_count : 1;
+    if (load_threads > BENCH_MAX_LOAD) {
+        load_threads = BENCH_MAX_LOAD;
+    }
+
+    uint32_t baseline = run_latency(0, load_threads);
+    uint32_t plan = run_latency(1, (s_cpu_count > 1) ? load_threads - 1 : load_threads);
+
+    if (s_cpu_count < 2) {
+        printf("SPSC: only %d host CPU, nothing to pin apart; latency not compared\n", s_cpu_count);
+        return;
+    }
+    TEST_ASSERT_TRUE(plan < baseline);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    find_cpus();
+    RUN_TEST(test_rejects_bad_sizes);
+    RUN_TEST(test_fifo_order_full_ring_and_wraparound);
+    RUN_TEST(test_drop_oldest_makes_room_for_the_newest);
+    RUN_TEST(test_two_threads_transfer_everything_in_order);
+    RUN_TEST(test_two_threads_with_drops_lose_nothing_twice);
+    RUN_TEST(test_command_latency_under_archive_load);
+
+    return UNITY_END();
+}
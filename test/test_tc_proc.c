@@ -0,0 +1,159 @@
+// test/test_tc_proc.c
+
+#include <unity.h>               // Unity Test Framework
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "tc_proc.h"             // Functions to test: register_handler, vCommandProcessorTask, get_*_stats
+#include "cdhs_router.h"
+#include "ccsds_packet.h"
+#include "packet_pool.h"
+#include "packet_schema.h"
+#include "host_runtime.h"        // Simulated scheduler for the processor task
+#include "utils.h"
+#include <unistd.h>
+
+// Links against src/tc_proc.c, src/cdhs_router.c, src/ccsds_packet.c,
+// src/packet_schema.c, src/packet_pool.c, src/spsc_ring.c, src/uplink_deframer.c,
+// src/param_store.c, src/fsw_log.c, src/rtos_alloc.c, src/trace.c, src/utils.c,
+// src/crc16.c and the host runtime (host/freertos_posix.c).
+// The burst is routed before the processor task starts, as a backlog left by
+// a long uplink pass would be.
+
+#define TEST_POOL_SLOTS     (TC_PROC_QUEUE_DEPTH + 8)
+#define TEST_BURST          (TC_PROC_QUEUE_DEPTH + 4)   // 4 more than xCommandQueue holds
+#define TEST_BAD_PARAM      0xBD                        // Payload byte the validator refuses
+#define TEST_EXEC_US        50                          // Handler run time
+#define TEST_WAIT_US        2000                        // Time the burst sits in the queue
+
+QueueHandle_t xCommandQueue;
+
+// Collaborators of the built-in handlers; the test only sends its own command
+void watchdog_pet(WatchdogTaskID_t task_id) {
+    (void)task_id;
+}
+
+BaseType_t tm_gen_request_hk(uint32_t request_timestamp) {
+    (void)request_timestamp;
+    return pdPASS;
+}
+
+BaseType_t set_system_mode(SystemMode_t new_mode) {
+    (void)new_mode;
+    return pdPASS;
+}
+
+static CCSDS_Frame_t s_frames[TEST_POOL_SLOTS];
+static PacketPool_t s_pool;
+static uint32_t s_executed;
+static uint32_t s_executed_bad;
+
+static int validate_test_cmd(const TelecommandPacket_t *tc) {
+    return (tc->payload[0] == TEST_BAD_PARAM) ? -1 : 0;
+}
+
+static void handle_test_cmd(const TelecommandPacket_t *tc) {
+    uint32_t start = util_get_time_us();
+
+    if (tc->payload[0] == TEST_BAD_PARAM) {
+        s_executed_bad++;
+    }
+    s_executed++;
+    while (util_get_time_us() - start < TEST_EXEC_US) {
+    }
+}
+
+// Allocates a frame holding TC_REQUEST_SUMMARY with `param` as its first payload byte
+static CCSDS_Frame_t *make_tc_frame(uint8_t param, uint16_t seq) {
+    TelecommandPacket_t tc = { .timestamp = seq, .command_id = TC_REQUEST_SUMMARY, .payload = { param } };
+    uint8_t wire[TC_WIRE_LEN];
+    CCSDS_Frame_t *frame = cdhs_router_alloc_frame();
+
+    TEST_ASSERT_NOT_NULL(frame);
+    TEST_ASSERT_EQUAL(TC_WIRE_LEN, tc_pack(&tc, wire));
+    frame->length = (uint16_t)ccsds_build_packet(frame->data, sizeof(frame->data), CCSDS_TYPE_TC, APID_CDHS, seq,
+                                                 0, wire, sizeof(wire));
+    TEST_ASSERT_TRUE(frame->length > 0);
+    frame->submit_time_us = util_get_time_us();
+    return frame;
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_burst_is_drained_in_batches_and_rejected_commands_do_not_run() {
+    TcProcStats_t proc;
+    TcCommandStats_t cmd;
+    PoolStats_t pool;
+    uint32_t bad_queued = 0;
+
+    TEST_ASSERT_EQUAL(pdPASS, tc_proc_register_handler(TC_REQUEST_SUMMARY, "TEST_CMD",
+                                                       validate_test_cmd, handle_test_cmd));
+    TEST_ASSERT_EQUAL(pdFAIL, tc_proc_register_handler(TC_ID_COUNT, "BAD_ID", NULL, handle_test_cmd));
+    TEST_ASSERT_EQUAL(pdFAIL, tc_proc_register_handler(TC_NO_OP, "NO_EXEC", NULL, NULL));
+
+    // 1. Every 4th command carries a refused parameter; the last 4 overflow the queue
+    for (uint16_t i = 0; i < TEST_BURST; i++) {
+        uint8_t param = (i % 4 == 3) ? TEST_BAD_PARAM : (uint8_t)i;
+        if (i < TC_PROC_QUEUE_DEPTH && param == TEST_BAD_PARAM) {
+            bad_queued++;
+        }
+        cdhs_router_route(make_tc_frame(param, i));
+    }
+    TEST_ASSERT_EQUAL(TC_PROC_QUEUE_DEPTH, uxQueueMessagesWaiting(xCommandQueue));
+    usleep(TEST_WAIT_US);
+
+    // 2. Run the processor until it is idle again
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(vCommandProcessorTask, "TC_PROC", 4096, NULL, 3, NULL));
+    host_runtime_run(xTaskGetTickCount() + pdMS_TO_TICKS(100));
+    TEST_ASSERT_EQUAL(0, uxQueueMessagesWaiting(xCommandQueue));
+
+    // 3. Drained in capped batches; overflow counted by the router
+    tc_proc_get_stats(&proc);
+    TEST_ASSERT_EQUAL_UINT32(TC_PROC_QUEUE_DEPTH, proc.received);
+    TEST_ASSERT_EQUAL_UINT32(TC_PROC_QUEUE_DEPTH / TC_PROC_BATCH_MAX, proc.batches);
+    TEST_ASSERT_EQUAL_UINT32(TC_PROC_BATCH_MAX, proc.batch_max);
+    TEST_ASSERT_EQUAL_UINT32(TC_PROC_QUEUE_DEPTH, proc.queue_peak);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BURST - TC_PROC_QUEUE_DEPTH, proc.queue_overflows);
+    TEST_ASSERT_EQUAL_UINT32(0, proc.malformed);
+    TEST_ASSERT_EQUAL_UINT32(0, proc.crc_failures);
+    TEST_ASSERT_EQUAL_UINT32(0, proc.unknown_id);
+
+    // 4. Refused commands never reached the handler
+    TEST_ASSERT_EQUAL(pdPASS, tc_proc_get_command_stats(TC_REQUEST_SUMMARY, &cmd));
+    TEST_ASSERT_EQUAL_UINT32(TC_PROC_QUEUE_DEPTH - bad_queued, cmd.executed);
+    TEST_ASSERT_EQUAL_UINT32(bad_queued, cmd.invalid_params);
+    TEST_ASSERT_EQUAL_UINT32(cmd.executed, s_executed);
+    TEST_ASSERT_EQUAL_UINT32(0, s_executed_bad);
+
+    // 5. Latencies advanced: every command waited, every executed one ran
+    TEST_ASSERT_GREATER_OR_EQUAL(TEST_WAIT_US, cmd.wait_max_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(TC_PROC_QUEUE_DEPTH * TEST_WAIT_US, cmd.wait_sum_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(TEST_EXEC_US, cmd.exec_max_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(cmd.executed * TEST_EXEC_US, cmd.exec_sum_us);
+
+    // 6. Every frame went back to the pool
+    packet_pool_get_stats(&s_pool, &pool);
+    TEST_ASSERT_EQUAL(0, pool.in_use);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(pdPASS, packet_pool_init(&s_pool, "UPLINK", s_frames, sizeof(CCSDS_Frame_t),
+                                               TEST_POOL_SLOTS, POOL_DROP_NEWEST, 0));
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_init(&s_pool));
+    xCommandQueue = xQueueCreate(TC_PROC_QUEUE_DEPTH, sizeof(CCSDS_Frame_t *));
+    TEST_ASSERT_NOT_NULL(xCommandQueue);
+    TEST_ASSERT_EQUAL(pdPASS, cdhs_router_set_destination(CDHS_DEST_CDHS, xCommandQueue));
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_burst_is_drained_in_batches_and_rejected_commands_do_not_run);
+
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+// test/test_tc_timeline.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "tc_timeline.h"         // Functions to test: insert/delete/pop_due/list
+#include "satellite_types.h"
+#include "utils.h"               // util_get_cycle_count
+
+#define TICKS_PER_DAY   (24u * 60u * 60u * 100u)    // CONFIG_FREERTOS_HZ = 100
+
+static TcTimeline_t s_tl;
+
+static uint32_t s_seed;
+static uint32_t next_random(void) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return s_seed >> 8;
+}
+
+static Command_t make_cmd(uint32_t t, uint8_t tag) {
+    Command_t cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.command_id = TC_NO_OP;
+    cmd.execution_time = t;
+    cmd.data[0] = tag;
+    return cmd;
+}
+
+// --- TEST FUNCTIONS ---
+
+// One simulated day, advanced a tick at a time (8.64 M ticks in well under a
+// second of host time), with a full timeline of random deadlines.
+void test_simulated_day_fires_in_order_and_never_early() {
+    TcTimelineEntry_t entry;
+    uint32_t fired = 0, last_time = 0, max_jitter = 0;
+    const uint32_t start = 0xFFF00000u;    // Tick counter wraps during the day
+
+    s_seed = 42;
+    for (uint32_t i = 0; i < TC_TIMELINE_CAPACITY; i++) {
+        Command_t cmd = make_cmd(start + next_random() % TICKS_PER_DAY, (uint8_t)i);
+        TEST_ASSERT_EQUAL(0, tc_timeline_insert(&s_tl, &cmd, NULL));
+    }
+
+    for (uint32_t tick = 0; tick <= TICKS_PER_DAY; tick++) {
+        uint32_t now = start + tick;
+        while (tc_timeline_pop_due(&s_tl, now, &entry) == 1) {
+            uint32_t jitter = now - entry.cmd.execution_time;
+            TEST_ASSERT_TRUE((int32_t)jitter >= 0);                       // Never early
+            if (fired > 0) {
+                TEST_ASSERT_TRUE((int32_t)(entry.cmd.execution_time - last_time) >= 0);
+            }
+            max_jitter = (jitter > max_jitter) ? jitter : max_jitter;
+            last_time = entry.cmd.execution_time;
+            fired++;
+        }
+    }
+
+    printf("TC TIMELINE: %u commands fired over a simulated day, max jitter %u ticks\n", fired, max_jitter);
+    TEST_ASSERT_EQUAL_UINT32(TC_TIMELINE_CAPACITY, fired);
+    TEST_ASSERT_EQUAL_UINT32(0, max_jitter);
+    TEST_ASSERT_EQUAL(0, tc_timeline_count(&s_tl));
+}
+
+// The scheduler task sleeps straight to the head deadline: the clock jumps
+// from event to event instead of ticking.
+void test_event_driven_clock_and_fifo_ties() {
+    TcTimelineEntry_t entry;
+    uint32_t now = 0, next, wakeups = 0;
+
+    for (uint8_t i = 0; i < 5; i++) {
+        Command_t cmd = make_cmd(1000, i);                 // Same deadline: FIFO
+        tc_timeline_insert(&s_tl, &cmd, NULL);
+    }
+    Command_t early = make_cmd(10, 0xEE);
+    tc_timeline_insert(&s_tl, &early, NULL);
+
+    uint8_t expected_tag = 0xEE;
+    while (tc_timeline_next_time(&s_tl, &next) == 0) {
+        now = next;
+        wakeups++;
+        while (tc_timeline_pop_due(&s_tl, now, &entry) == 1) {
+            TEST_ASSERT_EQUAL_UINT8(expected_tag, entry.cmd.data[0]);
+            expected_tag = (expected_tag == 0xEE) ? 0 : (uint8_t)(expected_tag + 1);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, wakeups);
+    TEST_ASSERT_EQUAL_UINT32(1000, now);
+}
+
+void test_delete_by_id_and_stale_ids() {
+    TcTimelineEntry_t entry;
+    uint16_t ids[10];
+
+    for (uint8_t i = 0; i < 10; i++) {
+        Command_t cmd = make_cmd(100u + i, i);
+        tc_timeline_insert(&s_tl, &cmd, &ids[i]);
+    }
+
+    // Delete the head, a middle entry and the tail
+    TEST_ASSERT_EQUAL(0, tc_timeline_delete(&s_tl, ids[0]));
+    TEST_ASSERT_EQUAL(0, tc_timeline_delete(&s_tl, ids[5]));
+    TEST_ASSERT_EQUAL(0, tc_timeline_delete(&s_tl, ids[9]));
+    TEST_ASSERT_EQUAL(-1, tc_timeline_delete(&s_tl, ids[5]));         // Already gone
+
+    // The freed slot is reused; the old id must not reach the new command
+    Command_t cmd = make_cmd(50, 0xAA);
+    uint16_t new_id;
+    tc_timeline_insert(&s_tl, &cmd, &new_id);
+    TEST_ASSERT_EQUAL(new_id & 0xFF, ids[9] & 0xFF);
+    TEST_ASSERT_EQUAL(-1, tc_timeline_delete(&s_tl, ids[9]));
+    TEST_ASSERT_EQUAL(8, tc_timeline_count(&s_tl));
+
+    uint8_t order[] = { 0xAA, 1, 2, 3, 4, 6, 7, 8 };
+    for (size_t i = 0; i < sizeof(order); i++) {
+        TEST_ASSERT_EQUAL(1, tc_timeline_pop_due(&s_tl, 1000, &entry));
+        TEST_ASSERT_EQUAL_UINT8(order[i], entry.cmd.data[0]);
+    }
+    TEST_ASSERT_EQUAL(0, tc_timeline_pop_due(&s_tl, 1000, &entry));
+}
+
+void test_ids_never_collide_with_the_invalid_id() {
+    Command_t cmd = make_cmd(100, 0);
+    uint16_t id, last_id = TC_TIMELINE_INVALID_ID;
+
+    // Fill the timeline: the last command gets slot 255
+    for (uint32_t i = 0; i < TC_TIMELINE_CAPACITY; i++) {
+        TEST_ASSERT_EQUAL(0, tc_timeline_insert(&s_tl, &cmd, &id));
+    }
+    TEST_ASSERT_EQUAL_HEX16(0x00FF, id);
+
+    // Reuse slot 255 through every generation, twice over
+    for (uint32_t round = 0; round < 2 * 256; round++) {
+        TEST_ASSERT_EQUAL(0, tc_timeline_delete(&s_tl, id));
+        TEST_ASSERT_EQUAL(-1, tc_timeline_delete(&s_tl, id));
+        TEST_ASSERT_EQUAL(0, tc_timeline_insert(&s_tl, &cmd, &id));
+        TEST_ASSERT_EQUAL_HEX16(0x00FF, id & 0xFFu);
+        TEST_ASSERT_TRUE(id != TC_TIMELINE_INVALID_ID);
+        TEST_ASSERT_TRUE(id != last_id);
+        last_id = id;
+    }
+    TEST_ASSERT_EQUAL(-1, tc_timeline_delete(&s_tl, TC_TIMELINE_INVALID_ID));
+}
+
+void test_list_by_time_range_is_sorted_and_bounded() {
+    TcTimelineEntry_t list[8];
+
+    s_seed = 7;
+    for (uint32_t i = 0; i < 200; i++) {
+        Command_t cmd = make_cmd(0xFFFFFF00u + next_random() % 512u, 0);   // Straddles the wrap
+        tc_timeline_insert(&s_tl, &cmd, NULL);
+    }
+
+    size_t n = tc_timeline_list(&s_tl, 0xFFFFFFF0u, 0x00000040u, list, 8);
+    TEST_ASSERT_EQUAL(8, n);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_TRUE((int32_t)(list[i].cmd.execution_time - 0xFFFFFFF0u) >= 0);
+        TEST_ASSERT_TRUE((int32_t)(0x00000040u - list[i].cmd.execution_time) >= 0);
+        if (i > 0) {
+            TEST_ASSERT_TRUE((int32_t)(list[i].cmd.execution_time - list[i - 1].cmd.execution_time) >= 0);
+        }
+    }
+
+    // The earliest entry in range is the first one listed
+    TcTimelineEntry_t all[TC_TIMELINE_CAPACITY];
+    size_t total = tc_timeline_list(&s_tl, 0xFFFFFFF0u, 0x00000040u, all, TC_TIMELINE_CAPACITY);
+    TEST_ASSERT_EQUAL_UINT32(all[0].cmd.execution_time, list[0].cmd.execution_time);
+    TEST_ASSERT_EQUAL(0, tc_timeline_delete(&s_tl, all[total - 1].id));
+    TEST_ASSERT_EQUAL(total - 1, tc_timeline_list(&s_tl, 0xFFFFFFF0u, 0x00000040u, all, TC_TIMELINE_CAPACITY));
+}
+
+void test_earliest_matches_the_head_of_a_full_listing() {
+    TcTimelineEntry_t first[32], all[TC_TIMELINE_CAPACITY];
+
+    s_seed = 11;
+    for (uint32_t i = 0; i < TC_TIMELINE_CAPACITY; i++) {
+        Command_t cmd = make_cmd(0xFFFFFF00u + next_random() % 128u, (uint8_t)i);   // Ties, and the wrap
+        tc_timeline_insert(&s_tl, &cmd, NULL);
+    }
+    uint32_t head;
+    tc_timeline_next_time(&s_tl, &head);
+
+    uint32_t t0 = util_get_cycle_count();
+    size_t n = tc_timeline_earliest(&s_tl, first, 32);
+    uint32_t earliest_cycles = util_get_cycle_count() - t0;
+    t0 = util_get_cycle_count();
+    size_t total = tc_timeline_list(&s_tl, head, head + 0x7FFFFFFFu, all, TC_TIMELINE_CAPACITY);
+    uint32_t list_cycles = util_get_cycle_count() - t0;
+
+    // Same commands in the same order, FIFO ties included
+    TEST_ASSERT_EQUAL(32, n);
+    TEST_ASSERT_EQUAL(TC_TIMELINE_CAPACITY, total);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT16(all[i].id, first[i].id);
+    }
+    printf("TC TIMELINE: earliest 32 of %u in %u cycles (full sorted listing %u)\n",
+           (unsigned)TC_TIMELINE_CAPACITY, earliest_cycles, list_cycles);
+
+    // Fewer pending than asked for: all of them, still in order
+    for (size_t i = 0; i < total - 5; i++) {
+        tc_timeline_delete(&s_tl, all[i].id);
+    }
+    TEST_ASSERT_EQUAL(5, tc_timeline_earliest(&s_tl, all, TC_TIMELINE_CAPACITY));
+    for (size_t i = 1; i < 5; i++) {
+        TEST_ASSERT_TRUE((int32_t)(all[i].cmd.execution_time - all[i - 1].cmd.execution_time) >= 0);
+    }
+    tc_timeline_init(&s_tl);
+    TEST_ASSERT_EQUAL(0, tc_timeline_earliest(&s_tl, all, TC_TIMELINE_CAPACITY));
+}
+
+void test_capacity_and_insert_cost_scaling() {
+    Command_t cmd;
+    uint32_t cost_small = 0, cost_full = 0;
+
+    s_seed = 99;
+    for (uint32_t i = 0; i < TC_TIMELINE_CAPACITY; i++) {
+        cmd = make_cmd(next_random(), 0);
+        uint32_t t0 = util_get_cycle_count();
+        TEST_ASSERT_EQUAL(0, tc_timeline_insert(&s_tl, &cmd, NULL));
+        uint32_t dt = util_get_cycle_count() - t0;
+        if (i < 16) {
+            cost_small += dt;
+        } else if (i >= TC_TIMELINE_CAPACITY - 16) {
+            cost_full += dt;
+        }
+    }
+    TEST_ASSERT_EQUAL(-1, tc_timeline_insert(&s_tl, &cmd, NULL));
+
+    uint32_t next;
+    uint32_t t0 = util_get_cycle_count();
+    tc_timeline_next_time(&s_tl, &next);
+    uint32_t peek = util_get_cycle_count() - t0;
+
+    printf("TC TIMELINE: insert %u cycles at n<16, %u cycles at n~%u; next-due %u cycles\n",
+           cost_small / 16, cost_full / 16, (unsigned)TC_TIMELINE_CAPACITY, peek);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    tc_timeline_init(&s_tl);
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_simulated_day_fires_in_order_and_never_early);
+    RUN_TEST(test_event_driven_clock_and_fifo_ties);
+    RUN_TEST(test_delete_by_id_and_stale_ids);
+    RUN_TEST(test_ids_never_collide_with_the_invalid_id);
+    RUN_TEST(test_list_by_time_range_is_sorted_and_bounded);
+    RUN_TEST(test_earliest_matches_the_head_of_a_full_listing);
+    RUN_TEST(test_capacity_and_insert_cost_scaling);
+
+    return UNITY_END();
+}
@@ -0,0 +1,463 @@
+// test/test_tm_archive.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "tm_archive.h"          // Functions to test: format/mount/append/flush/seek/read_next
+#include "flash_backend.h"       // File-backed mock flash
+#include "satellite_types.h"     // HK_Telemetry_t as the record payload
+
+#define TEST_IMAGE        "test_tm_archive.bin"
+#define TEST_SECTOR_SIZE  4096
+#define TEST_SECTORS      16
+
+// --- COUNTING WRAPPER AROUND THE FILE BACKEND ---
+static FlashBackend_t s_file;
+static FlashBackend_t s_flash;
+static uint32_t s_reads;
+static uint32_t s_erases[TEST_SECTORS];
+static int s_fail_programs;         // Programs fail while set
+
+static int counting_read(void *ctx, uint32_t addr, void *buf, size_t len) {
+    s_reads++;
+    return s_file.read(ctx, addr, buf, len);
+}
+
+static int counting_program(void *ctx, uint32_t addr, const void *buf, size_t len) {
+    if (s_fail_programs) {
+        return -1;
+    }
+    return s_file.program(ctx, addr, buf, len);
+}
+
+static int counting_erase(void *ctx, uint32_t sector) {
+    if (sector < TEST_SECTORS) {
+        s_erases[sector]++;
+    }
+    return s_file.erase_sector(ctx, sector);
+}
+
+static void open_flash(uint32_t sectors) {
+    TEST_ASSERT_EQUAL(0, flash_file_open(&s_file, TEST_IMAGE, TEST_SECTOR_SIZE, sectors));
+    s_flash = s_file;
+    s_flash.read = counting_read;
+    s_flash.program = counting_program;
+    s_flash.erase_sector = counting_erase;
+}
+
+static void make_packet(HK_Telemetry_t *pkt, uint32_t ts) {
+    memset(pkt, 0, sizeof(*pkt));
+    pkt->timestamp = ts;
+    pkt->sequence_count = (uint16_t)ts;
+    pkt->bus_voltage = 3.3f;
+}
+
+static TmArchive_t s_archive;
+
+// --- TEST FUNCTIONS ---
+
+void test_append_flush_and_read_back_in_order() {
+    HK_Telemetry_t pkt, out;
+    TmArchiveCursor_t cursor;
+    uint32_t ts;
+    uint16_t len;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    for (uint32_t i = 0; i < 500; i++) {
+        make_packet(&pkt, i * 10);
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, pkt.timestamp, &pkt, sizeof(pkt)));
+    }
+    TEST_ASSERT_EQUAL(0, tm_archive_flush(&s_archive));
+
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    for (uint32_t i = 0; i < 500; i++) {
+        TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, &out, sizeof(out), &len));
+        TEST_ASSERT_EQUAL_UINT32(i * 10, ts);
+        TEST_ASSERT_EQUAL(sizeof(HK_Telemetry_t), len);
+        TEST_ASSERT_EQUAL_UINT16((uint16_t)(i * 10), out.sequence_count);
+    }
+    TEST_ASSERT_EQUAL(0, tm_archive_read_next(&s_archive, &cursor, &ts, &out, sizeof(out), &len));
+}
+
+void test_record_kind_round_trips() {
+    uint8_t payload[20], out[20];
+    TmArchiveCursor_t cursor;
+    uint32_t ts;
+    uint16_t len;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    memset(payload, 0xA5, sizeof(payload));
+    TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, 10, payload, 17));
+    TEST_ASSERT_EQUAL(0, tm_archive_append_kind(&s_archive, 1, 20, payload, 12));
+    TEST_ASSERT_EQUAL(0, tm_archive_append_kind(&s_archive, TM_ARCHIVE_MAX_KIND, 30, payload, 20));
+    TEST_ASSERT_EQUAL(-1, tm_archive_append_kind(&s_archive, TM_ARCHIVE_MAX_KIND + 1, 40, payload, 20));
+    TEST_ASSERT_EQUAL(0, tm_archive_flush(&s_archive));
+
+    // The kind shares the length field and never leaks into the length
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL(0, cursor.kind);
+    TEST_ASSERT_EQUAL(17, len);
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL(1, cursor.kind);
+    TEST_ASSERT_EQUAL(12, len);
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL(TM_ARCHIVE_MAX_KIND, cursor.kind);
+    TEST_ASSERT_EQUAL(20, len);
+    TEST_ASSERT_EQUAL_MEMORY(payload, out, 20);
+    TEST_ASSERT_EQUAL(0, tm_archive_read_next(&s_archive, &cursor, &ts, out, sizeof(out), &len));
+}
+
+// Trailer owner: stamps each trailer with the number of pages it has filled
+static uint32_t s_trailers_filled;
+
+static void fill_test_trailer(void *ctx, uint8_t *trailer, uint16_t len) {
+    (void)ctx;
+    s_trailers_filled++;
+    memset(trailer, (int)s_trailers_filled, len);
+}
+
+void test_page_trailer_is_filled_per_page_and_read_back() {
+    HK_Telemetry_t pkt;
+    TmArchivePageHeader_t hdr;
+    TmArchiveCursor_t cursor;
+    uint8_t trailer[64], expected[64];
+    uint32_t ts;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    TEST_ASSERT_EQUAL(-1, tm_archive_set_trailer(&s_archive, TM_ARCHIVE_PAGE_SIZE / 2, fill_test_trailer, NULL));
+    TEST_ASSERT_EQUAL(-1, tm_archive_set_trailer(&s_archive, 64, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, tm_archive_set_trailer(&s_archive, 64, fill_test_trailer, NULL));
+    s_trailers_filled = 0;
+
+    // Records give up the trailer's bytes of maximum size
+    TEST_ASSERT_EQUAL(-1, tm_archive_append(&s_archive, 0, trailer, (uint16_t)(TM_ARCHIVE_MAX_RECORD - 63)));
+
+    for (uint32_t i = 0; i < 100; i++) {
+        make_packet(&pkt, i);
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, pkt.timestamp, &pkt, sizeof(pkt)));
+    }
+    TEST_ASSERT_EQUAL(0, tm_archive_flush(&s_archive));
+    TEST_ASSERT_EQUAL_UINT32(s_archive.stats.pages_written, s_trailers_filled);
+
+    // Every page carries the trailer filled just before it was programmed
+    for (uint32_t page = 0; page < s_archive.stats.pages_written; page++) {
+        TEST_ASSERT_EQUAL(0, tm_archive_read_trailer(&s_archive, page, &hdr, trailer));
+        memset(expected, (int)(page + 1), sizeof(expected));
+        TEST_ASSERT_EQUAL_MEMORY(expected, trailer, sizeof(trailer));
+    }
+    TEST_ASSERT_EQUAL(-1, tm_archive_read_trailer(&s_archive, s_archive.stats.pages_written, &hdr, trailer));
+
+    // Records are unaffected
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    for (uint32_t i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+        TEST_ASSERT_EQUAL_UINT32(i, ts);
+    }
+}
+
+void test_seek_uses_index_not_linear_scan() {
+    HK_Telemetry_t pkt;
+    TmArchiveCursor_t cursor;
+    uint32_t ts;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    for (uint32_t i = 0; i < 2000; i++) {
+        make_packet(&pkt, 1000 + i * 5);
+        tm_archive_append(&s_archive, pkt.timestamp, &pkt, sizeof(pkt));
+    }
+    tm_archive_flush(&s_archive);
+
+    // Exact hit, in-between hit and a time before the archive
+    s_reads = 0;
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 6000, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(6000, ts);
+
+    // Index binary search + one sector of headers + at most two page loads
+    uint32_t max_reads = (TEST_SECTOR_SIZE / TM_ARCHIVE_PAGE_SIZE) + 3;
+    printf("ARCHIVE SEEK: %u flash reads (bound %u, log holds %u pages)\n",
+           s_reads, max_reads, s_archive.stats.pages_written);
+    TEST_ASSERT_LESS_OR_EQUAL(max_reads, s_reads);
+
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 6003, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(6005, ts);
+
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1000, ts);
+
+    TEST_ASSERT_EQUAL(-1, tm_archive_seek(&s_archive, 999999, &cursor));
+}
+
+void test_wraparound_rotates_sectors_evenly() {
+    HK_Telemetry_t pkt;
+    TmArchiveCursor_t cursor;
+    uint32_t ts, first_ts;
+    const uint32_t total = 20000;   // Several times the 64 KB test region
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    memset(s_erases, 0, sizeof(s_erases));
+    for (uint32_t i = 0; i < total; i++) {
+        make_packet(&pkt, i);
+        tm_archive_append(&s_archive, i, &pkt, sizeof(pkt));
+    }
+    tm_archive_flush(&s_archive);
+
+    uint32_t min_e = UINT32_MAX, max_e = 0;
+    for (int s = 0; s < TEST_SECTORS; s++) {
+        min_e = (s_erases[s] < min_e) ? s_erases[s] : min_e;
+        max_e = (s_erases[s] > max_e) ? s_erases[s] : max_e;
+    }
+    printf("ARCHIVE WEAR: erases per sector min %u max %u\n", min_e, max_e);
+    TEST_ASSERT_LESS_OR_EQUAL(1, max_e - min_e);
+
+    // The oldest data was overwritten; the log now starts later and ends at the last record
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &first_ts, NULL, 0, NULL));
+    TEST_ASSERT_GREATER_THAN(0, first_ts);
+
+    uint32_t expected = first_ts + 1, count = 1;
+    while (tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL) == 1) {
+        TEST_ASSERT_EQUAL_UINT32(expected, ts);
+        expected++;
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(total, expected);
+    printf("ARCHIVE WEAR: %u of %u records retained\n", count, total);
+}
+
+void test_recovery_after_power_cut_scans_headers() {
+    HK_Telemetry_t pkt;
+    TmArchiveCursor_t cursor;
+    uint32_t ts, count = 0;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    for (uint32_t i = 0; i < 300; i++) {
+        make_packet(&pkt, i);
+        tm_archive_append(&s_archive, i, &pkt, sizeof(pkt));
+    }
+    tm_archive_flush(&s_archive);
+    for (uint32_t i = 300; i < 310; i++) {
+        tm_archive_append(&s_archive, i, &pkt, sizeof(pkt));   // Still in RAM: lost on power cut
+    }
+
+    // Power cut in the middle of programming the next page: half a header lands
+    uint32_t torn_page = s_archive.head_sector * s_archive.pages_per_sector + s_archive.head_page;
+    uint8_t garbage[10] = { 0x54, 0x4D, 0x41, 0x31, 0x99, 0, 0, 0, 0x12, 0x34 };
+    s_file.program(s_file.ctx, torn_page * TM_ARCHIVE_PAGE_SIZE, garbage, sizeof(garbage));
+
+    // Reboot
+    memset(&s_archive, 0, sizeof(s_archive));
+    s_reads = 0;
+    TEST_ASSERT_EQUAL(0, tm_archive_mount(&s_archive, &s_flash));
+    printf("ARCHIVE RECOVERY: %u pages recovered, %u corrupt, %u header reads\n",
+           s_archive.stats.pages_recovered, s_archive.stats.pages_corrupt, s_reads);
+    TEST_ASSERT_EQUAL_UINT32(1, s_archive.stats.pages_corrupt);
+
+    // New data goes after the torn page and the log reads through it
+    for (uint32_t i = 400; i < 410; i++) {
+        tm_archive_append(&s_archive, i, &pkt, sizeof(pkt));
+    }
+    tm_archive_flush(&s_archive);
+
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    while (tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL) == 1) {
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(310, count);
+    TEST_ASSERT_EQUAL_UINT32(409, ts);
+}
+
+void test_failed_page_does_not_fail_the_record_that_pushed_it_out() {
+    HK_Telemetry_t pkt;
+    TmArchiveCursor_t cursor;
+    uint32_t ts, count = 0;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    make_packet(&pkt, 0);
+    uint32_t per_page = 0;
+    while (s_archive.stats.pages_written == 0) {
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, per_page, &pkt, sizeof(pkt)));
+        per_page++;
+    }
+    per_page--;     // The last append pushed the first page out
+
+    // The second page fails to program: the record that triggers it is still buffered
+    for (uint32_t i = per_page + 1; i < 2 * per_page; i++) {
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, i, &pkt, sizeof(pkt)));
+    }
+    s_fail_programs = 1;
+    TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, 1000, &pkt, sizeof(pkt)));
+    s_fail_programs = 0;
+    TEST_ASSERT_EQUAL_UINT32(1, s_archive.stats.write_errors);
+    TEST_ASSERT_EQUAL(0, tm_archive_flush(&s_archive));
+
+    // First page, then straight to the record after the lost page
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    while (tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL) == 1) {
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(per_page + 1, count);
+    TEST_ASSERT_EQUAL_UINT32(1000, ts);
+}
+
+void test_seek_stays_ordered_across_a_reset_of_the_tick_count() {
+    HK_Telemetry_t pkt;
+    TmArchiveCursor_t cursor;
+    uint32_t ts, last_ts, base;
+
+    // First boot: ticks 10000..30000, all flushed
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    TEST_ASSERT_EQUAL(-1, tm_archive_last_timestamp(&s_archive, &last_ts));
+    for (uint32_t tick = 10000; tick <= 30000; tick += 20) {
+        make_packet(&pkt, tick);
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, tick, &pkt, sizeof(pkt)));
+    }
+    tm_archive_flush(&s_archive);
+
+    // Reset: the tick count starts over, archive time continues after the newest record
+    memset(&s_archive, 0, sizeof(s_archive));
+    TEST_ASSERT_EQUAL(0, tm_archive_mount(&s_archive, &s_flash));
+    TEST_ASSERT_EQUAL(0, tm_archive_last_timestamp(&s_archive, &last_ts));
+    TEST_ASSERT_EQUAL_UINT32(30000, last_ts);
+    base = last_ts + 1;
+    for (uint32_t tick = 0; tick <= 8000; tick += 20) {
+        make_packet(&pkt, base + tick);
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, base + tick, &pkt, sizeof(pkt)));
+    }
+    tm_archive_flush(&s_archive);
+    TEST_ASSERT_EQUAL(0, tm_archive_last_timestamp(&s_archive, &last_ts));
+    TEST_ASSERT_EQUAL_UINT32(base + 8000, last_ts);
+
+    // Post-reset ticks 500 and 5000 land in the second boot, not on its first record
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, base + 500, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(base + 500, ts);
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, base + 5000, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(base + 5000, ts);
+
+    // The first boot is still found where it was
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 20000, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(20000, ts);
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 500, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(10000, ts);
+
+    // And the whole log reads in one ordered run across the reset
+    uint32_t prev = ts, count = 1;
+    while (tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL) == 1) {
+        TEST_ASSERT_GREATER_THAN(prev, ts);
+        prev = ts;
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1001 + 401, count);
+}
+
+void test_torn_first_page_does_not_hide_the_rest_of_its_sector() {
+    HK_Telemetry_t pkt;
+    TmArchivePageHeader_t hdr0, hdr1;
+    TmArchiveCursor_t cursor;
+    uint32_t ts, count = 0;
+    const uint32_t records = 600;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    for (uint32_t i = 0; i < records; i++) {
+        make_packet(&pkt, i);
+        tm_archive_append(&s_archive, i, &pkt, sizeof(pkt));
+    }
+    tm_archive_flush(&s_archive);
+
+    // Sector 1 is full; its first page gets torn
+    uint32_t first = s_archive.pages_per_sector;
+    TEST_ASSERT_GREATER_THAN(first + s_archive.pages_per_sector, s_archive.stats.pages_written);
+    TEST_ASSERT_EQUAL(0, tm_archive_open_page(&s_archive, first, &hdr0, &cursor));
+    TEST_ASSERT_EQUAL(0, tm_archive_open_page(&s_archive, first + 1, &hdr1, &cursor));
+    uint8_t zeros[8] = { 0 };
+    s_file.program(s_file.ctx, first * TM_ARCHIVE_PAGE_SIZE, zeros, sizeof(zeros));
+
+    memset(&s_archive, 0, sizeof(s_archive));
+    TEST_ASSERT_EQUAL(0, tm_archive_mount(&s_archive, &s_flash));
+    TEST_ASSERT_EQUAL_UINT32(1, s_archive.stats.pages_corrupt);
+
+    // The rest of the sector is still live, to page and to time queries
+    TEST_ASSERT_EQUAL(-1, tm_archive_open_page(&s_archive, first, &hdr0, &cursor));
+    TEST_ASSERT_EQUAL(0, tm_archive_open_page(&s_archive, first + 1, &hdr1, &cursor));
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, hdr0.first_ts, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(hdr1.first_ts, ts);
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, hdr1.first_ts + 1, &cursor));
+    TEST_ASSERT_EQUAL(1, tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(hdr1.first_ts + 1, ts);
+
+    // Only the torn page's records are missing from a full read
+    TEST_ASSERT_EQUAL(0, tm_archive_seek(&s_archive, 0, &cursor));
+    while (tm_archive_read_next(&s_archive, &cursor, &ts, NULL, 0, NULL) == 1) {
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(records - hdr0.record_count, count);
+}
+
+void test_benchmark_sustained_throughput() {
+    HK_Telemetry_t pkt;
+    const uint32_t records = 200000;
+    struct timespec t0, t1;
+
+    make_packet(&pkt, 0);
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < records; i++) {
+        pkt.timestamp = i;
+        tm_archive_append(&s_archive, i, &pkt, sizeof(pkt));
+    }
+    tm_archive_flush(&s_archive);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    double rate = records / secs;
+    printf("ARCHIVE BENCH: %u records (%u B) in %.3f s -> %.0f records/s, %.1f KB/s\n",
+           records, (unsigned)sizeof(pkt), secs, rate, rate * sizeof(pkt) / 1024.0);
+    printf("ARCHIVE BENCH: %u page writes, %u erases (vs %u writes unbatched); HK rate is 0.2 records/s\n",
+           s_archive.stats.pages_written, s_archive.stats.sector_erases, records);
+
+    TEST_ASSERT_EQUAL(0, s_archive.stats.write_errors);
+    TEST_ASSERT_LESS_THAN(records / 10, s_archive.stats.pages_written);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    remove(TEST_IMAGE);
+    open_flash(TEST_SECTORS);
+    memset(&s_archive, 0, sizeof(s_archive));
+    s_fail_programs = 0;
+}
+
+void tearDown(void) {
+    flash_file_close(&s_file);
+    remove(TEST_IMAGE);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_append_flush_and_read_back_in_order);
+    RUN_TEST(test_record_kind_round_trips);
+    RUN_TEST(test_page_trailer_is_filled_per_page_and_read_back);
+    RUN_TEST(test_seek_uses_index_not_linear_scan);
+    RUN_TEST(test_wraparound_rotates_sectors_evenly);
+    RUN_TEST(test_recovery_after_power_cut_scans_headers);
+    RUN_TEST(test_failed_page_does_not_fail_the_record_that_pushed_it_out);
+    RUN_TEST(test_seek_stays_ordered_across_a_reset_of_the_tick_count);
+    RUN_TEST(test_torn_first_page_does_not_hide_the_rest_of_its_sector);
+    RUN_TEST(test_benchmark_sustained_throughput);
+
+    return UNITY_END();
+}
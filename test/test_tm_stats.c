@@ -0,0 +1,374 @@
+// test/test_tm_stats.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "tm_stats.h"            // Functions to test: add/trailer/query/merge + summary frame
+#include "tm_archive.h"          // The archive the trailers live in
+#include "flash_backend.h"       // File-backed mock flash
+#include "hk_sched.h"            // Sample sets as the TM Generator makes them
+#include "ccsds_packet.h"        // CCSDS_MAX_PACKET_LEN
+
+#define TEST_IMAGE        "test_tm_stats.bin"
+#define TEST_SECTOR_SIZE  4096
+#define TEST_SECTORS      240           // Flight partition geometry
+#define DAY_STEPS         86400u        // One day at the 1 s HK base rate
+#define TICKS_PER_STEP    100u
+
+static FlashBackend_t s_file;
+static FlashBackend_t s_flash;
+static uint32_t s_reads;
+static uint32_t s_read_bytes;
+static TmArchive_t s_archive;
+static TmStats_t s_stats;
+
+static int counting_read(void *ctx, uint32_t addr, void *buf, size_t len) {
+    s_reads++;
+    s_read_bytes += (uint32_t)len;
+    return s_file.read(ctx, addr, buf, len);
+}
+
+static uint32_t s_seed;
+static int32_t noise(int32_t amplitude) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return (int32_t)((s_seed >> 16) % (uint32_t)(2 * amplitude + 1)) - amplitude;
+}
+
+static uint32_t random_below(uint32_t n) {
+    uint32_t hi = (uint32_t)noise(0x7FFF) + 0x7FFFu;
+    uint32_t lo = (uint32_t)noise(0x7FFF) + 0x7FFFu;
+    return ((hi << 16) ^ lo) % n;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Archives sample sets of `steps` seconds the way the logger does: append,
+// then add the set to the statistics. The bus sags for ten minutes in every
+// 20000 s; the noise stays mostly inside the HK deadbands, as on the bus.
+// Returns how many of the sets carried bus_mv.
+static uint32_t fly(uint32_t first_step, uint32_t steps) {
+    static HkSched_t sched;
+    uint8_t frame[HK_SAMPLES_MAX_LEN];
+    int32_t value[HK_PARAM_COUNT];
+    HkSampleSet_t set;
+    uint32_t bus_samples = 0;
+
+    if (first_step == 0) {
+        hk_sched_init(&sched, MODE_NOMINAL, 0);
+    }
+    for (uint32_t t = first_step; t < first_step + steps; t++) {
+        int sag = (t % 20000u) > 15000u && (t % 20000u) < 15600u;
+
+        memset(value, 0, sizeof(value));
+        value[HK_PARAM_bus_mv] = (sag ? 2550 : 3300) + noise(12);
+        value[HK_PARAM_bus_min_mv] = value[HK_PARAM_bus_mv] - 40 - noise(20);
+        value[HK_PARAM_ext_temp_cc] = (int32_t)((t / 60u) % 90u) * 100 - 3000 + noise(30);
+
+        size_t len = hk_sched_step(&sched, t * HK_SCHED_TICK_MS, t * TICKS_PER_STEP, value, frame);
+        if (len == 0) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL(0, tm_archive_append(&s_archive, t * TICKS_PER_STEP, frame, (uint16_t)len));
+        TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_samples_unpack(frame, len, &set));
+        tm_stats_add(&s_stats, &set);
+        bus_samples += (set.present >> HK_PARAM_bus_mv) & 1u;
+    }
+    return bus_samples;
+}
+
+// Reference: decode every archived record in [from, to] again
+static void rescan(uint32_t from, uint32_t to, TmStats_t *ref) {
+    uint8_t frame[HK_SAMPLES_MAX_LEN];
+    TmArchiveCursor_t cursor;
+    HkSampleSet_t set;
+    uint32_t ts;
+    uint16_t len;
+
+    tm_stats_init(ref);
+    if (tm_archive_seek(&s_archive, from, &cursor) != 0) {
+        return;
+    }
+    while (tm_archive_read_next(&s_archive, &cursor, &ts, frame, sizeof(frame), &len) == 1 && ts <= to) {
+        TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, hk_samples_unpack(frame, len, &set));
+        tm_stats_add(ref, &set);
+    }
+}
+
+static void assert_agg_equal(const TmStatsAgg_t *expected, const TmStatsAgg_t *actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected->count, actual->count);
+    TEST_ASSERT_EQUAL_INT32(expected->min, actual->min);
+    TEST_ASSERT_EQUAL_INT32(expected->max, actual->max);
+    TEST_ASSERT_TRUE(expected->sum == actual->sum);
+    TEST_ASSERT_TRUE(expected->sum_sq == actual->sum_sq);
+    TEST_ASSERT_EQUAL_UINT32(expected->below, actual->below);
+    TEST_ASSERT_EQUAL_UINT32(expected->above, actual->above);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected->hist, actual->hist, TM_STATS_HIST_BINS);
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_add_tracks_moments_limits_and_bins() {
+    HkSampleSet_t set;
+    const int32_t bus[] = { 3300, 2600, 3700, 2100, 3000 };
+    double sum = 0.0, sum_sq = 0.0;
+
+    tm_stats_init(&s_stats);
+    memset(&set, 0, sizeof(set));
+    for (uint32_t i = 0; i < sizeof(bus) / sizeof(bus[0]); i++) {
+        set.timestamp = 100u + i;
+        set.present = (uint16_t)(1u << HK_PARAM_bus_mv);
+        set.value[HK_PARAM_bus_mv] = bus[i];
+        tm_stats_add(&s_stats, &set);
+        sum += bus[i];
+        sum_sq += (double)bus[i] * bus[i];
+    }
+
+    const TmStatsAgg_t *agg = &s_stats.page[TM_STAT_bus_mv];
+    TEST_ASSERT_EQUAL_UINT32(5, agg->count);
+    TEST_ASSERT_EQUAL_INT32(2100, agg->min);
+    TEST_ASSERT_EQUAL_INT32(3700, agg->max);
+    TEST_ASSERT_EQUAL_UINT32(2, agg->below);        // 2600 and 2100 under 2700
+    TEST_ASSERT_EQUAL_UINT32(1, agg->above);        // 3700 over 3600
+    TEST_ASSERT_EQUAL_UINT32(1, agg->hist[0]);      // 2100, under the base
+    TEST_ASSERT_EQUAL_UINT32(1, agg->hist[1]);      // 2600
+    TEST_ASSERT_EQUAL_UINT32(1, agg->hist[4]);      // 3000
+    TEST_ASSERT_EQUAL_UINT32(1, agg->hist[6]);      // 3300
+    TEST_ASSERT_EQUAL_UINT32(1, agg->hist[TM_STATS_HIST_BINS - 1]);     // 3700, over the top bin
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, sum / 5.0, tm_stats_mean(agg));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, sqrt(sum_sq / 5.0 - (sum / 5.0) * (sum / 5.0)), tm_stats_stddev(agg));
+
+    // Parameters absent from every set stay empty
+    TEST_ASSERT_EQUAL_UINT32(0, s_stats.page[TM_STAT_ext_temp_cc].count);
+    TEST_ASSERT_EQUAL_UINT32(5, s_stats.page_sets);
+    TEST_ASSERT_EQUAL_UINT32(100, s_stats.page_first_ts);
+    TEST_ASSERT_EQUAL_UINT32(104, s_stats.page_last_ts);
+}
+
+void test_trailer_round_trip_and_crc() {
+    uint8_t trailer[TM_STATS_TRAILER_LEN];
+    TmStatsAgg_t expected[TM_STATS_COUNT], out[TM_STATS_COUNT];
+    HkSampleSet_t set;
+
+    tm_stats_init(&s_stats);
+    memset(&set, 0, sizeof(set));
+    for (int32_t i = 0; i < 20; i++) {
+        set.present = (uint16_t)((1u << HK_PARAM_bus_min_mv) | (1u << HK_PARAM_ext_temp_cc));
+        set.value[HK_PARAM_bus_min_mv] = 2400 + i * 70;
+        set.value[HK_PARAM_ext_temp_cc] = -4500 + i * 500;
+        tm_stats_add(&s_stats, &set);
+    }
+    memcpy(expected, s_stats.page, sizeof(expected));
+
+    tm_stats_fill_trailer(&s_stats, trailer, sizeof(trailer));
+    TEST_ASSERT_EQUAL_UINT32(1, s_stats.trailers);
+    TEST_ASSERT_EQUAL_UINT32(0, s_stats.page_sets);
+    TEST_ASSERT_EQUAL_UINT32(0, s_stats.page[TM_STAT_bus_min_mv].count);
+
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, tm_stats_unpack_trailer(trailer, sizeof(trailer), out));
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        assert_agg_equal(&expected[i], &out[i]);
+    }
+
+    trailer[5] ^= 0x01;
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_CRC, tm_stats_unpack_trailer(trailer, sizeof(trailer), out));
+    memset(trailer, 0xFF, sizeof(trailer));        // A page written without statistics
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, tm_stats_unpack_trailer(trailer, sizeof(trailer), out));
+}
+
+void test_query_matches_rescan_of_the_covered_span() {
+    TmStatsSummary_t summary;
+    TmStats_t ref, inner;
+    const uint32_t end = DAY_STEPS * TICKS_PER_STEP;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    tm_stats_init(&s_stats);
+    TEST_ASSERT_EQUAL(0, tm_archive_set_trailer(&s_archive, TM_STATS_TRAILER_LEN, tm_stats_fill_trailer, &s_stats));
+    fly(0, DAY_STEPS);
+    TEST_ASSERT_EQUAL(0, tm_archive_flush(&s_archive));
+
+    // Windows of all sizes, edges anywhere: the summary is exactly the
+    // records of the whole pages it reports
+    s_seed = 7;
+    for (int n = 0; n < 50; n++) {
+        uint32_t from = random_below(end);
+        uint32_t to = from + random_below((n % 2) ? end / 100 : end / 2);
+
+        TEST_ASSERT_EQUAL(0, tm_stats_query(&s_stats, &s_archive, from, to, &summary));
+        TEST_ASSERT_EQUAL_UINT32(0, summary.pages_missing);
+        rescan(summary.first_ts, summary.last_ts, &ref);
+        rescan(from, to, &inner);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(summary.stat[TM_STAT_bus_mv].count, inner.page[TM_STAT_bus_mv].count);
+        for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+            assert_agg_equal(&ref.page[i], &summary.stat[i]);
+        }
+    }
+
+    // The whole day sees the sags, and nothing outside the log
+    TEST_ASSERT_EQUAL(0, tm_stats_query(&s_stats, &s_archive, 0, end, &summary));
+    TEST_ASSERT_EQUAL_UINT32(s_archive.stats.pages_written, summary.pages);
+    TEST_ASSERT_TRUE(summary.stat[TM_STAT_bus_mv].below > 0);
+    TEST_ASSERT_LESS_THAN_INT32(2700, summary.stat[TM_STAT_bus_mv].min);
+    TEST_ASSERT_EQUAL(-1, tm_stats_query(&s_stats, &s_archive, end + 1000, end + 2000, &summary));
+}
+
+void test_query_includes_the_page_still_in_ram() {
+    TmStatsSummary_t summary;
+    uint32_t bus_samples;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    tm_stats_init(&s_stats);
+    TEST_ASSERT_EQUAL(0, tm_archive_set_trailer(&s_archive, TM_STATS_TRAILER_LEN, tm_stats_fill_trailer, &s_stats));
+
+    // Nothing flushed yet: the answer comes from RAM alone
+    bus_samples = fly(0, 30);
+    TEST_ASSERT_EQUAL_UINT32(0, s_archive.stats.pages_written);
+    TEST_ASSERT_EQUAL(0, tm_stats_query(&s_stats, &s_archive, 0, UINT32_MAX, &summary));
+    TEST_ASSERT_EQUAL_UINT32(1, summary.pages);
+    TEST_ASSERT_EQUAL_UINT32(bus_samples, summary.stat[TM_STAT_bus_mv].count);
+
+    // Flushed pages plus the RAM page add up to every sample
+    bus_samples += fly(30, 3000);
+    TEST_ASSERT_TRUE(s_archive.stats.pages_written > 0 && s_stats.page_sets > 0);
+    TEST_ASSERT_EQUAL(0, tm_stats_query(&s_stats, &s_archive, 0, UINT32_MAX, &summary));
+    TEST_ASSERT_EQUAL_UINT32(s_archive.stats.pages_written + 1, summary.pages);
+    TEST_ASSERT_EQUAL_UINT32(bus_samples, summary.stat[TM_STAT_bus_mv].count);
+}
+
+void test_summary_frame_fits_one_packet_and_round_trips() {
+    uint8_t wire[TM_SUMMARY_WIRE_LEN];
+    TmStatsSummary_t summary;
+    TmSummaryFrame_t frame;
+
+    TEST_ASSERT_LESS_OR_EQUAL(CCSDS_MAX_PACKET_LEN, CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN +
+                              TM_SUMMARY_WIRE_LEN + CCSDS_CRC_LEN);
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    tm_stats_init(&s_stats);
+    TEST_ASSERT_EQUAL(0, tm_archive_set_trailer(&s_archive, TM_STATS_TRAILER_LEN, tm_stats_fill_trailer, &s_stats));
+    fly(0, 20000);
+    TEST_ASSERT_EQUAL(0, tm_stats_query(&s_stats, &s_archive, 0, UINT32_MAX, &summary));
+
+    TEST_ASSERT_EQUAL(TM_SUMMARY_WIRE_LEN, tm_summary_pack(4242, &summary, wire));
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_OK, tm_summary_unpack(wire, sizeof(wire), &frame));
+    TEST_ASSERT_EQUAL_UINT32(4242, frame.request_ts);
+    TEST_ASSERT_EQUAL_UINT32(summary.first_ts, frame.first_ts);
+    TEST_ASSERT_EQUAL_UINT32(summary.last_ts, frame.last_ts);
+    TEST_ASSERT_EQUAL_UINT32(summary.pages, frame.pages);
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        const TmStatsAgg_t *agg = &summary.stat[i];
+        uint32_t share = 0;
+
+        TEST_ASSERT_EQUAL_UINT32(agg->count, frame.stat[i].count);
+        TEST_ASSERT_EQUAL_INT32(agg->min, frame.stat[i].min);
+        TEST_ASSERT_EQUAL_INT32(agg->max, frame.stat[i].max);
+        TEST_ASSERT_INT_WITHIN(1, (int32_t)tm_stats_mean(agg), frame.stat[i].mean);
+        TEST_ASSERT_INT_WITHIN(1, (int32_t)tm_stats_stddev(agg), frame.stat[i].stddev);
+        TEST_ASSERT_EQUAL_UINT32(agg->below, frame.stat[i].below);
+        for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+            share += frame.stat[i].hist[b];
+        }
+        TEST_ASSERT_INT_WITHIN(TM_STATS_HIST_BINS / 2, 255, (int32_t)share);
+    }
+
+    wire[20] ^= 0x80;
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_CRC, tm_summary_unpack(wire, sizeof(wire), &frame));
+    TEST_ASSERT_EQUAL(PKT_SCHEMA_BAD_LENGTH, tm_summary_unpack(wire, sizeof(wire) - 1, &frame));
+}
+
+// --- BENCHMARK: summary of a day from trailers vs decoding it again ---
+void test_benchmark_query_vs_rescan() {
+    TmStatsSummary_t summary;
+    TmStats_t ref;
+    const uint32_t end = DAY_STEPS * TICKS_PER_STEP;
+    const int reps = 20;
+    HkSampleSet_t set;
+    uint32_t query_reads, rescan_reads, query_bytes, rescan_bytes;
+
+    TEST_ASSERT_EQUAL(0, tm_archive_format(&s_archive, &s_flash));
+    tm_stats_init(&s_stats);
+    TEST_ASSERT_EQUAL(0, tm_archive_set_trailer(&s_archive, TM_STATS_TRAILER_LEN, tm_stats_fill_trailer, &s_stats));
+    fly(0, DAY_STEPS);
+    TEST_ASSERT_EQUAL(0, tm_archive_flush(&s_archive));
+
+    // 1. Cost of one add (the logger pays it per archived set)
+    memset(&set, 0, sizeof(set));
+    set.present = (uint16_t)((1u << HK_PARAM_COUNT) - 1u);
+    tm_stats_init(&ref);
+    double t0 = now_s();
+    for (uint32_t i = 0; i < 1000000u; i++) {
+        set.value[HK_PARAM_bus_mv] = (int32_t)(2400u + (i & 1023u));
+        tm_stats_add(&ref, &set);
+    }
+    double add_ns = (now_s() - t0) * 1e9 / 1e6;
+
+    // 2. Whole day, both ways
+    s_reads = 0;
+    s_read_bytes = 0;
+    t0 = now_s();
+    for (int r = 0; r < reps; r++) {
+        tm_stats_query(&s_stats, &s_archive, 0, end, &summary);
+    }
+    double query_us = (now_s() - t0) * 1e6 / reps;
+    query_reads = s_reads / (uint32_t)reps;
+    query_bytes = s_read_bytes / (uint32_t)reps;
+
+    s_reads = 0;
+    s_read_bytes = 0;
+    t0 = now_s();
+    for (int r = 0; r < reps; r++) {
+        rescan(0, end, &ref);
+    }
+    double rescan_us = (now_s() - t0) * 1e6 / reps;
+    rescan_reads = s_reads / (uint32_t)reps;
+    rescan_bytes = s_read_bytes / (uint32_t)reps;
+
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        assert_agg_equal(&ref.page[i], &summary.stat[i]);
+    }
+    printf("TM STATS: add %.1f ns/set; day of %lu sets in %lu pages (trailer %u B of %u per page)\n",
+           add_ns, (unsigned long)s_stats.sets, (unsigned long)summary.pages, (unsigned)TM_STATS_TRAILER_LEN,
+           (unsigned)TM_ARCHIVE_PAGE_SIZE);
+    printf("TM STATS: day summary %.0f us, %lu flash reads (%lu B) | rescan %.0f us, %lu flash reads (%lu B) "
+           "(%.1fx faster, %.1fx fewer bytes)\n", query_us, (unsigned long)query_reads, (unsigned long)query_bytes,
+           rescan_us, (unsigned long)rescan_reads, (unsigned long)rescan_bytes, rescan_us / query_us,
+           (double)rescan_bytes / (double)query_bytes);
+    TEST_ASSERT_TRUE(query_us < rescan_us);
+    TEST_ASSERT_TRUE(query_bytes * 3 < rescan_bytes);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    remove(TEST_IMAGE);
+    TEST_ASSERT_EQUAL(0, flash_file_open(&s_file, TEST_IMAGE, TEST_SECTOR_SIZE, TEST_SECTORS));
+    s_flash = s_file;
+    s_flash.read = counting_read;
+    memset(&s_archive, 0, sizeof(s_archive));
+    s_seed = 1;
+}
+
+void tearDown(void) {
+    flash_file_close(&s_file);
+    remove(TEST_IMAGE);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_add_tracks_moments_limits_and_bins);
+    RUN_TEST(test_trailer_round_trip_and_crc);
+    RUN_TEST(test_query_matches_rescan_of_the_covered_span);
+    RUN_TEST(test_query_includes_the_page_still_in_ram);
+    RUN_TEST(test_summary_frame_fits_one_packet_and_round_trips);
+    RUN_TEST(test_benchmark_query_vs_rescan);
+
+    return UNITY_END();
+}
@@ -0,0 +1,538 @@
+// test/test_uplink_deframer.c
+
+#include <unity.h>               // Unity Test Framework
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "uplink_deframer.h"     // Functions to test: ring producer API, poll
+#include "ccsds_packet.h"        // Space packets to frame
+#include "utils.h"               // crc16_ccitt for the reference check
+
+#define TEST_RING_SIZE      512
+#define TEST_MAX_PACKETS    64
+#define BENCH_STREAM_LEN    (4u * 1024u * 1024u)
+#define BENCH_DMA_CHUNK     256u
+
+static const UplinkDeframerConfig_t s_cfg = {
+    .max_asm_errors = 2,
+    .slip_window_bits = 2,
+    .max_packet_len = CCSDS_MAX_PACKET_LEN,
+};
+
+static UplinkDeframer_t s_def;
+static uint8_t s_ring[TEST_RING_SIZE];
+
+// --- Captured packets ---
+static uint8_t s_got[TEST_MAX_PACKETS][CCSDS_MAX_PACKET_LEN];
+static uint16_t s_got_len[TEST_MAX_PACKETS];
+static uint8_t s_got_bit[TEST_MAX_PACKETS];
+static uint32_t s_got_count;
+static uint32_t s_wrapped;
+static uint32_t s_outside_ring;
+static uint32_t s_overfull;
+
+static void capture(void *ctx, const UplinkPacketView_t *packet) {
+    const uint8_t *ring = (const uint8_t *)ctx;
+    uint32_t ring_size = s_def.mask + 1u;
+
+    // Zero copy: both segments must point into the ring
+    for (int i = 0; i < 2; i++) {
+        if (packet->seg_len[i] != 0 &&
+            (packet->seg[i] < ring || packet->seg[i] + packet->seg_len[i] > ring + ring_size)) {
+            s_outside_ring++;
+        }
+    }
+    if (packet->seg_len[1] != 0) {
+        s_wrapped++;
+    }
+    // The tail never falls more than a ring behind the head
+    if (s_def.head - s_def.tail > ring_size) {
+        s_overfull++;
+    }
+    if (s_got_count < TEST_MAX_PACKETS) {
+        memcpy(s_got[s_got_count], packet->seg[0], packet->seg_len[0]);
+        memcpy(&s_got[s_got_count][packet->seg_len[0]], packet->seg[1], packet->seg_len[1]);
+        s_got_len[s_got_count] = packet->length;
+        s_got_bit[s_got_count] = packet->bit_offset;
+    }
+    s_got_count++;
+}
+
+// --- Bit stream builder (the ground station plus channel) ---
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t bits;
+} BitStream_t;
+
+static uint8_t s_stream_buf[8192];
+static BitStream_t s_stream;
+
+static void put_bits(BitStream_t *s, uint32_t value, unsigned count) {
+    while (count-- > 0 && (s->bits >> 3) < s->cap) {
+        uint8_t mask = (uint8_t)(0x80u >> (s->bits & 7u));
+        if ((value >> count) & 1u) {
+            s->buf[s->bits >> 3] |= mask;
+        } else {
+            s->buf[s->bits >> 3] &= (uint8_t)~mask;
+        }
+        s->bits++;
+    }
+}
+
+static size_t stream_bytes(BitStream_t *s) {
+    while (s->bits & 7u) {
+        put_bits(s, 0, 1);
+    }
+    return s->bits >> 3;
+}
+
+static uint32_t s_seed;
+static uint32_t prng(void) {
+    s_seed ^= s_seed << 13;
+    s_seed ^= s_seed >> 17;
+    s_seed ^= s_seed << 5;
+    return s_seed;
+}
+
+static void put_junk(BitStream_t *s, unsigned bits) {
+    while (bits >= 8) {
+        put_bits(s, prng() & 0xFFu, 8);
+        bits -= 8;
+    }
+    put_bits(s, prng(), bits);
+}
+
+// Builds a packet with `user_len` random bytes into pkt; returns its length
+static size_t make_packet(uint8_t *pkt, uint16_t seq, size_t user_len) {
+    uint8_t user[CCSDS_MAX_PACKET_LEN];
+    for (size_t i = 0; i < user_len; i++) {
+        user[i] = (uint8_t)prng();
+    }
+    return ccsds_build_packet(pkt, CCSDS_MAX_PACKET_LEN, CCSDS_TYPE_TC, APID_CDHS, seq, seq * 100u,
+                              user, user_len);
+}
+
+static void put_framed(BitStream_t *s, const uint8_t *pkt, size_t len, uint32_t asm_flips) {
+    put_bits(s, UPLINK_ASM ^ asm_flips, 32);
+    for (size_t i = 0; i < len; i++) {
+        put_bits(s, pkt[i], 8);
+    }
+}
+
+// Feeds the stream in `chunk` byte writes, polling after each
+static void feed(const uint8_t *data, size_t len, size_t chunk) {
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = (len - off < chunk) ? len - off : chunk;
+        TEST_ASSERT_EQUAL(n, uplink_deframer_rx_write(&s_def, &data[off], n));
+        uplink_deframer_poll(&s_def);
+    }
+}
+
+static void start(uint32_t ring_size) {
+    TEST_ASSERT_EQUAL(0, uplink_deframer_init(&s_def, s_ring, ring_size, &s_cfg, capture, s_ring));
+}
+
+// --- TESTS ---
+
+void test_init_rejects_bad_configuration() {
+    UplinkDeframerConfig_t cfg = s_cfg;
+
+    TEST_ASSERT_EQUAL(-1, uplink_deframer_init(&s_def, s_ring, 300, &cfg, capture, NULL));   // Not 2^n
+    TEST_ASSERT_EQUAL(-1, uplink_deframer_init(&s_def, s_ring, 128, &cfg, capture, NULL));   // < 2 packets
+    cfg.slip_window_bits = UPLINK_MAX_SLIP_BITS + 1;
+    TEST_ASSERT_EQUAL(-1, uplink_deframer_init(&s_def, s_ring, 256, &cfg, capture, NULL));
+    TEST_ASSERT_EQUAL(0, uplink_deframer_init(&s_def, s_ring, 256, &s_cfg, capture, NULL));
+}
+
+void test_clean_stream_delivers_every_packet_in_place() {
+    uint8_t pkt[20][CCSDS_MAX_PACKET_LEN];
+    size_t len[20];
+
+    start(TEST_RING_SIZE);
+    put_junk(&s_stream, 40);
+    for (int i = 0; i < 20; i++) {
+        len[i] = make_packet(pkt[i], (uint16_t)i, (size_t)(i * 5) % 100u);
+        put_framed(&s_stream, pkt[i], len[i], 0);
+    }
+    put_junk(&s_stream, 80);
+    feed(s_stream_buf, stream_bytes(&s_stream), 64);
+
+    TEST_ASSERT_EQUAL_UINT32(20, s_got_count);
+    for (int i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL(len[i], s_got_len[i]);
+        TEST_ASSERT_EQUAL_MEMORY(pkt[i], s_got[i], len[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, s_outside_ring);
+    TEST_ASSERT_TRUE(s_wrapped > 0);                    // 1.5 KB through a 512 B ring
+    TEST_ASSERT_EQUAL_UINT32(1, s_def.stats.acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(0, s_def.stats.crc_failures);
+    TEST_ASSERT_EQUAL_UINT32(1, s_def.stats.sync_losses);   // Junk after the last packet
+}
+
+void test_marker_bit_errors_up_to_the_limit() {
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    size_t len = make_packet(pkt, 7, 30);
+
+    // Two wrong bits: accepted and counted
+    start(TEST_RING_SIZE);
+    put_bits(&s_stream, 0x55555555u, 32);
+    put_framed(&s_stream, pkt, len, 0x80000001u);
+    feed(s_stream_buf, stream_bytes(&s_stream), 16);
+    TEST_ASSERT_EQUAL_UINT32(1, s_got_count);
+    TEST_ASSERT_EQUAL_UINT32(1, s_def.stats.asm_corrected);
+
+    // Three: not a marker
+    s_stream.bits = 0;
+    s_got_count = 0;
+    start(TEST_RING_SIZE);
+    put_bits(&s_stream, 0x55555555u, 32);
+    put_framed(&s_stream, pkt, len, 0x80010001u);
+    feed(s_stream_buf, stream_bytes(&s_stream), 16);
+    TEST_ASSERT_EQUAL_UINT32(0, s_got_count);
+    TEST_ASSERT_EQUAL_UINT32(0, s_def.stats.acquisitions);
+}
+
+void test_every_bit_alignment() {
+    uint8_t pkt[3][CCSDS_MAX_PACKET_LEN];
+    size_t len[3];
+
+    for (unsigned b = 0; b < 8; b++) {
+        s_stream.bits = 0;
+        s_got_count = 0;
+        start(TEST_RING_SIZE);
+        put_junk(&s_stream, 24 + b);
+        for (int i = 0; i < 3; i++) {
+            len[i] = make_packet(pkt[i], (uint16_t)i, 10u + 20u * (unsigned)i);
+            put_framed(&s_stream, pkt[i], len[i], 0);
+        }
+        put_junk(&s_stream, 64);
+        feed(s_stream_buf, stream_bytes(&s_stream), 7);
+
+        TEST_ASSERT_EQUAL_UINT32(3, s_got_count);
+        for (int i = 0; i < 3; i++) {
+            TEST_ASSERT_EQUAL(b, s_got_bit[i]);
+            TEST_ASSERT_EQUAL_MEMORY(pkt[i], s_got[i], len[i]);
+        }
+    }
+}
+
+void test_bit_slip_inside_window_keeps_lock() {
+    uint8_t pkt[4][CCSDS_MAX_PACKET_LEN];
+    size_t len[4];
+
+    start(TEST_RING_SIZE);
+    put_junk(&s_stream, 32);
+    for (int i = 0; i < 4; i++) {
+        len[i] = make_packet(pkt[i], (uint16_t)i, 40);
+    }
+    put_framed(&s_stream, pkt[0], len[0], 0);
+    put_bits(&s_stream, 1, 1);                      // +1 bit
+    put_framed(&s_stream, pkt[1], len[1], 0);
+    put_bits(&s_stream, 2, 2);                      // +2 bits, still inside the window
+    put_framed(&s_stream, pkt[2], len[2], 0x00000100u);
+    put_bits(&s_stream, 5, 3);                      // +3 bits: lock lost, marker hunted again
+    put_framed(&s_stream, pkt[3], len[3], 0);
+    put_junk(&s_stream, 64);
+    feed(s_stream_buf, stream_bytes(&s_stream), 32);
+
+    TEST_ASSERT_EQUAL_UINT32(4, s_got_count);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_MEMORY(pkt[i], s_got[i], len[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, s_def.stats.bit_slips);
+    TEST_ASSERT_EQUAL_UINT32(2, s_def.stats.acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(2, s_def.stats.sync_losses);   // After packets 2 and 3
+    TEST_ASSERT_EQUAL_UINT32(1, s_def.stats.asm_corrected);
+}
+
+// Frames a packet whose CRC ends in a 0 bit and drops that bit: the packet
+// still checks out (the marker's first bit stands in for it) and the next
+// marker arrives one bit early. Returns the stream byte holding that marker.
+static size_t put_framed_short_by_one_bit(BitStream_t *s, uint8_t *pkt, uint16_t seq) {
+    size_t len;
+
+    do {
+        len = make_packet(pkt, seq, 40);
+    } while (pkt[len - 1] & 1u);
+    put_bits(s, UPLINK_ASM, 32);
+    for (size_t i = 0; i + 1 < len; i++) {
+        put_bits(s, pkt[i], 8);
+    }
+    put_bits(s, pkt[len - 1] >> 1, 7);
+    return (s->bits + 1u) >> 3;
+}
+
+void test_negative_slip_on_a_full_ring_keeps_the_tail() {
+    uint8_t pkt[2][CCSDS_MAX_PACKET_LEN];
+    size_t end, len1, total;
+    UplinkDeframerStats_t stats;
+
+    for (int corrupt = 0; corrupt < 2; corrupt++) {
+        memset(&s_stream, 0, sizeof(s_stream));
+        s_stream.buf = s_stream_buf;
+        s_stream.cap = sizeof(s_stream_buf);
+        s_got_count = 0;
+        s_overfull = 0;
+        start(TEST_RING_SIZE);
+
+        // 1. Packet 0 one bit short, packet 1 (CRC broken on the second pass), then fill
+        put_junk(&s_stream, 32);
+        end = put_framed_short_by_one_bit(&s_stream, pkt[0], 1);
+        len1 = make_packet(pkt[1], 2, 60);
+        pkt[1][len1 - 1] ^= (uint8_t)corrupt;
+        put_framed(&s_stream, pkt[1], len1, 0);
+        put_junk(&s_stream, 8 * (TEST_RING_SIZE + 64));
+        total = stream_bytes(&s_stream);
+
+        // 2. Packet 0 is delivered before its successor's marker is in
+        TEST_ASSERT_EQUAL(end + 3, uplink_deframer_rx_write(&s_def, s_stream_buf, end + 3));
+        uplink_deframer_poll(&s_def);
+        TEST_ASSERT_EQUAL_UINT32(1, s_got_count);
+        TEST_ASSERT_EQUAL(end, s_def.tail);
+
+        // 3. The producer refills the whole ring before the consumer runs again
+        TEST_ASSERT_EQUAL(TEST_RING_SIZE - 3, uplink_deframer_rx_write(&s_def, &s_stream_buf[end + 3], total - end - 3));
+        TEST_ASSERT_EQUAL(TEST_RING_SIZE, s_def.head - s_def.tail);
+        uplink_deframer_poll(&s_def);
+
+        uplink_deframer_get_stats(&s_def, &stats);
+        TEST_ASSERT_EQUAL_UINT32(1, stats.bit_slips);
+        TEST_ASSERT_EQUAL_UINT32(0, s_overfull);
+        TEST_ASSERT_TRUE((int32_t)(s_def.tail - end) >= 0);
+        TEST_ASSERT_TRUE(s_def.head - s_def.tail <= TEST_RING_SIZE);
+        TEST_ASSERT_EQUAL_MEMORY(pkt[0], s_got[0], CCSDS_PRIMARY_HEADER_LEN + CCSDS_SECONDARY_HEADER_LEN + 40);
+        if (corrupt) {
+            // The re-hunt starts at the tail, not in the released byte before it
+            TEST_ASSERT_EQUAL_UINT32(1, stats.crc_failures);
+            TEST_ASSERT_EQUAL_UINT32(1, s_got_count);
+        } else {
+            TEST_ASSERT_EQUAL_UINT32(2, s_got_count);
+            TEST_ASSERT_EQUAL_MEMORY(pkt[1], s_got[1], len1);
+        }
+    }
+}
+
+void test_rejected_packets_do_not_hide_the_next_one() {
+    uint8_t pkt[3][CCSDS_MAX_PACKET_LEN];
+    size_t len[3];
+
+    start(TEST_RING_SIZE);
+    for (int i = 0; i < 3; i++) {
+        len[i] = make_packet(pkt[i], (uint16_t)i, 50);
+    }
+
+    // 1. A false marker in the junk, followed by an impossible header
+    put_bits(&s_stream, UPLINK_ASM, 32);
+    put_bits(&s_stream, 0xE0000000u, 32);           // Version 7
+    put_junk(&s_stream, 13);
+
+    // 2. A real packet with a payload bit flipped, then two good ones. The
+    //    second good one starts inside what the corrupted packet announced.
+    uint8_t bad[CCSDS_MAX_PACKET_LEN];
+    memcpy(bad, pkt[0], len[0]);
+    bad[8] ^= 0x04;
+    put_framed(&s_stream, bad, 12, 0);              // Cut short: next marker inside its length
+    put_framed(&s_stream, pkt[1], len[1], 0);
+    put_framed(&s_stream, pkt[2], len[2], 0);
+    put_junk(&s_stream, 64);
+    feed(s_stream_buf, stream_bytes(&s_stream), 5);
+
+    TEST_ASSERT_EQUAL_UINT32(2, s_got_count);
+    TEST_ASSERT_EQUAL_MEMORY(pkt[1], s_got[0], len[1]);
+    TEST_ASSERT_EQUAL_MEMORY(pkt[2], s_got[1], len[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, s_def.stats.header_errors);
+    TEST_ASSERT_EQUAL_UINT32(1, s_def.stats.crc_failures);
+}
+
+void test_byte_at_a_time_through_a_small_ring() {
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    uint32_t sent = 0;
+
+    start(256);
+    put_junk(&s_stream, 19);
+    for (int i = 0; i < 40; i++) {
+        size_t len = make_packet(pkt, (uint16_t)i, (size_t)(prng() % 100u));
+        put_framed(&s_stream, pkt, len, 0);
+        sent++;
+    }
+    put_junk(&s_stream, 64);
+    feed(s_stream_buf, stream_bytes(&s_stream), 1);
+
+    TEST_ASSERT_EQUAL_UINT32(sent, s_got_count);
+    TEST_ASSERT_TRUE(s_wrapped > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, s_outside_ring);
+    for (uint32_t i = 0; i < sent; i++) {
+        size_t body = s_got_len[i] - CCSDS_CRC_LEN;
+        TEST_ASSERT_EQUAL_HEX16(ccsds_get_be16(&s_got[i][body]), crc16_ccitt(s_got[i], body));
+    }
+}
+
+void test_full_ring_counts_overrun() {
+    uint8_t junk[TEST_RING_SIZE + 100];
+
+    start(TEST_RING_SIZE);
+    memset(junk, 0x55, sizeof(junk));
+    TEST_ASSERT_EQUAL(TEST_RING_SIZE, uplink_deframer_rx_write(&s_def, junk, sizeof(junk)));
+    TEST_ASSERT_EQUAL_UINT32(100, s_def.stats.overrun_bytes);
+
+    // Hunting frees the ring (minus the bytes a marker could still span)
+    uplink_deframer_poll(&s_def);
+    TEST_ASSERT_EQUAL(100, uplink_deframer_rx_write(&s_def, junk, 100));
+    TEST_ASSERT_EQUAL_UINT32(TEST_RING_SIZE + 100, s_def.stats.bytes_in);
+}
+
+// --- BENCHMARK: noisy synthetic stream fed in DMA-sized chunks ---
+
+static uint8_t s_bench[BENCH_STREAM_LEN];
+static uint32_t s_bench_packets;
+
+static void count_packet(void *ctx, const UplinkPacketView_t *packet) {
+    (void)ctx;
+    (void)packet;
+    s_bench_packets++;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Runs the whole buffer through a deframer the way a DMA driver would:
+// reserve, fill, commit, poll. Returns MB/s.
+static double run_stream(const uint8_t *data, size_t len) {
+    static uint8_t ring[4096];
+    double t0 = now_s();
+
+    TEST_ASSERT_EQUAL(0, uplink_deframer_init(&s_def, ring, sizeof(ring), &s_cfg, count_packet, NULL));
+    s_bench_packets = 0;
+    for (size_t off = 0; off < len;) {
+        size_t span;
+        uint8_t *dst = uplink_deframer_rx_reserve(&s_def, &span);
+        if (span > BENCH_DMA_CHUNK) {
+            span = BENCH_DMA_CHUNK;
+        }
+        if (span > len - off) {
+            span = len - off;
+        }
+        memcpy(dst, &data[off], span);              // Stands in for the DMA engine
+        uplink_deframer_rx_commit(&s_def, span);
+        uplink_deframer_poll(&s_def);
+        off += span;
+    }
+    return (double)len / (now_s() - t0) / 1e6;
+}
+
+// Reference: bit-serial marker search (one shift and an early-out Hamming
+// distance per bit)
+static uint32_t ref_hunt(const uint8_t *data, size_t len) {
+    uint32_t reg = 0, found = 0;
+    for (size_t i = 0; i < len; i++) {
+        for (int b = 7; b >= 0; b--) {
+            reg = (reg << 1) | ((data[i] >> b) & 1u);
+            uint32_t x = reg ^ UPLINK_ASM;
+            unsigned errors = 0;
+            while (x != 0 && errors <= s_cfg.max_asm_errors) {
+                x &= x - 1u;
+                errors++;
+            }
+            found += (errors <= s_cfg.max_asm_errors);
+        }
+    }
+    return found;
+}
+
+void test_benchmark_noisy_stream() {
+    BitStream_t bench = { s_bench, sizeof(s_bench), 0 };
+    uint8_t pkt[CCSDS_MAX_PACKET_LEN];
+    uint32_t sent = 0, flips = 0;
+
+    // 1. Bursts of 1..8 back-to-back packets with idle or random gaps; now
+    //    and then a marker bit error or a slipped bit
+    while (bench.bits / 8u + 16u * (CCSDS_MAX_PACKET_LEN + 8u) < sizeof(s_bench)) {
+        int burst = 1 + (int)(prng() % 8u);
+        put_junk(&bench, 8u + prng() % 200u);
+        for (int i = 0; i < burst; i++) {
+            size_t len = make_packet(pkt, (uint16_t)sent, (size_t)(prng() % 112u));
+            uint32_t asm_flips = (prng() % 16u == 0) ? (1u << (prng() % 32u)) : 0;
+            if (i > 0 && prng() % 32u == 0) {
+                put_bits(&bench, 0, 1);
+            }
+            put_framed(&bench, pkt, len, asm_flips);
+            sent++;
+        }
+    }
+    size_t len = stream_bytes(&bench);
+
+    // 2. Channel bit errors (BER 1e-5) on top
+    for (size_t bit = prng() % 100000u; bit < len * 8u; bit += 1u + prng() % 200000u) {
+        s_bench[bit >> 3] ^= (uint8_t)(0x80u >> (bit & 7u));
+        flips++;
+    }
+
+    double noisy_mbps = run_stream(s_bench, len);
+    UplinkDeframerStats_t stats = s_def.stats;
+
+    // 3. Pure noise: hunting all the way, word-at-a-time vs bit-serial
+    for (size_t i = 0; i < len; i++) {
+        s_bench[i] = (uint8_t)prng();
+    }
+    double hunt_mbps = run_stream(s_bench, len);
+    double t0 = now_s();
+    uint32_t ref_found = ref_hunt(s_bench, len);
+    double ref_mbps = (double)len / (now_s() - t0) / 1e6;
+
+    printf("UPLINK DEFRAMER: %lu packets sent in %lu KB, %lu bit errors -> %lu delivered, %lu CRC failures, "
+           "%lu header errors, %lu corrected markers, %lu slips, %lu sync losses\n",
+           (unsigned long)sent, (unsigned long)(len / 1024u), (unsigned long)flips,
+           (unsigned long)stats.packets, (unsigned long)stats.crc_failures, (unsigned long)stats.header_errors,
+           (unsigned long)stats.asm_corrected, (unsigned long)stats.bit_slips, (unsigned long)stats.sync_losses);
+    printf("UPLINK DEFRAMER: noisy stream %.1f MB/s | pure noise hunt %.1f MB/s (%lu false markers) | "
+           "bit-serial hunt %.1f MB/s (%lu)\n", noisy_mbps, hunt_mbps,
+           (unsigned long)s_def.stats.acquisitions, ref_mbps, (unsigned long)ref_found);
+
+    // Each bit error costs at most the packet it hits (and the one behind a
+    // damaged marker); everything else gets through
+    TEST_ASSERT_TRUE(stats.packets + 2u * flips >= sent);
+    TEST_ASSERT_TRUE(stats.packets <= sent);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overrun_bytes);
+    TEST_ASSERT_TRUE(stats.bit_slips > 0);
+    TEST_ASSERT_TRUE(hunt_mbps > ref_mbps);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    memset(s_stream_buf, 0, sizeof(s_stream_buf));
+    s_stream.buf = s_stream_buf;
+    s_stream.cap = sizeof(s_stream_buf);
+    s_stream.bits = 0;
+    s_got_count = 0;
+    s_wrapped = 0;
+    s_outside_ring = 0;
+    s_overfull = 0;
+    s_seed = 0x2545F491u;
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_init_rejects_bad_configuration);
+    RUN_TEST(test_clean_stream_delivers_every_packet_in_place);
+    RUN_TEST(test_marker_bit_errors_up_to_the_limit);
+    RUN_TEST(test_every_bit_alignment);
+    RUN_TEST(test_bit_slip_inside_window_keeps_lock);
+    RUN_TEST(test_negative_slip_on_a_full_ring_keeps_the_tail);
+    RUN_TEST(test_rejected_packets_do_not_hide_the_next_one);
+    RUN_TEST(test_byte_at_a_time_through_a_small_ring);
+    RUN_TEST(test_full_ring_counts_overrun);
+    RUN_TEST(test_benchmark_noisy_stream);
+
+    return UNITY_END();
+}
@@ -0,0 +1,197 @@
+// test/test_watchdog.c
+
+#include <unity.h>               // Unity Test Framework
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "watchdog.h"            // Functions to test: pet/check/configure/get_stats
+#include "state_manager.h"       // Escalation target (MODE_CRITICAL)
+#include "satellite_types.h"
+#include <stdio.h>
+
+// --- GLOBAL VARIABLE DEFINITIONS FOR HOST TESTING ---
+SemaphoreHandle_t xModeMutex;
+
+// Simulated clock (1 tick = 1 ms with the host pdMS_TO_TICKS)
+static TickType_t s_now;
+
+TickType_t xTaskGetTickCount(void) {
+    return s_now;
+}
+
+static const uint32_t s_periods_ms[WDT_TASK_COUNT] = {
+    [WDT_TASK_TM_GEN] = 5000, [WDT_TASK_CMD_PROC] = 100, [WDT_TASK_EPS_MON] = 100,
+    [WDT_TASK_DATA_LOG] = 100, [WDT_TASK_ROUTER] = 1000, [WDT_TASK_TC_SCHED] = 5000,
+};
+
+static int s_hook_calls;
+static WatchdogTaskID_t s_hook_task;
+
+static void restart_hook(WatchdogTaskID_t task_id) {
+    s_hook_calls++;
+    s_hook_task = task_id;
+}
+
+// Event-driven run: the clock jumps to the next pet or to the deadline the
+// watchdog asked to wake up for, whichever is first. `hung` stops petting at
+// `hang_at`. Returns the time the first escalation happened (0 if none).
+static TickType_t run_until(TickType_t end, int hung, TickType_t hang_at) {
+    TickType_t next_pet[WDT_TASK_COUNT];
+    TickType_t wake = watchdog_check(s_now);
+    TickType_t wake_at = s_now + wake;
+    uint32_t expiries_before = 0, expiries;
+    TickType_t fired_at = 0;
+    WatchdogTaskStats_t stats;
+
+    for (int i = 0; i < WDT_TASK_COUNT; i++) {
+        next_pet[i] = s_now + s_periods_ms[i];
+        watchdog_get_stats((WatchdogTaskID_t)i, &stats);
+        expiries_before += stats.expiries;
+    }
+
+    while (s_now < end) {
+        TickType_t t = wake_at;
+        for (int i = 0; i < WDT_TASK_COUNT; i++) {
+            if (next_pet[i] < t) {
+                t = next_pet[i];
+            }
+        }
+        s_now = t;
+
+        for (int i = 0; i < WDT_TASK_COUNT; i++) {
+            if (next_pet[i] == s_now) {
+                if (!(i == hung && s_now >= hang_at)) {
+                    watchdog_pet((WatchdogTaskID_t)i);
+                }
+                next_pet[i] += s_periods_ms[i];
+            }
+        }
+        if (s_now == wake_at) {
+            wake_at = s_now + watchdog_check(s_now);
+
+            expiries = 0;
+            for (int i = 0; i < WDT_TASK_COUNT; i++) {
+                watchdog_get_stats((WatchdogTaskID_t)i, &stats);
+                expiries += stats.expiries;
+            }
+            if (fired_at == 0 && expiries > expiries_before) {
+                fired_at = s_now;
+            }
+        }
+    }
+    return fired_at;
+}
+
+// --- TEST FUNCTIONS ---
+
+void test_monitor_sleeps_until_earliest_deadline() {
+    // 1. Right after init the nearest deadline is EPS_MON's 1 s one
+    TEST_ASSERT_EQUAL_UINT32(1000, watchdog_check(s_now));
+
+    // 2. A 100 ms task keeps it there: the 1 s deadline is re-armed on every pet
+    s_now = 900;
+    watchdog_pet(WDT_TASK_EPS_MON);
+    TEST_ASSERT_EQUAL_UINT32(1000, watchdog_check(s_now));     // EPS_MON again, at 1900
+
+    // 3. Healthy system: ten minutes without a single escalation
+    TEST_ASSERT_EQUAL_UINT32(0, run_until(600000, -1, 0));
+    TEST_ASSERT_EQUAL(MODE_SAFE, get_system_mode());
+}
+
+void test_hung_fast_task_detected_at_its_own_deadline() {
+    // CMD_PROC pets every 100 ms and stops at T = 10 s. The last pet was at
+    // 9900 ms, so the 3 s budget runs out at 12900 ms, long before the 15 s
+    // shared timeout the old scan used.
+    TickType_t fired_at = run_until(60000, WDT_TASK_CMD_PROC, 10000);
+    WatchdogTaskStats_t stats;
+
+    printf("WATCHDOG: hung CMD_PROC detected %u ms after its last pet\n", fired_at - 9900);
+    TEST_ASSERT_EQUAL_UINT32(12900, fired_at);
+    TEST_ASSERT_EQUAL(MODE_CRITICAL, get_system_mode());
+
+    // Escalated once per outage, not on every wake-up
+    watchdog_get_stats(WDT_TASK_CMD_PROC, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.expiries);
+    watchdog_get_stats(WDT_TASK_EPS_MON, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.expiries);
+}
+
+void test_pet_interval_and_jitter_statistics() {
+    const TickType_t intervals[] = { 90, 110, 100, 100, 130, 70 };
+    WatchdogTaskStats_t stats;
+
+    watchdog_pet(WDT_TASK_DATA_LOG);                 // First pet: boot skew, not counted
+    for (size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++) {
+        s_now += intervals[i];
+        watchdog_pet(WDT_TASK_DATA_LOG);
+    }
+
+    watchdog_get_stats(WDT_TASK_DATA_LOG, &stats);
+    TEST_ASSERT_EQUAL_UINT32(7, stats.pets);
+    TEST_ASSERT_EQUAL_UINT32(70, stats.interval_min_ticks);
+    TEST_ASSERT_EQUAL_UINT32(130, stats.interval_max_ticks);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.interval_sum_ticks / (stats.pets - 1));
+    TEST_ASSERT_EQUAL_UINT32(30, stats.jitter_max_ticks);
+    TEST_ASSERT_EQUAL_UINT32(10 + 10 + 0 + 0 + 30 + 30, stats.jitter_sum_ticks);
+    TEST_ASSERT_EQUAL_UINT32(5000 - 130, stats.slack_min_ticks);
+}
+
+void test_escalation_actions() {
+    WatchdogConfig_t cfg = { 100, 500, WDT_ACTION_LOG };
+    const WatchdogConfig_t data_log_default = { 100, 5000, WDT_ACTION_LOG };
+
+    // 1. LOG: reported, mode untouched
+    watchdog_configure(WDT_TASK_DATA_LOG, &cfg);
+    s_now = 500;
+    watchdog_check(s_now);
+    TEST_ASSERT_EQUAL(MODE_SAFE, get_system_mode());
+
+    // 2. RESTART with a hook: the hook decides
+    cfg.action = WDT_ACTION_RESTART;
+    watchdog_configure(WDT_TASK_DATA_LOG, &cfg);
+    watchdog_set_restart_hook(restart_hook);
+    watchdog_pet(WDT_TASK_DATA_LOG);                 // Recovered: supervised again
+    watchdog_pet(WDT_TASK_EPS_MON);                  // Keep the 1 s EPS deadline out of the way
+    s_now = 1000;
+    watchdog_check(s_now);
+    TEST_ASSERT_EQUAL(1, s_hook_calls);
+    TEST_ASSERT_EQUAL(WDT_TASK_DATA_LOG, s_hook_task);
+    TEST_ASSERT_EQUAL(MODE_SAFE, get_system_mode());
+
+    // 3. RESTART without a hook falls back to MODE_CRITICAL
+    watchdog_set_restart_hook(NULL);
+    watchdog_pet(WDT_TASK_DATA_LOG);
+    watchdog_pet(WDT_TASK_EPS_MON);
+    s_now = 1500;
+    watchdog_check(s_now);
+    TEST_ASSERT_EQUAL(MODE_CRITICAL, get_system_mode());
+
+    WatchdogTaskStats_t stats;
+    watchdog_get_stats(WDT_TASK_DATA_LOG, &stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.expiries);
+
+    watchdog_configure(WDT_TASK_DATA_LOG, &data_log_default);
+}
+
+// -----------------------------------------------------------
+// Standard PlatformIO/Unity Test Runner Boilerplate
+
+void setUp(void) {
+    s_now = 0;
+    s_hook_calls = 0;
+    watchdog_set_restart_hook(NULL);
+    state_manager_init();
+    watchdog_init();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_monitor_sleeps_until_earliest_deadline);
+    RUN_TEST(test_hung_fast_task_detected_at_its_own_deadline);
+    RUN_TEST(test_pet_interval_and_jitter_statistics);
+    RUN_TEST(test_escalation_actions);
+
+    return UNITY_END();
+}
@@ -1,7 +1,20 @@
+#ifndef TEST_FREERTOS_H
+#define TEST_FREERTOS_H
 #define pdTRUE 1
 #define pdFALSE 0
 #define pdPASS 1
+#define pdFAIL 0
 #define portMAX_DELAY 0xFFFF
 typedef void * QueueHandle_t;
 typedef void * SemaphoreHandle_t;
-typedef int BaseType_t;
\ No newline at end of file
+typedef int BaseType_t;
+typedef unsigned int TickType_t;
+#define portTICK_PERIOD_MS 1
+// Mock the critical section (host tests only run one writer at a time)
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portMUX_INITIALIZE(mux) (*(mux) = 0)
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+#endif
@@ -1,5 +1,8 @@
+#ifndef TEST_SEMPHR_H
+#define TEST_SEMPHR_H
 #include "FreeRTOS.h"
 // Mock the Mutex creation and access functions
 #define xSemaphoreCreateMutex() ((SemaphoreHandle_t)1)
 #define xSemaphoreTake(x, t) pdTRUE
-#define xSemaphoreGive(x) pdTRUE
\ No newline at end of file
+#define xSemaphoreGive(x) pdTRUE
+#endif
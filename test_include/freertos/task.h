@@ -1,3 +1,14 @@
+#ifndef TEST_TASK_H
+#define TEST_TASK_H
 #include "FreeRTOS.h"
 #define pdMS_TO_TICKS(x) (x)
-#define vTaskDelay(x) {}
\ No newline at end of file
+#define vTaskDelay(x) {}
+#define vTaskDelayUntil(prev, period) ((void)(prev), (void)(period))
+typedef void * TaskHandle_t;
+#define xTaskGetCurrentTaskHandle() ((TaskHandle_t)0)
+#define xTaskNotifyGive(h) ((void)(h))
+#define ulTaskNotifyTake(clear, t) ((void)(clear), (void)(t))
+// Provided by the test so it can drive time
+TickType_t xTaskGetTickCount(void);
+
+#endif
@@ -0,0 +1,256 @@
+// tools/tm_decode.c
+// Ground-side decoder for downlinked housekeeping (see include/packet_schema.h).
+//
+//   gcc -std=c99 -D_GNU_SOURCE -O2 -Iinclude tools/tm_decode.c src/packet_schema.c
+//       src/hk_compress.c src/hk_sched.c src/tm_stats.c src/tm_archive.c src/ccsds_packet.c
+//       src/crc16.c src/utils.c src/rs_fec.c src/downlink_fec.c -lm -o tm_decode
+//   tm_decode [--limit N] [--fec DEPTH] downlink.bin
+//
+// With --fec the file holds RS codeblocks of that interleave depth
+// (DATA_LOGGER_FEC_DEPTH, downlink_fec.h), as fsw_host records it; they are
+// corrected first and the packets inside go on as below. Without it:
+// reads CCSDS space packets back to back (a DATA_LOGGER_FEC_DEPTH 0 run), checks
+// the packet CRC, and prints one line per HK record: plain records
+// (APID_HOUSEKEEPING) through hk_tm_unpack(), compressed frames
+// (APID_HK_COMPRESSED) through hk_decode_frame(), TC_REQUEST_HK answers
+// (APID_HK_RESPONSE) through hk_response_unpack(), multi-rate sample sets
+// (APID_HK_SAMPLES) through hk_samples_unpack(), TC_REQUEST_SUMMARY answers
+// (APID_TM_SUMMARY) through tm_summary_unpack(). The field lists come from
+// HK_TM_SCHEMA and HK_PARAM_TABLE; only a new wire type needs a printer here.
+
+#include "ccsds_packet.h"
+#include "downlink_fec.h"
+#include "hk_compress.h"
+#include "hk_sched.h"
+#include "packet_schema.h"
+#include "tm_stats.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t packets;
+    uint32_t bad_packets;       // Header or packet CRC wrong
+    uint32_t plain_records;
+    uint32_t compressed_frames;
+    uint32_t compressed_records;
+    uint32_t responses;
+    uint32_t sample_sets;
+    uint32_t summaries;
+    uint32_t bad_records;       // Record length/CRC or frame CRC wrong
+    uint32_t other_apids;
+} DecodeStats_t;
+
+static DecodeStats_t s_stats;
+static uint32_t s_printed;
+static uint32_t s_limit = UINT32_MAX;
+
+// --- A. FIELD PRINTERS (one per wire type) ---
+
+static void print_U16(const char *name, uint32_t v) { printf(" %s=%u", name, (unsigned)v); }
+static void print_U32(const char *name, uint32_t v) { printf(" %s=%lu", name, (unsigned long)v); }
+static void print_F32(const char *name, float v)    { printf(" %s=%.3f", name, (double)v); }
+
+static void print_FLAGS(const char *name, HK_StatusFlags_t v) {
+    printf(" %s=0x%02X(mode %u%s%s%s)", name, hk_flags_pack(&v), (unsigned)v.system_mode,
+           v.flg_low_voltage ? " LOW_V" : "", v.flg_antenna_armed ? " ANT" : "",
+           v.flg_reset_pending ? " RST" : "");
+}
+
+static void print_record(const char *kind, uint64_t met, const HK_Telemetry_t *pkt) {
+    if (s_printed++ >= s_limit) {
+        return;
+    }
+    printf("MET %10llu %-4s", (unsigned long long)met, kind);
+#define PRINT_FIELD(name, type) print_##type(#name, pkt->name);
+    HK_TM_SCHEMA(PRINT_FIELD)
+#undef PRINT_FIELD
+    printf(" crc=0x%04X\n", pkt->crc_checksum);
+}
+
+// Only the parameters present in the set
+static void print_sample_set(uint64_t met, const HkSampleSet_t *set) {
+    if (s_printed++ >= s_limit) {
+        return;
+    }
+    printf("MET %10llu %-4s timestamp=%lu", (unsigned long long)met, "HKS", (unsigned long)set->timestamp);
+    for (uint32_t i = 0; i < HK_PARAM_COUNT; i++) {
+        if (set->present & (1u << i)) {
+            printf(" %s=%ld", hk_param_name((HkParamId_t)i), (long)set->value[i]);
+        }
+    }
+    printf("\n");
+}
+
+// One line per statistic of a window summary
+static void print_summary(uint64_t met, const TmSummaryFrame_t *frame) {
+    if (s_printed++ >= s_limit) {
+        return;
+    }
+    printf("SUMMARY for request T %lu: T %lu..%lu from %u pages (%u missing)\n",
+           (unsigned long)frame->request_ts, (unsigned long)frame->first_ts,
+           (unsigned long)frame->last_ts, (unsigned)frame->pages, (unsigned)frame->pages_missing);
+    for (uint32_t i = 0; i < TM_STATS_COUNT; i++) {
+        const TmSummaryStat_t *st = &frame->stat[i];
+        printf("MET %10llu %-4s %s count=%lu min=%d max=%d mean=%d stddev=%u below=%u above=%u hist255=",
+               (unsigned long long)met, "SUM", tm_stats_name((TmStatId_t)i), (unsigned long)st->count,
+               st->min, st->max, st->mean, (unsigned)st->stddev, (unsigned)st->below, (unsigned)st->above);
+        for (uint32_t b = 0; b < TM_STATS_HIST_BINS; b++) {
+            printf("%s%u", (b > 0) ? "," : "", (unsigned)st->hist[b]);
+        }
+        printf("\n");
+    }
+}
+
+// --- B. PACKETS ---
+
+static void decode_packet(const uint8_t *packet, size_t len) {
+    static HK_Telemetry_t records[CCSDS_MAX_PACKET_LEN];
+    CCSDS_PrimaryHeader_t hdr;
+    CCSDS_SecondaryHeader_t sec = { 0 };
+    const uint8_t *user;
+    size_t user_len = 0, count = 0;
+
+    s_stats.packets++;
+    if (ccsds_decode_primary(packet, len, &hdr) != 0 || len < CCSDS_CRC_LEN ||
+        crc16_ccitt(packet, len - CCSDS_CRC_LEN) != ccsds_get_be16(&packet[len - CCSDS_CRC_LEN]) ||
+        (user = ccsds_user_data(packet, &hdr, &user_len)) == NULL) {
+        s_stats.bad_packets++;
+        return;
+    }
+    ccsds_decode_secondary(packet, len, &sec);
+
+    if (hdr.apid == APID_HOUSEKEEPING) {
+        HK_Telemetry_t pkt;
+        if (hk_tm_unpack(user, user_len, &pkt) != PKT_SCHEMA_OK) {
+            s_stats.bad_records++;
+            return;
+        }
+        s_stats.plain_records++;
+        print_record("HK", sec.met, &pkt);
+    } else if (hdr.apid == APID_HK_COMPRESSED) {
+        if (hk_decode_frame(user, user_len, records, CCSDS_MAX_PACKET_LEN, &count) != 0) {
+            s_stats.bad_records++;
+            return;
+        }
+        s_stats.compressed_frames++;
+        s_stats.compressed_records += (uint32_t)count;
+        for (size_t i = 0; i < count; i++) {
+            print_record("HKZ", sec.met, &records[i]);
+        }
+    } else if (hdr.apid == APID_HK_SAMPLES) {
+        HkSampleSet_t set;
+        if (hk_samples_unpack(user, user_len, &set) != PKT_SCHEMA_OK) {
+            s_stats.bad_records++;
+            return;
+        }
+        s_stats.sample_sets++;
+        print_sample_set(sec.met, &set);
+    } else if (hdr.apid == APID_HK_RESPONSE) {
+        HK_Telemetry_t pkt;
+        uint32_t request_timestamp;
+        if (hk_response_unpack(user, user_len, &request_timestamp, &pkt) != PKT_SCHEMA_OK) {
+            s_stats.bad_records++;
+            return;
+        }
+        s_stats.responses++;
+        if (s_printed < s_limit) {
+            printf("REQUEST T %lu answered:\n", (unsigned long)request_timestamp);
+        }
+        print_record("RSP", sec.met, &pkt);
+    } else if (hdr.apid == APID_TM_SUMMARY) {
+        TmSummaryFrame_t frame;
+        if (tm_summary_unpack(user, user_len, &frame) != PKT_SCHEMA_OK) {
+            s_stats.bad_records++;
+            return;
+        }
+        s_stats.summaries++;
+        print_summary(sec.met, &frame);
+    } else {
+        s_stats.other_apids++;
+    }
+}
+
+static void decode_fec_packet(void *ctx, const uint8_t *packet, size_t len) {
+    (void)ctx;
+    decode_packet(packet, len);
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    unsigned fec_depth = 0;
+    uint8_t packet[CCSDS_MAX_PACKET_LEN];
+    static uint8_t block[DOWNLINK_FEC_BLOCK_LEN(DOWNLINK_FEC_MAX_DEPTH)];
+    DownlinkFecRxStats_t fec = { 0 };
+    uint32_t asm_errors = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            s_limit = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--fec") == 0 && i + 1 < argc) {
+            fec_depth = (unsigned)strtoul(argv[++i], NULL, 0);
+            if (fec_depth == 0 || fec_depth > DOWNLINK_FEC_MAX_DEPTH) {
+                path = NULL;
+                break;
+            }
+        } else if (path == NULL) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s [--limit N] [--fec DEPTH (1..%u)] downlink.bin\n", argv[0],
+                (unsigned)DOWNLINK_FEC_MAX_DEPTH);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return 2;
+    }
+
+    // 1. Codeblocks have a fixed length; the marker is only counted, not hunted
+    size_t block_len = DOWNLINK_FEC_BLOCK_LEN(fec_depth);
+    while (fec_depth > 0 && fread(block, 1, block_len, f) == block_len) {
+        if (ccsds_get_be32(block) != CCSDS_ASM) {
+            asm_errors++;
+        }
+        downlink_fec_decode_block(block, fec_depth, decode_fec_packet, NULL, &fec);
+    }
+    if (fec_depth > 0) {
+        // Packets lost inside a codeblock never reached decode_packet()
+        s_stats.packets += fec.bad_packets;
+        s_stats.bad_packets += fec.bad_packets;
+        printf("\n%u codeblocks (depth %u, %u damaged markers): %u symbols corrected, %u of %u codewords "
+               "uncorrectable\n", (unsigned)fec.blocks, fec_depth, (unsigned)asm_errors,
+               (unsigned)fec.corrected, (unsigned)fec.uncorrectable, (unsigned)fec.codewords);
+    }
+
+    // 2. Packets are self-delimiting: the primary header gives the length
+    while (fec_depth == 0 && fread(packet, 1, CCSDS_PRIMARY_HEADER_LEN, f) == CCSDS_PRIMARY_HEADER_LEN) {
+        size_t total = CCSDS_PRIMARY_HEADER_LEN + (size_t)ccsds_get_be16(&packet[4]) + 1u;
+        if (total > sizeof(packet) ||
+            fread(&packet[CCSDS_PRIMARY_HEADER_LEN], 1, total - CCSDS_PRIMARY_HEADER_LEN, f) !=
+                total - CCSDS_PRIMARY_HEADER_LEN) {
+            fprintf(stderr, "Truncated or oversized packet after %u packets; stopping.\n",
+                    (unsigned)s_stats.packets);
+            s_stats.bad_packets++;
+            break;
+        }
+        decode_packet(packet, total);
+    }
+    fclose(f);
+
+    // 3. Summary
+    printf("\n%u packets (%u bad), %u plain HK records, %u compressed frames carrying %u records, "
+           "%u HK sample sets, %u HK responses, %u summaries, %u bad records, %u other APIDs\n",
+           (unsigned)s_stats.packets, (unsigned)s_stats.bad_packets, (unsigned)s_stats.plain_records,
+           (unsigned)s_stats.compressed_frames, (unsigned)s_stats.compressed_records,
+           (unsigned)s_stats.sample_sets, (unsigned)s_stats.responses, (unsigned)s_stats.summaries,
+           (unsigned)s_stats.bad_records, (unsigned)s_stats.other_apids);
+    return (s_stats.bad_packets == 0 && s_stats.bad_records == 0 && fec.uncorrectable == 0) ? 0 : 1;
+}
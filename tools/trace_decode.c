@@ -0,0 +1,337 @@
+// tools/trace_decode.c
+// Ground-side decoder for trace_dump() images (see include/trace.h).
+//
+//   gcc -std=c99 -O2 -Iinclude tools/trace_decode.c -o trace_decode
+//   trace_decode [--timeline N] trace.bin
+//
+// Prints the last N events as a timeline (default 40, 0 for none), then a
+// per-task summary (CPU time between WAKE and SLEEP, longest run) and a
+// per-object summary (queue traffic, time from SEND to the matching RECEIVE,
+// mutex hold times and timeouts).
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TRACKED     64
+#define FIFO_DEPTH      64
+
+typedef struct {
+    uint64_t time;          // Unwrapped cycles of the recording core
+    TraceEvent_t raw;
+} DecodedEvent_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t runs;
+    uint64_t cpu_cycles;
+    uint64_t run_max;
+    uint64_t running_since;
+    int running;
+} TaskSummary_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t sends, receives, full;
+    uint32_t takes, gives, timeouts;
+    uint32_t matched;
+    uint64_t wait_sum, wait_max;
+    uint64_t hold_max, held_since;
+    uint64_t fifo[FIFO_DEPTH];  // SEND times not yet received
+    uint32_t fifo_head, fifo_count;
+} ObjectSummary_t;
+
+static TraceName_t s_names[TRACE_MAX_NAMES];
+static uint32_t s_name_count;
+static TaskSummary_t s_tasks[MAX_TRACKED];
+static uint32_t s_task_count;
+static ObjectSummary_t s_objects[MAX_TRACKED];
+static uint32_t s_object_count;
+
+static const char *s_type_names[TRACE_EVENT_TYPE_COUNT] = {
+    [TRACE_TASK_START]    = "START",
+    [TRACE_TASK_WAKE]     = "WAKE",
+    [TRACE_TASK_SLEEP]    = "SLEEP",
+    [TRACE_QUEUE_SEND]    = "SEND",
+    [TRACE_QUEUE_RECEIVE] = "RECEIVE",
+    [TRACE_QUEUE_FULL]    = "FULL",
+    [TRACE_MUTEX_TAKE]    = "TAKE",
+    [TRACE_MUTEX_GIVE]    = "GIVE",
+    [TRACE_MUTEX_TIMEOUT] = "TIMEOUT",
+    [TRACE_WDT_PET]       = "WDT_PET",
+    [TRACE_MODE_CHANGE]   = "MODE",
+};
+
+// --- A. LOOKUP ---
+
+static const char *name_of(uint32_t id) {
+    static char buf[4][16];
+    static int next;
+
+    if (id == 0) {
+        return "-";
+    }
+    for (uint32_t i = 0; i < s_name_count; i++) {
+        if (s_names[i].id == id) {
+            return s_names[i].name;
+        }
+    }
+    char *out = buf[next++ & 3];
+    snprintf(out, sizeof(buf[0]), "0x%08lx", (unsigned long)id);
+    return out;
+}
+
+static TaskSummary_t *task_of(uint32_t id) {
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        if (s_tasks[i].id == id) {
+            return &s_tasks[i];
+        }
+    }
+    if (s_task_count == MAX_TRACKED) {
+        return NULL;
+    }
+    s_tasks[s_task_count].id = id;
+    return &s_tasks[s_task_count++];
+}
+
+static ObjectSummary_t *object_of(uint32_t id) {
+    for (uint32_t i = 0; i < s_object_count; i++) {
+        if (s_objects[i].id == id) {
+            return &s_objects[i];
+        }
+    }
+    if (s_object_count == MAX_TRACKED) {
+        return NULL;
+    }
+    s_objects[s_object_count].id = id;
+    return &s_objects[s_object_count++];
+}
+
+static int by_time(const void *a, const void *b) {
+    const DecodedEvent_t *x = a, *y = b;
+    return (x->time > y->time) - (x->time < y->time);
+}
+
+// --- B. ANALYSIS ---
+
+static void account(const DecodedEvent_t *e) {
+    TaskSummary_t *task = task_of(e->raw.task);
+    ObjectSummary_t *obj = (e->raw.object != 0) ? object_of(e->raw.object) : NULL;
+
+    switch (e->raw.type) {
+        case TRACE_TASK_START:
+        case TRACE_TASK_WAKE:
+            if (task != NULL) {
+                task->running = 1;
+                task->running_since = e->time;
+            }
+            break;
+
+        case TRACE_TASK_SLEEP:
+            if (task != NULL && task->running) {
+                uint64_t run = e->time - task->running_since;
+                task->runs++;
+                task->cpu_cycles += run;
+                if (run > task->run_max) {
+                    task->run_max = run;
+                }
+                task->running = 0;
+            }
+            break;
+
+        case TRACE_QUEUE_SEND:
+            if (obj != NULL) {
+                obj->sends++;
+                if (obj->fifo_count < FIFO_DEPTH) {
+                    obj->fifo[(obj->fifo_head + obj->fifo_count++) % FIFO_DEPTH] = e->time;
+                }
+            }
+            break;
+
+        case TRACE_QUEUE_RECEIVE:
+            // Queues are FIFO, so the oldest pending send is this item.
+            // Items sent before the retained window have nothing to match.
+            if (obj != NULL) {
+                obj->receives++;
+                if (obj->fifo_count > 0) {
+                    uint64_t wait = e->time - obj->fifo[obj->fifo_head];
+                    obj->fifo_head = (obj->fifo_head + 1) % FIFO_DEPTH;
+                    obj->fifo_count--;
+                    obj->matched++;
+                    obj->wait_sum += wait;
+                    if (wait > obj->wait_max) {
+                        obj->wait_max = wait;
+                    }
+                }
+            }
+            break;
+
+        case TRACE_QUEUE_FULL:
+            if (obj != NULL) {
+                obj->full++;
+            }
+            break;
+
+        case TRACE_MUTEX_TAKE:
+            if (obj != NULL) {
+                obj->takes++;
+                obj->held_since = e->time;
+            }
+            break;
+
+        case TRACE_MUTEX_GIVE:
+            if (obj != NULL && obj->takes > obj->gives) {
+                uint64_t hold = e->time - obj->held_since;
+                obj->gives++;
+                if (hold > obj->hold_max) {
+                    obj->hold_max = hold;
+                }
+            }
+            break;
+
+        case TRACE_MUTEX_TIMEOUT:
+            if (obj != NULL) {
+                obj->timeouts++;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// --- C. MAIN ---
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    long timeline = 40;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--timeline") == 0 && i + 1 < argc) {
+            timeline = strtol(argv[++i], NULL, 0);
+        } else if (path == NULL) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s [--timeline N] trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    // 1. Header and name table
+    TraceDumpHeader_t header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TRACE_DUMP_MAGIC ||
+        header.version != TRACE_DUMP_VERSION || header.name_count > TRACE_MAX_NAMES ||
+        header.ring_events == 0 || (header.ring_events & (header.ring_events - 1)) != 0) {
+        fprintf(stderr, "%s: not a version %d trace dump\n", path, TRACE_DUMP_VERSION);
+        fclose(f);
+        return 1;
+    }
+    s_name_count = header.name_count;
+    if (fread(s_names, sizeof(TraceName_t), s_name_count, f) != s_name_count) {
+        fprintf(stderr, "%s: truncated name table\n", path);
+        fclose(f);
+        return 1;
+    }
+    for (uint32_t i = 0; i < s_name_count; i++) {
+        s_names[i].name[TRACE_NAME_LEN - 1] = '\0';
+    }
+
+    // 2. Rings: oldest retained event first, cycle counter unwrapped per core
+    uint64_t lost = 0;
+    size_t count = 0;
+    TraceEvent_t *ring = malloc(header.ring_events * sizeof(TraceEvent_t));
+    DecodedEvent_t *events = malloc((size_t)header.cores * header.ring_events * sizeof(DecodedEvent_t));
+    if (ring == NULL || events == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    for (uint32_t core = 0; core < header.cores; core++) {
+        uint32_t head;
+        if (fread(&head, sizeof(head), 1, f) != 1 ||
+            fread(ring, sizeof(TraceEvent_t), header.ring_events, f) != header.ring_events) {
+            fprintf(stderr, "%s: truncated ring for core %lu\n", path, (unsigned long)core);
+            return 1;
+        }
+
+        uint32_t kept = (head < header.ring_events) ? head : header.ring_events;
+        uint64_t time = 0;
+        uint32_t prev = 0;
+        lost += head - kept;
+
+        for (uint32_t n = 0; n < kept; n++) {
+            const TraceEvent_t *raw = &ring[(head - kept + n) & (header.ring_events - 1)];
+            time = (n == 0) ? raw->cycles : time + (uint32_t)(raw->cycles - prev);
+            prev = raw->cycles;
+            events[count].time = time;
+            events[count].raw = *raw;
+            count++;
+        }
+    }
+    fclose(f);
+    free(ring);
+
+    // The cores' counters are not synchronized; merging them by time is only
+    // as good as their skew.
+    qsort(events, count, sizeof(events[0]), by_time);
+
+    double per_us = header.cycles_per_us ? (double)header.cycles_per_us : 1.0;
+    uint64_t t0 = (count > 0) ? events[0].time : 0;
+
+    printf("=== TRACE %s: %lu events on %u core(s), %lu overwritten, %lu cycles/us, %.1f ms span ===\n",
+           path, (unsigned long)count, (unsigned)header.cores, (unsigned long)lost,
+           (unsigned long)header.cycles_per_us,
+           (count > 0) ? (double)(events[count - 1].time - t0) / per_us / 1000.0 : 0.0);
+
+    // 3. Timeline (tail)
+    if (timeline > 0) {
+        size_t first = (count > (size_t)timeline) ? count - (size_t)timeline : 0;
+        printf("\n%12s  %4s  %-12s %-8s %-12s %s\n", "t (us)", "core", "task", "event", "object", "arg");
+        for (size_t i = first; i < count; i++) {
+            const TraceEvent_t *raw = &events[i].raw;
+            const char *type = (raw->type < TRACE_EVENT_TYPE_COUNT && s_type_names[raw->type])
+                               ? s_type_names[raw->type] : "?";
+            printf("%12.1f  %4u  %-12s %-8s %-12s %u\n", (double)(events[i].time - t0) / per_us,
+                   (unsigned)raw->core, name_of(raw->task), type, name_of(raw->object),
+                   (unsigned)raw->arg);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        account(&events[i]);
+    }
+    free(events);
+
+    // 4. Summaries
+    printf("\n%-12s %8s %12s %10s %10s\n", "task", "runs", "cpu (us)", "avg (us)", "max (us)");
+    for (uint32_t i = 0; i < s_task_count; i++) {
+        const TaskSummary_t *t = &s_tasks[i];
+        printf("%-12s %8lu %12.1f %10.1f %10.1f\n", name_of(t->id), (unsigned long)t->runs,
+               (double)t->cpu_cycles / per_us,
+               t->runs ? (double)t->cpu_cycles / t->runs / per_us : 0.0,
+               (double)t->run_max / per_us);
+    }
+
+    printf("\n%-12s %6s %6s %5s %12s %12s %6s %8s %12s\n", "object", "send", "recv", "full",
+           "wait avg(us)", "wait max(us)", "take", "timeout", "hold max(us)");
+    for (uint32_t i = 0; i < s_object_count; i++) {
+        const ObjectSummary_t *o = &s_objects[i];
+        printf("%-12s %6lu %6lu %5lu %12.1f %12.1f %6lu %8lu %12.1f\n", name_of(o->id),
+               (unsigned long)o->sends, (unsigned long)o->receives, (unsigned long)o->full,
+               o->matched ? (double)o->wait_sum / o->matched / per_us : 0.0,
+               (double)o->wait_max / per_us, (unsigned long)o->takes,
+               (unsigned long)o->timeouts, (double)o->hold_max / per_us);
+    }
+    return 0;
+}